@@ -1,5 +1,13 @@
 
-vec3 objectNormal = vec3( normal );
+#ifdef USE_OCTAHEDRAL_NORMALS
+
+	vec3 objectNormal = octahedralDecode( normal );
+
+#else
+
+	vec3 objectNormal = vec3( normal );
+
+#endif
 
 #ifdef USE_TANGENT
 
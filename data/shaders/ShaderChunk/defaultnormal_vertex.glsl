@@ -1,6 +1,18 @@
 
 vec3 transformedNormal = objectNormal;
 
+#ifdef USE_BATCHING
+
+	// same as the instancing block below, shear transforms are not supported
+
+	mat3 bm = mat3( getBatchingMatrix( batchId ) );
+
+	transformedNormal /= vec3( dot( bm[ 0 ], bm[ 0 ] ), dot( bm[ 1 ], bm[ 1 ] ), dot( bm[ 2 ], bm[ 2 ] ) );
+
+	transformedNormal = bm * transformedNormal;
+
+#endif
+
 #ifdef USE_INSTANCING
 
 	// this is in lieu of a per-instance normal-matrix
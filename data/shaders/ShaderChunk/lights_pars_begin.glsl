@@ -1,7 +1,18 @@
 
 uniform bool receiveShadow;
-uniform vec3 ambientLightColor;
-uniform vec3 lightProbe[ 9 ];
+#ifdef USE_UNIFORM_BUFFERS
+
+	layout( std140 ) uniform AmbientLightBlock {
+		vec3 ambientLightColor;
+		vec3 lightProbe[ 9 ];
+	};
+
+#else
+
+	uniform vec3 ambientLightColor;
+	uniform vec3 lightProbe[ 9 ];
+
+#endif
 
 // get the irradiance (radiance convolved with cosine lobe) at the point 'normal' on the unit sphere
 // source: https://graphics.stanford.edu/papers/envmap/envmap.pdf
@@ -61,7 +72,11 @@ vec3 getAmbientLightIrradiance( const in vec3 ambientLightColor ) {
 		vec3 color;
 	};
 
-	uniform DirectionalLight directionalLights[ NUM_DIR_LIGHTS ];
+	#ifdef USE_UNIFORM_BUFFERS
+		layout( std140 ) uniform DirectionalLightsBlock { DirectionalLight directionalLights[ NUM_DIR_LIGHTS ]; };
+	#else
+		uniform DirectionalLight directionalLights[ NUM_DIR_LIGHTS ];
+	#endif
 
 	void getDirectionalDirectLightIrradiance( const in DirectionalLight directionalLight, const in GeometricContext geometry, out IncidentLight directLight ) {
 
@@ -83,7 +98,11 @@ vec3 getAmbientLightIrradiance( const in vec3 ambientLightColor ) {
 		float decay;
 	};
 
-	uniform PointLight pointLights[ NUM_POINT_LIGHTS ];
+	#ifdef USE_UNIFORM_BUFFERS
+		layout( std140 ) uniform PointLightsBlock { PointLight pointLights[ NUM_POINT_LIGHTS ]; };
+	#else
+		uniform PointLight pointLights[ NUM_POINT_LIGHTS ];
+	#endif
 
 	// directLight is an out parameter as having it as a return value caused compiler errors on some devices
 	void getPointDirectLightIrradiance( const in PointLight pointLight, const in GeometricContext geometry, out IncidentLight directLight ) {
@@ -114,7 +133,11 @@ vec3 getAmbientLightIrradiance( const in vec3 ambientLightColor ) {
 		float penumbraCos;
 	};
 
-	uniform SpotLight spotLights[ NUM_SPOT_LIGHTS ];
+	#ifdef USE_UNIFORM_BUFFERS
+		layout( std140 ) uniform SpotLightsBlock { SpotLight spotLights[ NUM_SPOT_LIGHTS ]; };
+	#else
+		uniform SpotLight spotLights[ NUM_SPOT_LIGHTS ];
+	#endif
 
 	// directLight is an out parameter as having it as a return value caused compiler errors on some devices
 	void getSpotDirectLightIrradiance( const in SpotLight spotLight, const in GeometricContext geometry, out IncidentLight directLight ) {
@@ -171,7 +194,11 @@ vec3 getAmbientLightIrradiance( const in vec3 ambientLightColor ) {
 		vec3 groundColor;
 	};
 
-	uniform HemisphereLight hemisphereLights[ NUM_HEMI_LIGHTS ];
+	#ifdef USE_UNIFORM_BUFFERS
+		layout( std140 ) uniform HemisphereLightsBlock { HemisphereLight hemisphereLights[ NUM_HEMI_LIGHTS ]; };
+	#else
+		uniform HemisphereLight hemisphereLights[ NUM_HEMI_LIGHTS ];
+	#endif
 
 	vec3 getHemisphereLightIrradiance( const in HemisphereLight hemiLight, const in GeometricContext geometry ) {
 
@@ -1,6 +1,12 @@
 
 vec4 mvPosition = vec4( transformed, 1.0 );
 
+#ifdef USE_BATCHING
+
+	mvPosition = getBatchingMatrix( batchId ) * mvPosition;
+
+#endif
+
 #ifdef USE_INSTANCING
 
 	mvPosition = instanceMatrix * mvPosition;
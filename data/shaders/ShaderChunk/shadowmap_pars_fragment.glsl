@@ -1,9 +1,28 @@
 
 #ifdef USE_SHADOWMAP
 
+	// the map of each light is a region of the atlas, shadowMapRect
+	#ifdef USE_SHADOW_ATLAS
+
+		uniform sampler2D shadowAtlas;
+
+		#define DIRECTIONAL_SHADOW_MAP( index ) shadowAtlas
+		#define SPOT_SHADOW_MAP( index ) shadowAtlas
+		#define POINT_SHADOW_MAP( index ) shadowAtlas
+
+	#else
+
+		#define DIRECTIONAL_SHADOW_MAP( index ) directionalShadowMap[ index ]
+		#define SPOT_SHADOW_MAP( index ) spotShadowMap[ index ]
+		#define POINT_SHADOW_MAP( index ) pointShadowMap[ index ]
+
+	#endif
+
 	#if NUM_DIR_LIGHT_SHADOWS > 0
 
-		uniform sampler2D directionalShadowMap[ NUM_DIR_LIGHT_SHADOWS ];
+		#ifndef USE_SHADOW_ATLAS
+			uniform sampler2D directionalShadowMap[ NUM_DIR_LIGHT_SHADOWS ];
+		#endif
 		varying vec4 vDirectionalShadowCoord[ NUM_DIR_LIGHT_SHADOWS ];
 
 		struct DirectionalLightShadow {
@@ -11,15 +30,34 @@
 			float shadowNormalBias;
 			float shadowRadius;
 			vec2 shadowMapSize;
+			float shadowCascades;
+			vec4 shadowMapRect;
 		};
 
-		uniform DirectionalLightShadow directionalLightShadows[ NUM_DIR_LIGHT_SHADOWS ];
+		#ifdef USE_UNIFORM_BUFFERS
+			layout( std140 ) uniform DirectionalLightShadowsBlock { DirectionalLightShadow directionalLightShadows[ NUM_DIR_LIGHT_SHADOWS ]; };
+		#else
+			uniform DirectionalLightShadow directionalLightShadows[ NUM_DIR_LIGHT_SHADOWS ];
+		#endif
+
+		#if NUM_DIR_LIGHT_SHADOW_CASCADES > 1
+
+			// per light, from the shadow coordinates of its first cascade to those of each cascade
+			#ifdef USE_UNIFORM_BUFFERS
+				layout( std140 ) uniform DirectionalShadowCascadeMatrixBlock { mat4 directionalShadowCascadeMatrix[ NUM_DIR_LIGHT_SHADOWS * NUM_DIR_LIGHT_SHADOW_CASCADES ]; };
+			#else
+				uniform mat4 directionalShadowCascadeMatrix[ NUM_DIR_LIGHT_SHADOWS * NUM_DIR_LIGHT_SHADOW_CASCADES ];
+			#endif
+
+		#endif
 
 	#endif
 
 	#if NUM_SPOT_LIGHT_SHADOWS > 0
 
-		uniform sampler2D spotShadowMap[ NUM_SPOT_LIGHT_SHADOWS ];
+		#ifndef USE_SHADOW_ATLAS
+			uniform sampler2D spotShadowMap[ NUM_SPOT_LIGHT_SHADOWS ];
+		#endif
 		varying vec4 vSpotShadowCoord[ NUM_SPOT_LIGHT_SHADOWS ];
 
 		struct SpotLightShadow {
@@ -27,15 +65,22 @@
 			float shadowNormalBias;
 			float shadowRadius;
 			vec2 shadowMapSize;
+			vec4 shadowMapRect;
 		};
 
-		uniform SpotLightShadow spotLightShadows[ NUM_SPOT_LIGHT_SHADOWS ];
+		#ifdef USE_UNIFORM_BUFFERS
+			layout( std140 ) uniform SpotLightShadowsBlock { SpotLightShadow spotLightShadows[ NUM_SPOT_LIGHT_SHADOWS ]; };
+		#else
+			uniform SpotLightShadow spotLightShadows[ NUM_SPOT_LIGHT_SHADOWS ];
+		#endif
 
 	#endif
 
 	#if NUM_POINT_LIGHT_SHADOWS > 0
 
-		uniform sampler2D pointShadowMap[ NUM_POINT_LIGHT_SHADOWS ];
+		#ifndef USE_SHADOW_ATLAS
+			uniform sampler2D pointShadowMap[ NUM_POINT_LIGHT_SHADOWS ];
+		#endif
 		varying vec4 vPointShadowCoord[ NUM_POINT_LIGHT_SHADOWS ];
 
 		struct PointLightShadow {
@@ -45,9 +90,14 @@
 			vec2 shadowMapSize;
 			float shadowCameraNear;
 			float shadowCameraFar;
+			vec4 shadowMapRect;
 		};
 
-		uniform PointLightShadow pointLightShadows[ NUM_POINT_LIGHT_SHADOWS ];
+		#ifdef USE_UNIFORM_BUFFERS
+			layout( std140 ) uniform PointLightShadowsBlock { PointLightShadow pointLightShadows[ NUM_POINT_LIGHT_SHADOWS ]; };
+		#else
+			uniform PointLightShadow pointLightShadows[ NUM_POINT_LIGHT_SHADOWS ];
+		#endif
 
 	#endif
 
@@ -92,7 +142,7 @@
 
 	}
 
-	float getShadow( sampler2D shadowMap, vec2 shadowMapSize, float shadowBias, float shadowRadius, vec4 shadowCoord ) {
+	float getShadow( sampler2D shadowMap, vec2 shadowMapSize, float shadowBias, float shadowRadius, vec4 shadowCoord, vec4 shadowMapRect ) {
 
 		float shadow = 1.0;
 
@@ -109,6 +159,16 @@
 
 		bool frustumTest = all( frustumTestVec );
 
+		#ifdef USE_SHADOW_ATLAS
+
+			// lights left out of the atlas have an empty region
+			frustumTest = frustumTest && shadowMapRect.z > 0.0;
+
+			shadowCoord.xy = shadowMapRect.xy + shadowCoord.xy * shadowMapRect.zw;
+			shadowMapSize /= shadowMapRect.zw;
+
+		#endif
+
 		if ( frustumTest ) {
 
 		#if defined( SHADOWMAP_TYPE_PCF )
@@ -196,6 +256,65 @@
 
 	}
 
+	float getShadow( sampler2D shadowMap, vec2 shadowMapSize, float shadowBias, float shadowRadius, vec4 shadowCoord ) {
+
+		return getShadow( shadowMap, shadowMapSize, shadowBias, shadowRadius, shadowCoord, vec4( 0.0, 0.0, 1.0, 1.0 ) );
+
+	}
+
+	#if NUM_DIR_LIGHT_SHADOWS > 0
+
+	float getDirectionalShadow( sampler2D shadowMap, DirectionalLightShadow directionalShadow, int shadowIndex, vec4 shadowCoord ) {
+
+		#if NUM_DIR_LIGHT_SHADOW_CASCADES > 1
+
+		int cascades = int( directionalShadow.shadowCascades + 0.5 );
+
+		if ( cascades > 1 ) {
+
+			// the cascades are cells of a grid in the map, laid out like DirectionalLightShadow::setCascades does
+			int columns = int( floor( sqrt( float( cascades ) - 0.5 ) ) ) + 1;
+			int rows = ( cascades + columns - 1 ) / columns;
+			vec2 grid = vec2( columns, rows );
+
+			// keeps the filter inside the cell
+			vec2 margin = vec2( directionalShadow.shadowRadius + 1.0 ) / directionalShadow.shadowMapSize;
+
+			// the first cascade covering the fragment has the most texels for it
+			for ( int c = 0; c < NUM_DIR_LIGHT_SHADOW_CASCADES; c ++ ) {
+
+				if ( c >= cascades ) break;
+
+				mat4 cascadeMatrix = directionalShadowCascadeMatrix[ shadowIndex * NUM_DIR_LIGHT_SHADOW_CASCADES + c ];
+				vec4 coord = cascadeMatrix * shadowCoord;
+
+				bvec4 inCell = bvec4( coord.x >= margin.x, coord.x <= 1.0 - margin.x, coord.y >= margin.y, coord.y <= 1.0 - margin.y );
+
+				if ( all( inCell ) && coord.z <= 1.0 ) {
+
+					vec2 cell = vec2( c - ( c / columns ) * columns, c / columns );
+					coord.xy = ( coord.xy + cell ) / grid;
+
+					// the bias is in the depth units of the first cascade
+					return getShadow( shadowMap, directionalShadow.shadowMapSize * grid, directionalShadow.shadowBias * cascadeMatrix[ 2 ][ 2 ], directionalShadow.shadowRadius, coord, directionalShadow.shadowMapRect );
+
+				}
+
+			}
+
+			// beyond the last cascade
+			return 1.0;
+
+		}
+
+		#endif
+
+		return getShadow( shadowMap, directionalShadow.shadowMapSize, directionalShadow.shadowBias, directionalShadow.shadowRadius, shadowCoord, directionalShadow.shadowMapRect );
+
+	}
+
+	#endif
+
 	// cubeToUV() maps a 3D direction vector suitable for cube texture mapping to a 2D
 	// vector suitable for 2D texture mapping. This code uses the following layout for the
 	// 2D texture:
@@ -267,7 +386,29 @@
 
 	}
 
-	float getPointShadow( sampler2D shadowMap, vec2 shadowMapSize, float shadowBias, float shadowRadius, vec4 shadowCoord, float shadowCameraNear, float shadowCameraFar ) {
+	// cubeToUV() in the region of the map
+	vec2 pointShadowUV( vec3 v, float texelSizeY, vec4 shadowMapRect ) {
+
+		vec2 uv = cubeToUV( v, texelSizeY );
+
+		#ifdef USE_SHADOW_ATLAS
+
+			uv = shadowMapRect.xy + uv * shadowMapRect.zw;
+
+		#endif
+
+		return uv;
+
+	}
+
+	float getPointShadow( sampler2D shadowMap, vec2 shadowMapSize, float shadowBias, float shadowRadius, vec4 shadowCoord, float shadowCameraNear, float shadowCameraFar, vec4 shadowMapRect ) {
+
+		#ifdef USE_SHADOW_ATLAS
+
+			// lights left out of the atlas have an empty region
+			if ( shadowMapRect.z <= 0.0 ) return 1.0;
+
+		#endif
 
 		vec2 texelSize = vec2( 1.0 ) / ( shadowMapSize * vec2( 4.0, 2.0 ) );
 
@@ -287,24 +428,31 @@
 			vec2 offset = vec2( - 1, 1 ) * shadowRadius * texelSize.y;
 
 			return (
-				texture2DCompare( shadowMap, cubeToUV( bd3D + offset.xyy, texelSize.y ), dp ) +
-				texture2DCompare( shadowMap, cubeToUV( bd3D + offset.yyy, texelSize.y ), dp ) +
-				texture2DCompare( shadowMap, cubeToUV( bd3D + offset.xyx, texelSize.y ), dp ) +
-				texture2DCompare( shadowMap, cubeToUV( bd3D + offset.yyx, texelSize.y ), dp ) +
-				texture2DCompare( shadowMap, cubeToUV( bd3D, texelSize.y ), dp ) +
-				texture2DCompare( shadowMap, cubeToUV( bd3D + offset.xxy, texelSize.y ), dp ) +
-				texture2DCompare( shadowMap, cubeToUV( bd3D + offset.yxy, texelSize.y ), dp ) +
-				texture2DCompare( shadowMap, cubeToUV( bd3D + offset.xxx, texelSize.y ), dp ) +
-				texture2DCompare( shadowMap, cubeToUV( bd3D + offset.yxx, texelSize.y ), dp )
+				texture2DCompare( shadowMap, pointShadowUV( bd3D + offset.xyy, texelSize.y, shadowMapRect ), dp ) +
+				texture2DCompare( shadowMap, pointShadowUV( bd3D + offset.yyy, texelSize.y, shadowMapRect ), dp ) +
+				texture2DCompare( shadowMap, pointShadowUV( bd3D + offset.xyx, texelSize.y, shadowMapRect ), dp ) +
+				texture2DCompare( shadowMap, pointShadowUV( bd3D + offset.yyx, texelSize.y, shadowMapRect ), dp ) +
+				texture2DCompare( shadowMap, pointShadowUV( bd3D, texelSize.y, shadowMapRect ), dp ) +
+				texture2DCompare( shadowMap, pointShadowUV( bd3D + offset.xxy, texelSize.y, shadowMapRect ), dp ) +
+				texture2DCompare( shadowMap, pointShadowUV( bd3D + offset.yxy, texelSize.y, shadowMapRect ), dp ) +
+				texture2DCompare( shadowMap, pointShadowUV( bd3D + offset.xxx, texelSize.y, shadowMapRect ), dp ) +
+				texture2DCompare( shadowMap, pointShadowUV( bd3D + offset.yxx, texelSize.y, shadowMapRect ), dp )
 			) * ( 1.0 / 9.0 );
 
 		#else // no percentage-closer filtering
 
-			return texture2DCompare( shadowMap, cubeToUV( bd3D, texelSize.y ), dp );
+			return texture2DCompare( shadowMap, pointShadowUV( bd3D, texelSize.y, shadowMapRect ), dp );
 
 		#endif
 
 	}
 
+
+	float getPointShadow( sampler2D shadowMap, vec2 shadowMapSize, float shadowBias, float shadowRadius, vec4 shadowCoord, float shadowCameraNear, float shadowCameraFar ) {
+
+		return getPointShadow( shadowMap, shadowMapSize, shadowBias, shadowRadius, shadowCoord, shadowCameraNear, shadowCameraFar, vec4( 0.0, 0.0, 1.0, 1.0 ) );
+
+	}
+
 #endif
 
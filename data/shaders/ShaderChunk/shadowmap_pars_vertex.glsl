@@ -3,7 +3,11 @@
 
 	#if NUM_DIR_LIGHT_SHADOWS > 0
 
-		uniform mat4 directionalShadowMatrix[ NUM_DIR_LIGHT_SHADOWS ];
+		#ifdef USE_UNIFORM_BUFFERS
+			layout( std140 ) uniform DirectionalShadowMatrixBlock { mat4 directionalShadowMatrix[ NUM_DIR_LIGHT_SHADOWS ]; };
+		#else
+			uniform mat4 directionalShadowMatrix[ NUM_DIR_LIGHT_SHADOWS ];
+		#endif
 		varying vec4 vDirectionalShadowCoord[ NUM_DIR_LIGHT_SHADOWS ];
 
 		struct DirectionalLightShadow {
@@ -11,15 +15,25 @@
 			float shadowNormalBias;
 			float shadowRadius;
 			vec2 shadowMapSize;
+			float shadowCascades;
+			vec4 shadowMapRect;
 		};
 
-		uniform DirectionalLightShadow directionalLightShadows[ NUM_DIR_LIGHT_SHADOWS ];
+		#ifdef USE_UNIFORM_BUFFERS
+			layout( std140 ) uniform DirectionalLightShadowsBlock { DirectionalLightShadow directionalLightShadows[ NUM_DIR_LIGHT_SHADOWS ]; };
+		#else
+			uniform DirectionalLightShadow directionalLightShadows[ NUM_DIR_LIGHT_SHADOWS ];
+		#endif
 
 	#endif
 
 	#if NUM_SPOT_LIGHT_SHADOWS > 0
 
-		uniform mat4 spotShadowMatrix[ NUM_SPOT_LIGHT_SHADOWS ];
+		#ifdef USE_UNIFORM_BUFFERS
+			layout( std140 ) uniform SpotShadowMatrixBlock { mat4 spotShadowMatrix[ NUM_SPOT_LIGHT_SHADOWS ]; };
+		#else
+			uniform mat4 spotShadowMatrix[ NUM_SPOT_LIGHT_SHADOWS ];
+		#endif
 		varying vec4 vSpotShadowCoord[ NUM_SPOT_LIGHT_SHADOWS ];
 
 		struct SpotLightShadow {
@@ -27,15 +41,24 @@
 			float shadowNormalBias;
 			float shadowRadius;
 			vec2 shadowMapSize;
+			vec4 shadowMapRect;
 		};
 
-		uniform SpotLightShadow spotLightShadows[ NUM_SPOT_LIGHT_SHADOWS ];
+		#ifdef USE_UNIFORM_BUFFERS
+			layout( std140 ) uniform SpotLightShadowsBlock { SpotLightShadow spotLightShadows[ NUM_SPOT_LIGHT_SHADOWS ]; };
+		#else
+			uniform SpotLightShadow spotLightShadows[ NUM_SPOT_LIGHT_SHADOWS ];
+		#endif
 
 	#endif
 
 	#if NUM_POINT_LIGHT_SHADOWS > 0
 
-		uniform mat4 pointShadowMatrix[ NUM_POINT_LIGHT_SHADOWS ];
+		#ifdef USE_UNIFORM_BUFFERS
+			layout( std140 ) uniform PointShadowMatrixBlock { mat4 pointShadowMatrix[ NUM_POINT_LIGHT_SHADOWS ]; };
+		#else
+			uniform mat4 pointShadowMatrix[ NUM_POINT_LIGHT_SHADOWS ];
+		#endif
 		varying vec4 vPointShadowCoord[ NUM_POINT_LIGHT_SHADOWS ];
 
 		struct PointLightShadow {
@@ -45,9 +68,14 @@
 			vec2 shadowMapSize;
 			float shadowCameraNear;
 			float shadowCameraFar;
+			vec4 shadowMapRect;
 		};
 
-		uniform PointLightShadow pointLightShadows[ NUM_POINT_LIGHT_SHADOWS ];
+		#ifdef USE_UNIFORM_BUFFERS
+			layout( std140 ) uniform PointLightShadowsBlock { PointLightShadow pointLightShadows[ NUM_POINT_LIGHT_SHADOWS ]; };
+		#else
+			uniform PointLightShadow pointLightShadows[ NUM_POINT_LIGHT_SHADOWS ];
+		#endif
 
 	#endif
 
@@ -20,7 +20,10 @@
 	uniform sampler2D transmissionSamplerMap;
 
 	uniform mat4 modelMatrix;
-	uniform mat4 projectionMatrix;
+
+	#ifndef USE_UNIFORM_BUFFERS
+		uniform mat4 projectionMatrix;
+	#endif
 
 	varying vec4 vWorldPosition;
 
@@ -3,6 +3,12 @@
 
 	vec4 worldPosition = vec4( transformed, 1.0 );
 
+	#ifdef USE_BATCHING
+
+		worldPosition = getBatchingMatrix( batchId ) * worldPosition;
+
+	#endif
+
 	#ifdef USE_INSTANCING
 
 		worldPosition = instanceMatrix * worldPosition;
@@ -0,0 +1,91 @@
+// Measures the startup cost of compiling a set of material permutations, using GLRenderer::programCacheDirectory.
+// Run it twice: the first run starts with an empty cache (cold) and fills it, the second one loads the binaries (warm).
+//
+// usage: program_cache_benchmark [cacheDirectory=program_cache]
+
+#include "threepp/materials/MeshToonMaterial.hpp"
+#include "threepp/threepp.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+
+using namespace threepp;
+
+namespace {
+
+    std::vector<std::shared_ptr<Material>> createMaterials() {
+
+        std::vector<std::shared_ptr<Material>> materials;
+
+        const std::vector<std::function<std::shared_ptr<Material>()>> factories{
+                [] { return MeshBasicMaterial::create(); },
+                [] { return MeshLambertMaterial::create(); },
+                [] { return MeshPhongMaterial::create(); },
+                [] { return MeshStandardMaterial::create(); },
+                [] { return MeshToonMaterial::create(); },
+                [] { return MeshNormalMaterial::create(); }};
+
+        for (const auto& factory : factories) {
+            for (int permutation = 0; permutation < 8; permutation++) {
+
+                auto material = factory();
+                material->vertexColors = permutation & 1;
+                material->side = (permutation & 2) ? Side::Double : Side::Front;
+                if (auto flat = dynamic_cast<MaterialWithFlatShading*>(material.get())) {
+                    flat->flatShading = permutation & 4;
+                }
+                materials.emplace_back(material);
+            }
+        }
+
+        return materials;
+    }
+
+}// namespace
+
+int main(int argc, char** argv) {
+
+    const std::filesystem::path cacheDirectory = argc > 1 ? argv[1] : "program_cache";
+
+    std::error_code ec;
+    const bool warm = std::filesystem::exists(cacheDirectory, ec) && !std::filesystem::is_empty(cacheDirectory, ec);
+
+    Canvas canvas("Program cache benchmark", {{"vsync", false}});
+    GLRenderer renderer(canvas.size());
+    renderer.shadowMap().enabled = true;
+    renderer.programCacheDirectory = cacheDirectory;
+
+    auto scene = Scene::create();
+    scene->add(AmbientLight::create(0xffffff, 0.3f));
+
+    auto light = DirectionalLight::create(0xffffff, 0.7f);
+    light->position.set(10, 10, 10);
+    light->castShadow = true;
+    scene->add(light);
+
+    auto geometry = BoxGeometry::create();
+    const auto materials = createMaterials();
+    for (unsigned i = 0; i < materials.size(); i++) {
+
+        auto mesh = Mesh::create(geometry, materials[i]);
+        mesh->position.set(static_cast<float>(i % 8) * 1.5f - 5, static_cast<float>(i / 8) * 1.5f - 4, 0);
+        mesh->receiveShadow = true;
+        mesh->castShadow = true;
+        scene->add(mesh);
+    }
+
+    auto camera = PerspectiveCamera::create(60, canvas.aspect(), 0.1f, 100);
+    camera->position.z = 15;
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    // the first frame compiles every program
+    const auto start = Clock::now();
+    renderer.render(*scene, *camera);
+    const auto stop = Clock::now();
+
+    std::cout << "materials=" << materials.size() << ", cache=" << (warm ? "warm" : "cold")
+              << ", first frame=" << std::chrono::duration<double, std::milli>(stop - start).count() << "ms" << std::endl;
+}
@@ -0,0 +1,113 @@
+// Measures the CPU time of GLRenderer::render on a large scene where most objects are outside the view frustum,
+// comparing the sequential scene projection with GLRenderer::parallelProjection across thread counts.
+//
+// usage: projection_benchmark [numMeshes=50000] [numFrames=200]
+
+#include "threepp/threepp.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+using namespace threepp;
+
+namespace {
+
+    struct Run {
+        std::string name;
+        bool parallel;
+        unsigned int threads;
+    };
+
+    std::shared_ptr<Group> createScene(int numMeshes) {
+
+        auto geometry = BoxGeometry::create(0.5f, 0.5f, 0.5f);
+        auto material = MeshBasicMaterial::create();
+
+        auto root = Group::create();
+
+        // a few levels of hierarchy, similar to an imported plant model
+        const int meshesPerGroup = 100;
+        const int side = static_cast<int>(std::ceil(std::sqrt(numMeshes)));
+        std::shared_ptr<Group> group;
+        for (int i = 0; i < numMeshes; i++) {
+
+            if (i % meshesPerGroup == 0) {
+                group = Group::create();
+                root->add(group);
+            }
+
+            auto mesh = Mesh::create(geometry, material);
+            mesh->position.set(static_cast<float>(i % side), 0, static_cast<float>(i / side));
+            group->add(mesh);
+        }
+
+        return root;
+    }
+
+}// namespace
+
+int main(int argc, char** argv) {
+
+    const int numMeshes = argc > 1 ? std::stoi(argv[1]) : 50000;
+    const int numFrames = argc > 2 ? std::stoi(argv[2]) : 200;
+    const int warmupFrames = 20;
+
+    Canvas canvas("Projection benchmark", {{"vsync", false}});
+    GLRenderer renderer(canvas.size());
+
+    auto scene = Scene::create();
+    scene->add(createScene(numMeshes));
+
+    // only a small corner of the grid is inside the frustum, so culling dominates the frame
+    auto camera = PerspectiveCamera::create(30, canvas.aspect(), 0.1f, 50);
+    camera->position.set(-5, 5, -5);
+    camera->lookAt(5, 0, 5);
+
+    std::vector<Run> runs{{"sequential", false, 1}};
+    const auto maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int threads = 1; threads < maxThreads; threads *= 2) {
+        runs.push_back({"parallel", true, threads});
+    }
+    runs.push_back({"parallel", true, maxThreads});
+
+    std::cout << "meshes=" << numMeshes << ", frames=" << numFrames << std::endl;
+    std::cout << std::setw(12) << "mode" << std::setw(10) << "threads" << std::setw(14) << "ms/frame" << std::setw(10) << "speedup" << std::endl;
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    size_t runIndex = 0;
+    int frame = 0;
+    double elapsed = 0;
+    double baseline = 0;
+
+    canvas.animate([&] {
+        const auto& run = runs[runIndex];
+        renderer.parallelProjection = run.parallel;
+        renderer.projectionThreads = run.threads;
+
+        const auto start = Clock::now();
+        renderer.render(*scene, *camera);
+        const auto stop = Clock::now();
+
+        if (frame++ >= warmupFrames) {
+            elapsed += std::chrono::duration<double, std::milli>(stop - start).count();
+        }
+
+        if (frame == warmupFrames + numFrames) {
+
+            const auto msPerFrame = elapsed / numFrames;
+            if (runIndex == 0) baseline = msPerFrame;
+
+            std::cout << std::setw(12) << run.name << std::setw(10) << run.threads
+                      << std::setw(14) << std::fixed << std::setprecision(3) << msPerFrame
+                      << std::setw(9) << std::setprecision(2) << (baseline / msPerFrame) << "x" << std::endl;
+
+            frame = 0;
+            elapsed = 0;
+            if (++runIndex == runs.size()) canvas.close();
+        }
+    });
+}
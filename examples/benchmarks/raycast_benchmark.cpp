@@ -0,0 +1,121 @@
+// Measures Mesh::raycast on a dense mesh, comparing the brute force triangle loop with
+// BufferGeometry::useBoundsTree, with and without Raycaster::firstHitOnly,
+// and the batched Raycaster::intersectObjects over all rays at once.
+// No window is opened, raycasting does not use the GPU.
+//
+// usage: raycast_benchmark [segments=1000] [numRays=200]
+
+#include "threepp/geometries/TorusKnotGeometry.hpp"
+#include "threepp/threepp.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace threepp;
+
+namespace {
+
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    struct Run {
+        std::string name;
+        bool useBoundsTree;
+        bool firstHitOnly;
+    };
+
+    double millisSince(TimePoint start) {
+
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+}// namespace
+
+int main(int argc, char** argv) {
+
+    const int segments = argc > 1 ? std::stoi(argv[1]) : 1000;
+    const int numRays = argc > 2 ? std::stoi(argv[2]) : 200;
+
+    // a torus knot has many overlapping layers along most rays, like a scanned model
+    auto geometry = TorusKnotGeometry::create(10, 3, segments, segments / 4);
+    auto material = MeshBasicMaterial::create();
+    material->side = Side::Double;
+
+    auto mesh = Mesh::create(geometry, material);
+    mesh->updateMatrixWorld();
+
+    const auto numTriangles = geometry->getIndex()->count() / 3;
+
+    PerspectiveCamera camera(60, 1, 0.1f, 1000);
+    camera.position.set(0, 0, 40);
+    camera.updateMatrixWorld();
+
+    std::vector<Vector2> coords(numRays);
+    for (auto& c : coords) c.set(math::randFloatSpread(1), math::randFloatSpread(1));
+
+    auto start = std::chrono::steady_clock::now();
+    geometry->boundsTree();
+    const auto buildTime = millisSince(start);
+
+    std::cout << "triangles=" << numTriangles << ", rays=" << numRays << std::endl;
+    std::cout << "bounds tree build: " << std::fixed << std::setprecision(1) << buildTime << " ms" << std::endl;
+    std::cout << std::setw(24) << "mode" << std::setw(14) << "ms/ray" << std::setw(10) << "hits" << std::setw(10) << "speedup" << std::endl;
+
+    const std::vector<Run> runs{
+            {"brute force", false, false},
+            {"brute force, first hit", false, true},
+            {"bounds tree", true, false},
+            {"bounds tree, first hit", true, true}};
+
+    Raycaster raycaster;
+    double baseline = 0;
+
+    for (const auto& run : runs) {
+
+        geometry->useBoundsTree = run.useBoundsTree;
+        raycaster.firstHitOnly = run.firstHitOnly;
+
+        size_t hits = 0;
+        start = std::chrono::steady_clock::now();
+        for (const auto& c : coords) {
+
+            raycaster.setFromCamera(c, camera);
+            hits += raycaster.intersectObject(*mesh).size();
+        }
+        const auto msPerRay = millisSince(start) / numRays;
+
+        if (baseline == 0) baseline = msPerRay;
+
+        std::cout << std::setw(24) << run.name
+                  << std::setw(14) << std::setprecision(4) << msPerRay
+                  << std::setw(10) << hits
+                  << std::setw(9) << std::setprecision(1) << (baseline / msPerRay) << "x" << std::endl;
+    }
+
+    std::vector<Ray> rays;
+    for (const auto& c : coords) {
+
+        raycaster.setFromCamera(c, camera);
+        rays.emplace_back(raycaster.ray);
+    }
+
+    geometry->useBoundsTree = true;
+    raycaster.firstHitOnly = false;
+
+    for (const auto numThreads : {1u, 0u}) {
+
+        size_t hits = 0;
+        start = std::chrono::steady_clock::now();
+        for (const auto& intersects : raycaster.intersectObjects(rays, {mesh.get()}, false, numThreads)) {
+
+            hits += intersects.size();
+        }
+        const auto msPerRay = millisSince(start) / numRays;
+
+        const auto name = "batched, " + (numThreads == 0 ? std::string("all threads") : "1 thread");
+        std::cout << std::setw(24) << name
+                  << std::setw(14) << std::setprecision(4) << msPerRay
+                  << std::setw(10) << hits
+                  << std::setw(9) << std::setprecision(1) << (baseline / msPerRay) << "x" << std::endl;
+    }
+}
@@ -49,6 +49,7 @@ int main() {
     Clock clock;
     auto position = plane->geometry()->getAttribute<float>("position");
     position->setUsage(DrawUsage::Dynamic);
+    position->setStreamed(true);
     canvas.animate([&]() {
         float time = clock.getElapsedTime();
 
@@ -0,0 +1,73 @@
+
+#include "threepp/threepp.hpp"
+
+#include <cmath>
+
+using namespace threepp;
+
+int main() {
+
+    const int count = 1000;
+
+    Canvas canvas("BatchedMesh", {{"aa", 4}});
+    GLRenderer renderer(canvas.size());
+    renderer.setClearColor(Color::aliceblue);
+
+    auto scene = Scene::create();
+    auto camera = PerspectiveCamera::create(60, canvas.aspect(), 0.1f, 1000);
+    camera->position.set(0, 0, 30);
+
+    OrbitControls controls{*camera, canvas};
+
+    auto light = HemisphereLight::create(0xffffff, 0x888888);
+    light->position.set(0, 1, 0);
+    scene->add(light);
+
+    std::vector<std::shared_ptr<BufferGeometry>> geometries{
+            BoxGeometry::create(),
+            SphereGeometry::create(0.5f, 16, 8),
+            ConeGeometry::create(0.5f, 1),
+            TorusGeometry::create(0.4f, 0.1f)};
+
+    int vertexCount = 0;
+    int indexCount = 0;
+    for (const auto& g : geometries) {
+        vertexCount += g->getAttribute<float>("position")->count();
+        indexCount += g->getIndex()->count();
+    }
+
+    // every object gets its own copy of one of the geometries, all drawn with a single call
+    const auto copies = count / static_cast<int>(geometries.size());
+    auto mesh = BatchedMesh::create(count, vertexCount * copies, indexCount * copies, MeshPhongMaterial::create());
+
+    Matrix4 matrix;
+    Euler rotation;
+    for (int i = 0; i < count; i++) {
+
+        const auto id = mesh->addGeometry(*geometries[i % geometries.size()]);
+
+        rotation.set(math::randFloat(0, math::TWO_PI), math::randFloat(0, math::TWO_PI), 0);
+        matrix.makeRotationFromEuler(rotation);
+        matrix.setPosition(math::randFloatSpread(20), math::randFloatSpread(20), math::randFloatSpread(20));
+        mesh->setMatrixAt(id, matrix);
+    }
+    scene->add(mesh);
+
+    canvas.onWindowResize([&](WindowSize size) {
+        camera->aspect = size.aspect();
+        camera->updateProjectionMatrix();
+        renderer.setSize(size);
+    });
+
+    Clock clock;
+    canvas.animate([&]() {
+        const auto t = clock.getElapsedTime();
+
+        // blink a few of them to exercise the visibility ranges
+        for (int i = 0; i < count; i += 10) {
+            mesh->setVisibleAt(i, std::sin(t + static_cast<float>(i)) > 0);
+        }
+
+        renderer.render(*scene, *camera);
+    });
+}
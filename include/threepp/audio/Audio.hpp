@@ -24,6 +24,12 @@ namespace threepp {
 
         ~AudioListener() override;
 
+    protected:
+        [[nodiscard]] bool overridesMatrixWorldUpdate() const override {
+
+            return true;
+        }
+
     private:
         struct Impl;
         std::unique_ptr<Impl> pimpl_;
@@ -66,6 +72,12 @@ namespace threepp {
         PositionalAudio(AudioListener& ctx, const std::filesystem::path& file);
 
         void updateMatrixWorld(bool force) override;
+
+    protected:
+        [[nodiscard]] bool overridesMatrixWorldUpdate() const override {
+
+            return true;
+        }
     };
 
 }// namespace threepp
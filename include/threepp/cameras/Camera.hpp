@@ -50,6 +50,12 @@ namespace threepp {
         void updateWorldMatrix(std::optional<bool> updateParents, std::optional<bool> updateChildren) override;
 
         virtual void updateProjectionMatrix() {};
+
+    protected:
+        [[nodiscard]] bool overridesMatrixWorldUpdate() const override {
+
+            return true;
+        }
     };
 
 }// namespace threepp
@@ -11,6 +11,7 @@
 
 #include "threepp/constants.hpp"
 #include "threepp/core/misc.hpp"
+#include "threepp/extras/DataUtils.hpp"
 
 #include <memory>
 #include <vector>
@@ -23,8 +24,13 @@ namespace threepp {
     class BufferAttribute {
 
     public:
+        // single range to upload on the next update, a count of -1 means no range
         UpdateRange updateRange{0, -1};
 
+        // ranges to upload on the next update, in elements. Cleared once uploaded.
+        // If neither these nor updateRange are set, the whole attribute is uploaded.
+        std::vector<UpdateRange> updateRanges;
+
         unsigned int version = 0;
 
         [[nodiscard]] virtual int count() const = 0;
@@ -44,16 +50,39 @@ namespace threepp {
             return usage_;
         }
 
-        void needsUpdate() {
+        virtual void needsUpdate() {
 
             ++version;
         }
 
+        void addUpdateRange(int offset, int count) {
+
+            updateRanges.push_back({offset, count});
+        }
+
+        void clearUpdateRanges() {
+
+            updateRanges.clear();
+        }
+
         void setUsage(DrawUsage value) {
 
             this->usage_ = value;
         }
 
+        [[nodiscard]] bool streamed() const {
+
+            return streamed_;
+        }
+
+        // Opt in to streaming a Dynamic or Stream usage vertex attribute that is updated every frame:
+        // the GPU buffer holds three copies, so updates do not wait for draws still reading the previous data.
+        // Costs three times the GPU memory. Set before the attribute is first rendered.
+        void setStreamed(bool value) {
+
+            this->streamed_ = value;
+        }
+
         template<class T>
         TypedBufferAttribute<T>* typed() {
 
@@ -67,6 +96,7 @@ namespace threepp {
         bool normalized_{};
 
         DrawUsage usage_{DrawUsage::Static};
+        bool streamed_{};
 
         BufferAttribute() = default;
 
@@ -79,6 +109,7 @@ namespace threepp {
             this->normalized_ = source.normalized_;
 
             this->usage_ = source.usage_;
+            this->streamed_ = source.streamed_;
         }
 
         inline static Vector3 _vector{};
@@ -431,6 +462,12 @@ namespace threepp {
     typedef TypedBufferAttribute<unsigned int> IntBufferAttribute;
     typedef TypedBufferAttribute<float> FloatBufferAttribute;
 
+    typedef TypedBufferAttribute<int8_t> Int8BufferAttribute;
+    typedef TypedBufferAttribute<uint8_t> Uint8BufferAttribute;
+    typedef TypedBufferAttribute<int16_t> Int16BufferAttribute;
+    typedef TypedBufferAttribute<uint16_t> Uint16BufferAttribute;
+    typedef TypedBufferAttribute<Half> Float16BufferAttribute;
+
 
 }// namespace threepp
 
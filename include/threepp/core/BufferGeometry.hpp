@@ -15,6 +15,8 @@
 
 namespace threepp {
 
+    class TriangleBVH;
+
     class BufferGeometry: public EventDispatcher {
 
     public:
@@ -33,6 +35,10 @@ namespace threepp {
 
         DrawRange drawRange{0, std::numeric_limits<int>::max() / 2};
 
+        // When set, Mesh::raycast only tests the triangles found by a TriangleBVH over the positions.
+        // The hierarchy is built on first use, and rebuilt when the position attribute or the index change.
+        bool useBoundsTree = false;
+
         BufferGeometry();
 
         BufferGeometry(const BufferGeometry&) = delete;
@@ -118,6 +124,12 @@ namespace threepp {
 
         void computeBoundingSphere();
 
+        // The triangle hierarchy, built or rebuilt if it is missing or outdated.
+        // nullptr if the geometry has no float positions.
+        const TriangleBVH* boundsTree();
+
+        void disposeBoundsTree();
+
         void normalizeNormals();
 
         [[nodiscard]] std::shared_ptr<BufferGeometry> toNonIndexed() const;
@@ -140,6 +152,8 @@ namespace threepp {
         std::unordered_map<std::string, std::shared_ptr<BufferAttribute>> attributes_;
         std::unordered_map<std::string, std::vector<std::shared_ptr<BufferAttribute>>> morphAttributes_;
 
+        std::unique_ptr<TriangleBVH> boundsTree_;
+
         inline static unsigned int _id{0};
     };
 
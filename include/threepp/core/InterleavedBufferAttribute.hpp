@@ -21,6 +21,12 @@ namespace threepp {
         InterleavedBufferAttribute(std::shared_ptr<InterleavedBuffer> data, int itemSize, unsigned int offset, bool normalized)
             : data(std::move(data)), offset(offset), TypedBufferAttribute<float>({}, itemSize, normalized) {}
 
+        // the data is shared with the other attributes of the buffer, which is what gets uploaded
+        void needsUpdate() override {
+
+            data->needsUpdate();
+        }
+
         [[nodiscard]] std::vector<float>& array() override {
 
             return data->array();
@@ -116,6 +122,11 @@ namespace threepp {
 
             return *this;
         }
+
+        static std::unique_ptr<InterleavedBufferAttribute> create(std::shared_ptr<InterleavedBuffer> data, int itemSize, unsigned int offset, bool normalized = false) {
+
+            return std::make_unique<InterleavedBufferAttribute>(std::move(data), itemSize, offset, normalized);
+        }
     };
 
 }// namespace threepp
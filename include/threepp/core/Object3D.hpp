@@ -15,6 +15,7 @@
 #include "misc.hpp"
 
 #include <any>
+#include <array>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -25,7 +26,9 @@ namespace threepp {
     class Raycaster;
     struct Intersection;
     class Object3D;
+    class ObjectWithMaterials;
     class BufferGeometry;
+    class SpatialIndex;
 
     typedef std::function<void(void*, Object3D*, Camera*, BufferGeometry*, Material*, std::optional<GeometryGroup>)> RenderCallback;
 
@@ -34,6 +37,23 @@ namespace threepp {
     class Object3D: public EventDispatcher {
 
     public:
+        // Built-in object types, set by their constructors. Derived types carry the tags of their bases too.
+        enum class Tag: unsigned int {
+            Mesh = 1 << 0,
+            InstancedMesh = 1 << 1,
+            SkinnedMesh = 1 << 2,
+            Line = 1 << 3,
+            LineSegments = 1 << 4,
+            LineLoop = 1 << 5,
+            Points = 1 << 6,
+            Sprite = 1 << 7,
+            Light = 1 << 8,
+            Group = 1 << 9,
+            LOD = 1 << 10,
+            Scene = 1 << 11,
+            BatchedMesh = 1 << 12
+        };
+
         inline static Vector3 defaultUp{0, 1, 0};
         inline static bool defaultMatrixAutoUpdate{true};
 
@@ -78,6 +98,8 @@ namespace threepp {
 
         // When this is set, it calculates the matrix of position, (rotation or quaternion) and scale every frame and also recalculates the matrixWorld property.
         // Default is Object3D::defaultMatrixAutoUpdate (true).
+        // The matrix is only recalculated when position, quaternion or scale changed since, so unlike in three.js an edit of
+        // matrix itself is kept until then. Set matrixWorldNeedsUpdate after such an edit to have matrixWorld follow it.
         bool matrixAutoUpdate = defaultMatrixAutoUpdate;
         // When this is set, it calculates the matrixWorld in that frame and resets this property to false. Default is false.
         bool matrixWorldNeedsUpdate = false;
@@ -96,6 +118,9 @@ namespace threepp {
         // When this is set, it checks every frame if the object is in the frustum of the camera before rendering the object.
         // If set to false the object gets rendered every frame even if it is not in the frustum of the camera. Default is true.
         bool frustumCulled = true;
+        // When occlusion culling is enabled in the renderer, the object is skipped while its bounding box is hidden
+        // behind other objects. Set to false for objects that must never pop in late. Default is true.
+        bool occlusionCulled = true;
         // This value allows the default rendering order of scene graph objects to be overridden although opaque and transparent objects remain sorted independently.
         // When this property is set for an instance of Group, all descendants objects will be sorted and rendered together. Sorting is from lowest to highest renderOrder. Default value is 0.
         unsigned int renderOrder = 0;
@@ -227,8 +252,16 @@ namespace threepp {
         // Updates the local transform.
         void updateMatrix();
 
+        // Updates the global transform of the object and its descendants.
+        // When matrixAutoUpdate is set, the local transform is only recomposed if position, quaternion or scale changed since it was last composed.
         virtual void updateMatrixWorld(bool force = false);
 
+        // Breadth-first variant of updateMatrixWorld that processes one depth level at a time, spreading wide levels across
+        // numThreads threads (0 means std::thread::hardware_concurrency). Produces the same matrices as updateMatrixWorld.
+        // The threads are shared by all hierarchies, calls from several threads run one after the other.
+        // Subtrees rooted at objects that override updateMatrixWorld are delegated to that override on the calling thread.
+        void updateMatrixWorldParallel(bool force = false, unsigned int numThreads = 0);
+
         virtual void updateWorldMatrix(std::optional<bool> updateParents = std::nullopt, std::optional<bool> updateChildren = std::nullopt);
 
         static std::shared_ptr<Object3D> create() {
@@ -246,13 +279,16 @@ namespace threepp {
             return nullptr;
         }
 
+        // ObjectWithMaterials, looked up for every rendered object, is answered from a pointer registered by its
+        // constructor, everything else takes a dynamic_cast.
         template<class T>
         T* as() {
 
             static_assert(std::is_base_of<Object3D, typename std::remove_cv<typename std::remove_pointer<T>::type>::type>::value,
                           "T must be a base class of Object3D");
 
-            return dynamic_cast<T*>(this);
+            if constexpr (std::is_same_v<T, ObjectWithMaterials>) return withMaterials_;
+            else return dynamic_cast<T*>(this);
         }
 
         template<class T>
@@ -261,13 +297,20 @@ namespace threepp {
             static_assert(std::is_base_of<Object3D, typename std::remove_cv<typename std::remove_pointer<T>::type>::type>::value,
                           "T must be a base class of Object3D");
 
-            return dynamic_cast<const T*>(this);
+            if constexpr (std::is_same_v<T, ObjectWithMaterials>) return withMaterials_;
+            else return dynamic_cast<const T*>(this);
         }
 
         template<class T>
         [[nodiscard]] bool is() const {
 
-            return dynamic_cast<const T*>(this) != nullptr;
+            return as<T>() != nullptr;
+        }
+
+        // Cheap alternative to is<T>() for the built-in types, used by the renderer in per-object code paths.
+        [[nodiscard]] bool hasTag(Tag tag) const {
+
+            return (tags_ & static_cast<unsigned int>(tag)) != 0;
         }
 
         virtual void copy(const Object3D& source, bool recursive = true);
@@ -289,10 +332,43 @@ namespace threepp {
             return std::make_shared<Object3D>();
         }
 
+        // Subclasses overriding updateMatrixWorld must return true, so that updateMatrixWorldParallel calls their override.
+        [[nodiscard]] virtual bool overridesMatrixWorldUpdate() const {
+
+            return false;
+        }
+
+        void addTag(Tag tag) {
+
+            tags_ |= static_cast<unsigned int>(tag);
+        }
+
+        // Called by the ObjectWithMaterials constructor, a virtual base static_cast can not reach.
+        void registerType(ObjectWithMaterials* object) {
+
+            withMaterials_ = object;
+        }
+
     private:
         inline static unsigned int _object3Did{0};
 
+        unsigned int tags_{0};
+        ObjectWithMaterials* withMaterials_{nullptr};
+
         std::vector<std::shared_ptr<Object3D>> children_;
+
+        // position, quaternion and scale the local matrix was last composed from
+        std::array<float, 10> composedTransform_;
+
+        [[nodiscard]] bool transformChanged() const;
+
+        bool updateMatrixWorldSelf(bool force);
+
+        // slot in the spatial index that last added this object, validated by the index itself
+        const SpatialIndex* spatialIndex_ = nullptr;
+        int spatialProxy_ = -1;
+
+        friend class SpatialIndex;
     };
 
 }// namespace threepp
@@ -32,6 +32,14 @@ namespace threepp {
         std::optional<float> distanceToRay;
     };
 
+    // Raycasting only reads the objects, once the lazily computed state it relies on exists: geometry bounding spheres
+    // and bounds trees (BufferGeometry::useBoundsTree). Separate raycasters may then be used from several threads,
+    // as long as no thread modifies the objects.
+    // The batched intersectObjects computes this state once, before distributing the rays.
+    //
+    // A scene with a spatial index (Scene::spatialIndex) is raycast through the index as of its last update,
+    // which GLRenderer::render makes every frame. Objects moved since are found where they were then, call
+    // SpatialIndex::update to raycast a scene that has not been rendered since it changed.
     class Raycaster {
 
     public:
@@ -48,6 +56,10 @@ namespace threepp {
         };
         Params params;
 
+        // When set, each mesh reports only its closest intersection,
+        // which lets meshes with BufferGeometry::useBoundsTree stop searching early.
+        bool firstHitOnly = false;
+
         explicit Raycaster(const Vector3& origin = Vector3(), const Vector3& direction = Vector3(), float near = 0, float far = std::numeric_limits<float>::infinity())
             : near(near), far(far), ray(origin, direction), camera(nullptr) {}
 
@@ -58,6 +70,13 @@ namespace threepp {
         std::vector<Intersection> intersectObject(Object3D& object, bool recursive = false);
 
         std::vector<Intersection> intersectObjects(const std::vector<Object3D*>& objects, bool recursive = false);
+
+        // Intersects every ray with the objects, with the settings of this raycaster, distributing the rays over
+        // numThreads threads (0 selects the hardware concurrency). Element i of the result is what
+        // intersectObjects returns for rays[i]. The ray directions are assumed to be normalized.
+        std::vector<std::vector<Intersection>> intersectObjects(
+                const std::vector<Ray>& rays, const std::vector<Object3D*>& objects,
+                bool recursive = false, unsigned int numThreads = 0) const;
     };
 
 }// namespace threepp
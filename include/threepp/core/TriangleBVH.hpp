@@ -0,0 +1,127 @@
+
+#ifndef THREEPP_TRIANGLEBVH_HPP
+#define THREEPP_TRIANGLEBVH_HPP
+
+#include "threepp/core/BufferAttribute.hpp"
+#include "threepp/math/Box3.hpp"
+#include "threepp/math/Ray.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace threepp {
+
+    // Static bounding volume hierarchy over the triangles of a geometry, built top down with a binned
+    // surface area heuristic. Used by Mesh::raycast when BufferGeometry::useBoundsTree is set.
+    //
+    // Triangle t consists of the vertices index[3t], index[3t + 1] and index[3t + 2], or 3t, 3t + 1 and 3t + 2
+    // when the geometry is not indexed. That is, t is the faceIndex reported by Mesh::raycast.
+    class TriangleBVH {
+
+    public:
+        TriangleBVH(const FloatBufferAttribute& position, const IntBufferAttribute* index);
+
+        // Whether the hierarchy was built from these attributes, as they are now. For an interleaved position,
+        // that is the version of its InterleavedBuffer.
+        [[nodiscard]] bool upToDate(const FloatBufferAttribute& position, const IntBufferAttribute* index) const;
+
+        [[nodiscard]] size_t triangleCount() const;
+
+        [[nodiscard]] size_t nodeCount() const;
+
+        // Bounds of all triangles, empty if there are none.
+        [[nodiscard]] const Box3& boundingBox() const;
+
+        // Calls callback(triangle) for the triangles in the leaves hit by the ray before far, nearest leaves first.
+        // The callback returns the distance along the ray after which no more triangles are needed,
+        // which lets the traversal skip everything behind the closest hit found so far.
+        template<class Callback>
+        void raycast(const Ray& ray, float far, Callback&& callback) const {
+
+            if (triangles_.empty()) return;
+
+            const Vector3 invDir{1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z};
+
+            float tmin;
+            if (!intersectsRay(nodes_.front().box, ray.origin, invDir, far, tmin)) return;
+
+            // (node, distance to its box)
+            std::vector<std::pair<int, float>> stack{{0, tmin}};
+            while (!stack.empty()) {
+
+                const auto [id, distance] = stack.back();
+                stack.pop_back();
+
+                if (distance > far) continue;
+
+                const auto& node = nodes_[id];
+
+                if (node.count > 0) {
+
+                    for (auto i = node.offset; i < node.offset + node.count; ++i) {
+
+                        far = std::min(far, callback(triangles_[i]));
+                    }
+
+                    continue;
+                }
+
+                const auto left = id + 1;
+                const auto right = node.offset;
+
+                float tLeft, tRight;
+                const bool hitLeft = intersectsRay(nodes_[left].box, ray.origin, invDir, far, tLeft);
+                const bool hitRight = intersectsRay(nodes_[right].box, ray.origin, invDir, far, tRight);
+
+                // the nearer child is visited first
+                if (hitLeft && hitRight) {
+
+                    if (tLeft < tRight) {
+                        stack.emplace_back(right, tRight);
+                        stack.emplace_back(left, tLeft);
+                    } else {
+                        stack.emplace_back(left, tLeft);
+                        stack.emplace_back(right, tRight);
+                    }
+
+                } else if (hitLeft) {
+
+                    stack.emplace_back(left, tLeft);
+
+                } else if (hitRight) {
+
+                    stack.emplace_back(right, tRight);
+                }
+            }
+        }
+
+    private:
+        // leaf: triangles_[offset, offset + count), internal (count == 0): left child follows the node, right child at offset
+        struct Node {
+
+            Box3 box;
+            int offset = 0;
+            int count = 0;
+        };
+
+        std::vector<Node> nodes_;
+        std::vector<int> triangles_;
+
+        const BufferAttribute* position_;
+        // the interleaved buffer of an interleaved position, whose version is the one that changes
+        const BufferAttribute* positionData_;
+        unsigned int positionVersion_;
+        int positionCount_;
+        const BufferAttribute* index_;
+        unsigned int indexVersion_;
+        int indexCount_;
+
+        void build(int node, int begin, int end, const std::vector<float>& bounds);
+
+        static bool intersectsRay(const Box3& box, const Vector3& origin, const Vector3& invDir, float far, float& tmin);
+    };
+
+}// namespace threepp
+
+#endif//THREEPP_TRIANGLEBVH_HPP
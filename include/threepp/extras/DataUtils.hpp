@@ -0,0 +1,36 @@
+// https://github.com/mrdoob/three.js/blob/r150/src/extras/DataUtils.js
+
+#ifndef THREEPP_DATAUTILS_HPP
+#define THREEPP_DATAUTILS_HPP
+
+#include <cstdint>
+
+namespace threepp {
+
+    namespace datautils {
+
+        // float to IEEE 754 half precision bits, rounding to nearest even
+        uint16_t toHalfFloat(float value);
+
+        float fromHalfFloat(uint16_t value);
+
+    }// namespace datautils
+
+    // Half precision float, the element type of Float16BufferAttribute.
+    struct Half {
+
+        uint16_t bits{};
+
+        Half() = default;
+
+        Half(float value): bits(datautils::toHalfFloat(value)) {}
+
+        operator float() const {
+
+            return datautils::fromHalfFloat(bits);
+        }
+    };
+
+}// namespace threepp
+
+#endif//THREEPP_DATAUTILS_HPP
@@ -17,6 +17,11 @@ namespace threepp {
     protected:
         Box3Helper(const Box3& box, const Color& color);
 
+        [[nodiscard]] bool overridesMatrixWorldUpdate() const override {
+
+            return true;
+        }
+
     private:
         const Box3& box;
     };
@@ -22,6 +22,11 @@ namespace threepp {
     protected:
         PlaneHelper(const Plane& plane, float size, const Color& color);
 
+        [[nodiscard]] bool overridesMatrixWorldUpdate() const override {
+
+            return true;
+        }
+
     private:
         std::shared_ptr<Mesh> mesh_;
     };
@@ -23,6 +23,12 @@ namespace threepp {
             return std::make_shared<SkeletonHelper>(skeleton);
         }
 
+    protected:
+        [[nodiscard]] bool overridesMatrixWorldUpdate() const override {
+
+            return true;
+        }
+
     private:
         Object3D& root;
         std::vector<Bone*> bones;
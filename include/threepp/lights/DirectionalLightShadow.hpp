@@ -7,11 +7,47 @@
 
 #include "threepp/cameras/OrthographicCamera.hpp"
 
+#include <vector>
+
 namespace threepp {
 
+    // With more than one cascade, the view frustum is split along its depth into slices, and each slice gets its own
+    // orthographic shadow camera fitted around it, rendered into a cell of the shadow map (mapSize is the size of a cell).
+    // Close slices are small, so nearby shadows get most of the texels. The cascade cameras are snapped to whole texels
+    // to keep shadow edges from shimmering as the view moves, and the shader picks the finest cascade covering a fragment.
     class DirectionalLightShadow: public LightShadow {
 
     public:
+        // Where the cascades split the view range: 0 splits it uniformly, 1 logarithmically.
+        float cascadeSplitLambda = 0.5f;
+
+        // View distances at which the cascades but the last end, overrides cascadeSplitLambda when it holds cascades() - 1 values.
+        std::vector<float> cascadeSplits;
+
+        // Farthest view distance covered by the cascades, the far plane of the view camera when 0.
+        float cascadeFar = 0;
+
+        // How far beyond its slice, towards the light, casters are rendered into a cascade.
+        float cascadeCasterDistance = 500;
+
+        // Sets the number of cascades. With 1 (the default), the shadow camera is used as configured.
+        // Changing the count releases the shadow map, which is recreated with the new layout.
+        void setCascades(size_t count);
+
+        [[nodiscard]] size_t cascades() const;
+
+        // Fits the cascades to the view frustum of camera. Called by the renderer before the map is rendered.
+        void updateCascades(Light& light, const Camera& camera);
+
+        // Sets up the shadow camera and frustum of a cascade, as fitted by the last updateCascades.
+        void updateCascade(size_t index);
+
+        // View distance at which each cascade ends.
+        [[nodiscard]] const std::vector<float>& cascadeEnds() const;
+
+        // Per cascade, the transform from the shadow coordinates of the first cascade (matrix) to those of the cascade.
+        [[nodiscard]] const std::vector<Matrix4>& cascadeMatrices() const;
+
         static std::shared_ptr<DirectionalLightShadow> create() {
 
             return std::shared_ptr<DirectionalLightShadow>(new DirectionalLightShadow());
@@ -20,6 +56,17 @@ namespace threepp {
     protected:
         DirectionalLightShadow()
             : LightShadow(std::make_unique<OrthographicCamera>(-5.f, 5.f, 5.f, -5.f, 0.5f, 500.f)) {}
+
+    private:
+        struct Cascade {
+
+            Vector3 position;
+            float radius = 0;
+        };
+
+        std::vector<Cascade> cascades_{Cascade()};
+        std::vector<float> cascadeEnds_{0};
+        std::vector<Matrix4> cascadeMatrices_{Matrix4()};
     };
 
 }// namespace threepp
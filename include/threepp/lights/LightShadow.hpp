@@ -30,6 +30,13 @@ namespace threepp {
 
         Matrix4 matrix;
 
+        // Set by the renderer when it packs the maps into a shadow atlas (see GLShadowMap::atlasSize), zero otherwise:
+        // the region of the atlas holding the map, in texture coordinates (x, y, width, height), and the size a
+        // viewport got there, which is mapSize scaled down for lights that cover little of the screen.
+        // A zero region means the atlas had no room left for the light.
+        Vector4 atlasRect;
+        Vector2 atlasMapSize;
+
         bool autoUpdate = true;
         bool needsUpdate = false;
 
@@ -48,6 +55,9 @@ namespace threepp {
 
         Vector2& getFrameExtents();
 
+        // Size of a viewport of the map as rendered, mapSize unless the atlas scaled it down.
+        [[nodiscard]] const Vector2& getRenderedMapSize() const;
+
         void dispose();
 
         virtual ~LightShadow();
@@ -13,11 +13,37 @@
 
 namespace threepp {
 
+    struct MaterialWithEnvMap;
+    struct MaterialWithLights;
+    struct MaterialWithLineWidth;
+    struct MaterialWithMorphTargets;
+    struct MaterialWithWireframe;
+    class ShaderMaterial;
+
     typedef std::variant<bool, int, float, Vector2, Side, Blending, BlendFactor, BlendEquation, StencilFunc, StencilOp, CombineOperation, DepthFunc, NormalMapType, Color, std::string, std::shared_ptr<Texture>> MaterialValue;
 
     class Material: public EventDispatcher {
 
     public:
+        // Built-in material types, set by their constructors. RawShaderMaterial carries the Shader tag too.
+        enum class Tag: unsigned int {
+            MeshBasic = 1 << 0,
+            MeshLambert = 1 << 1,
+            MeshPhong = 1 << 2,
+            MeshStandard = 1 << 3,
+            MeshToon = 1 << 4,
+            MeshNormal = 1 << 5,
+            MeshMatcap = 1 << 6,
+            MeshDepth = 1 << 7,
+            MeshDistance = 1 << 8,
+            LineBasic = 1 << 9,
+            Points = 1 << 10,
+            Sprite = 1 << 11,
+            Shadow = 1 << 12,
+            Shader = 1 << 13,
+            RawShader = 1 << 14
+        };
+
         const unsigned int id = materialId++;
 
         std::string name;
@@ -93,19 +119,33 @@ namespace threepp {
 
         [[nodiscard]] virtual std::string type() const = 0;
 
+        // The types the renderer looks up on every draw are answered from pointers registered by their
+        // constructors, everything else takes a dynamic_cast.
         template<class T>
         T* as() {
 
             static_assert(std::is_base_of<T, typename std::remove_cv<typename std::remove_pointer<T>::type>::type>::value,
                           "T must be a base class of the current class");
 
-            return dynamic_cast<T*>(this);
+            if constexpr (std::is_same_v<T, MaterialWithEnvMap>) return registered_.envMap;
+            else if constexpr (std::is_same_v<T, MaterialWithLights>) return registered_.lights;
+            else if constexpr (std::is_same_v<T, MaterialWithLineWidth>) return registered_.lineWidth;
+            else if constexpr (std::is_same_v<T, MaterialWithMorphTargets>) return registered_.morphTargets;
+            else if constexpr (std::is_same_v<T, MaterialWithWireframe>) return registered_.wireframe;
+            else if constexpr (std::is_same_v<T, ShaderMaterial>) return registered_.shader;
+            else return dynamic_cast<T*>(this);
         }
 
         template<class T>
         [[nodiscard]] bool is() const {
 
-            return dynamic_cast<const T*>(this) != nullptr;
+            return const_cast<Material*>(this)->as<T>() != nullptr;
+        }
+
+        // Cheap alternative to type() string comparisons, used by the renderer when selecting programs.
+        [[nodiscard]] bool hasTag(Tag tag) const {
+
+            return (tags_ & static_cast<unsigned int>(tag)) != 0;
         }
 
         template<class T = Material>
@@ -147,7 +187,33 @@ namespace threepp {
 
         virtual bool setValue(const std::string& key, const MaterialValue& value);
 
+        void addTag(Tag tag) {
+
+            tags_ |= static_cast<unsigned int>(tag);
+        }
+
+        // Called by the constructors of the types as() answers without a dynamic_cast.
+        // They are virtual bases, so a static_cast from Material can not reach them.
+        void registerType(MaterialWithEnvMap* material) { registered_.envMap = material; }
+        void registerType(MaterialWithLights* material) { registered_.lights = material; }
+        void registerType(MaterialWithLineWidth* material) { registered_.lineWidth = material; }
+        void registerType(MaterialWithMorphTargets* material) { registered_.morphTargets = material; }
+        void registerType(MaterialWithWireframe* material) { registered_.wireframe = material; }
+        void registerType(ShaderMaterial* material) { registered_.shader = material; }
+
     private:
+        struct RegisteredTypes {
+
+            MaterialWithEnvMap* envMap = nullptr;
+            MaterialWithLights* lights = nullptr;
+            MaterialWithLineWidth* lineWidth = nullptr;
+            MaterialWithMorphTargets* morphTargets = nullptr;
+            MaterialWithWireframe* wireframe = nullptr;
+            ShaderMaterial* shader = nullptr;
+        };
+
+        unsigned int tags_ = 0;
+        RegisteredTypes registered_;
         bool disposed_ = false;
         std::string uuid_;
         unsigned int version_ = 0;
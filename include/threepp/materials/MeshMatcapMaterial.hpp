@@ -68,6 +68,8 @@ namespace threepp {
               MaterialWithDisplacementMap(1, 0),
               MaterialWithNormalMap(NormalMapType::TangentSpace, {1, 1}) {
 
+            addTag(Tag::MeshMatcap);
+
             this->defines["MATCAP"] = "";
         }
 
@@ -25,6 +25,8 @@ namespace threepp {
     protected:
         ShadowMaterial(): MaterialWithColor(0x000000) {
 
+            addTag(Tag::Shadow);
+
             this->transparent = true;
         }
 
@@ -33,7 +33,10 @@ namespace threepp {
 
         bool lights;
 
-        explicit MaterialWithLights(bool lights): lights(lights) {}
+        explicit MaterialWithLights(bool lights): lights(lights) {
+
+            registerType(this);
+        }
     };
 
     struct MaterialWithSize: virtual Material {
@@ -48,7 +51,10 @@ namespace threepp {
 
         float linewidth;
 
-        explicit MaterialWithLineWidth(float linewidth): linewidth(linewidth) {}
+        explicit MaterialWithLineWidth(float linewidth): linewidth(linewidth) {
+
+            registerType(this);
+        }
     };
 
     struct MaterialWithEmissive: virtual Material {
@@ -87,7 +93,10 @@ namespace threepp {
         bool wireframe;
         float wireframeLinewidth;
 
-        MaterialWithWireframe(bool wireframe, float wireframeLinewidth): wireframe(wireframe), wireframeLinewidth(wireframeLinewidth) {}
+        MaterialWithWireframe(bool wireframe, float wireframeLinewidth): wireframe(wireframe), wireframeLinewidth(wireframeLinewidth) {
+
+            registerType(this);
+        }
     };
 
     struct MaterialWithMap: virtual Material {
@@ -110,7 +119,10 @@ namespace threepp {
         float envMapIntensity;// Only used by MeshStandardMaterial
         std::shared_ptr<Texture> envMap;
 
-        explicit MaterialWithEnvMap(std::optional<float> envMapIntensity = std::nullopt): envMapIntensity(envMapIntensity.value_or(1)) {}
+        explicit MaterialWithEnvMap(std::optional<float> envMapIntensity = std::nullopt): envMapIntensity(envMapIntensity.value_or(1)) {
+
+            registerType(this);
+        }
     };
 
     struct MaterialWithGradientMap: virtual Material {
@@ -228,6 +240,11 @@ namespace threepp {
 
         bool morphTargets = false;
         bool morphNormals = false;
+
+        MaterialWithMorphTargets() {
+
+            registerType(this);
+        }
     };
 
 }// namespace threepp
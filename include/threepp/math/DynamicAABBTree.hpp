@@ -0,0 +1,223 @@
+
+#ifndef THREEPP_DYNAMICAABBTREE_HPP
+#define THREEPP_DYNAMICAABBTREE_HPP
+
+#include "threepp/math/Box3.hpp"
+#include "threepp/math/Frustum.hpp"
+#include "threepp/math/Ray.hpp"
+
+#include <vector>
+
+namespace threepp {
+
+    // Bounding volume hierarchy of axis aligned boxes that supports insertion, removal and movement of proxies.
+    // Proxies are stored with a fat box, enlarged by a fraction of their size, so that small movements do not
+    // change the tree. Insertion uses the surface area heuristic and the tree is kept balanced with rotations.
+    //
+    // Queries are const and do not allocate shared state, so they may run concurrently.
+    class DynamicAABBTree {
+
+    public:
+        static constexpr int nullNode = -1;
+
+        // Fat boxes are enlarged by margin times the largest dimension of the box on every side.
+        explicit DynamicAABBTree(float margin = 0.1f);
+
+        // Returns the id of the new proxy.
+        int insert(const Box3& box, void* userData = nullptr);
+
+        void remove(int proxy);
+
+        // Updates the box of a proxy. Returns true if the proxy was reinserted,
+        // which happens when the box leaves its fat box or the fat box has become much larger than needed.
+        bool move(int proxy, const Box3& box);
+
+        void clear();
+
+        [[nodiscard]] void* userData(int proxy) const;
+
+        [[nodiscard]] const Box3& fatBox(int proxy) const;
+
+        // Number of proxies.
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] bool empty() const;
+
+        // Height of the tree, 0 when it holds a single proxy.
+        [[nodiscard]] int height() const;
+
+        // Sum of the surface areas of the internal nodes divided by the surface area of the root. Lower is better.
+        [[nodiscard]] float areaRatio() const;
+
+        // Checks the structure of the tree, throws std::runtime_error if it is corrupt.
+        void validate() const;
+
+        // Calls callback(proxy) for every proxy whose fat box intersects the box.
+        template<class Callback>
+        void query(const Box3& box, Callback&& callback) const {
+
+            if (root_ == nullNode) return;
+
+            std::vector<int> stack{root_};
+            while (!stack.empty()) {
+
+                const auto id = stack.back();
+                const auto& node = nodes_[id];
+                stack.pop_back();
+
+                if (!node.box.intersectsBox(box)) continue;
+
+                if (node.isLeaf()) {
+
+                    callback(id);
+
+                } else {
+
+                    stack.emplace_back(node.child1);
+                    stack.emplace_back(node.child2);
+                }
+            }
+        }
+
+        // Calls callback(proxy, inside) for every proxy whose fat box intersects the frustum,
+        // where inside tells whether the fat box is entirely inside it.
+        // Subtrees entirely inside the frustum are reported without further plane tests.
+        template<class Callback>
+        void query(const Frustum& frustum, Callback&& callback) const {
+
+            if (root_ == nullNode) return;
+
+            std::vector<int> stack{root_};
+            while (!stack.empty()) {
+
+                const auto id = stack.back();
+                const auto& node = nodes_[id];
+                stack.pop_back();
+
+                const auto containment = classify(frustum, node.box);
+
+                if (containment == Containment::Outside) continue;
+
+                if (node.isLeaf()) {
+
+                    callback(id, containment == Containment::Inside);
+
+                } else if (containment == Containment::Inside) {
+
+                    reportAll(id, callback);
+
+                } else {
+
+                    stack.emplace_back(node.child1);
+                    stack.emplace_back(node.child2);
+                }
+            }
+        }
+
+        // Calls callback(proxy) for every proxy whose fat box, enlarged by threshold, is hit by the ray between near and far.
+        template<class Callback>
+        void raycast(const Ray& ray, float near, float far, float threshold, Callback&& callback) const {
+
+            if (root_ == nullNode) return;
+
+            const Vector3 invDir{1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z};
+
+            std::vector<int> stack{root_};
+            while (!stack.empty()) {
+
+                const auto id = stack.back();
+                const auto& node = nodes_[id];
+                stack.pop_back();
+
+                if (!intersectsRay(node.box, ray.origin, invDir, near, far, threshold)) continue;
+
+                if (node.isLeaf()) {
+
+                    callback(id);
+
+                } else {
+
+                    stack.emplace_back(node.child1);
+                    stack.emplace_back(node.child2);
+                }
+            }
+        }
+
+    private:
+        struct Node {
+
+            Box3 box;
+            void* userData = nullptr;
+
+            // parent, or next free node
+            int parent = nullNode;
+            int child1 = nullNode;
+            int child2 = nullNode;
+
+            // leaf = 0, free node = -1
+            int height = -1;
+
+            [[nodiscard]] bool isLeaf() const {
+
+                return child1 == nullNode;
+            }
+        };
+
+        enum class Containment {
+            Outside,
+            Intersecting,
+            Inside
+        };
+
+        float margin_;
+
+        std::vector<Node> nodes_;
+        int root_ = nullNode;
+        int freeList_ = nullNode;
+        size_t proxyCount_ = 0;
+
+        int allocateNode();
+
+        void freeNode(int id);
+
+        void insertLeaf(int leaf);
+
+        void removeLeaf(int leaf);
+
+        int balance(int id);
+
+        [[nodiscard]] Box3 fatten(const Box3& box) const;
+
+        // returns the height of the subtree
+        int validate(int id, int parent, size_t& leafCount) const;
+
+        template<class Callback>
+        void reportAll(int id, Callback& callback) const {
+
+            std::vector<int> stack{id};
+            while (!stack.empty()) {
+
+                const auto current = stack.back();
+                const auto& node = nodes_[current];
+                stack.pop_back();
+
+                if (node.isLeaf()) {
+
+                    callback(current, true);
+
+                } else {
+
+                    stack.emplace_back(node.child1);
+                    stack.emplace_back(node.child2);
+                }
+            }
+        }
+
+        static Containment classify(const Frustum& frustum, const Box3& box);
+
+        static bool intersectsRay(const Box3& box, const Vector3& origin, const Vector3& invDir, float near, float far, float threshold);
+    };
+
+}// namespace threepp
+
+#endif//THREEPP_DYNAMICAABBTREE_HPP
@@ -0,0 +1,103 @@
+// https://github.com/mrdoob/three.js/blob/r159/src/objects/BatchedMesh.js
+
+#ifndef THREEPP_BATCHEDMESH_HPP
+#define THREEPP_BATCHEDMESH_HPP
+
+#include "threepp/math/Box3.hpp"
+#include "threepp/math/Sphere.hpp"
+#include "threepp/objects/Mesh.hpp"
+#include "threepp/textures/DataTexture.hpp"
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace threepp {
+
+    // A special version of Mesh that draws many different geometries sharing one material in as few draw calls as possible.
+    // The geometries are packed into shared vertex and index buffers, and each one has its own transform and visibility.
+    class BatchedMesh: public Mesh {
+
+    public:
+        // Bounds of the visible geometries, as placed by their matrices. Reset when geometries, matrices or visibility change,
+        // and computed again when the mesh is frustum culled.
+        std::optional<Box3> boundingBox;
+        std::optional<Sphere> boundingSphere;
+
+        BatchedMesh(size_t maxGeometryCount, size_t maxVertexCount, size_t maxIndexCount, std::shared_ptr<Material> material);
+
+        [[nodiscard]] std::string type() const override;
+
+        [[nodiscard]] size_t maxGeometryCount() const;
+
+        // Number of geometries added, including deleted ones.
+        [[nodiscard]] size_t geometryCount() const;
+
+        // Copies the geometry into the shared buffers and returns its id.
+        // All geometries must have the same attributes and must either all be indexed or all be non-indexed.
+        // Throws, leaving the mesh unchanged, when the geometry does not match or does not fit.
+        size_t addGeometry(const BufferGeometry& geometry);
+
+        // Stops drawing the geometry. Its space in the shared buffers is not reclaimed.
+        void deleteGeometry(size_t id);
+
+        void setMatrixAt(size_t id, const Matrix4& matrix);
+
+        void getMatrixAt(size_t id, Matrix4& matrix) const;
+
+        void setVisibleAt(size_t id, bool visible);
+
+        [[nodiscard]] bool getVisibleAt(size_t id) const;
+
+        void computeBoundingBox();
+
+        void computeBoundingSphere();
+
+        // Float RGBA texture holding one matrix (4 texels) per geometry.
+        [[nodiscard]] DataTexture* matricesTexture() const;
+
+        // Ranges of the visible geometries in the shared index buffer, or vertex buffer if non-indexed.
+        void getDrawRanges(std::vector<int>& starts, std::vector<int>& counts) const;
+
+        void raycast(const Raycaster& raycaster, std::vector<Intersection>& intersects) override;
+
+        static std::shared_ptr<BatchedMesh> create(size_t maxGeometryCount, size_t maxVertexCount, size_t maxIndexCount, std::shared_ptr<Material> material);
+
+    private:
+        struct Range {
+
+            int vertexStart;
+            int vertexCount;
+            int indexStart;
+            int indexCount;
+            bool active = true;
+            bool visible = true;
+
+            // bounds of the geometry, before its matrix
+            Box3 box;
+            Sphere sphere;
+        };
+
+        size_t maxGeometryCount_;
+        size_t maxVertexCount_;
+        size_t maxIndexCount_;
+
+        bool initialized_ = false;
+        int nextVertexStart_ = 0;
+        int nextIndexStart_ = 0;
+
+        std::vector<Range> ranges_;
+        std::shared_ptr<DataTexture> matricesTexture_;
+
+        void validateGeometry(const BufferGeometry& geometry) const;
+
+        void initializeGeometry(const BufferGeometry& reference);
+
+        void resetBounds();
+
+        const Range& range(size_t id) const;
+    };
+
+}// namespace threepp
+
+#endif//THREEPP_BATCHEDMESH_HPP
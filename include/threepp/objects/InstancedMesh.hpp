@@ -5,16 +5,26 @@
 
 #include "Mesh.hpp"
 
+#include "threepp/math/DynamicAABBTree.hpp"
+#include "threepp/math/Frustum.hpp"
+
+#include <array>
 #include <memory>
 
 namespace threepp {
 
+    class Camera;
+
     class InstancedMesh: public Mesh {
 
     public:
         std::optional<Sphere> boundingSphere;
         std::optional<Box3> boundingBox;
 
+        // When set, the renderer tests every instance against the camera (or shadow camera) frustum before drawing,
+        // and draws only the visible instances, from visibleInstanceMatrix() and visibleInstanceColor().
+        bool perInstanceCulling = false;
+
         InstancedMesh(
                 std::shared_ptr<BufferGeometry> geometry,
                 std::shared_ptr<Material> material,
@@ -42,6 +52,39 @@ namespace threepp {
 
         void computeBoundingSphere();
 
+        // Tests the bounding sphere of every instance (the geometry bounding sphere, transformed by the instance
+        // and world matrices) against the frustum, and compacts the matrices and colors of the visible instances.
+        // Large counts are distributed over numThreads threads (0 selects the hardware concurrency).
+        // Returns the number of visible instances. Repeating the last call is free.
+        size_t cullInstances(const Frustum& frustum, unsigned int numThreads = 0);
+
+        // As above, for the frustum of a viewport of camera. Each camera and viewport has its own visible instances,
+        // so that views culled in turn (the view and the shadow maps, every frame) do not rebuild each other's.
+        // Repeating the last call for the view is free. Up to maxCullViews views are kept, the least recently
+        // culled one is reused after that.
+        size_t cullInstances(const Frustum& frustum, const Camera& camera, unsigned int viewport = 0, unsigned int numThreads = 0);
+
+        // Number of instances found visible by the last cullInstances.
+        [[nodiscard]] size_t visibleCount() const;
+
+        // Matrices of the instances found visible by the last cullInstances, in instance order.
+        // The array is resized to the visible instances, use visibleCount() rather than count() of the attribute.
+        [[nodiscard]] FloatBufferAttribute* visibleInstanceMatrix() const;
+
+        // Colors of the instances found visible by the last cullInstances, nullptr if the instances have no colors.
+        [[nodiscard]] FloatBufferAttribute* visibleInstanceColor() const;
+
+        // The visible matrices and colors of every view.
+        [[nodiscard]] std::vector<FloatBufferAttribute*> visibleInstanceAttributes() const;
+
+        static constexpr size_t maxCullViews = 8;
+
+        // Hierarchy of the instance bounding boxes (the geometry bounding box transformed by the instance matrix)
+        // in object space, used by raycast so that only instances whose box is hit by the ray are tested.
+        // Built on first use, refit when instanceMatrix changes version and rebuilt when count or the geometry
+        // bounding box changes. Call instanceMatrix()->needsUpdate() after setMatrixAt for raycasts to see the change.
+        const DynamicAABBTree& instanceBoundsTree();
+
         void dispose();
 
         void raycast(const Raycaster& raycaster, std::vector<Intersection>& intersects) override;
@@ -54,7 +97,6 @@ namespace threepp {
         ~InstancedMesh() override;
 
     private:
-        Mesh _mesh;
         bool disposed{false};
 
         size_t count_;
@@ -64,12 +106,53 @@ namespace threepp {
         std::unique_ptr<FloatBufferAttribute> instanceColor_ = nullptr;
 
         Matrix4 _instanceLocalMatrix;
-        Matrix4 _instanceWorldMatrix;
 
         Sphere _sphere;
         Box3 _box3;
 
-        std::vector<Intersection> _instanceIntersects;
+        // per instance center and radius in object space, and what they were computed from
+        std::vector<float> instanceSpheres_;
+        unsigned int instanceSpheresVersion_ = 0;
+        std::optional<Sphere> instanceSpheresSource_;
+
+        std::unique_ptr<DynamicAABBTree> instanceTree_;
+        std::vector<int> instanceProxies_;// by instance
+        std::vector<size_t> proxyInstances_;// by proxy
+        unsigned int instanceTreeVersion_ = 0;
+        std::optional<Box3> instanceTreeSource_;
+
+        // what the last cullInstances of a view depended on
+        struct CullInputs {
+
+            std::array<float, 24> planes{};
+            std::array<float, 16> matrixWorld{};
+            size_t count = 0;
+            unsigned int matrixVersion = 0;
+            bool colors = false;
+            unsigned int colorVersion = 0;
+
+            bool operator==(const CullInputs& other) const;
+        };
+
+        // the visible instances as seen from a viewport of a camera (none for the views culled without one)
+        struct CullView {
+
+            const Camera* camera = nullptr;
+            unsigned int viewport = 0;
+            size_t lastUse = 0;
+
+            std::optional<CullInputs> inputs;
+
+            std::unique_ptr<FloatBufferAttribute> matrices;
+            std::unique_ptr<FloatBufferAttribute> colors;
+            size_t visibleCount = 0;
+        };
+
+        std::vector<CullView> cullViews_;
+        size_t cullView_ = 0;// the one culled last
+        size_t cullUses_ = 0;
+
+        size_t cull(const Frustum& frustum, const Camera* camera, unsigned int viewport, unsigned int numThreads);
     };
 
 }// namespace threepp
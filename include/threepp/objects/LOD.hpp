@@ -25,6 +25,8 @@ namespace threepp {
     public:
         bool autoUpdate = true;
 
+        LOD();
+
         [[nodiscard]] std::string type() const override;
 
         LOD& addLevel(Object3D& object, float distance = 0);
@@ -42,6 +42,10 @@ namespace threepp {
     protected:
         std::shared_ptr<BufferGeometry> geometry_;
 
+        // Mesh::raycast with the given world matrix and draw range in place of the mesh's own,
+        // which lets InstancedMesh and BatchedMesh raycast each instance without modifying any state.
+        void raycastGeometry(const Raycaster& raycaster, const Matrix4& matrixWorld, const DrawRange& drawRange, std::vector<Intersection>& intersects);
+
         std::shared_ptr<Object3D> createDefault() override;
     };
 
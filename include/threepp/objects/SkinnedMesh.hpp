@@ -40,6 +40,12 @@ namespace threepp {
 
             return std::make_shared<SkinnedMesh>(geometry, material);
         }
+
+    protected:
+        [[nodiscard]] bool overridesMatrixWorldUpdate() const override {
+
+            return true;
+        }
     };
 
 }// namespace threepp
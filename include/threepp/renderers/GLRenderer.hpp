@@ -17,6 +17,7 @@
 #include "threepp/renderers/gl/GLShadowMap.hpp"
 #include "threepp/renderers/gl/GLState.hpp"
 
+#include <filesystem>
 #include <functional>
 #include <memory>
 #include <vector>
@@ -52,6 +53,22 @@ namespace threepp {
 
         bool sortObjects = true;
 
+        // Distributes frustum culling of the scene graph across worker threads.
+        // GL resources are still updated on the calling thread, and the resulting render lists are identical.
+        bool parallelProjection = false;
+        // Number of threads used when parallelProjection is enabled. 0 means std::thread::hardware_concurrency.
+        unsigned int projectionThreads = 0;
+
+        // Draws consecutive render items that share geometry, material and program as one instanced draw.
+        // Applies to plain meshes without morph targets, skinning or render callbacks.
+        bool autoInstancing = false;
+
+        // Skips meshes whose bounding box was hidden behind the opaque objects of an earlier frame, see Object3D::occlusionCulled.
+        // Results are read without waiting for the GPU, so an object coming into view can appear a frame late.
+        bool occlusionCulling = false;
+        // Frames between occlusion tests of visible objects. Hidden objects are tested every frame.
+        unsigned int occlusionTestInterval = 4;
+
         // user-defined clipping
 
         std::vector<Plane> clippingPlanes;
@@ -66,6 +83,12 @@ namespace threepp {
 
         bool physicallyCorrectLights = false;
 
+        // uniform buffers
+
+        // Shares camera, light and shadow uniforms between programs through std140 uniform blocks,
+        // so that they are uploaded once per frame instead of once per program switch.
+        bool uniformBuffers = false;
+
         // tone mapping
 
         ToneMapping toneMapping{ToneMapping::None};
@@ -73,6 +96,16 @@ namespace threepp {
 
         bool checkShaderErrors = false;
 
+        // profiling
+
+        // Measures the GPU time of each render call with timer queries, reported in info().timing.
+        // CPU timings are always collected.
+        bool gpuTiming = false;
+
+        // When set, linked program binaries are stored in this directory and reused by later runs,
+        // skipping shader compilation. Entries are invalidated by driver or shader source changes.
+        std::filesystem::path programCacheDirectory;
+
         explicit GLRenderer(WindowSize size, const Parameters& parameters = {});
 
         GLRenderer(GLRenderer&&) = delete;
@@ -28,8 +28,55 @@ namespace threepp::gl {
         size_t points{0};
         size_t lines{0};
 
+        // draws of the shadow pass, which as in three.js are not part of calls and triangles
+        size_t shadowCalls{0};
+
+        // buffer data uploaded this frame
+        size_t uploads{0};
+        size_t uploadedBytes{0};
+
+        // GLState activity this frame
+        size_t programSwitches{0};
+        size_t textureBinds{0};
+        // calls to GLState that matched the cached state, so no GL call was made
+        size_t stateChangesAvoided{0};
+
+        // occlusion culling this frame: boxes tested, and draws skipped as hidden
+        size_t occlusionQueries{0};
+        size_t occlusionCulled{0};
+
         friend std::ostream& operator<<(std::ostream& os, const RenderInfo& m) {
-            os << "RenderInfo: frame=" << m.frame << ", calls=" << m.calls << ", triangles=" << m.triangles << ", points=" << m.points << ", lines=" << m.lines;
+            os << "RenderInfo: frame=" << m.frame << ", calls=" << m.calls << ", triangles=" << m.triangles << ", points=" << m.points << ", lines=" << m.lines
+               << ", shadowCalls=" << m.shadowCalls << ", uploads=" << m.uploads << ", uploadedBytes=" << m.uploadedBytes
+               << ", programSwitches=" << m.programSwitches << ", textureBinds=" << m.textureBinds << ", stateChangesAvoided=" << m.stateChangesAvoided
+               << ", occlusionQueries=" << m.occlusionQueries << ", occlusionCulled=" << m.occlusionCulled;
+            return os;
+        }
+    };
+
+    // Durations of the last render call, in milliseconds.
+    struct TimingInfo {
+
+        // CPU
+        double update{0};
+        double projection{0};
+        double sort{0};
+        double shadows{0};
+        double opaque{0};
+        double transparent{0};
+
+        // GPU time of a recent render call, measured when GLRenderer::gpuTiming is enabled.
+        // Lags a few frames behind, and is negative until the first measurement is available.
+        double gpu{-1};
+
+        [[nodiscard]] double cpu() const {
+
+            return update + projection + sort + shadows + opaque + transparent;
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const TimingInfo& m) {
+            os << "TimingInfo: update=" << m.update << ", projection=" << m.projection << ", sort=" << m.sort << ", shadows=" << m.shadows
+               << ", opaque=" << m.opaque << ", transparent=" << m.transparent << ", gpu=" << m.gpu;
             return os;
         }
     };
@@ -38,18 +85,36 @@ namespace threepp::gl {
 
         MemoryInfo memory{};
         RenderInfo render{};
+        TimingInfo timing{};
 
         bool autoReset = true;
 
         void update(int count, unsigned int mode, size_t instanceCount);
 
+        // draws between these count as shadowCalls
+        void beginShadows();
+
+        void endShadows();
+
+        void updateUpload(size_t bytes);
+
+        void updateProgramSwitch();
+
+        void updateTextureBind();
+
+        void updateStateChangeAvoided();
+
         void reset();
 
         friend std::ostream& operator<<(std::ostream& os, const GLInfo& m) {
             os << m.memory << "\n"
-               << m.render;
+               << m.render << "\n"
+               << m.timing;
             return os;
         }
+
+    private:
+        bool shadows_{false};
     };
 
 }// namespace threepp::gl
@@ -14,6 +14,7 @@ namespace threepp {
     class Light;
     class Object3D;
     class Camera;
+    class Texture;
 
     namespace gl {
 
@@ -26,12 +27,28 @@ namespace threepp {
             bool autoUpdate = true;
             bool needsUpdate = false;
 
+            // When set, the map of a light is only rendered again when its shadow camera or one of the casters
+            // in its frustum changed: moved, appeared, disappeared, or had its geometry, materials or instances updated.
+            // Frames where nothing relevant changed cost a traversal of the scene, but no draws.
+            bool skipUnchanged = false;
+
+            // When above 0, the maps of all lights are regions of a single square atlas of this size (clamped to the
+            // largest texture size) instead of a render target each: one framebuffer for all shadows, and one sampler
+            // in the shaders. Point and spot lights covering little of the view get smaller regions, and the largest
+            // regions are halved while the atlas is short of room. Not used with ShadowMap::VSM, which blurs whole maps.
+            unsigned int atlasSize = 0;
+
             ShadowMap type;
 
             explicit GLShadowMap(GLObjects& objects);
 
             void render(GLRenderer& renderer, const std::vector<Light*>& lights, Object3D* scene, Camera* camera);
 
+            [[nodiscard]] bool usesAtlas() const;
+
+            // The atlas holding the maps, nullptr when not used.
+            [[nodiscard]] Texture* atlasTexture() const;
+
             ~GLShadowMap();
 
         private:
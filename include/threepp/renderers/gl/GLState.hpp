@@ -5,6 +5,7 @@
 
 #include "threepp/constants.hpp"
 #include "threepp/math/Vector4.hpp"
+#include "threepp/renderers/gl/GLInfo.hpp"
 
 #include <functional>
 #include <optional>
@@ -142,7 +143,10 @@ namespace threepp {
             Vector4 currentScissor;
             Vector4 currentViewport;
 
-            GLState();
+            // receives the program switches, texture binds and avoided state changes
+            GLInfo& info;
+
+            explicit GLState(GLInfo& info);
 
             void enable(int id);
 
@@ -183,6 +187,9 @@ namespace threepp {
 
             void unbindTexture();
 
+            // Forgets the bindings of a texture that is being deleted, as GL may reuse its name.
+            void invalidateTexture(int glTexture);
+
             void texImage2D(unsigned int target, int level, int internalFormat, int width, int height, unsigned int format, unsigned int type, const void* pixels);
 
             void texImage3D(unsigned int target, int level, int internalFormat, int width, int height, int depth, unsigned int format, unsigned int type, const void* pixels);
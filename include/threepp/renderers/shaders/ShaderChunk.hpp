@@ -3,6 +3,9 @@
 #ifndef THREEPP_SHADERCHUNK_HPP
 #define THREEPP_SHADERCHUNK_HPP
 
+#include "threepp/utils/StringUtils.hpp"
+
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 
@@ -544,6 +547,16 @@ namespace threepp::shaders {
             return data_.at(key);
         }
 
+        // Order independent hash of all chunk sources. Changes whenever any chunk is edited,
+        // and is otherwise stable across builds.
+        [[nodiscard]] uint64_t hash() const {
+            uint64_t h = 0;
+            for (const auto& [key, value] : data_) {
+                h += utils::fnv1a(key) ^ (utils::fnv1a(value) << 1);
+            }
+            return h;
+        }
+
         static ShaderChunk& instance() {
             static ShaderChunk instance;
             return instance;
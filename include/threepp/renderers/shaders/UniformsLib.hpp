@@ -80,6 +80,7 @@ namespace threepp::shaders {
                 {"directionalLightShadows", Uniform()},
                 {"directionalShadowMap", Uniform()},
                 {"directionalShadowMatrix", Uniform()},
+                {"directionalShadowCascadeMatrix", Uniform()},
                 {"spotLights", Uniform()},
                 {"spotLightShadows", Uniform()},
                 {"spotShadowMap", Uniform()},
@@ -88,6 +89,7 @@ namespace threepp::shaders {
                 {"pointLightShadows", Uniform()},
                 {"pointShadowMap", Uniform()},
                 {"pointShadowMatrix", Uniform()},
+                {"shadowAtlas", Uniform()},
                 {"hemisphereLights", Uniform()},
                 {"rectAreaLights", Uniform()},
                 {"ltc_1", Uniform()},
@@ -7,6 +7,7 @@
 
 #include "threepp/scenes/Fog.hpp"
 #include "threepp/scenes/FogExp2.hpp"
+#include "threepp/scenes/SpatialIndex.hpp"
 
 #include <memory>
 #include <variant>
@@ -53,6 +54,12 @@ namespace threepp {
 
         bool autoUpdate = true;
 
+        // When set, frustum culling, shadow caster culling and recursive raycasting of this scene
+        // query the index instead of testing every object.
+        std::shared_ptr<SpatialIndex> spatialIndex;
+
+        Scene();
+
         static std::shared_ptr<Scene> create();
     };
 
@@ -0,0 +1,104 @@
+
+#ifndef THREEPP_SPATIALINDEX_HPP
+#define THREEPP_SPATIALINDEX_HPP
+
+#include "threepp/math/DynamicAABBTree.hpp"
+#include "threepp/math/Matrix4.hpp"
+#include "threepp/math/Sphere.hpp"
+
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+namespace threepp {
+
+    class BufferGeometry;
+    class Object3D;
+
+    // Keeps the world bounds of the meshes, lines, points and sprites of a scene in a DynamicAABBTree.
+    // The index is synchronized by update(), which only touches the tree for objects whose world matrix
+    // or bounding sphere changed. Instanced and batched meshes are not indexed, as their bounds depend on
+    // per instance data.
+    //
+    // Assign one to Scene::spatialIndex to have the renderer and Raycaster use it. The renderer updates the index
+    // once per frame, Raycaster only reads it.
+    // An object is tracked by the index that updated it last, so scenes sharing objects should not all have one.
+    //
+    // update() and query() take the index exclusively and raycast() shares it, so raycasts may run on several
+    // threads while one of them updates the index.
+    class SpatialIndex {
+
+    public:
+        enum class FrustumResult {
+            NotIndexed,
+            Outside,
+            Intersecting,
+            Inside
+        };
+
+        explicit SpatialIndex(float margin = 0.1f);
+
+        // Synchronizes the index with the objects below root, including root itself.
+        void update(Object3D& root);
+
+        // Classifies the indexed objects against the frustum, see frustumResult.
+        void query(const Frustum& frustum);
+
+        // Result of the last frustum query for the object.
+        // Outside and Inside are exact for the bounding sphere of the object, Intersecting needs an exact test.
+        [[nodiscard]] FrustumResult frustumResult(const Object3D& object) const;
+
+        // Same as Frustum::intersectsObject (or intersectsSprite), answered by the last query when possible.
+        bool intersectsFrustum(const Frustum& frustum, Object3D& object) const;
+
+        // Appends the objects a raycast of the scene has to test: the indexed meshes, lines and points whose bounds,
+        // enlarged by threshold, are hit by the ray, followed by the uncovered objects.
+        void raycast(const Ray& ray, float near, float far, float threshold, std::vector<Object3D*>& result) const;
+
+        // Objects below the root that raycast() never reports, as of the last update. That is everything but
+        // indexed meshes, lines and points: sprites (their raycast shape depends on the camera), groups, lights etc.
+        // Not synchronized with update().
+        [[nodiscard]] const std::vector<Object3D*>& uncovered() const;
+
+        [[nodiscard]] bool contains(const Object3D& object) const;
+
+        // Number of indexed objects.
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] const DynamicAABBTree& tree() const;
+
+        static std::shared_ptr<SpatialIndex> create(float margin = 0.1f);
+
+    private:
+        struct Entry {
+
+            Object3D* object = nullptr;
+            const BufferGeometry* geometry = nullptr;
+            bool sprite = false;
+
+            // bounds the world box was last computed from
+            Sphere sphere{Vector3(), -1};
+            Matrix4 matrixWorld;
+
+            unsigned int updateStamp = 0;
+            unsigned int queryStamp = 0;
+            bool inside = false;
+        };
+
+        DynamicAABBTree tree_;
+        std::vector<Entry> entries_;// by proxy
+        std::vector<Object3D*> uncovered_;
+
+        unsigned int updateStamp_ = 0;
+        unsigned int queryStamp_ = 0;
+
+        mutable std::shared_mutex mutex_;
+
+        void updateObject(Object3D& object);
+
+        [[nodiscard]] int proxyOf(const Object3D& object) const;
+    };
+
+}// namespace threepp
+
+#endif//THREEPP_SPATIALINDEX_HPP
@@ -29,6 +29,7 @@
 
 #include "threepp/objects/Group.hpp"
 #include "threepp/objects/HUD.hpp"
+#include "threepp/objects/BatchedMesh.hpp"
 #include "threepp/objects/InstancedMesh.hpp"
 #include "threepp/objects/Mesh.hpp"
 #include "threepp/objects/Points.hpp"
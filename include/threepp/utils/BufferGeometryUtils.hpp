@@ -4,15 +4,68 @@
 #define THREEPP_BUFFERGEOMETRYUTILS_HPP
 
 #include "threepp/core/BufferGeometry.hpp"
+#include "threepp/core/InterleavedBufferAttribute.hpp"
+#include "threepp/math/Matrix4.hpp"
 
 #include <vector>
 
 namespace threepp {
 
+    class Mesh;
+
     std::shared_ptr<BufferGeometry> mergeBufferGeometries(const std::vector<BufferGeometry*>& geometries, bool useGroups = false);
 
     std::shared_ptr<BufferGeometry> mergeBufferGeometries(const std::vector<std::shared_ptr<BufferGeometry>>& geometries, bool useGroups = false);
 
+    // Packs the attributes, which must have the same count, into one interleaved buffer.
+    // The returned attributes are in the same order as the given ones.
+    std::vector<std::unique_ptr<InterleavedBufferAttribute>> interleaveAttributes(const std::vector<const FloatBufferAttribute*>& attributes);
+
+    // Replaces the float attributes of the geometry by views into one interleaved buffer, so that
+    // all data of a vertex is fetched together. Other attributes, and morph attributes, are kept as they are.
+    // Meant to be called before the geometry is first rendered.
+    // Returns the buffer, or nullptr if the geometry has less than two attributes to interleave.
+    std::shared_ptr<InterleavedBuffer> interleave(BufferGeometry& geometry);
+
+    struct QuantizeOptions {
+
+        // bits per position component, 8 or 16
+        int positionBits = 16;
+        // bits per octahedral normal component, 8 or 16. 0 keeps float normals
+        int normalBits = 8;
+        // uv and uv2 become 16-bit when all coordinates lie in [0, 1]
+        bool uvs = true;
+        // colors become 8-bit when all components lie in [0, 1]
+        bool colors = true;
+    };
+
+    struct QuantizeResult {
+
+        // maps the quantized positions, in [0, 1], back to the original ones
+        Matrix4 decodeMatrix;
+
+        // largest error of each quantized attribute. Positions in geometry units, normals in radians
+        float positionError{};
+        float normalError{};
+        float uvError{};
+        float colorError{};
+
+        // size of the quantized attributes before and after
+        size_t bytesBefore{};
+        size_t bytesAfter{};
+    };
+
+    // Quantizes the float position, normal, uv, uv2 and color attributes of the geometry in place.
+    // Positions become unsigned normalized integers to be decoded with decodeMatrix, which must be part of
+    // the transform of every object using the geometry (see quantizeMesh).
+    // Normals become two octahedral components, prepared for decodeMatrix.
+    // Morph targets and skinning are not supported. The geometry can not be raycast afterwards.
+    QuantizeResult quantizeGeometry(BufferGeometry& geometry, const QuantizeOptions& options = {});
+
+    // Quantizes the geometry of the mesh and folds the decode matrix into the mesh position and scale.
+    // The mesh must not have children, as they would inherit the decode scale.
+    QuantizeResult quantizeMesh(Mesh& mesh, const QuantizeOptions& options = {});
+
 
 }// namespace threepp
 
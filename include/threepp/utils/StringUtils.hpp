@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -109,6 +110,17 @@ namespace threepp::utils {
         return std::equal(ending.rbegin(), ending.rend(), value.rbegin());
     }
 
+    // 64-bit FNV-1a. Unlike std::hash, the result is the same across runs, builds and standard libraries.
+    inline uint64_t fnv1a(const std::string& s) {
+
+        uint64_t hash = 14695981039346656037ull;
+        for (const auto c : s) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
     int parseInt(const std::string& str);
 
     float parseFloat(const std::string& str);
@@ -1,10 +1,13 @@
 
 #include "threepp/core/BufferGeometry.hpp"
 
+#include "threepp/core/InterleavedBufferAttribute.hpp"
+#include "threepp/core/TriangleBVH.hpp"
 #include "threepp/math/MathUtils.hpp"
 #include "threepp/math/Matrix3.hpp"
 #include "threepp/math/Matrix4.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <utility>
@@ -13,36 +16,104 @@ using namespace threepp;
 
 namespace {
 
-    std::unique_ptr<BufferAttribute> convertBufferAttribute(BufferAttribute& _attribute, const std::vector<unsigned int>& indices) {
+    constexpr auto unsupportedType = "THREE.BufferGeometry: Unsupported buffer attribute type, "
+                                     "expected float, unsigned int, Half, uint16_t, int16_t, uint8_t or int8_t.";
 
-        if (_attribute.typed<float>()) {
+    template<class T>
+    std::unique_ptr<BufferAttribute> convertTypedBufferAttribute(const TypedBufferAttribute<T>& attribute, const std::vector<unsigned int>& indices) {
 
-            auto attribute = _attribute.typed<float>();
+        const auto& array = attribute.array();
+        const auto itemSize = attribute.itemSize();
+        const auto normalized = attribute.normalized();
 
-            const auto& array = attribute->array();
-            const auto itemSize = attribute->itemSize();
-            const auto normalized = attribute->normalized();
+        auto array2 = std::vector<T>(indices.size() * itemSize);
 
-            auto array2 = std::vector<float>(indices.size() * itemSize);
+        unsigned index = 0, index2 = 0;
 
-            unsigned index = 0, index2 = 0;
+        for (unsigned i = 0, l = indices.size(); i < l; i++) {
 
-            for (unsigned i = 0, l = indices.size(); i < l; i++) {
+            index = indices[i] * itemSize;
 
-                index = indices[i] * itemSize;
+            for (unsigned j = 0; j < itemSize; j++) {
 
-                for (unsigned j = 0; j < itemSize; j++) {
-
-                    array2[index2++] = array[index++];
-                }
+                array2[index2++] = array[index++];
             }
+        }
+
+        return TypedBufferAttribute<T>::create(array2, itemSize, normalized);
+    }
+
+    template<class T, class... Rest>
+    std::unique_ptr<BufferAttribute> convertAs(BufferAttribute& attribute, const std::vector<unsigned int>& indices) {
+
+        if (auto typed = attribute.typed<T>()) {
+
+            return convertTypedBufferAttribute(*typed, indices);
+        }
+
+        if constexpr (sizeof...(Rest) > 0) {
+
+            return convertAs<Rest...>(attribute, indices);
+
+        } else {
+
+            throw std::runtime_error(unsupportedType);
+        }
+    }
+
+    template<class T, class... Rest>
+    std::unique_ptr<BufferAttribute> cloneAs(BufferAttribute& attribute) {
+
+        if (auto typed = attribute.typed<T>()) {
+
+            return typed->clone();
+        }
+
+        if constexpr (sizeof...(Rest) > 0) {
 
-            return FloatBufferAttribute::create(array2, itemSize, normalized);
+            return cloneAs<Rest...>(attribute);
 
         } else {
 
-            throw std::runtime_error("Unsupported operation");
+            throw std::runtime_error(unsupportedType);
+        }
+    }
+
+    // tightly packed copy of an interleaved attribute
+    std::unique_ptr<FloatBufferAttribute> deinterleave(const InterleavedBufferAttribute& attribute) {
+
+        const auto itemSize = attribute.itemSize();
+        const auto stride = attribute.data->stride();
+        const auto& data = attribute.data->array();
+
+        std::vector<float> array(attribute.count() * itemSize);
+        for (size_t i = 0, l = attribute.count(); i < l; i++) {
+
+            std::copy_n(data.begin() + i * stride + attribute.offset, itemSize, array.begin() + i * itemSize);
+        }
+
+        return FloatBufferAttribute::create(array, itemSize, attribute.normalized());
+    }
+
+    std::unique_ptr<BufferAttribute> convertBufferAttribute(BufferAttribute& attribute, const std::vector<unsigned int>& indices) {
+
+        if (auto interleaved = dynamic_cast<InterleavedBufferAttribute*>(&attribute)) {
+
+            return convertTypedBufferAttribute(*deinterleave(*interleaved), indices);
+        }
+
+        return convertAs<float, unsigned int, Half, uint16_t, int16_t, uint8_t, int8_t>(attribute, indices);
+    }
+
+    std::unique_ptr<BufferAttribute> cloneBufferAttribute(BufferAttribute& attribute) {
+
+        // the clone does not share the buffer with the other attributes, so it gets its own packed array
+        if (auto interleaved = dynamic_cast<InterleavedBufferAttribute*>(&attribute)) {
+
+            return deinterleave(*interleaved);
         }
+
+        return cloneAs<float, unsigned int, Half, uint16_t, int16_t, uint8_t, int8_t>(attribute);
     }
 
 }// namespace
@@ -484,13 +555,7 @@ void BufferGeometry::copy(const BufferGeometry& source) {
 
     for (const auto& [name, attribute] : attributes) {
 
-        if (attribute->typed<unsigned int>()) {
-            this->setAttribute(name, attribute->typed<unsigned int>()->clone());
-        } else if (attribute->typed<float>()) {
-            this->setAttribute(name, attribute->typed<float>()->clone());
-        } else {
-            throw std::runtime_error("TODO");
-        }
+        this->setAttribute(name, cloneBufferAttribute(*attribute));
     }
 
 
@@ -523,6 +588,10 @@ void BufferGeometry::copy(const BufferGeometry& source) {
 
     this->drawRange.start = source.drawRange.start;
     this->drawRange.count = source.drawRange.count;
+
+    // the hierarchy itself is rebuilt on demand
+    this->useBoundsTree = source.useBoundsTree;
+    this->boundsTree_ = nullptr;
 }
 
 std::shared_ptr<BufferGeometry> BufferGeometry::toNonIndexed() const {
@@ -673,8 +742,31 @@ std::shared_ptr<BufferGeometry> BufferGeometry::clone() const {
     return g;
 }
 
+const TriangleBVH* BufferGeometry::boundsTree() {
+
+    const auto position = getAttribute<float>("position");
+
+    if (!position) {
+
+        boundsTree_ = nullptr;
+
+    } else if (!boundsTree_ || !boundsTree_->upToDate(*position, index_.get())) {
+
+        boundsTree_ = std::make_unique<TriangleBVH>(*position, index_.get());
+    }
+
+    return boundsTree_.get();
+}
+
+void BufferGeometry::disposeBoundsTree() {
+
+    boundsTree_ = nullptr;
+}
+
 void BufferGeometry::dispose() {
 
+    boundsTree_ = nullptr;
+
     if (!disposed_) {
         disposed_ = true;
         this->dispatchEvent("dispose", this);
@@ -10,13 +10,48 @@
 
 #include "threepp/lights/Light.hpp"
 
+#include "threepp/utils/ThreadPool.hpp"
+
+#include <limits>
+#include <mutex>
+
 using namespace threepp;
 
+namespace {
+
+    // levels narrower than this are not worth distributing
+    constexpr size_t minParallelLevelSize = 256;
+
+    struct MatrixWorldNode {
+        Object3D* object;
+        bool force;
+    };
+
+    std::mutex poolMutex;
+
+    // shared by all hierarchies, callers hold poolMutex as the pool runs one job at a time and is replaced
+    // when a caller asks for another number of threads
+    utils::ThreadPool& matrixWorldPool(size_t numThreads) {
+
+        static std::unique_ptr<utils::ThreadPool> pool;
+
+        if (!pool || pool->size() != numThreads) {
+
+            pool = std::make_unique<utils::ThreadPool>(numThreads);
+        }
+
+        return *pool;
+    }
+
+}// namespace
+
 Object3D::Object3D()
     : uuid(math::generateUUID()),
       matrix(std::make_shared<Matrix4>()),
       matrixWorld(std::make_shared<Matrix4>()) {
 
+    composedTransform_.fill(std::numeric_limits<float>::quiet_NaN());
+
     rotation._onChange([this] {
         quaternion.setFromEuler(rotation, false);
     });
@@ -337,12 +372,24 @@ void Object3D::updateMatrix() {
 
     this->matrix->compose(this->position, this->quaternion, this->scale);
 
+    composedTransform_ = {position.x, position.y, position.z,
+                          quaternion.x, quaternion.y, quaternion.z, quaternion.w,
+                          scale.x, scale.y, scale.z};
+
     this->matrixWorldNeedsUpdate = true;
 }
 
-void Object3D::updateMatrixWorld(bool force) {
+bool Object3D::transformChanged() const {
 
-    if (this->matrixAutoUpdate) this->updateMatrix();
+    // NaN never compares equal, so objects that were never composed always report a change
+    return composedTransform_[0] != position.x || composedTransform_[1] != position.y || composedTransform_[2] != position.z ||
+           composedTransform_[3] != quaternion.x || composedTransform_[4] != quaternion.y || composedTransform_[5] != quaternion.z || composedTransform_[6] != quaternion.w ||
+           composedTransform_[7] != scale.x || composedTransform_[8] != scale.y || composedTransform_[9] != scale.z;
+}
+
+bool Object3D::updateMatrixWorldSelf(bool force) {
+
+    if (this->matrixAutoUpdate && transformChanged()) this->updateMatrix();
 
     if (this->matrixWorldNeedsUpdate || force) {
 
@@ -360,6 +407,13 @@ void Object3D::updateMatrixWorld(bool force) {
         force = true;
     }
 
+    return force;
+}
+
+void Object3D::updateMatrixWorld(bool force) {
+
+    force = updateMatrixWorldSelf(force);
+
     // update children
 
     for (auto& child : this->children) {
@@ -368,6 +422,92 @@ void Object3D::updateMatrixWorld(bool force) {
     }
 }
 
+void Object3D::updateMatrixWorldParallel(bool force, unsigned int numThreads) {
+
+    if (overridesMatrixWorldUpdate()) {
+
+        updateMatrixWorld(force);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lck(poolMutex);
+    auto& pool = matrixWorldPool(numThreads == 0 ? utils::ThreadPool::defaultNumThreads() : numThreads);
+    const auto numChunks = pool.size() * 4;
+
+    std::vector<MatrixWorldNode> level;
+    std::vector<MatrixWorldNode> nextLevel;
+    std::vector<std::vector<MatrixWorldNode>> chunkLevels(numChunks);
+    std::vector<std::vector<MatrixWorldNode>> chunkDelegates(numChunks);
+
+    const auto process = [](const MatrixWorldNode& node, std::vector<MatrixWorldNode>& next, std::vector<MatrixWorldNode>& delegates) {
+        if (node.object->overridesMatrixWorldUpdate()) {
+
+            delegates.emplace_back(node);
+            return;
+        }
+
+        const auto force = node.object->updateMatrixWorldSelf(node.force);
+
+        for (auto& child : node.object->children) {
+
+            next.push_back({child, force});
+        }
+    };
+
+    level.push_back({this, force});
+
+    while (!level.empty()) {
+
+        nextLevel.clear();
+
+        if (level.size() < minParallelLevelSize || pool.size() == 1) {
+
+            auto& delegates = chunkDelegates.front();
+            delegates.clear();
+
+            for (const auto& node : level) {
+
+                process(node, nextLevel, delegates);
+            }
+
+            for (const auto& node : delegates) {
+
+                node.object->updateMatrixWorld(node.force);
+            }
+
+        } else {
+
+            const auto chunkSize = (level.size() + numChunks - 1) / numChunks;
+
+            pool.parallelFor(numChunks, [&](size_t chunk) {
+                auto& next = chunkLevels[chunk];
+                auto& delegates = chunkDelegates[chunk];
+                next.clear();
+                delegates.clear();
+
+                const auto end = std::min(level.size(), (chunk + 1) * chunkSize);
+                for (auto i = chunk * chunkSize; i < end; ++i) {
+
+                    process(level[i], next, delegates);
+                }
+            });
+
+            for (size_t chunk = 0; chunk < numChunks; ++chunk) {
+
+                nextLevel.insert(nextLevel.end(), chunkLevels[chunk].begin(), chunkLevels[chunk].end());
+
+                // overriding objects may touch state outside their subtree, so they are updated on this thread
+                for (const auto& node : chunkDelegates[chunk]) {
+
+                    node.object->updateMatrixWorld(node.force);
+                }
+            }
+        }
+
+        std::swap(level, nextLevel);
+    }
+}
+
 void Object3D::updateWorldMatrix(std::optional<bool> updateParents, std::optional<bool> updateChildren) {
 
     if (updateParents && updateParents.value() && parent) {
@@ -421,6 +561,7 @@ void Object3D::copy(const Object3D& source, bool recursive) {
     this->receiveShadow = source.receiveShadow;
 
     this->frustumCulled = source.frustumCulled;
+    this->occlusionCulled = source.occlusionCulled;
     this->renderOrder = source.renderOrder;
 
     if (recursive) {
@@ -462,6 +603,7 @@ Object3D::Object3D(Object3D&& source) noexcept: Object3D() {
     this->receiveShadow = source.receiveShadow;
 
     this->frustumCulled = source.frustumCulled;
+    this->occlusionCulled = source.occlusionCulled;
     this->renderOrder = source.renderOrder;
 
     this->onAfterRender = std::move(onAfterRender);
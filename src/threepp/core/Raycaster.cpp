@@ -3,20 +3,29 @@
 
 #include "threepp/cameras/OrthographicCamera.hpp"
 #include "threepp/cameras/PerspectiveCamera.hpp"
+#include "threepp/core/BufferGeometry.hpp"
+#include "threepp/objects/InstancedMesh.hpp"
+#include "threepp/scenes/Scene.hpp"
+
+#include "threepp/utils/ThreadPool.hpp"
 
 #include <algorithm>
 #include <iostream>
+#include <mutex>
 
 using namespace threepp;
 
 namespace {
 
+    // rays handed to a thread at a time, a single ray through a bounds tree is too little work to distribute
+    constexpr size_t raysPerChunk = 16;
+
     bool ascSort(const Intersection& a, const Intersection& b) {
 
         return a.distance < b.distance;
     }
 
-    void intersectObject(Object3D& object, Raycaster& raycaster, std::vector<Intersection>& intersects, bool recursive) {
+    void intersectObject(Object3D& object, const Raycaster& raycaster, std::vector<Intersection>& intersects, bool recursive) {
 
         if (object.layers.test(raycaster.layers)) {
 
@@ -34,6 +43,83 @@ namespace {
         }
     }
 
+    SpatialIndex* spatialIndexOf(Object3D& object, bool recursive) {
+
+        if (!recursive || !object.hasTag(Object3D::Tag::Scene)) return nullptr;
+
+        return static_cast<Scene&>(object).spatialIndex.get();
+    }
+
+    // raycasts a scene through its spatial index, as of its last update, which only raycasts the objects whose bounds are hit.
+    // Returns false if the object is not a scene with an index.
+    bool intersectSpatialIndex(Object3D& object, const Raycaster& raycaster, std::vector<Intersection>& intersects, bool recursive) {
+
+        const auto index = spatialIndexOf(object, recursive);
+        if (!index) return false;
+
+        std::vector<Object3D*> candidates;
+        const auto threshold = std::max(raycaster.params.lineThreshold, raycaster.params.pointsThreshold);
+        index->raycast(raycaster.ray, raycaster.near, raycaster.far, threshold, candidates);
+
+        for (const auto candidate : candidates) {
+
+            if (candidate->layers.test(raycaster.layers)) {
+
+                candidate->raycast(raycaster, intersects);
+            }
+        }
+
+        return true;
+    }
+
+    void intersectObjects(const std::vector<Object3D*>& objects, const Raycaster& raycaster, std::vector<Intersection>& intersects, bool recursive) {
+
+        for (const auto object : objects) {
+
+            if (!intersectSpatialIndex(*object, raycaster, intersects, recursive)) {
+
+                intersectObject(*object, raycaster, intersects, recursive);
+            }
+        }
+
+        std::stable_sort(intersects.begin(), intersects.end(), &ascSort);
+    }
+
+    // computes the state raycasting would otherwise compute on first use, so that raycasts only read the objects
+    void prepareObject(Object3D& object) {
+
+        if (!object.hasTag(Object3D::Tag::Mesh) && !object.hasTag(Object3D::Tag::Line) && !object.hasTag(Object3D::Tag::Points)) return;
+
+        const auto geometry = object.geometry();
+        if (!geometry) return;
+
+        if (!geometry->boundingSphere) geometry->computeBoundingSphere();
+
+        // the condition under which Mesh::raycast uses the hierarchy
+        if (object.hasTag(Object3D::Tag::Mesh) && geometry->useBoundsTree &&
+            !geometry->getMorphAttribute("position") && !object.hasTag(Object3D::Tag::SkinnedMesh)) {
+
+            geometry->boundsTree();
+        }
+
+        if (auto instanced = object.as<InstancedMesh>()) instanced->instanceBoundsTree();
+    }
+
+    std::mutex poolMutex;
+
+    // shared by all raycasters, callers hold poolMutex as the pool runs one job at a time
+    utils::ThreadPool& raycastPool(size_t numThreads) {
+
+        static std::unique_ptr<utils::ThreadPool> pool;
+
+        if (!pool || pool->size() != numThreads) {
+
+            pool = std::make_unique<utils::ThreadPool>(numThreads);
+        }
+
+        return *pool;
+    }
+
 }// namespace
 
 
@@ -48,9 +134,7 @@ std::vector<Intersection> Raycaster::intersectObject(Object3D& object, bool recu
 
     std::vector<Intersection> intersects;
 
-    ::intersectObject(object, *this, intersects, recursive);
-
-    std::stable_sort(intersects.begin(), intersects.end(), &ascSort);
+    ::intersectObjects({&object}, *this, intersects, recursive);
 
     return intersects;
 }
@@ -59,14 +143,47 @@ std::vector<Intersection> Raycaster::intersectObjects(const std::vector<Object3D
 
     std::vector<Intersection> intersects;
 
-    for (auto& object : objects) {
+    ::intersectObjects(objects, *this, intersects, recursive);
+
+    return intersects;
+}
 
-        ::intersectObject(*object, *this, intersects, recursive);
+std::vector<std::vector<Intersection>> Raycaster::intersectObjects(
+        const std::vector<Ray>& rays, const std::vector<Object3D*>& objects,
+        bool recursive, unsigned int numThreads) const {
+
+    // everything the rays might touch, computed once here instead of racing in the threads
+    for (const auto object : objects) {
+
+        if (recursive) {
+
+            object->traverse(&prepareObject);
+
+        } else {
+
+            prepareObject(*object);
+        }
     }
 
-    std::stable_sort(intersects.begin(), intersects.end(), &ascSort);
+    std::vector<std::vector<Intersection>> result(rays.size());
 
-    return intersects;
+    const auto numChunks = (rays.size() + raysPerChunk - 1) / raysPerChunk;
+
+    std::lock_guard<std::mutex> lck(poolMutex);
+    auto& pool = raycastPool(numThreads == 0 ? utils::ThreadPool::defaultNumThreads() : numThreads);
+
+    pool.parallelFor(numChunks, [&](size_t chunk) {
+        Raycaster raycaster(*this);
+
+        const auto end = std::min(rays.size(), (chunk + 1) * raysPerChunk);
+        for (auto i = chunk * raysPerChunk; i < end; i++) {
+
+            raycaster.ray.copy(rays[i]);
+            ::intersectObjects(objects, raycaster, result[i], recursive);
+        }
+    });
+
+    return result;
 }
 
 void Raycaster::setFromCamera(const Vector2& coords, Camera& camera) {
@@ -0,0 +1,246 @@
+
+#include "threepp/core/TriangleBVH.hpp"
+#include "threepp/core/InterleavedBufferAttribute.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+using namespace threepp;
+
+namespace {
+
+    constexpr int numBins = 16;
+    constexpr int maxLeafSize = 4;
+
+    // relative cost of visiting a node, compared to testing a triangle
+    constexpr float traversalCost = 1;
+
+    float component(const Vector3& v, int axis) {
+
+        return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+    }
+
+    float surfaceArea(const Box3& box) {
+
+        if (box.isEmpty()) return 0;
+
+        const auto size = box.getSize();
+
+        return 2 * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    float centroid(const std::vector<float>& bounds, int triangle, int axis) {
+
+        return (bounds[triangle * 6 + axis] + bounds[triangle * 6 + 3 + axis]) / 2;
+    }
+
+    void expand(Box3& box, const std::vector<float>& bounds, int triangle) {
+
+        const auto b = bounds.data() + triangle * 6;
+        box.expandByPoint({b[0], b[1], b[2]});
+        box.expandByPoint({b[3], b[4], b[5]});
+    }
+
+    // the buffer an interleaved attribute reads from, where needsUpdate counts changes, or the attribute itself
+    const BufferAttribute& versioned(const BufferAttribute& attribute) {
+
+        if (auto interleaved = dynamic_cast<const InterleavedBufferAttribute*>(&attribute)) return *interleaved->data;
+
+        return attribute;
+    }
+
+}// namespace
+
+TriangleBVH::TriangleBVH(const FloatBufferAttribute& position, const IntBufferAttribute* index)
+    : position_(&position), positionData_(&versioned(position)), positionVersion_(positionData_->version), positionCount_(position.count()),
+      index_(index), indexVersion_(index ? index->version : 0), indexCount_(index ? index->count() : 0) {
+
+    const auto count = (index ? index->count() : position.count()) / 3;
+
+    // min and max of every triangle
+    std::vector<float> bounds(count * 6);
+
+    for (int t = 0; t < count; t++) {
+
+        auto b = bounds.data() + t * 6;
+        std::fill_n(b, 3, std::numeric_limits<float>::infinity());
+        std::fill_n(b + 3, 3, -std::numeric_limits<float>::infinity());
+
+        for (int v = 0; v < 3; v++) {
+
+            const auto i = index ? index->getX(t * 3 + v) : t * 3 + v;
+            const std::array<float, 3> p{position.getX(i), position.getY(i), position.getZ(i)};
+
+            for (int axis = 0; axis < 3; axis++) {
+
+                b[axis] = std::min(b[axis], p[axis]);
+                b[3 + axis] = std::max(b[3 + axis], p[axis]);
+            }
+        }
+    }
+
+    triangles_.resize(count);
+    for (int t = 0; t < count; t++) triangles_[t] = t;
+
+    nodes_.reserve(std::max(1, 2 * count / maxLeafSize));
+    nodes_.emplace_back();
+    build(0, 0, count, bounds);
+}
+
+bool TriangleBVH::upToDate(const FloatBufferAttribute& position, const IntBufferAttribute* index) const {
+
+    const auto& positionData = versioned(position);
+
+    return position_ == &position && positionData_ == &positionData && positionVersion_ == positionData.version && positionCount_ == position.count() &&
+           index_ == index && indexVersion_ == (index ? index->version : 0) && indexCount_ == (index ? index->count() : 0);
+}
+
+size_t TriangleBVH::triangleCount() const {
+
+    return triangles_.size();
+}
+
+size_t TriangleBVH::nodeCount() const {
+
+    return nodes_.size();
+}
+
+const Box3& TriangleBVH::boundingBox() const {
+
+    return nodes_.front().box;
+}
+
+void TriangleBVH::build(int node, int begin, int end, const std::vector<float>& bounds) {
+
+    Box3 box;
+    Box3 centroidBox;
+    for (auto i = begin; i < end; ++i) {
+
+        const auto t = triangles_[i];
+        expand(box, bounds, t);
+        centroidBox.expandByPoint({centroid(bounds, t, 0), centroid(bounds, t, 1), centroid(bounds, t, 2)});
+    }
+
+    nodes_[node].box = box;
+
+    const auto count = end - begin;
+
+    auto makeLeaf = [&] {
+        nodes_[node].offset = begin;
+        nodes_[node].count = count;
+    };
+
+    if (count <= maxLeafSize) return makeLeaf();
+
+    // find the cheapest split over all axes, evaluating the cost at the bin boundaries
+
+    const auto centroidSize = centroidBox.getSize();
+
+    int bestAxis = -1;
+    int bestSplit = 0;
+    float bestCost = std::numeric_limits<float>::infinity();
+
+    struct Bin {
+        Box3 box;
+        int count = 0;
+    };
+
+    for (int axis = 0; axis < 3; axis++) {
+
+        const auto extent = component(centroidSize, axis);
+        if (extent <= 0) continue;
+
+        const auto min = component(centroidBox.min(), axis);
+        const auto scale = numBins / extent;
+
+        std::array<Bin, numBins> bins{};
+        for (auto i = begin; i < end; ++i) {
+
+            const auto t = triangles_[i];
+            const auto b = std::min(numBins - 1, static_cast<int>((centroid(bounds, t, axis) - min) * scale));
+            bins[b].count++;
+            expand(bins[b].box, bounds, t);
+        }
+
+        // sweep from the right to get the cost of every right side, then from the left
+        std::array<float, numBins> rightCost{};
+        Box3 rightBox;
+        int rightCount = 0;
+        for (int b = numBins - 1; b > 0; b--) {
+
+            rightBox.union_(bins[b].box);
+            rightCount += bins[b].count;
+            rightCost[b] = surfaceArea(rightBox) * static_cast<float>(rightCount);
+        }
+
+        Box3 leftBox;
+        int leftCount = 0;
+        for (int b = 0; b < numBins - 1; b++) {
+
+            leftBox.union_(bins[b].box);
+            leftCount += bins[b].count;
+
+            if (leftCount == 0 || leftCount == count) continue;
+
+            const auto cost = surfaceArea(leftBox) * static_cast<float>(leftCount) + rightCost[b + 1];
+            if (cost < bestCost) {
+
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = b;
+            }
+        }
+    }
+
+    // all centroids coincide
+    if (bestAxis == -1) return makeLeaf();
+
+    const auto area = surfaceArea(box);
+    const auto splitCost = traversalCost + (area > 0 ? bestCost / area : 0);
+
+    if (splitCost >= static_cast<float>(count) && count <= 4 * maxLeafSize) return makeLeaf();
+
+    const auto min = component(centroidBox.min(), bestAxis);
+    const auto scale = numBins / component(centroidSize, bestAxis);
+
+    const auto mid = std::partition(triangles_.begin() + begin, triangles_.begin() + end, [&](int t) {
+        return std::min(numBins - 1, static_cast<int>((centroid(bounds, t, bestAxis) - min) * scale)) <= bestSplit;
+    });
+    const auto split = static_cast<int>(mid - triangles_.begin());
+
+    const auto left = static_cast<int>(nodes_.size());
+    nodes_.emplace_back();
+    build(left, begin, split, bounds);
+
+    const auto right = static_cast<int>(nodes_.size());
+    nodes_.emplace_back();
+    build(right, split, end, bounds);
+
+    nodes_[node].offset = right;
+    nodes_[node].count = 0;
+}
+
+bool TriangleBVH::intersectsRay(const Box3& box, const Vector3& origin, const Vector3& invDir, float far, float& tmin) {
+
+    float tmax = far;
+    tmin = 0;
+
+    for (int axis = 0; axis < 3; axis++) {
+
+        const auto o = component(origin, axis);
+        const auto inv = component(invDir, axis);
+
+        auto t1 = (component(box.min(), axis) - o) * inv;
+        auto t2 = (component(box.max(), axis) - o) * inv;
+        if (inv < 0) std::swap(t1, t2);
+
+        // NaN, from a zero direction component on the boundary of a slab, leaves the interval unchanged
+        if (t1 > tmin) tmin = t1;
+        if (t2 < tmax) tmax = t2;
+
+        if (tmin > tmax) return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,91 @@
+
+#include "threepp/extras/DataUtils.hpp"
+
+#include <cstring>
+
+using namespace threepp;
+
+uint16_t datautils::toHalfFloat(float value) {
+
+    uint32_t x;
+    std::memcpy(&x, &value, sizeof(x));
+
+    const auto sign = static_cast<uint16_t>((x >> 16) & 0x8000);
+    const auto exponent = static_cast<int>((x >> 23) & 0xff);
+    auto mantissa = x & 0x7fffff;
+
+    // NaN and Infinity
+    if (exponent == 0xff) {
+
+        return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+    }
+
+    const int e = exponent - 127 + 15;
+
+    // overflow, clamp to Infinity
+    if (e >= 0x1f) {
+
+        return sign | 0x7c00;
+    }
+
+    // subnormal or zero
+    if (e <= 0) {
+
+        if (e < -10) return sign;
+
+        mantissa |= 0x800000;
+        const auto shift = static_cast<uint32_t>(14 - e);
+        auto half = mantissa >> shift;
+        const auto remainder = mantissa & ((1u << shift) - 1);
+        const auto halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1))) ++half;
+
+        return sign | static_cast<uint16_t>(half);
+    }
+
+    auto half = static_cast<uint32_t>(e << 10) | (mantissa >> 13);
+    const auto remainder = mantissa & 0x1fff;
+    // a carry into the exponent correctly rounds up to the next binade, or to Infinity
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) ++half;
+
+    return sign | static_cast<uint16_t>(half);
+}
+
+float datautils::fromHalfFloat(uint16_t value) {
+
+    const uint32_t sign = (value & 0x8000u) << 16;
+    uint32_t exponent = (value >> 10) & 0x1f;
+    uint32_t mantissa = value & 0x3ff;
+
+    uint32_t x;
+    if (exponent == 0) {
+
+        if (mantissa == 0) {
+
+            x = sign;
+
+        } else {
+
+            // subnormal, normalize it
+            exponent = 127 - 15 + 1;
+            while (!(mantissa & 0x400)) {
+                mantissa <<= 1;
+                --exponent;
+            }
+            mantissa &= 0x3ff;
+            x = sign | (exponent << 23) | (mantissa << 13);
+        }
+
+    } else if (exponent == 0x1f) {
+
+        x = sign | 0x7f800000 | (mantissa << 13);
+
+    } else {
+
+        x = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &x, sizeof(result));
+    return result;
+}
@@ -0,0 +1,206 @@
+
+#include "threepp/lights/DirectionalLightShadow.hpp"
+
+#include "threepp/lights/light_interfaces.hpp"
+#include "threepp/renderers/GLRenderTarget.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+using namespace threepp;
+
+namespace {
+
+    // maps clip space to texture coordinates
+    Matrix4 shadowBias() {
+
+        Matrix4 m;
+        m.set(
+                0.5f, 0.0f, 0.0f, 0.5f,
+                0.0f, 0.5f, 0.0f, 0.5f,
+                0.0f, 0.0f, 0.5f, 0.5f,
+                0.0f, 0.0f, 0.0f, 1.0f);
+
+        return m;
+    }
+
+}// namespace
+
+
+void DirectionalLightShadow::setCascades(size_t count) {
+
+    count = std::max<size_t>(1, count);
+
+    if (count == cascades()) return;
+
+    cascades_.assign(count, Cascade());
+    cascadeEnds_.assign(count, 0);
+    cascadeMatrices_.assign(count, Matrix4());
+
+    // cells of a grid as close to square as possible
+    const auto columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<float>(count))));
+    const auto rows = (count + columns - 1) / columns;
+
+    _frameExtents.set(static_cast<float>(columns), static_cast<float>(rows));
+
+    _viewports.clear();
+    for (size_t i = 0; i < count; i++) {
+
+        _viewports.emplace_back(static_cast<float>(i % columns), static_cast<float>(i / columns), 1.f, 1.f);
+    }
+
+    // the map has the wrong layout now
+    dispose();
+    map = nullptr;
+    mapPass = nullptr;
+}
+
+size_t DirectionalLightShadow::cascades() const {
+
+    return cascades_.size();
+}
+
+void DirectionalLightShadow::updateCascades(Light& light, const Camera& camera) {
+
+    const auto count = cascades();
+
+    // view range covered by the cascades
+    const auto near = camera.near;
+    const auto far = cascadeFar > 0 ? std::min(cascadeFar, camera.far) : camera.far;
+
+    for (size_t i = 0; i + 1 < count; i++) {
+
+        if (cascadeSplits.size() + 1 == count) {
+
+            cascadeEnds_[i] = cascadeSplits[i];
+            continue;
+        }
+
+        const auto p = static_cast<float>(i + 1) / static_cast<float>(count);
+        const auto uniform = near + (far - near) * p;
+        // the logarithmic scheme needs a positive near plane
+        const auto logarithmic = near > 0 ? near * std::pow(far / near, p) : uniform;
+
+        cascadeEnds_[i] = cascadeSplitLambda * logarithmic + (1 - cascadeSplitLambda) * uniform;
+    }
+    cascadeEnds_[count - 1] = far;
+
+    // corners of the view frustum on the near and far planes, in view space
+    std::array<Vector3, 4> nearCorners;
+    std::array<Vector3, 4> farCorners;
+    for (size_t i = 0; i < 4; i++) {
+
+        const auto x = (i & 1) ? 1.f : -1.f;
+        const auto y = (i & 2) ? 1.f : -1.f;
+
+        nearCorners[i].set(x, y, -1).applyMatrix4(camera.projectionMatrixInverse);
+        farCorners[i].set(x, y, 1).applyMatrix4(camera.projectionMatrixInverse);
+    }
+
+    // all cascades look along the light direction
+    Vector3 target;
+    if (auto lightWithTarget = dynamic_cast<LightWithTarget*>(&light)) {
+
+        target.setFromMatrixPosition(*lightWithTarget->target().matrixWorld);
+    }
+
+    Vector3 direction;
+    direction.setFromMatrixPosition(*light.matrixWorld);
+    direction.sub(target).negate().normalize();
+
+    Matrix4 rotation;
+    rotation.lookAt(Vector3(), direction, this->camera->up);
+    this->camera->quaternion.setFromRotationMatrix(rotation);
+
+    Matrix4 rotationInverse;
+    rotationInverse.copy(rotation).transpose();
+
+    const auto bias = shadowBias();
+    std::vector<Matrix4> matrices(count);
+    std::array<Vector3, 8> points;
+
+    for (size_t i = 0; i < count; i++) {
+
+        const auto start = i == 0 ? near : cascadeEnds_[i - 1];
+        const auto end = cascadeEnds_[i];
+
+        // the slice of the view frustum, in world space
+        Vector3 center;
+        for (size_t j = 0; j < 4; j++) {
+
+            const auto depth = -farCorners[j].z + nearCorners[j].z;
+            const auto t0 = depth != 0 ? (start + nearCorners[j].z) / depth : 0;
+            const auto t1 = depth != 0 ? (end + nearCorners[j].z) / depth : 1;
+
+            points[j].lerpVectors(nearCorners[j], farCorners[j], t0).applyMatrix4(*camera.matrixWorld);
+            points[j + 4].lerpVectors(nearCorners[j], farCorners[j], t1).applyMatrix4(*camera.matrixWorld);
+
+            center.add(points[j]).add(points[j + 4]);
+        }
+        center.divideScalar(8);
+
+        // a sphere does not change size as the view turns, so neither do the texels
+        float radius = 0;
+        for (const auto& point : points) radius = std::max(radius, center.distanceTo(point));
+        radius = std::max(std::ceil(radius * 16), 1.f) / 16;
+
+        // moving the center by whole texels keeps the shadow edges in place
+        const auto texelWidth = 2 * radius / getRenderedMapSize().x;
+        const auto texelHeight = 2 * radius / getRenderedMapSize().y;
+
+        center.applyMatrix4(rotationInverse);
+        center.x = std::floor(center.x / texelWidth) * texelWidth;
+        center.y = std::floor(center.y / texelHeight) * texelHeight;
+        center.applyMatrix4(rotation);
+
+        auto& cascade = cascades_[i];
+        cascade.radius = radius;
+        cascade.position.copy(center).addScaledVector(direction, -(radius + cascadeCasterDistance));
+
+        updateCascade(i);
+
+        matrices[i].copy(bias).multiply(this->camera->projectionMatrix).multiply(this->camera->matrixWorldInverse);
+    }
+
+    this->matrix.copy(matrices.front());
+
+    Matrix4 firstInverse;
+    firstInverse.copy(matrices.front()).invert();
+
+    for (size_t i = 0; i < count; i++) {
+
+        cascadeMatrices_[i].multiplyMatrices(matrices[i], firstInverse);
+    }
+}
+
+void DirectionalLightShadow::updateCascade(size_t index) {
+
+    const auto& cascade = cascades_.at(index);
+    auto& shadowCamera = dynamic_cast<OrthographicCamera&>(*this->camera);
+
+    shadowCamera.left = -cascade.radius;
+    shadowCamera.right = cascade.radius;
+    shadowCamera.top = cascade.radius;
+    shadowCamera.bottom = -cascade.radius;
+    shadowCamera.near = 0;
+    shadowCamera.far = cascadeCasterDistance + 2 * cascade.radius;
+    shadowCamera.zoom = 1;
+    shadowCamera.updateProjectionMatrix();
+
+    shadowCamera.position.copy(cascade.position);
+    shadowCamera.updateMatrixWorld();
+
+    _projScreenMatrix.multiplyMatrices(shadowCamera.projectionMatrix, shadowCamera.matrixWorldInverse);
+    this->_frustum.setFromProjectionMatrix(_projScreenMatrix);
+}
+
+const std::vector<float>& DirectionalLightShadow::cascadeEnds() const {
+
+    return cascadeEnds_;
+}
+
+const std::vector<Matrix4>& DirectionalLightShadow::cascadeMatrices() const {
+
+    return cascadeMatrices_;
+}
@@ -5,7 +5,10 @@ using namespace threepp;
 
 
 Light::Light(const Color& color, std::optional<float> intensity)
-    : color(color), intensity(intensity.value_or(1)) {}
+    : color(color), intensity(intensity.value_or(1)) {
+
+    addTag(Tag::Light);
+}
 
 
 std::string Light::type() const {
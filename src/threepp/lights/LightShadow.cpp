@@ -57,6 +57,11 @@ Vector2& LightShadow::getFrameExtents() {
     return this->_frameExtents;
 }
 
+const Vector2& LightShadow::getRenderedMapSize() const {
+
+    return atlasMapSize.x > 0 ? atlasMapSize : mapSize;
+}
+
 void LightShadow::dispose() {
 
     if (this->map) {
@@ -5,7 +5,10 @@ using namespace threepp;
 
 LineBasicMaterial::LineBasicMaterial()
     : MaterialWithColor(0xffffff),
-      MaterialWithLineWidth(1) {}
+      MaterialWithLineWidth(1) {
+
+    addTag(Tag::LineBasic);
+}
 
 
 std::string LineBasicMaterial::type() const {
@@ -9,7 +9,10 @@ MeshBasicMaterial::MeshBasicMaterial()
       MaterialWithLightMap(1),
       MaterialWithCombine(CombineOperation::Multiply),
       MaterialWithReflectivity(1, 0.98f),
-      MaterialWithWireframe(false, 1) {}
+      MaterialWithWireframe(false, 1) {
+
+    addTag(Tag::MeshBasic);
+}
 
 
 std::string MeshBasicMaterial::type() const {
@@ -134,5 +137,5 @@ bool MeshBasicMaterial::setValue(const std::string& key, const MaterialValue& va
 
 std::shared_ptr<Material> MeshBasicMaterial::createDefault() const {
 
-    return {};
+    return std::shared_ptr<MeshBasicMaterial>(new MeshBasicMaterial());
 }
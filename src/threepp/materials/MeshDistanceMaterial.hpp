@@ -30,6 +30,8 @@ namespace threepp {
     protected:
         MeshDistanceMaterial(): MaterialWithDisplacementMap(1, 0) {
 
+            addTag(Tag::MeshDistance);
+
             this->fog = false;
         }
 
@@ -15,7 +15,10 @@ MeshPhongMaterial::MeshPhongMaterial()
       MaterialWithNormalMap(NormalMapType::TangentSpace, {1, 1}),
       MaterialWithDisplacementMap(1, 0),
       MaterialWithReflectivity(1, 0.98f),
-      MaterialWithWireframe(false, 1) {}
+      MaterialWithWireframe(false, 1) {
+
+    addTag(Tag::MeshPhong);
+}
 
 
 std::string MeshPhongMaterial::type() const {
@@ -20,6 +20,8 @@ MeshStandardMaterial::MeshStandardMaterial()
       MaterialWithVertexTangents(false),
       MaterialWithFlatShading(false) {
 
+    addTag(Tag::MeshStandard);
+
     defines["STANDARD"] = "";
 }
 
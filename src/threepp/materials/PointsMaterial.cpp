@@ -5,7 +5,10 @@ using namespace threepp;
 
 PointsMaterial::PointsMaterial()
     : MaterialWithColor(0xffffff),
-      MaterialWithSize(1, true) {}
+      MaterialWithSize(1, true) {
+
+    addTag(Tag::Points);
+}
 
 
 std::string PointsMaterial::type() const {
@@ -4,7 +4,10 @@
 using namespace threepp;
 
 
-RawShaderMaterial::RawShaderMaterial() = default;
+RawShaderMaterial::RawShaderMaterial() {
+
+    addTag(Tag::RawShader);
+}
 
 
 std::string RawShaderMaterial::type() const {
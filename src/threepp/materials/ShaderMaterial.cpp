@@ -13,6 +13,9 @@ ShaderMaterial::ShaderMaterial()
       vertexShader(shaders::ShaderChunk::instance().default_vertex()),
       fragmentShader(shaders::ShaderChunk::instance().default_fragment()) {
 
+    addTag(Tag::Shader);
+    registerType(this);
+
     this->fog = false;
     this->lights = false;
     this->clipping = false;
@@ -6,6 +6,9 @@ using namespace threepp;
 SpriteMaterial::SpriteMaterial()
     : MaterialWithColor(0xffffff),
       MaterialWithSize(0, true) {
+
+    addTag(Tag::Sprite);
+
     transparent = true;
 }
 
@@ -12,27 +12,10 @@ using namespace threepp;
 
 namespace {
 
-    Vector3 _vector;
-
-    Vector3 _v0;
-    Vector3 _v1;
-    Vector3 _v2;
-
-    Vector3 _f0;
-    Vector3 _f1;
-    Vector3 _f2;
-
-    Vector3 _center;
-    Vector3 _extents;
-
-    Vector3 _triangleNormal;
-    Vector3 _testAxis;
-
-    std::array<Vector3, 8> _points;
-
-
     bool satForAxes(const std::vector<float>& axes, const Vector3& v0, const Vector3& v1, const Vector3& v2, const Vector3& extents) {
 
+        Vector3 _testAxis;
+
         for (unsigned i = 0, j = axes.size() - 3; i <= j; i += 3) {
 
             _testAxis.fromArray(axes, i);
@@ -91,6 +74,8 @@ Box3& Box3::set(float minX, float minY, float minZ, float maxX, float maxY, floa
 
 Box3& Box3::setFromCenterAndSize(const Vector3& center, const Vector3& size) {
 
+    Vector3 _vector;
+
     const auto halfSize = _vector.copy(size).multiplyScalar(0.5f);
 
     this->min_.copy(center).sub(halfSize);
@@ -221,6 +206,7 @@ Box3& Box3::expandByObject(Object3D& object, bool presice) {
             if (presice && geometry->getAttributes().count("position")) {
 
                 const auto position = geometry->getAttribute<float>("position");
+                Vector3 _vector;
                 for (unsigned i = 0, l = position->count(); i < l; i++) {
 
                     position->setFromBufferAttribute(_vector, i);
@@ -284,6 +270,8 @@ bool Box3::intersectsBox(const Box3& box) const {
 
 bool Box3::intersectsSphere(const Sphere& sphere) const {
 
+    Vector3 _vector;
+
     // Find the point on the AABB closest to the sphere center.
     this->clampPoint(sphere.center, _vector);
 
@@ -337,6 +325,16 @@ bool Box3::intersectsPlane(const Plane& plane) const {
 
 bool Box3::intersectsTriangle(const Triangle& triangle) const {
 
+    Vector3 _v0;
+    Vector3 _v1;
+    Vector3 _v2;
+    Vector3 _f0;
+    Vector3 _f1;
+    Vector3 _f2;
+    Vector3 _center;
+    Vector3 _extents;
+    Vector3 _triangleNormal;
+
     if (this->isEmpty()) {
 
         return false;
@@ -390,6 +388,8 @@ Vector3& Box3::clampPoint(const Vector3& point, Vector3& target) const {
 
 float Box3::distanceToPoint(const Vector3& point) const {
 
+    Vector3 _vector;
+
     auto clampedPoint = _vector.copy(point).clamp(this->min_, this->max_);
 
     return clampedPoint.sub(point).length();
@@ -397,6 +397,8 @@ float Box3::distanceToPoint(const Vector3& point) const {
 
 void Box3::getBoundingSphere(Sphere& target) const {
 
+    Vector3 _vector;
+
     this->getCenter(target.center);
 
     this->getSize(_vector);
@@ -424,6 +426,8 @@ Box3& Box3::union_(const Box3& box) {
 
 Box3& Box3::applyMatrix4(const Matrix4& matrix) {
 
+    std::array<Vector3, 8> _points;
+
     // transform of empty box is an empty box.
     if (this->isEmpty()) return *this;
 
@@ -0,0 +1,503 @@
+
+#include "threepp/math/DynamicAABBTree.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+using namespace threepp;
+
+namespace {
+
+    // fat boxes larger than this factor of a freshly fattened box are rebuilt on move
+    constexpr float maxFatAreaFactor = 4;
+
+    float surfaceArea(const Box3& box) {
+
+        const auto dx = box.max().x - box.min().x;
+        const auto dy = box.max().y - box.min().y;
+        const auto dz = box.max().z - box.min().z;
+
+        return 2 * (dx * dy + dy * dz + dz * dx);
+    }
+
+    Box3 combine(const Box3& a, const Box3& b) {
+
+        Box3 box(a);
+        box.union_(b);
+
+        return box;
+    }
+
+}// namespace
+
+DynamicAABBTree::DynamicAABBTree(float margin)
+    : margin_(margin) {}
+
+int DynamicAABBTree::insert(const Box3& box, void* userData) {
+
+    const auto proxy = allocateNode();
+
+    auto& node = nodes_[proxy];
+    node.box = fatten(box);
+    node.userData = userData;
+    node.height = 0;
+
+    insertLeaf(proxy);
+    ++proxyCount_;
+
+    return proxy;
+}
+
+void DynamicAABBTree::remove(int proxy) {
+
+    if (proxy < 0 || proxy >= static_cast<int>(nodes_.size()) || !nodes_[proxy].isLeaf() || nodes_[proxy].height != 0) {
+        throw std::runtime_error("THREE.DynamicAABBTree: Invalid proxy " + std::to_string(proxy) + ".");
+    }
+
+    removeLeaf(proxy);
+    freeNode(proxy);
+    --proxyCount_;
+}
+
+bool DynamicAABBTree::move(int proxy, const Box3& box) {
+
+    auto& node = nodes_.at(proxy);
+
+    if (node.box.containsBox(box)) {
+
+        // keep the fat box unless it has become too loose
+        const auto fat = fatten(box);
+        if (surfaceArea(node.box) <= maxFatAreaFactor * std::max(surfaceArea(fat), 1e-12f)) return false;
+    }
+
+    removeLeaf(proxy);
+    nodes_[proxy].box = fatten(box);
+    insertLeaf(proxy);
+
+    return true;
+}
+
+void DynamicAABBTree::clear() {
+
+    nodes_.clear();
+    root_ = nullNode;
+    freeList_ = nullNode;
+    proxyCount_ = 0;
+}
+
+void* DynamicAABBTree::userData(int proxy) const {
+
+    return nodes_.at(proxy).userData;
+}
+
+const Box3& DynamicAABBTree::fatBox(int proxy) const {
+
+    return nodes_.at(proxy).box;
+}
+
+size_t DynamicAABBTree::size() const {
+
+    return proxyCount_;
+}
+
+bool DynamicAABBTree::empty() const {
+
+    return proxyCount_ == 0;
+}
+
+int DynamicAABBTree::height() const {
+
+    return root_ == nullNode ? 0 : nodes_[root_].height;
+}
+
+float DynamicAABBTree::areaRatio() const {
+
+    if (root_ == nullNode) return 0;
+
+    const auto rootArea = surfaceArea(nodes_[root_].box);
+    if (rootArea <= 0) return 0;
+
+    float totalArea = 0;
+    for (const auto& node : nodes_) {
+
+        if (node.height > 0) totalArea += surfaceArea(node.box);
+    }
+
+    return totalArea / rootArea;
+}
+
+void DynamicAABBTree::validate() const {
+
+    size_t leafCount = 0;
+    if (root_ != nullNode) validate(root_, nullNode, leafCount);
+
+    if (leafCount != proxyCount_) {
+        throw std::runtime_error("THREE.DynamicAABBTree: Leaf count does not match the proxy count.");
+    }
+
+    size_t freeCount = 0;
+    for (auto id = freeList_; id != nullNode; id = nodes_[id].parent) {
+
+        if (nodes_[id].height != -1) {
+            throw std::runtime_error("THREE.DynamicAABBTree: Node in the free list is in use.");
+        }
+        ++freeCount;
+    }
+
+    // a tree with n leaves has n - 1 internal nodes
+    const auto usedCount = proxyCount_ == 0 ? 0 : 2 * proxyCount_ - 1;
+    if (usedCount + freeCount != nodes_.size()) {
+        throw std::runtime_error("THREE.DynamicAABBTree: Nodes are leaking.");
+    }
+}
+
+int DynamicAABBTree::validate(int id, int parent, size_t& leafCount) const {
+
+    const auto& node = nodes_[id];
+
+    if (node.parent != parent) {
+        throw std::runtime_error("THREE.DynamicAABBTree: Invalid parent of node " + std::to_string(id) + ".");
+    }
+
+    if (node.isLeaf()) {
+
+        if (node.child2 != nullNode || node.height != 0) {
+            throw std::runtime_error("THREE.DynamicAABBTree: Invalid leaf " + std::to_string(id) + ".");
+        }
+
+        ++leafCount;
+        return 0;
+    }
+
+    const auto height1 = validate(node.child1, id, leafCount);
+    const auto height2 = validate(node.child2, id, leafCount);
+
+    if (node.height != 1 + std::max(height1, height2)) {
+        throw std::runtime_error("THREE.DynamicAABBTree: Invalid height of node " + std::to_string(id) + ".");
+    }
+
+    if (!node.box.containsBox(nodes_[node.child1].box) || !node.box.containsBox(nodes_[node.child2].box)) {
+        throw std::runtime_error("THREE.DynamicAABBTree: Box of node " + std::to_string(id) + " does not contain its children.");
+    }
+
+    return node.height;
+}
+
+int DynamicAABBTree::allocateNode() {
+
+    if (freeList_ == nullNode) {
+
+        nodes_.emplace_back();
+        return static_cast<int>(nodes_.size() - 1);
+    }
+
+    const auto id = freeList_;
+    freeList_ = nodes_[id].parent;
+
+    nodes_[id] = Node{};
+
+    return id;
+}
+
+void DynamicAABBTree::freeNode(int id) {
+
+    auto& node = nodes_[id];
+    node.userData = nullptr;
+    node.child1 = nullNode;
+    node.child2 = nullNode;
+    node.height = -1;
+    node.parent = freeList_;
+
+    freeList_ = id;
+}
+
+void DynamicAABBTree::insertLeaf(int leaf) {
+
+    if (root_ == nullNode) {
+
+        root_ = leaf;
+        nodes_[root_].parent = nullNode;
+        return;
+    }
+
+    // find the best sibling, descending towards the lowest cost according to the surface area heuristic
+
+    const auto leafBox = nodes_[leaf].box;
+    auto index = root_;
+
+    while (!nodes_[index].isLeaf()) {
+
+        const auto& node = nodes_[index];
+
+        const auto area = surfaceArea(node.box);
+        const auto combinedArea = surfaceArea(combine(node.box, leafBox));
+
+        // cost of creating a new parent for this node and the new leaf
+        const auto cost = 2 * combinedArea;
+
+        // minimum cost of pushing the leaf further down the tree
+        const auto inheritanceCost = 2 * (combinedArea - area);
+
+        auto childCost = [&](int child) {
+            const auto& c = nodes_[child];
+            const auto enlarged = surfaceArea(combine(leafBox, c.box));
+            return c.isLeaf() ? enlarged + inheritanceCost : enlarged - surfaceArea(c.box) + inheritanceCost;
+        };
+
+        const auto cost1 = childCost(node.child1);
+        const auto cost2 = childCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) break;
+
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const auto sibling = index;
+
+    // create a new parent
+
+    const auto oldParent = nodes_[sibling].parent;
+    const auto newParent = allocateNode();
+
+    auto& parent = nodes_[newParent];
+    parent.parent = oldParent;
+    parent.box = combine(leafBox, nodes_[sibling].box);
+    parent.height = nodes_[sibling].height + 1;
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+
+    if (oldParent != nullNode) {
+
+        if (nodes_[oldParent].child1 == sibling) {
+            nodes_[oldParent].child1 = newParent;
+        } else {
+            nodes_[oldParent].child2 = newParent;
+        }
+
+    } else {
+
+        root_ = newParent;
+    }
+
+    // walk back up the tree fixing heights and boxes
+
+    index = nodes_[leaf].parent;
+    while (index != nullNode) {
+
+        index = balance(index);
+
+        auto& node = nodes_[index];
+        node.height = 1 + std::max(nodes_[node.child1].height, nodes_[node.child2].height);
+        node.box = combine(nodes_[node.child1].box, nodes_[node.child2].box);
+
+        index = node.parent;
+    }
+}
+
+void DynamicAABBTree::removeLeaf(int leaf) {
+
+    if (leaf == root_) {
+
+        root_ = nullNode;
+        return;
+    }
+
+    const auto parent = nodes_[leaf].parent;
+    const auto grandParent = nodes_[parent].parent;
+    const auto sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+    if (grandParent != nullNode) {
+
+        // destroy the parent and connect the sibling to the grand parent
+        if (nodes_[grandParent].child1 == parent) {
+            nodes_[grandParent].child1 = sibling;
+        } else {
+            nodes_[grandParent].child2 = sibling;
+        }
+        nodes_[sibling].parent = grandParent;
+        freeNode(parent);
+
+        auto index = grandParent;
+        while (index != nullNode) {
+
+            index = balance(index);
+
+            auto& node = nodes_[index];
+            node.box = combine(nodes_[node.child1].box, nodes_[node.child2].box);
+            node.height = 1 + std::max(nodes_[node.child1].height, nodes_[node.child2].height);
+
+            index = node.parent;
+        }
+
+    } else {
+
+        root_ = sibling;
+        nodes_[sibling].parent = nullNode;
+        freeNode(parent);
+    }
+}
+
+// Performs a left or right rotation if node a is imbalanced. Returns the new root of the subtree.
+int DynamicAABBTree::balance(int iA) {
+
+    auto& a = nodes_[iA];
+    if (a.isLeaf() || a.height < 2) return iA;
+
+    const auto iB = a.child1;
+    const auto iC = a.child2;
+    auto& b = nodes_[iB];
+    auto& c = nodes_[iC];
+
+    const auto balance = c.height - b.height;
+
+    // rotates child x up, where y is the other child of a
+    auto rotate = [&](int iX, int iY) -> int {
+        auto& x = nodes_[iX];
+        auto& y = nodes_[iY];
+
+        const auto iF = x.child1;
+        const auto iG = x.child2;
+        auto& f = nodes_[iF];
+        auto& g = nodes_[iG];
+
+        // swap a and x
+        x.child1 = iA;
+        x.parent = a.parent;
+        a.parent = iX;
+
+        if (x.parent != nullNode) {
+
+            if (nodes_[x.parent].child1 == iA) {
+                nodes_[x.parent].child1 = iX;
+            } else {
+                nodes_[x.parent].child2 = iX;
+            }
+
+        } else {
+
+            root_ = iX;
+        }
+
+        const auto replace = [&](int child) {
+            if (a.child1 == iX) {
+                a.child1 = child;
+            } else {
+                a.child2 = child;
+            }
+        };
+
+        // keep the taller grandchild under x
+        if (f.height > g.height) {
+
+            x.child2 = iF;
+            replace(iG);
+            g.parent = iA;
+            a.box = combine(y.box, g.box);
+            x.box = combine(a.box, f.box);
+
+            a.height = 1 + std::max(y.height, g.height);
+            x.height = 1 + std::max(a.height, f.height);
+
+        } else {
+
+            x.child2 = iG;
+            replace(iF);
+            f.parent = iA;
+            a.box = combine(y.box, f.box);
+            x.box = combine(a.box, g.box);
+
+            a.height = 1 + std::max(y.height, f.height);
+            x.height = 1 + std::max(a.height, g.height);
+        }
+
+        return iX;
+    };
+
+    if (balance > 1) return rotate(iC, iB);
+    if (balance < -1) return rotate(iB, iC);
+
+    return iA;
+}
+
+Box3 DynamicAABBTree::fatten(const Box3& box) const {
+
+    const auto size = box.getSize();
+
+    Box3 fat(box);
+    fat.expandByScalar(margin_ * std::max({size.x, size.y, size.z}));
+
+    return fat;
+}
+
+DynamicAABBTree::Containment DynamicAABBTree::classify(const Frustum& frustum, const Box3& box) {
+
+    auto containment = Containment::Inside;
+
+    for (const auto& plane : frustum.planes()) {
+
+        const auto& n = plane.normal;
+        const auto& min = box.min();
+        const auto& max = box.max();
+
+        // corners at max and min distance
+        const auto far = n.x * (n.x > 0 ? max.x : min.x) + n.y * (n.y > 0 ? max.y : min.y) + n.z * (n.z > 0 ? max.z : min.z) + plane.constant;
+        if (far < 0) return Containment::Outside;
+
+        const auto near = n.x * (n.x > 0 ? min.x : max.x) + n.y * (n.y > 0 ? min.y : max.y) + n.z * (n.z > 0 ? min.z : max.z) + plane.constant;
+        if (near < 0) containment = Containment::Intersecting;
+    }
+
+    return containment;
+}
+
+bool DynamicAABBTree::intersectsRay(const Box3& box, const Vector3& origin, const Vector3& invDir, float near, float far, float threshold) {
+
+    const auto& min = box.min();
+    const auto& max = box.max();
+
+    float tmin, tmax;
+
+    if (invDir.x >= 0) {
+        tmin = (min.x - threshold - origin.x) * invDir.x;
+        tmax = (max.x + threshold - origin.x) * invDir.x;
+    } else {
+        tmin = (max.x + threshold - origin.x) * invDir.x;
+        tmax = (min.x - threshold - origin.x) * invDir.x;
+    }
+
+    float tymin, tymax;
+    if (invDir.y >= 0) {
+        tymin = (min.y - threshold - origin.y) * invDir.y;
+        tymax = (max.y + threshold - origin.y) * invDir.y;
+    } else {
+        tymin = (max.y + threshold - origin.y) * invDir.y;
+        tymax = (min.y - threshold - origin.y) * invDir.y;
+    }
+
+    if (tmin > tymax || tymin > tmax) return false;
+
+    // the comparisons also reject NaN, from a zero direction component on the boundary of a slab
+    if (tymin > tmin || tmin != tmin) tmin = tymin;
+    if (tymax < tmax || tmax != tmax) tmax = tymax;
+
+    float tzmin, tzmax;
+    if (invDir.z >= 0) {
+        tzmin = (min.z - threshold - origin.z) * invDir.z;
+        tzmax = (max.z + threshold - origin.z) * invDir.z;
+    } else {
+        tzmin = (max.z + threshold - origin.z) * invDir.z;
+        tzmax = (min.z - threshold - origin.z) * invDir.z;
+    }
+
+    if (tmin > tzmax || tzmin > tmax) return false;
+
+    if (tzmin > tmin || tmin != tmin) tmin = tzmin;
+    if (tzmax < tmax || tmax != tmax) tmax = tzmax;
+
+    return tmax >= near && tmin <= far;
+}
@@ -2,16 +2,12 @@
 #include "threepp/math/Frustum.hpp"
 
 #include "threepp/core/BufferGeometry.hpp"
+#include "threepp/objects/BatchedMesh.hpp"
 #include "threepp/objects/InstancedMesh.hpp"
 #include "threepp/objects/Sprite.hpp"
 
 using namespace threepp;
 
-namespace {
-    Sphere _sphere{};
-    Vector3 _vector{};
-}// namespace
-
 Frustum::Frustum(Plane p0, Plane p1, Plane p2, Plane p3, Plane p4, Plane p5)
     : planes_{p0, p1, p2, p3, p4, p5} {}
 
@@ -57,12 +53,20 @@ Frustum& Frustum::setFromProjectionMatrix(const Matrix4& m) {
 
 bool Frustum::intersectsObject(Object3D& object) const {
 
+    Sphere _sphere;
+
     if (auto instancedMesh = object.as<InstancedMesh>()) {
 
         if (!instancedMesh->boundingSphere) instancedMesh->computeBoundingSphere();
 
         _sphere.copy(instancedMesh->boundingSphere.value()).applyMatrix4(*object.matrixWorld);
 
+    } else if (auto batchedMesh = object.as<BatchedMesh>()) {
+
+        if (!batchedMesh->boundingSphere) batchedMesh->computeBoundingSphere();
+
+        _sphere.copy(batchedMesh->boundingSphere.value()).applyMatrix4(*object.matrixWorld);
+
     } else {
 
         const auto geometry = object.geometry();
@@ -76,6 +80,8 @@ bool Frustum::intersectsObject(Object3D& object) const {
 }
 
 bool Frustum::intersectsSprite(const Sprite& sprite) const {
+
+    Sphere _sphere;
     _sphere.center.set(0, 0, 0);
     _sphere.radius = 0.7071067811865476f;
     _sphere.applyMatrix4(*sprite.matrixWorld);
@@ -103,6 +109,8 @@ bool Frustum::intersectsSphere(const Sphere& sphere) const {
 
 bool Frustum::intersectsBox(const Box3& box) const {
 
+    Vector3 _vector;
+
     for (int i = 0; i < 6; i++) {
 
         const auto& plane = planes_[i];
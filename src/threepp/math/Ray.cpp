@@ -10,20 +10,6 @@
 
 using namespace threepp;
 
-namespace {
-
-    Vector3 _vector;
-
-    Vector3 _segCenter;
-    Vector3 _segDir;
-    Vector3 _diff;
-
-    Vector3 _edge1;
-    Vector3 _edge2;
-    Vector3 _normal;
-
-}// namespace
-
 Ray::Ray(const Vector3& origin, const Vector3& direction): origin(origin), direction(direction) {}
 
 Ray& Ray::set(const Vector3& origin, const Vector3& direction) {
@@ -84,6 +70,8 @@ float Ray::distanceToPoint(const Vector3& point) const {
 
 float Ray::distanceSqToPoint(const Vector3& point) const {
 
+    Vector3 _vector;
+
     const auto directionDistance = _vector.subVectors(point, this->origin).dot(this->direction);
 
     // point behind the ray
@@ -101,6 +89,10 @@ float Ray::distanceSqToPoint(const Vector3& point) const {
 
 float Ray::distanceSqToSegment(const Vector3& v0, const Vector3& v1, Vector3* optionalPointOnRay, Vector3* optionalPointOnSegment) const {
 
+    Vector3 _segCenter;
+    Vector3 _segDir;
+    Vector3 _diff;
+
     // from http://www.geometrictools.com/GTEngine/Include/Mathematics/GteDistRaySegment.h
     // It returns the min distance between the ray and the segment
     // defined by v0 and v1
@@ -212,6 +204,8 @@ float Ray::distanceSqToSegment(const Vector3& v0, const Vector3& v1, Vector3* op
 
 void Ray::intersectSphere(const Sphere& sphere, Vector3& target) const {
 
+    Vector3 _vector;
+
     _vector.subVectors(sphere.center, this->origin);
     const auto tca = _vector.dot(this->direction);
     const auto d2 = _vector.dot(_vector) - tca * tca;
@@ -392,6 +386,8 @@ void Ray::intersectBox(const Box3& box, Vector3& target) const {
 
 bool Ray::intersectsBox(const Box3& box) const {
 
+    Vector3 _vector;
+
     this->intersectBox(box, _vector);
 
     return !_vector.isNan();
@@ -399,6 +395,11 @@ bool Ray::intersectsBox(const Box3& box) const {
 
 std::optional<Vector3> Ray::intersectTriangle(const Vector3& a, const Vector3& b, const Vector3& c, bool backfaceCulling, Vector3& target) const {
 
+    Vector3 _edge1;
+    Vector3 _edge2;
+    Vector3 _normal;
+    Vector3 _diff;
+
     // Compute the offset origin, edges, and normal.
 
     // from http://www.geometrictools.com/GTEngine/Include/Mathematics/GteIntrRay3Triangle3.h
@@ -5,15 +5,6 @@
 
 using namespace threepp;
 
-namespace {
-
-    Vector3 _v0{};
-    Vector3 _v1{};
-    Vector3 _v2{};
-    Vector3 _v3{};
-
-}// namespace
-
 Triangle::Triangle(Vector3 a, Vector3 b, Vector3 c): a_(a), b_(b), c_(c) {}
 
 const Vector3& Triangle::a() const {
@@ -31,6 +22,8 @@ const Vector3& Triangle::c() const {
 
 void Triangle::getNormal(const Vector3& a, const Vector3& b, const Vector3& c, Vector3& target) {
 
+    Vector3 _v0;
+
     target.subVectors(c, b);
     _v0.subVectors(a, b);
     target.cross(_v0);
@@ -48,6 +41,10 @@ void Triangle::getNormal(const Vector3& a, const Vector3& b, const Vector3& c, V
 
 void Triangle::getBarycoord(const Vector3& point, const Vector3& a, const Vector3& b, const Vector3& c, Vector3& target) {
 
+    Vector3 _v0;
+    Vector3 _v1;
+    Vector3 _v2;
+
     _v0.subVectors(c, a);
     _v1.subVectors(b, a);
     _v2.subVectors(point, a);
@@ -80,6 +77,8 @@ void Triangle::getBarycoord(const Vector3& point, const Vector3& a, const Vector
 
 bool Triangle::containsPoint(const Vector3& point, const Vector3& a, const Vector3& b, const Vector3& c) {
 
+    Vector3 _v3;
+
     getBarycoord(point, a, b, c, _v3);
 
     return (_v3.x >= 0) && (_v3.y >= 0) && ((_v3.x + _v3.y) <= 1);
@@ -87,6 +86,8 @@ bool Triangle::containsPoint(const Vector3& point, const Vector3& a, const Vecto
 
 void Triangle::getUV(const Vector3& point, const Vector3& p1, const Vector3& p2, const Vector3& p3, const Vector2& uv1, const Vector2& uv2, const Vector2& uv3, Vector2& target) {
 
+    Vector3 _v3;
+
     getBarycoord(point, p1, p2, p3, _v3);
 
     target.set(0, 0);
@@ -97,6 +98,9 @@ void Triangle::getUV(const Vector3& point, const Vector3& p1, const Vector3& p2,
 
 bool Triangle::isFrontFacing(const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& direction) {
 
+    Vector3 _v0;
+    Vector3 _v1;
+
     _v0.subVectors(c, b);
     _v1.subVectors(a, b);
 
@@ -115,6 +119,9 @@ Triangle& Triangle::set(const Vector3& a, const Vector3& b, const Vector3& c) {
 
 float Triangle::getArea() const {
 
+    Vector3 _v0;
+    Vector3 _v1;
+
     _v0.subVectors(this->c_, this->b_);
     _v1.subVectors(this->a_, this->b_);
 
@@ -156,12 +163,12 @@ void Triangle::closestPointToPoint(const Vector3& p, Vector3& target) {
     const auto a = this->a_, b = this->b_, c = this->c_;
     float v, w;
 
-    static Vector3 _vab{};
-    static Vector3 _vac{};
-    static Vector3 _vap{};
-    static Vector3 _vbp{};
-    static Vector3 _vcp{};
-    static Vector3 _vbc{};
+    Vector3 _vab;
+    Vector3 _vac;
+    Vector3 _vap;
+    Vector3 _vbp;
+    Vector3 _vcp;
+    Vector3 _vbc;
 
 
     // algorithm thanks to Real-Time Collision Detection by Christer Ericson,
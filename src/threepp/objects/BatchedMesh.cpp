@@ -0,0 +1,335 @@
+
+#include "threepp/objects/BatchedMesh.hpp"
+
+#include "threepp/core/Raycaster.hpp"
+#include "threepp/math/MathUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace threepp;
+
+namespace {
+
+    const std::string batchIdName = "batchId";
+
+}// namespace
+
+BatchedMesh::BatchedMesh(size_t maxGeometryCount, size_t maxVertexCount, size_t maxIndexCount, std::shared_ptr<Material> material)
+    : Mesh(BufferGeometry::create(), std::move(material)),
+      maxGeometryCount_(maxGeometryCount), maxVertexCount_(maxVertexCount), maxIndexCount_(maxIndexCount) {
+
+    addTag(Tag::BatchedMesh);
+
+    // layout (1 matrix = 4 pixels), same as Skeleton::computeBoneTexture
+    auto size = static_cast<int>(math::ceilPowerOfTwo(std::sqrt(static_cast<float>(maxGeometryCount * 4))));
+    size = std::max(size, 4);
+
+    std::vector<float> matrices(size * size * 4);
+    Matrix4 identity;
+    for (size_t i = 0; i < maxGeometryCount; i++) {
+        identity.toArray(matrices, i * 16);
+    }
+
+    matricesTexture_ = DataTexture::create(matrices, size, size);
+    matricesTexture_->format = Format::RGBA;
+    matricesTexture_->type = Type::Float;
+}
+
+std::string BatchedMesh::type() const {
+
+    return "BatchedMesh";
+}
+
+size_t BatchedMesh::maxGeometryCount() const {
+
+    return maxGeometryCount_;
+}
+
+size_t BatchedMesh::geometryCount() const {
+
+    return ranges_.size();
+}
+
+void BatchedMesh::validateGeometry(const BufferGeometry& geometry) const {
+
+    if (ranges_.size() >= maxGeometryCount_) {
+        throw std::runtime_error("THREE.BatchedMesh: Maximum geometry count reached.");
+    }
+
+    for (const auto& [name, attribute] : geometry.getAttributes()) {
+
+        if (!dynamic_cast<const FloatBufferAttribute*>(attribute.get())) {
+            throw std::runtime_error("THREE.BatchedMesh: Only float attributes are supported ('" + name + "').");
+        }
+    }
+
+    const auto position = geometry.getAttribute<float>("position");
+    if (!position) {
+        throw std::runtime_error("THREE.BatchedMesh: Added geometry has no position attribute.");
+    }
+
+    if (initialized_) {
+
+        const auto& attributes = geometry_->getAttributes();
+        if (attributes.size() != geometry.getAttributes().size() + 1) {
+            throw std::runtime_error("THREE.BatchedMesh: Added geometry has a different set of attributes than the batched geometry.");
+        }
+
+        for (const auto& [name, attribute] : attributes) {
+
+            if (name == batchIdName) continue;
+
+            const auto src = geometry.getAttribute<float>(name);
+            if (!src || src->itemSize() != attribute->itemSize()) {
+                throw std::runtime_error("THREE.BatchedMesh: Added geometry attribute '" + name + "' does not match the batched geometry.");
+            }
+        }
+
+        if (geometry.hasIndex() != geometry_->hasIndex()) {
+            throw std::runtime_error("THREE.BatchedMesh: All geometries must consistently have an index or not.");
+        }
+    }
+
+    const int vertexCount = position->count();
+    const int indexCount = geometry.hasIndex() ? geometry.getIndex()->count() : vertexCount;
+
+    if (nextVertexStart_ + vertexCount > static_cast<int>(maxVertexCount_) ||
+        (geometry.hasIndex() && nextIndexStart_ + indexCount > static_cast<int>(maxIndexCount_))) {
+        throw std::runtime_error("THREE.BatchedMesh: Reserved space not large enough for provided geometry.");
+    }
+}
+
+void BatchedMesh::initializeGeometry(const BufferGeometry& reference) {
+
+    for (const auto& [name, attribute] : reference.getAttributes()) {
+
+        const auto itemSize = attribute->itemSize();
+        geometry_->setAttribute(name, FloatBufferAttribute::create(std::vector<float>(maxVertexCount_ * itemSize), itemSize, attribute->normalized()));
+    }
+
+    geometry_->setAttribute(batchIdName, FloatBufferAttribute::create(std::vector<float>(maxVertexCount_), 1));
+
+    if (reference.hasIndex()) {
+
+        geometry_->setIndex(std::vector<unsigned int>(maxIndexCount_));
+    }
+
+    initialized_ = true;
+}
+
+size_t BatchedMesh::addGeometry(const BufferGeometry& geometry) {
+
+    // everything is checked before the first write, so a geometry that is rejected leaves the mesh unchanged
+    validateGeometry(geometry);
+
+    if (!initialized_) initializeGeometry(geometry);
+
+    const auto position = geometry.getAttribute<float>("position");
+    const int vertexCount = position->count();
+    const int indexCount = geometry.hasIndex() ? geometry.getIndex()->count() : vertexCount;
+
+    // copy
+
+    const auto id = ranges_.size();
+    const auto& attributes = geometry_->getAttributes();
+
+    Range range{nextVertexStart_, vertexCount, geometry.hasIndex() ? nextIndexStart_ : nextVertexStart_, indexCount};
+
+    position->setFromBufferAttribute(range.box);
+    range.box.getCenter(range.sphere.center);
+
+    float maxRadiusSq = 0;
+    Vector3 v;
+    for (int i = 0; i < vertexCount; i++) {
+
+        position->setFromBufferAttribute(v, i);
+        maxRadiusSq = std::max(maxRadiusSq, range.sphere.center.distanceToSquared(v));
+    }
+    range.sphere.radius = std::sqrt(maxRadiusSq);
+
+    for (const auto& [name, attribute] : attributes) {
+
+        auto dst = dynamic_cast<FloatBufferAttribute*>(attribute.get());
+        auto& dstArray = dst->array();
+
+        if (name == batchIdName) {
+
+            std::fill_n(dstArray.begin() + range.vertexStart, vertexCount, static_cast<float>(id));
+
+        } else {
+
+            const auto src = geometry.getAttribute<float>(name);
+            const auto& srcArray = src->array();
+            std::copy_n(srcArray.begin(), vertexCount * src->itemSize(), dstArray.begin() + range.vertexStart * dst->itemSize());
+        }
+
+        dst->needsUpdate();
+    }
+
+    if (geometry.hasIndex()) {
+
+        // indices are made absolute, so that every geometry can be drawn from the shared vertex buffer
+        const auto& srcIndex = geometry.getIndex()->array();
+        auto& dstIndex = geometry_->getIndex()->array();
+        for (int i = 0; i < indexCount; i++) {
+            dstIndex[range.indexStart + i] = srcIndex[i] + range.vertexStart;
+        }
+
+        geometry_->getIndex()->needsUpdate();
+
+        nextIndexStart_ += indexCount;
+    }
+
+    nextVertexStart_ += vertexCount;
+
+    geometry_->boundingBox = std::nullopt;
+    geometry_->boundingSphere = std::nullopt;
+
+    ranges_.emplace_back(range);
+    resetBounds();
+
+    return id;
+}
+
+void BatchedMesh::deleteGeometry(size_t id) {
+
+    ranges_.at(id).active = false;
+    resetBounds();
+}
+
+void BatchedMesh::setMatrixAt(size_t id, const Matrix4& matrix) {
+
+    range(id);
+
+    matrix.toArray(matricesTexture_->image.front().data<float>(), id * 16);
+    matricesTexture_->needsUpdate();
+
+    resetBounds();
+}
+
+void BatchedMesh::getMatrixAt(size_t id, Matrix4& matrix) const {
+
+    range(id);
+
+    matrix.fromArray(matricesTexture_->image.front().data<float>(), id * 16);
+}
+
+void BatchedMesh::setVisibleAt(size_t id, bool visible) {
+
+    ranges_.at(id).visible = visible;
+    resetBounds();
+}
+
+bool BatchedMesh::getVisibleAt(size_t id) const {
+
+    return range(id).visible;
+}
+
+void BatchedMesh::computeBoundingBox() {
+
+    if (!boundingBox) boundingBox = Box3();
+    boundingBox->makeEmpty();
+
+    Matrix4 matrix;
+    Box3 box;
+    for (size_t id = 0; id < ranges_.size(); id++) {
+
+        const auto& range = ranges_[id];
+        if (!range.active || !range.visible) continue;
+
+        getMatrixAt(id, matrix);
+        boundingBox->union_(box.copy(range.box).applyMatrix4(matrix));
+    }
+}
+
+void BatchedMesh::computeBoundingSphere() {
+
+    if (!boundingSphere) boundingSphere = Sphere();
+    boundingSphere->makeEmpty();
+
+    Matrix4 matrix;
+    Sphere sphere;
+    for (size_t id = 0; id < ranges_.size(); id++) {
+
+        const auto& range = ranges_[id];
+        if (!range.active || !range.visible) continue;
+
+        getMatrixAt(id, matrix);
+        sphere.copy(range.sphere).applyMatrix4(matrix);
+
+        // a union with an empty sphere would enclose its center too
+        if (boundingSphere->isEmpty()) {
+
+            boundingSphere->copy(sphere);
+
+        } else {
+
+            boundingSphere->union_(sphere);
+        }
+    }
+}
+
+void BatchedMesh::resetBounds() {
+
+    boundingBox = std::nullopt;
+    boundingSphere = std::nullopt;
+}
+
+DataTexture* BatchedMesh::matricesTexture() const {
+
+    return matricesTexture_.get();
+}
+
+void BatchedMesh::getDrawRanges(std::vector<int>& starts, std::vector<int>& counts) const {
+
+    starts.clear();
+    counts.clear();
+
+    for (const auto& range : ranges_) {
+
+        if (!range.active || !range.visible) continue;
+
+        starts.emplace_back(range.indexStart);
+        counts.emplace_back(range.indexCount);
+    }
+}
+
+void BatchedMesh::raycast(const Raycaster& raycaster, std::vector<Intersection>& intersects) {
+
+    if (!material()) return;
+
+    Matrix4 instanceMatrix;
+    Matrix4 instanceWorldMatrix;
+
+    for (size_t id = 0; id < ranges_.size(); id++) {
+
+        const auto& range = ranges_[id];
+        if (!range.active || !range.visible) continue;
+
+        // raycast the index range of this single geometry
+
+        getMatrixAt(id, instanceMatrix);
+        instanceWorldMatrix.multiplyMatrices(*matrixWorld, instanceMatrix);
+
+        const auto first = intersects.size();
+
+        raycastGeometry(raycaster, instanceWorldMatrix, {range.indexStart, range.indexCount}, intersects);
+
+        for (auto i = first; i < intersects.size(); i++) {
+
+            intersects[i].instanceId = static_cast<int>(id);
+        }
+    }
+}
+
+const BatchedMesh::Range& BatchedMesh::range(size_t id) const {
+
+    return ranges_.at(id);
+}
+
+std::shared_ptr<BatchedMesh> BatchedMesh::create(size_t maxGeometryCount, size_t maxVertexCount, size_t maxIndexCount, std::shared_ptr<Material> material) {
+
+    return std::make_shared<BatchedMesh>(maxGeometryCount, maxVertexCount, maxIndexCount, std::move(material));
+}
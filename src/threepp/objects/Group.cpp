@@ -5,6 +5,11 @@
 
 using namespace threepp;
 
+Group::Group() {
+
+    addTag(Tag::Group);
+}
+
 std::string Group::type() const {
 
     return "Group";
@@ -3,8 +3,55 @@
 
 #include "threepp/core/Raycaster.hpp"
 
+#include "threepp/utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
 using namespace threepp;
 
+namespace {
+
+    // fewer instances are culled on the calling thread
+    constexpr size_t minParallelInstances = 16384;
+
+    std::mutex poolMutex;
+
+    // shared by all instanced meshes, callers hold poolMutex as the pool runs one job at a time
+    utils::ThreadPool& cullingPool(size_t numThreads) {
+
+        static std::unique_ptr<utils::ThreadPool> pool;
+
+        if (!pool || pool->size() != numThreads) {
+
+            pool = std::make_unique<utils::ThreadPool>(numThreads);
+        }
+
+        return *pool;
+    }
+
+    // calls fn(begin, end, chunk) for numChunks consecutive ranges covering [0, count)
+    void forEachChunk(utils::ThreadPool* pool, size_t count, size_t numChunks, const std::function<void(size_t, size_t, size_t)>& fn) {
+
+        const auto chunkSize = (count + numChunks - 1) / numChunks;
+        auto chunk = [&](size_t i) {
+            fn(std::min(count, i * chunkSize), std::min(count, (i + 1) * chunkSize), i);
+        };
+
+        if (pool) {
+
+            pool->parallelFor(numChunks, chunk);
+
+        } else {
+
+            for (size_t i = 0; i < numChunks; i++) chunk(i);
+        }
+    }
+
+}// namespace
+
 
 InstancedMesh::InstancedMesh(
         std::shared_ptr<BufferGeometry> geometry,
@@ -13,6 +60,8 @@ InstancedMesh::InstancedMesh(
     : Mesh(std::move(geometry), std::move(material)),
       count_(count), maxCount_(count), instanceMatrix_(FloatBufferAttribute::create(std::vector<float>(count * 16), 16)) {
 
+    addTag(Tag::InstancedMesh);
+
     Matrix4 identity;
     for (unsigned i = 0; i < count; i++) {
 
@@ -81,39 +130,99 @@ void InstancedMesh::dispose() {
 
 void InstancedMesh::raycast(const Raycaster& raycaster, std::vector<Intersection>& intersects) {
 
-    const auto& matrixWorld = this->matrixWorld;
-    const auto raycastTimes = this->count_;
+    if (!material() || count_ == 0) return;
 
-    _mesh.setGeometry(geometry_);
-    _mesh.setMaterials(materials_);
+    const auto& tree = instanceBoundsTree();
 
-    if (!_mesh.material()) return;
+    // the tree is in object space, like the instance matrices
+    Matrix4 inverseMatrix;
+    inverseMatrix.copy(*matrixWorld).invert();
 
-    for (int instanceId = 0; instanceId < raycastTimes; instanceId++) {
+    Ray ray;
+    ray.copy(raycaster.ray).applyMatrix4(inverseMatrix);
 
-        // calculate the world matrix for each instance
+    // near and far are world distances, they are applied by the exact test below
+    std::vector<size_t> candidates;
+    tree.raycast(ray, 0, std::numeric_limits<float>::infinity(), 0, [&](int proxy) {
+        candidates.emplace_back(proxyInstances_[proxy]);
+    });
 
-        this->getMatrixAt(instanceId, _instanceLocalMatrix);
+    // in instance order, like testing every instance
+    std::sort(candidates.begin(), candidates.end());
+
+    Matrix4 instanceLocalMatrix;
+    Matrix4 instanceWorldMatrix;
+
+    for (const auto instanceId : candidates) {
+
+        // calculate the world matrix for each instance
 
-        _instanceWorldMatrix.multiplyMatrices(*matrixWorld, _instanceLocalMatrix);
+        this->getMatrixAt(instanceId, instanceLocalMatrix);
 
-        // the mesh represents this single instance
+        instanceWorldMatrix.multiplyMatrices(*matrixWorld, instanceLocalMatrix);
 
-        _mesh.matrixWorld->copy(_instanceWorldMatrix);
+        // raycast the geometry as this single instance
 
-        _mesh.raycast(raycaster, _instanceIntersects);
+        const auto first = intersects.size();
 
-        // process the result of raycast
+        raycastGeometry(raycaster, instanceWorldMatrix, geometry_->drawRange, intersects);
 
-        for (auto& intersect : _instanceIntersects) {
+        for (auto i = first; i < intersects.size(); i++) {
 
-            intersect.instanceId = instanceId;
-            intersect.object = this;
-            intersects.emplace_back(intersect);
+            intersects[i].instanceId = static_cast<int>(instanceId);
         }
+    }
+}
+
+const DynamicAABBTree& InstancedMesh::instanceBoundsTree() {
+
+    const auto geometry = this->geometry();
+
+    if (!geometry->boundingBox) geometry->computeBoundingBox();
+
+    const auto& source = *geometry->boundingBox;
+
+    const bool rebuild = !instanceTree_ || instanceProxies_.size() != count_ ||
+                         !instanceTreeSource_ || !instanceTreeSource_->equals(source);
+
+    if (!rebuild && instanceTreeVersion_ == instanceMatrix_->version) return *instanceTree_;
 
-        _instanceIntersects.clear();
+    if (rebuild) {
+
+        instanceTree_ = std::make_unique<DynamicAABBTree>();
+        instanceProxies_.assign(count_, DynamicAABBTree::nullNode);
+        proxyInstances_.clear();
+        instanceTreeSource_ = source;
+    }
+
+    instanceTreeVersion_ = instanceMatrix_->version;
+
+    // a geometry without positions is never hit
+    if (source.isEmpty()) return *instanceTree_;
+
+    Matrix4 matrix;
+    Box3 box;
+    for (size_t i = 0; i < count_; i++) {
+
+        getMatrixAt(i, matrix);
+        box.copy(source).applyMatrix4(matrix);
+
+        if (rebuild) {
+
+            const auto proxy = instanceTree_->insert(box);
+            if (proxyInstances_.size() <= static_cast<size_t>(proxy)) proxyInstances_.resize(proxy + 1);
+
+            instanceProxies_[i] = proxy;
+            proxyInstances_[proxy] = i;
+
+        } else {
+
+            // the tree only changes for instances that left their fat box, proxies keep their id
+            instanceTree_->move(instanceProxies_[i], box);
+        }
     }
+
+    return *instanceTree_;
 }
 
 InstancedMesh::~InstancedMesh() {
@@ -181,3 +290,232 @@ void InstancedMesh::computeBoundingSphere() {
         this->boundingSphere->union_(_sphere);
     }
 }
+
+size_t InstancedMesh::cullInstances(const Frustum& frustum, unsigned int numThreads) {
+
+    return cull(frustum, nullptr, 0, numThreads);
+}
+
+size_t InstancedMesh::cullInstances(const Frustum& frustum, const Camera& camera, unsigned int viewport, unsigned int numThreads) {
+
+    return cull(frustum, &camera, viewport, numThreads);
+}
+
+size_t InstancedMesh::cull(const Frustum& frustum, const Camera* camera, unsigned int viewport, unsigned int numThreads) {
+
+    const auto geometry = this->geometry();
+
+    if (!geometry->boundingSphere) geometry->computeBoundingSphere();
+
+    const auto& source = *geometry->boundingSphere;
+
+    const bool spheresOutdated = instanceSpheres_.size() != count_ * 4 || instanceSpheresVersion_ != instanceMatrix_->version ||
+                                 !instanceSpheresSource_ || !instanceSpheresSource_->equals(source);
+
+    if (spheresOutdated) {
+
+        for (auto& view : cullViews_) view.inputs.reset();
+    }
+
+    auto view = std::find_if(cullViews_.begin(), cullViews_.end(), [&](const CullView& other) {
+        return other.camera == camera && other.viewport == viewport;
+    });
+
+    if (view == cullViews_.end()) {
+
+        if (cullViews_.size() < maxCullViews) {
+
+            view = cullViews_.emplace(cullViews_.end());
+
+        } else {
+
+            // keeps the attributes, they may have GPU buffers
+            view = std::min_element(cullViews_.begin(), cullViews_.end(), [](const CullView& a, const CullView& b) {
+                return a.lastUse < b.lastUse;
+            });
+        }
+
+        view->camera = camera;
+        view->viewport = viewport;
+        view->inputs.reset();
+    }
+
+    view->lastUse = ++cullUses_;
+    cullView_ = view - cullViews_.begin();
+
+    CullInputs inputs;
+    for (size_t i = 0; i < 6; i++) {
+
+        const auto& plane = frustum.planes()[i];
+        plane.normal.toArray(inputs.planes, i * 4);
+        inputs.planes[i * 4 + 3] = plane.constant;
+    }
+    inputs.matrixWorld = matrixWorld->elements;
+    inputs.count = count_;
+    inputs.matrixVersion = instanceMatrix_->version;
+    inputs.colors = instanceColor_ != nullptr;
+    inputs.colorVersion = instanceColor_ ? instanceColor_->version : 0;
+
+    if (view->inputs == inputs) return view->visibleCount;
+
+    view->inputs = inputs;
+
+    // the planes in object space, where the instance spheres are.
+    // With the world matrix [A | t], n.(Ap + t) + d = (A^T n).p + (n.t + d)
+    const auto& e = matrixWorld->elements;
+    std::array<float, 24> planes{};
+    bool cull = true;
+    for (size_t i = 0; i < 6; i++) {
+
+        const auto n = inputs.planes.data() + i * 4;
+        auto p = planes.data() + i * 4;
+
+        p[0] = e[0] * n[0] + e[1] * n[1] + e[2] * n[2];
+        p[1] = e[4] * n[0] + e[5] * n[1] + e[6] * n[2];
+        p[2] = e[8] * n[0] + e[9] * n[1] + e[10] * n[2];
+        p[3] = e[12] * n[0] + e[13] * n[1] + e[14] * n[2] + n[3];
+
+        const auto length = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+        if (length == 0) {
+
+            cull = false;
+            break;
+        }
+
+        for (int j = 0; j < 4; j++) p[j] /= length;
+    }
+
+    const auto count = count_;
+
+    std::unique_lock<std::mutex> lck(poolMutex, std::defer_lock);
+    utils::ThreadPool* pool = nullptr;
+    if (count >= minParallelInstances) {
+
+        lck.lock();
+        pool = &cullingPool(numThreads == 0 ? utils::ThreadPool::defaultNumThreads() : numThreads);
+        if (pool->size() == 1) pool = nullptr;
+    }
+
+    const auto numChunks = pool ? pool->size() * 4 : 1;
+
+    if (spheresOutdated) {
+
+        instanceSpheres_.resize(count * 4);
+        instanceSpheresVersion_ = instanceMatrix_->version;
+        instanceSpheresSource_ = source;
+
+        forEachChunk(pool, count, numChunks, [&](size_t begin, size_t end, size_t) {
+            Matrix4 matrix;
+            Sphere sphere;
+
+            for (auto i = begin; i < end; i++) {
+
+                getMatrixAt(i, matrix);
+                sphere.copy(source).applyMatrix4(matrix);
+
+                sphere.center.toArray(instanceSpheres_, i * 4);
+                instanceSpheres_[i * 4 + 3] = sphere.radius;
+            }
+        });
+    }
+
+    // test every instance, counting the visible ones per chunk
+    std::vector<unsigned char> visible(count);
+    std::vector<size_t> offsets(numChunks + 1);
+
+    forEachChunk(pool, count, numChunks, [&](size_t begin, size_t end, size_t chunk) {
+        size_t numVisible = 0;
+
+        for (auto i = begin; i < end; i++) {
+
+            const auto sphere = instanceSpheres_.data() + i * 4;
+
+            bool inside = true;
+            for (size_t j = 0; cull && j < 6 && inside; j++) {
+
+                const auto p = planes.data() + j * 4;
+                inside = p[0] * sphere[0] + p[1] * sphere[1] + p[2] * sphere[2] + p[3] >= -sphere[3];
+            }
+
+            visible[i] = inside;
+            numVisible += inside;
+        }
+
+        offsets[chunk + 1] = numVisible;
+    });
+
+    for (size_t i = 0; i < numChunks; i++) offsets[i + 1] += offsets[i];
+
+    view->visibleCount = offsets.back();
+
+    // compact the visible instances, keeping their order
+    if (!view->matrices) {
+
+        view->matrices = FloatBufferAttribute::create(std::vector<float>(), 16);
+        view->matrices->setUsage(DrawUsage::Dynamic);
+    }
+    if (instanceColor_ && !view->colors) {
+
+        view->colors = FloatBufferAttribute::create(std::vector<float>(), 3);
+        view->colors->setUsage(DrawUsage::Dynamic);
+    }
+
+    auto& matrices = view->matrices->array();
+    matrices.resize(view->visibleCount * 16);
+    const auto& sourceMatrices = instanceMatrix_->array();
+
+    auto colors = instanceColor_ ? &view->colors->array() : nullptr;
+    if (colors) colors->resize(view->visibleCount * 3);
+
+    forEachChunk(pool, count, numChunks, [&](size_t begin, size_t end, size_t chunk) {
+        auto offset = offsets[chunk];
+
+        for (auto i = begin; i < end; i++) {
+
+            if (!visible[i]) continue;
+
+            std::copy_n(sourceMatrices.begin() + static_cast<std::ptrdiff_t>(i * 16), 16, matrices.begin() + static_cast<std::ptrdiff_t>(offset * 16));
+            if (colors) std::copy_n(instanceColor_->array().begin() + static_cast<std::ptrdiff_t>(i * 3), 3, colors->begin() + static_cast<std::ptrdiff_t>(offset * 3));
+
+            ++offset;
+        }
+    });
+
+    view->matrices->needsUpdate();
+    if (colors) view->colors->needsUpdate();
+
+    return view->visibleCount;
+}
+
+size_t InstancedMesh::visibleCount() const {
+
+    return cullViews_.empty() ? 0 : cullViews_[cullView_].visibleCount;
+}
+
+FloatBufferAttribute* InstancedMesh::visibleInstanceMatrix() const {
+
+    return cullViews_.empty() ? nullptr : cullViews_[cullView_].matrices.get();
+}
+
+FloatBufferAttribute* InstancedMesh::visibleInstanceColor() const {
+
+    return cullViews_.empty() ? nullptr : cullViews_[cullView_].colors.get();
+}
+
+std::vector<FloatBufferAttribute*> InstancedMesh::visibleInstanceAttributes() const {
+
+    std::vector<FloatBufferAttribute*> attributes;
+    for (const auto& view : cullViews_) {
+
+        if (view.matrices) attributes.emplace_back(view.matrices.get());
+        if (view.colors) attributes.emplace_back(view.colors.get());
+    }
+
+    return attributes;
+}
+
+bool InstancedMesh::CullInputs::operator==(const CullInputs& other) const {
+
+    return planes == other.planes && matrixWorld == other.matrixWorld && count == other.count &&
+           matrixVersion == other.matrixVersion && colors == other.colors && colorVersion == other.colorVersion;
+}
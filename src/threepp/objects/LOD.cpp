@@ -7,6 +7,11 @@
 
 using namespace threepp;
 
+LOD::LOD() {
+
+    addTag(Tag::LOD);
+}
+
 std::string LOD::type() const {
 
     return "LOD";
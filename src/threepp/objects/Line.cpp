@@ -9,18 +9,12 @@
 
 using namespace threepp;
 
-namespace {
-
-    Sphere _sphere;
-    Matrix4 _inverseMatrix;
-    Ray _ray;
-
-}// namespace
-
-
 Line::Line(std::shared_ptr<BufferGeometry> geometry, std::shared_ptr<Material> material)
     : geometry_(geometry ? std::move(geometry) : BufferGeometry::create()),
-      ObjectWithMaterials({material ? std::move(material) : LineBasicMaterial::create()}) {}
+      ObjectWithMaterials({material ? std::move(material) : LineBasicMaterial::create()}) {
+
+    addTag(Tag::Line);
+}
 
 std::string Line::type() const {
 
@@ -77,6 +71,10 @@ void Line::raycast(const Raycaster& raycaster, std::vector<Intersection>& inters
     auto threshold = raycaster.params.lineThreshold;
     auto drawRange = geometry->drawRange;
 
+    Sphere _sphere;
+    Matrix4 _inverseMatrix;
+    Ray _ray;
+
     // Checking boundingSphere distance to ray
 
     if (!geometry->boundingSphere) geometry->computeBoundingSphere();
@@ -9,7 +9,10 @@ using namespace threepp;
 LineLoop::LineLoop(
         const std::shared_ptr<BufferGeometry>& geometry,
         const std::shared_ptr<Material>& material)
-    : Line(geometry, material) {}
+    : Line(geometry, material) {
+
+    addTag(Tag::LineLoop);
+}
 
 
 std::string LineLoop::type() const {
@@ -5,12 +5,14 @@
 
 #include "threepp/core/Face3.hpp"
 #include "threepp/core/Raycaster.hpp"
+#include "threepp/core/TriangleBVH.hpp"
 
 #include "threepp/materials/MeshBasicMaterial.hpp"
 
 #include "threepp/math/Triangle.hpp"
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 
 
@@ -19,10 +21,10 @@ using namespace threepp;
 namespace {
 
     std::optional<Intersection> checkIntersection(
-            Object3D& object, Material& material, const Raycaster& raycaster, const Ray& ray,
+            Object3D& object, const Matrix4& matrixWorld, Material& material, const Raycaster& raycaster, const Ray& ray,
             const Vector3& pA, const Vector3& pB, const Vector3& pC, Vector3& point) {
 
-        static Vector3 _intersectionPointWorld{};
+        Vector3 _intersectionPointWorld;
 
         if (material.side == Side::Back) {
 
@@ -36,7 +38,7 @@ namespace {
         if (point.isNan()) return std::nullopt;
 
         _intersectionPointWorld.copy(point);
-        _intersectionPointWorld.applyMatrix4(*object.matrixWorld);
+        _intersectionPointWorld.applyMatrix4(matrixWorld);
 
         const auto distance = raycaster.ray.origin.distanceTo(_intersectionPointWorld);
 
@@ -51,7 +53,7 @@ namespace {
     }
 
     std::optional<Intersection> checkBufferGeometryIntersection(
-            Object3D& object, Material& material,
+            Object3D& object, const Matrix4& matrixWorld, Material& material,
             const Raycaster& raycaster, const Ray& ray,
             const FloatBufferAttribute& position,
             const std::vector<std::shared_ptr<BufferAttribute>>* morphPosition,
@@ -60,10 +62,10 @@ namespace {
             const FloatBufferAttribute* uv2,
             unsigned int a, unsigned int b, unsigned int c) {
 
-        static Vector3 _vA{};
-        static Vector3 _vB{};
-        static Vector3 _vC{};
-        static Vector3 _intersectionPoint{};
+        Vector3 _vA;
+        Vector3 _vB;
+        Vector3 _vC;
+        Vector3 _intersectionPoint;
 
         position.setFromBufferAttribute(_vA, a);
         position.setFromBufferAttribute(_vB, b);
@@ -129,13 +131,13 @@ namespace {
             skinned->boneTransform(c, _vC);
         }
 
-        auto intersection = checkIntersection(object, material, raycaster, ray, _vA, _vB, _vC, _intersectionPoint);
+        auto intersection = checkIntersection(object, matrixWorld, material, raycaster, ray, _vA, _vB, _vC, _intersectionPoint);
 
         if (intersection) {
 
-            static Vector2 _uvA{};
-            static Vector2 _uvB{};
-            static Vector2 _uvC{};
+            Vector2 _uvA;
+            Vector2 _uvB;
+            Vector2 _uvC;
 
             if (uv) {
 
@@ -169,37 +171,126 @@ namespace {
         return intersection;
     }
 
+    // same tests as the loops in Mesh::raycast, restricted to the triangles near the ray
+    void raycastBoundsTree(Mesh& mesh, const Matrix4& matrixWorld, const DrawRange& drawRange,
+                           const Raycaster& raycaster, const Ray& ray, std::vector<Intersection>& intersects) {
+
+        auto& geometry = *mesh.geometry();
+
+        const auto bvh = geometry.boundsTree();
+        const auto index = geometry.getIndex();
+        const auto& position = *geometry.getAttribute<float>("position");
+        const auto uv = geometry.getAttribute<float>("uv");
+        const auto uv2 = geometry.getAttribute<float>("uv2");
+        const auto& groups = geometry.groups;
+        const auto& materials = mesh.materials();
+
+        // distances along the local ray are proportional to world distances
+        Vector3 origin(ray.origin);
+        Vector3 end;
+        ray.at(1, end);
+        const auto worldPerLocal = origin.applyMatrix4(matrixWorld).distanceTo(end.applyMatrix4(matrixWorld));
+
+        const auto infinity = std::numeric_limits<float>::infinity();
+        const auto far = worldPerLocal > 0 ? raycaster.far / worldPerLocal : infinity;
+
+        const int count = index ? index->count() : position.count();
+
+        auto inRange = [](int j, int start, int end) {
+            return j >= start && j < end && (j - start) % 3 == 0;
+        };
+
+        float closest = infinity;
+
+        bvh->raycast(ray, far, [&](int triangle) {
+            const auto j = triangle * 3;
+            const auto a = index ? index->getX(j) : j;
+            const auto b = index ? index->getX(j + 1) : j + 1;
+            const auto c = index ? index->getX(j + 2) : j + 2;
+
+            if (materials.size() > 1) {
+
+                for (const auto& group : groups) {
+
+                    const auto start = std::max(group.start, drawRange.start);
+                    const auto end = std::min((group.start + group.count), (drawRange.start + drawRange.count));
+
+                    if (!inRange(j, start, end)) continue;
+
+                    auto intersection = checkBufferGeometryIntersection(
+                            mesh, matrixWorld, *materials[group.materialIndex], raycaster, ray, position,
+                            nullptr, false, uv, uv2, a, b, c);
+
+                    if (intersection) {
+
+                        intersection->faceIndex = triangle;
+                        intersection->face->materialIndex = group.materialIndex;
+                        closest = std::min(closest, intersection->distance);
+                        intersects.emplace_back(*intersection);
+                    }
+                }
+
+            } else if (inRange(j, std::max(0, drawRange.start), std::min(count, (drawRange.start + drawRange.count)))) {
+
+                auto intersection = checkBufferGeometryIntersection(
+                        mesh, matrixWorld, *materials.front(), raycaster, ray, position,
+                        nullptr, false, uv, uv2, a, b, c);
+
+                if (intersection) {
+
+                    intersection->faceIndex = triangle;
+                    closest = std::min(closest, intersection->distance);
+                    intersects.emplace_back(*intersection);
+                }
+            }
+
+            // with firstHitOnly, only closer triangles are of interest
+            return raycaster.firstHitOnly && worldPerLocal > 0 ? closest / worldPerLocal : infinity;
+        });
+    }
+
 }// namespace
 
 
 Mesh::Mesh(std::shared_ptr<BufferGeometry> geometry, std::shared_ptr<Material> material)
     : geometry_(geometry ? std::move(geometry) : BufferGeometry::create()),
-      ObjectWithMaterials({material ? std::move(material) : MeshBasicMaterial::create()}) {}
+      ObjectWithMaterials({material ? std::move(material) : MeshBasicMaterial::create()}) {
+
+    addTag(Tag::Mesh);
+}
 
 Mesh::Mesh(std::shared_ptr<BufferGeometry> geometry, std::vector<std::shared_ptr<Material>> materials)
-    : geometry_(std::move(geometry)), ObjectWithMaterials{std::move(materials)} {}
+    : geometry_(std::move(geometry)), ObjectWithMaterials{std::move(materials)} {
+
+    addTag(Tag::Mesh);
+}
 
 void Mesh::raycast(const Raycaster& raycaster, std::vector<Intersection>& intersects) {
 
+    raycastGeometry(raycaster, *matrixWorld, geometry_->drawRange, intersects);
+}
+
+void Mesh::raycastGeometry(const Raycaster& raycaster, const Matrix4& matrixWorld, const DrawRange& drawRange, std::vector<Intersection>& intersects) {
+
     if (material() == nullptr) return;
 
-    static Sphere _sphere{};
+    Sphere _sphere;
 
     // Checking boundingSphere distance to ray
 
     if (!geometry_->boundingSphere) geometry_->computeBoundingSphere();
 
     _sphere.copy(*geometry_->boundingSphere);
-    _sphere.applyMatrix4(*matrixWorld);
+    _sphere.applyMatrix4(matrixWorld);
 
     if (!raycaster.ray.intersectsSphere(_sphere)) return;
 
     //
 
-    static Ray _ray{};
-    static Matrix4 _inverseMatrix{};
+    Ray _ray;
+    Matrix4 _inverseMatrix;
 
-    _inverseMatrix.copy(*matrixWorld).invert();
+    _inverseMatrix.copy(matrixWorld).invert();
     _ray.copy(raycaster.ray).applyMatrix4(_inverseMatrix);
 
     // Check boundingBox before continuing
@@ -217,10 +308,19 @@ void Mesh::raycast(const Raycaster& raycaster, std::vector<Intersection>& inters
     const auto morphTargetsRelative = geometry_->morphTargetsRelative;
     const auto uv = geometry_->getAttribute<float>("uv");
     const auto uv2 = geometry_->getAttribute<float>("uv2");
-    const auto groups = geometry_->groups;
-    const auto drawRange = geometry_->drawRange;
+    const auto& groups = geometry_->groups;
+
+    // only float positions can be raycast, quantized ones are not decoded here
+    if (position == nullptr) return;
+
+    const auto first = intersects.size();
 
-    if (index != nullptr) {
+    // the hierarchy is built from the rest positions
+    if (geometry_->useBoundsTree && !morphPosition && !hasTag(Tag::SkinnedMesh)) {
+
+        raycastBoundsTree(*this, matrixWorld, drawRange, raycaster, _ray, intersects);
+
+    } else if (index != nullptr) {
 
         // indexed buffer geometry
 
@@ -240,7 +340,7 @@ void Mesh::raycast(const Raycaster& raycaster, std::vector<Intersection>& inters
                     const auto c = index->getX(j + 2);
 
                     intersection = checkBufferGeometryIntersection(
-                            *this, *groupMaterial, raycaster, _ray, *position,
+                            *this, matrixWorld, *groupMaterial, raycaster, _ray, *position,
                             morphPosition, morphTargetsRelative, uv, uv2, a, b, c);
 
                     if (intersection) {
@@ -264,7 +364,7 @@ void Mesh::raycast(const Raycaster& raycaster, std::vector<Intersection>& inters
                 const auto c = index->getX(i + 2);
 
                 intersection = checkBufferGeometryIntersection(
-                        *this, *material(), raycaster, _ray, *position,
+                        *this, matrixWorld, *material(), raycaster, _ray, *position,
                         morphPosition, morphTargetsRelative, uv, uv2, a, b, c);
 
                 if (intersection) {
@@ -295,7 +395,7 @@ void Mesh::raycast(const Raycaster& raycaster, std::vector<Intersection>& inters
                     const auto c = j + 2;
 
                     intersection = checkBufferGeometryIntersection(
-                            *this, *groupMaterial, raycaster, _ray, *position,
+                            *this, matrixWorld, *groupMaterial, raycaster, _ray, *position,
                             morphPosition, morphTargetsRelative, uv, uv2, a, b, c);
 
                     if (intersection) {
@@ -319,7 +419,7 @@ void Mesh::raycast(const Raycaster& raycaster, std::vector<Intersection>& inters
                 const int c = i + 2;
 
                 intersection = checkBufferGeometryIntersection(
-                        *this, *material(), raycaster, _ray, *position,
+                        *this, matrixWorld, *material(), raycaster, _ray, *position,
                         morphPosition, morphTargetsRelative, uv, uv2, a, b, c);
 
                 if (intersection) {
@@ -330,6 +430,15 @@ void Mesh::raycast(const Raycaster& raycaster, std::vector<Intersection>& inters
             }
         }
     }
+
+    if (raycaster.firstHitOnly && intersects.size() > first + 1) {
+
+        const auto closest = std::min_element(intersects.begin() + static_cast<std::ptrdiff_t>(first), intersects.end(), [](const auto& a, const auto& b) {
+            return a.distance < b.distance;
+        });
+        intersects[first] = *closest;
+        intersects.resize(first + 1);
+    }
 }
 
 std::string Mesh::type() const {
@@ -9,13 +9,9 @@ using namespace threepp;
 
 namespace {
 
-    Sphere _sphere;
-    Vector3 _position;
-    Matrix4 _inverseMatrix;
-    Ray _ray;
-
     void testPoint(
             const Vector3& point,
+            const Ray& localRay,
             unsigned int index,
             float localThresholdSq,
             const Matrix4& matrixWorld,
@@ -23,13 +19,13 @@ namespace {
             std::vector<Intersection>& intersects,
             Object3D* object) {
 
-        const auto rayPointDistanceSq = _ray.distanceSqToPoint(point);
+        const auto rayPointDistanceSq = localRay.distanceSqToPoint(point);
 
         if (rayPointDistanceSq < localThresholdSq) {
 
             Vector3 intersectPoint;
 
-            _ray.closestPointToPoint(point, intersectPoint);
+            localRay.closestPointToPoint(point, intersectPoint);
             intersectPoint.applyMatrix4(matrixWorld);
 
             const auto distance = raycaster.ray.origin.distanceTo(intersectPoint);
@@ -49,7 +45,10 @@ namespace {
 }// namespace
 
 Points::Points(std::shared_ptr<BufferGeometry> geometry, std::shared_ptr<Material> material)
-    : geometry_(std::move(geometry)), ObjectWithMaterials({std::move(material)}) {}
+    : geometry_(std::move(geometry)), ObjectWithMaterials({std::move(material)}) {
+
+    addTag(Tag::Points);
+}
 
 std::string Points::type() const {
 
@@ -77,6 +76,11 @@ void Points::raycast(const Raycaster& raycaster, std::vector<Intersection>& inte
     const auto threshold = raycaster.params.pointsThreshold;
     const auto drawRange = geometry->drawRange;
 
+    Sphere _sphere;
+    Vector3 _position;
+    Matrix4 _inverseMatrix;
+    Ray _ray;
+
     // Checking boundingSphere distance to ray
 
     if (!geometry->boundingSphere) geometry->computeBoundingSphere();
@@ -109,7 +113,7 @@ void Points::raycast(const Raycaster& raycaster, std::vector<Intersection>& inte
 
             positionAttribute->setFromBufferAttribute(_position, a);
 
-            testPoint(_position, a, localThresholdSq, *matrixWorld, raycaster, intersects, this);
+            testPoint(_position, _ray, a, localThresholdSq, *matrixWorld, raycaster, intersects, this);
         }
 
     } else {
@@ -121,7 +125,7 @@ void Points::raycast(const Raycaster& raycaster, std::vector<Intersection>& inte
 
             positionAttribute->setFromBufferAttribute(_position, i);
 
-            testPoint(_position, i, localThresholdSq, *matrixWorld, raycaster, intersects, this);
+            testPoint(_position, _ray, i, localThresholdSq, *matrixWorld, raycaster, intersects, this);
         }
     }
 }
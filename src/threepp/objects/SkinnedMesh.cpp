@@ -3,21 +3,11 @@
 
 using namespace threepp;
 
-namespace {
-
-    Vector3 _basePosition;
-
-    Vector4 _skinIndex;
-    Vector4 _skinWeight;
-
-    Vector3 _vector;
-    Matrix4 _matrix;
-
-}// namespace
-
-
 SkinnedMesh::SkinnedMesh(const std::shared_ptr<BufferGeometry>& geometry, const std::shared_ptr<Material>& material)
-    : Mesh(geometry, material) {}
+    : Mesh(geometry, material) {
+
+    addTag(Tag::SkinnedMesh);
+}
 
 
 std::string SkinnedMesh::type() const {
@@ -87,6 +77,12 @@ void SkinnedMesh::updateMatrixWorld(bool force) {
 
 void SkinnedMesh::boneTransform(size_t index, Vector3& target) {
 
+    Vector3 _basePosition;
+    Vector4 _skinIndex;
+    Vector4 _skinWeight;
+    Vector3 _vector;
+    Matrix4 _matrix;
+
     geometry_->getAttribute<int>("skinIndex")->setFromBufferAttribute(_skinIndex, index);
     geometry_->getAttribute<float>("skinWeight")->setFromBufferAttribute(_skinWeight, index);
 
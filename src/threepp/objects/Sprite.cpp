@@ -15,24 +15,11 @@ using namespace threepp;
 
 namespace {
 
-    Vector3 _intersectPoint;
-    Vector3 _worldScale;
-    Vector3 _mvPosition;
-
-    Vector2 _alignedPosition;
-    Vector2 _rotatedPosition;
-    Matrix4 _viewWorldMatrix;
-
-    Vector3 _vA;
-    Vector3 _vB;
-    Vector3 _vC;
-
-    Vector2 _uvA;
-    Vector2 _uvB;
-    Vector2 _uvC;
-
+    void transformVertex(Vector3& vertexPosition, const Vector3& mvPosition, const Vector2& center, const Vector3& scale,
+                         const std::optional<std::pair<float, float>>& sincos, const Matrix4& viewWorldMatrix) {
 
-    void transformVertex(Vector3& vertexPosition, const Vector3& mvPosition, const Vector2& center, const Vector3& scale, const std::optional<std::pair<float, float>>& sincos) {
+        Vector2 _alignedPosition;
+        Vector2 _rotatedPosition;
 
         // compute position in camera space
         _alignedPosition.subVectors(vertexPosition, center).addScalar(0.5f).multiply(scale);
@@ -57,7 +44,7 @@ namespace {
         vertexPosition.y += _rotatedPosition.y;
 
         // transform to world space
-        vertexPosition.applyMatrix4(_viewWorldMatrix);
+        vertexPosition.applyMatrix4(viewWorldMatrix);
     }
 }// namespace
 
@@ -66,6 +53,8 @@ Sprite::Sprite(const std::shared_ptr<SpriteMaterial>& material)
     : _material(material ? material : SpriteMaterial::create()),
       _geometry(BufferGeometry::create()) {
 
+    addTag(Tag::Sprite);
+
     std::vector<float> float32Array{
             -0.5f, -0.5f, 0.f, 0.f, 0.f,
             0.5f, -0.5f, 0.f, 1.f, 0.f,
@@ -74,8 +63,8 @@ Sprite::Sprite(const std::shared_ptr<SpriteMaterial>& material)
 
     auto interleavedBuffer = InterleavedBuffer::create(float32Array, 5);
     _geometry->setIndex(std::vector<int>{0, 1, 2, 0, 2, 3});
-    _geometry->setAttribute("position", std::make_unique<InterleavedBufferAttribute>(interleavedBuffer, 3, 0, false));
-    _geometry->setAttribute("uv", std::make_unique<InterleavedBufferAttribute>(interleavedBuffer, 3, 0, false));
+    _geometry->setAttribute("position", InterleavedBufferAttribute::create(interleavedBuffer, 3, 0));
+    _geometry->setAttribute("uv", InterleavedBufferAttribute::create(interleavedBuffer, 2, 3));
 }
 
 std::string Sprite::type() const {
@@ -110,12 +99,26 @@ void Sprite::raycast(const Raycaster& raycaster, std::vector<Intersection>& inte
         throw std::runtime_error("THREE.Sprite: 'Raycaster.camera' needs to be set in order to raycast against sprites.");
     }
 
+    Vector3 _intersectPoint;
+    Vector3 _worldScale;
+    Vector3 _mvPosition;
+
+    Vector3 _vA;
+    Vector3 _vB;
+    Vector3 _vC;
+
+    Vector2 _uvA;
+    Vector2 _uvB;
+    Vector2 _uvC;
+
     _worldScale.setFromMatrixScale(*this->matrixWorld);
 
-    _viewWorldMatrix.copy(*raycaster.camera->matrixWorld);
-    this->modelViewMatrix.multiplyMatrices(raycaster.camera->matrixWorldInverse, *this->matrixWorld);
+    // the renderer computes modelViewMatrix itself, a local keeps concurrent raycasts from writing to the sprite
+    const auto& _viewWorldMatrix = *raycaster.camera->matrixWorld;
+    Matrix4 _modelViewMatrix;
+    _modelViewMatrix.multiplyMatrices(raycaster.camera->matrixWorldInverse, *this->matrixWorld);
 
-    _mvPosition.setFromMatrixPosition(this->modelViewMatrix);
+    _mvPosition.setFromMatrixPosition(_modelViewMatrix);
 
     if (raycaster.camera->is<PerspectiveCamera>() && !this->_material->sizeAttenuation) {
 
@@ -129,9 +132,9 @@ void Sprite::raycast(const Raycaster& raycaster, std::vector<Intersection>& inte
         sincos = std::make_pair(std::sin(rotation), std::cos(rotation));
     }
 
-    transformVertex(_vA.set(-0.5f, -0.5f, 0.f), _mvPosition, center, _worldScale, sincos);
-    transformVertex(_vB.set(0.5f, -0.5f, 0.f), _mvPosition, center, _worldScale, sincos);
-    transformVertex(_vC.set(0.5f, 0.5f, 0.f), _mvPosition, center, _worldScale, sincos);
+    transformVertex(_vA.set(-0.5f, -0.5f, 0.f), _mvPosition, center, _worldScale, sincos, _viewWorldMatrix);
+    transformVertex(_vB.set(0.5f, -0.5f, 0.f), _mvPosition, center, _worldScale, sincos, _viewWorldMatrix);
+    transformVertex(_vC.set(0.5f, 0.5f, 0.f), _mvPosition, center, _worldScale, sincos, _viewWorldMatrix);
 
     _uvA.set(0, 0);
     _uvB.set(1, 0);
@@ -143,7 +146,7 @@ void Sprite::raycast(const Raycaster& raycaster, std::vector<Intersection>& inte
     if (!intersect) {
 
         // check second triangle
-        transformVertex(_vB.set(-0.5f, 0.5f, 0.f), _mvPosition, center, _worldScale, sincos);
+        transformVertex(_vB.set(-0.5f, 0.5f, 0.f), _mvPosition, center, _worldScale, sincos, _viewWorldMatrix);
         _uvB.set(0, 1);
 
         intersect = raycaster.ray.intersectTriangle(_vA, _vC, _vB, false, _intersectPoint);
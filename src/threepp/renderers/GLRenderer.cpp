@@ -4,6 +4,7 @@
 #include "threepp/renderers/GLRenderTarget.hpp"
 
 #include "threepp/renderers/gl/GLAttributes.hpp"
+#include "threepp/renderers/gl/GLAutoInstancing.hpp"
 #include "threepp/renderers/gl/GLBackground.hpp"
 #include "threepp/renderers/gl/GLBindingStates.hpp"
 #include "threepp/renderers/gl/GLBufferRenderer.hpp"
@@ -12,15 +13,19 @@
 #include "threepp/renderers/gl/GLMaterials.hpp"
 #include "threepp/renderers/gl/GLMorphTargets.hpp"
 #include "threepp/renderers/gl/GLObjects.hpp"
+#include "threepp/renderers/gl/GLOcclusionCulling.hpp"
 #include "threepp/renderers/gl/GLPrograms.hpp"
 #include "threepp/renderers/gl/GLRenderLists.hpp"
 #include "threepp/renderers/gl/GLRenderStates.hpp"
 #include "threepp/renderers/gl/GLTextures.hpp"
+#include "threepp/renderers/gl/GLTimerQueries.hpp"
+#include "threepp/renderers/gl/GLUniformBuffers.hpp"
 #include "threepp/renderers/gl/GLUtils.hpp"
 
 #include "threepp/cameras/OrthographicCamera.hpp"
 #include "threepp/materials/RawShaderMaterial.hpp"
 
+#include "threepp/objects/BatchedMesh.hpp"
 #include "threepp/objects/Group.hpp"
 #include "threepp/objects/InstancedMesh.hpp"
 #include "threepp/objects/LOD.hpp"
@@ -32,6 +37,7 @@
 #include "threepp/objects/Sprite.hpp"
 
 #include "threepp/utils/TaskManager.hpp"
+#include "threepp/utils/ThreadPool.hpp"
 
 #ifndef EMSCRIPTEN
 #include "threepp/utils/LoadGlad.hpp"
@@ -39,11 +45,25 @@
 #include <GLES3/gl32.h>
 #endif
 
+#include <chrono>
 #include <cmath>
 
 
 using namespace threepp;
 
+namespace {
+
+    // milliseconds elapsed since start, which then moves to now
+    double lap(std::chrono::steady_clock::time_point& start) {
+
+        const auto now = std::chrono::steady_clock::now();
+        const std::chrono::duration<double, std::milli> elapsed = now - start;
+        start = now;
+
+        return elapsed.count();
+    }
+
+}// namespace
 
 struct GLRenderer::Impl {
 
@@ -66,6 +86,9 @@ struct GLRenderer::Impl {
 
     GLRenderer& scope;
 
+    // before state, which reports to it
+    gl::GLInfo _info;
+
     gl::GLState state;
 
 
@@ -105,6 +128,9 @@ struct GLRenderer::Impl {
 
     Frustum _frustum;
 
+    // spatial index of the scene being projected, if it has one
+    SpatialIndex* spatialIndex = nullptr;
+
     // clipping
 
     bool _clippingEnabled = false;
@@ -116,8 +142,6 @@ struct GLRenderer::Impl {
 
     Vector3 _vector3;
 
-    gl::GLInfo _info;
-
     gl::GLProperties properties;
 
     gl::GLBindingStates bindingStates;
@@ -134,10 +158,18 @@ struct GLRenderer::Impl {
     gl::GLPrograms programCache;
     gl::GLCubeMaps cubemaps;
     gl::GLBackground background;
+    gl::GLUniformBuffers uniformBuffers;
+    gl::GLAutoInstancing autoInstancing;
+    gl::GLTimerQueries timerQueries;
+    gl::GLOcclusionCulling occlusionCulling;
 
     std::unique_ptr<gl::GLBufferRenderer> bufferRenderer;
     std::unique_ptr<gl::GLIndexedBufferRenderer> indexedBufferRenderer;
 
+    // draw ranges of the BatchedMesh being rendered
+    std::vector<int> batchStarts;
+    std::vector<int> batchCounts;
+
     gl::GLShadowMap shadowMap;
 
     // used for in-thread task execution
@@ -145,23 +177,26 @@ struct GLRenderer::Impl {
     utils::TaskManager taskManager;
 
     Impl(GLRenderer& scope, WindowSize size, const GLRenderer::Parameters& parameters)
-        : scope(scope), _size(size),
-          cubemaps(scope),
-          bufferRenderer(std::make_unique<gl::GLBufferRenderer>(_info)),
-          indexedBufferRenderer(std::make_unique<gl::GLIndexedBufferRenderer>(_info)),
-          clipping(properties),
+        : scope(scope), state(_info),
+          _emptyScene(std::make_unique<Scene>()),
+          onMaterialDispose(this),
+          _size(size),
+          _currentDrawBuffers(GL_BACK),
           bindingStates(attributes),
+          attributes(_info),
           geometries(attributes, _info, bindingStates),
+          clipping(properties),
           textures(state, properties, _info),
-          objects(geometries, attributes, _info),
-          renderLists(properties),
-          shadowMap(objects),
           materials(properties),
-          background(scope, cubemaps, state, objects, parameters.premultipliedAlpha),
+          renderLists(properties),
+          objects(geometries, attributes, _info),
           programCache(bindingStates, clipping),
-          _currentDrawBuffers(GL_BACK),
-          _emptyScene(std::make_unique<Scene>()),
-          onMaterialDispose(this) {
+          cubemaps(scope),
+          background(scope, cubemaps, state, objects, parameters.premultipliedAlpha),
+          occlusionCulling(state, bindingStates, _info),
+          bufferRenderer(std::make_unique<gl::GLBufferRenderer>(_info)),
+          indexedBufferRenderer(std::make_unique<gl::GLIndexedBufferRenderer>(_info)),
+          shadowMap(objects) {
 
         this->setViewport(0, 0, size.width, size.height);
         this->setScissor(0, 0, _size.width, _size.height);
@@ -206,16 +241,29 @@ struct GLRenderer::Impl {
 
         handleTasks();
 
+        // timer queries can not be nested
+        const bool outermost = renderStateStack.empty();
+        if (outermost && scope.gpuTiming) timerQueries.begin();
+
+        // before projection and the shadow pass, so the counters cover their uploads and state changes too.
+        // Draws of the shadow pass go to shadowCalls, so calls and triangles count the scene only, as in three.js
+        if (outermost && this->_info.autoReset) this->_info.reset();
+
+        gl::TimingInfo timing;
+        auto time = std::chrono::steady_clock::now();
+
         // update scene graph
 
-        if (auto _scene = scene->as<Scene>()) {
-            if (_scene->autoUpdate) scene->updateMatrixWorld();
+        if (scene->hasTag(Object3D::Tag::Scene)) {
+            if (static_cast<Scene*>(scene)->autoUpdate) scene->updateMatrixWorld();
         }
 
         // update camera matrices and frustum
 
         if (camera->parent == nullptr) camera->updateMatrixWorld();
 
+        timing.update = lap(time);
+
         //
         //    if ( scene.isScene === true ) scene.onBeforeRender( _this, scene, camera, _currentRenderTarget );
 
@@ -227,6 +275,13 @@ struct GLRenderer::Impl {
         _projScreenMatrix.multiplyMatrices(camera->projectionMatrix, camera->matrixWorldInverse);
         _frustum.setFromProjectionMatrix(_projScreenMatrix);
 
+        spatialIndex = scene->hasTag(Object3D::Tag::Scene) ? static_cast<Scene*>(scene)->spatialIndex.get() : nullptr;
+        if (spatialIndex) {
+
+            spatialIndex->update(*scene);
+            spatialIndex->query(_frustum);
+        }
+
         _localClippingEnabled = scope.localClippingEnabled;
         _clippingEnabled = clipping.init(scope.clippingPlanes, _localClippingEnabled, camera);
 
@@ -235,31 +290,44 @@ struct GLRenderer::Impl {
 
         renderListStack.emplace_back(currentRenderList);
 
-        projectObject(scene, camera, 0, scope.sortObjects);
+        if (scope.parallelProjection) {
+
+            projectObjectParallel(scene, camera, scope.sortObjects);
+
+        } else {
+
+            projectObject(scene, camera, 0, scope.sortObjects);
+        }
 
         currentRenderList->finish();
 
+        timing.projection = lap(time);
+
         if (scope.sortObjects) {
 
             currentRenderList->sort();
         }
 
+        timing.sort = lap(time);
+
         //
 
         if (_clippingEnabled) clipping.beginShadows();
 
         auto& shadowsArray = currentRenderState->getShadowsArray();
 
+        _info.beginShadows();
         shadowMap.render(scope, shadowsArray, scene, camera);
+        _info.endShadows();
 
-        currentRenderState->setupLights();
+        currentRenderState->setupLights(shadowMap.atlasTexture());
         currentRenderState->setupLightsView(camera);
 
-        if (_clippingEnabled) clipping.endShadows();
+        if (scope.uniformBuffers) uniformBuffers.updateLights(currentRenderState->getLights().state);
 
-        //
+        if (_clippingEnabled) clipping.endShadows();
 
-        if (this->_info.autoReset) this->_info.reset();
+        timing.shadows = lap(time);
 
         //
 
@@ -269,9 +337,37 @@ struct GLRenderer::Impl {
 
         auto& opaqueObjects = currentRenderList->opaque;
         auto& transparentObjects = currentRenderList->transparent;
+
+        // local, as nested render calls replace _frustum
+        const auto frustum = _frustum;
+
+        // local, as the render lists of nested render calls are culled too
+        std::vector<gl::RenderItem*> visibleOpaqueObjects;
+        std::vector<gl::RenderItem*> visibleTransparentObjects;
+
+        if (scope.occlusionCulling) {
+
+            occlusionCulling.cull(opaqueObjects, *camera, visibleOpaqueObjects);
+            occlusionCulling.cull(transparentObjects, *camera, visibleTransparentObjects);
+        }
+
+        const auto& opaque = scope.occlusionCulling ? visibleOpaqueObjects : opaqueObjects;
+        const auto& transparent = scope.occlusionCulling ? visibleTransparentObjects : transparentObjects;
         //
-        if (!opaqueObjects.empty()) renderObjects(opaqueObjects, scene, camera);
-        if (!transparentObjects.empty()) renderObjects(transparentObjects, scene, camera);
+        if (!opaque.empty()) renderObjects(opaque, scene, camera, frustum);
+
+        if (scope.occlusionCulling) {
+
+            // against the depth of the opaque objects, results are used in later frames
+            occlusionCulling.test(opaqueObjects, *camera, _projScreenMatrix, scope.occlusionTestInterval);
+            occlusionCulling.test(transparentObjects, *camera, _projScreenMatrix, scope.occlusionTestInterval);
+        }
+
+        timing.opaque = lap(time);
+
+        if (!transparent.empty()) renderObjects(transparent, scene, camera, frustum);
+
+        timing.transparent = lap(time);
 
         //
 
@@ -296,6 +392,18 @@ struct GLRenderer::Impl {
 
         // finish
 
+        // nested render calls are part of the durations of the outer one, which alone is reported
+        if (outermost) {
+
+            if (scope.gpuTiming) timerQueries.end();
+
+            // never waits, results arrive a few frames late
+            const auto gpuTime = timerQueries.poll();
+            timing.gpu = gpuTime ? *gpuTime : _info.timing.gpu;
+
+            _info.timing = timing;
+        }
+
         _currentMaterialId = std::nullopt;
         _currentCamera = nullptr;
 
@@ -305,6 +413,9 @@ struct GLRenderer::Impl {
 
             currentRenderState = renderStateStack.back();
 
+            // a nested render has overwritten the shared light blocks
+            if (scope.uniformBuffers) uniformBuffers.updateLights(currentRenderState->getLights().state);
+
         } else {
 
             currentRenderState = nullptr;
@@ -319,6 +430,9 @@ struct GLRenderer::Impl {
         } else {
 
             currentRenderList = nullptr;
+
+            autoInstancing.endFrame();
+            occlusionCulling.endFrame();
         }
     }
 
@@ -330,7 +444,7 @@ struct GLRenderer::Impl {
             scene = _emptyScene.get();
         }
 
-        bool isMesh = object->is<Mesh>();
+        bool isMesh = object->hasTag(Object3D::Tag::Mesh);
         const auto frontFaceCW = (isMesh && object->matrixWorld->determinant() < 0);
 
         auto program = setProgram(camera, scene, material, object);
@@ -340,7 +454,7 @@ struct GLRenderer::Impl {
         //
 
         auto index = geometry->getIndex();
-        const auto& position = geometry->getAttribute<float>("position");
+        const auto position = geometry->getAttribute("position");
 
         //
 
@@ -357,7 +471,7 @@ struct GLRenderer::Impl {
 
         int rangeFactor = 1;
 
-        auto wireframeMaterial = dynamic_cast<MaterialWithWireframe*>(material);
+        auto wireframeMaterial = material->as<MaterialWithWireframe>();
         bool isWireframeMaterial = wireframeMaterial != nullptr;
 
         if (isWireframeMaterial && wireframeMaterial->wireframe) {
@@ -415,7 +529,7 @@ struct GLRenderer::Impl {
                 renderer->setMode(GL_TRIANGLES);
             }
 
-        } else if (object->is<Line>()) {
+        } else if (object->hasTag(Object3D::Tag::Line)) {
 
             float lineWidth = 1;
             if (auto lw = material->as<MaterialWithLineWidth>()) {
@@ -424,11 +538,11 @@ struct GLRenderer::Impl {
 
             state.setLineWidth(lineWidth * static_cast<float>(scope.getTargetPixelRatio()));
 
-            if (object->is<LineSegments>()) {
+            if (object->hasTag(Object3D::Tag::LineSegments)) {
 
                 renderer->setMode(GL_LINES);
 
-            } else if (object->is<LineLoop>()) {
+            } else if (object->hasTag(Object3D::Tag::LineLoop)) {
 
                 renderer->setMode(GL_LINE_LOOP);
 
@@ -437,18 +551,32 @@ struct GLRenderer::Impl {
                 renderer->setMode(GL_LINE_STRIP);
             }
 
-        } else if (object->is<Points>()) {
+        } else if (object->hasTag(Object3D::Tag::Points)) {
 
             renderer->setMode(GL_POINTS);
 
-        } else if (object->is<Sprite>()) {
+        } else if (object->hasTag(Object3D::Tag::Sprite)) {
 
             renderer->setMode(GL_TRIANGLES);
         }
 
-        if (auto im = object->as<InstancedMesh>()) {
+        if (object->hasTag(Object3D::Tag::BatchedMesh)) {
+
+            dynamic_cast<BatchedMesh*>(object)->getDrawRanges(batchStarts, batchCounts);
+
+            for (size_t i = 0; i < batchStarts.size(); i++) {
+                batchStarts[i] *= rangeFactor;
+                batchCounts[i] *= rangeFactor;
+            }
+
+            renderer->renderMultiDraw(batchStarts, batchCounts);
+
+        } else if (object->hasTag(Object3D::Tag::InstancedMesh)) {
+
+            const auto instancedMesh = dynamic_cast<InstancedMesh*>(object);
+            const auto instanceCount = instancedMesh->perInstanceCulling ? instancedMesh->visibleCount() : instancedMesh->count();
 
-            renderer->renderInstances(drawStart, drawCount, im->count());
+            renderer->renderInstances(drawStart, drawCount, static_cast<int>(instanceCount));
 
         } /*else if (auto g = dynamic_cast<InstancedBufferGeometry*>(geometry)) {
 
@@ -466,30 +594,39 @@ struct GLRenderer::Impl {
     void projectObject(Object3D* object, Camera* camera, unsigned int groupOrder, bool sortObjects) {
         if (!object->visible) return;
 
+        projectNode(object, camera, groupOrder, sortObjects);
+
+        for (const auto& child : object->children) {
+
+            projectObject(child, camera, groupOrder, sortObjects);
+        }
+    }
+
+    // projects a single node into the current render list/state and updates groupOrder for its children
+    void projectNode(Object3D* object, Camera* camera, unsigned int& groupOrder, bool sortObjects) {
+
         bool visible = object->layers.test(camera->layers);
 
         if (visible) {
 
-            if (object->is<Group>()) {
+            if (object->hasTag(Object3D::Tag::Group)) {
 
                 groupOrder = object->renderOrder;
 
-            } else if (auto lod = object->as<LOD>()) {
+            } else if (object->hasTag(Object3D::Tag::LOD)) {
 
+                auto lod = static_cast<LOD*>(object);
                 if (lod->autoUpdate) lod->update(*camera);
 
-            } else if (auto light = object->as<Light>()) {
-
-                currentRenderState->pushLight(light);
+            } else if (object->hasTag(Object3D::Tag::Light)) {
 
-                if (light->castShadow) {
+                pushLight(static_cast<Light*>(object));
 
-                    currentRenderState->pushShadow(light);
-                }
+            } else if (object->hasTag(Object3D::Tag::Sprite)) {
 
-            } else if (auto sprite = object->as<Sprite>()) {
+                auto sprite = static_cast<Sprite*>(object);
 
-                if (!object->frustumCulled || _frustum.intersectsSprite(*sprite)) {
+                if (!object->frustumCulled || inFrustum(*object)) {
 
                     if (sortObjects) {
 
@@ -497,18 +634,14 @@ struct GLRenderer::Impl {
                                 .applyMatrix4(_projScreenMatrix);
                     }
 
-                    const auto geometry = objects.update(object);
-                    const auto material = sprite->material().get();
-
-                    if (material->visible) {
-
-                        currentRenderList->push(object, geometry, material, groupOrder, _vector3.z, std::nullopt);
-                    }
+                    pushSprite(sprite, groupOrder, _vector3.z);
                 }
 
-            } else if (object->is<Mesh>() || object->is<Line>() || object->is<Points>()) {
+            } else if (object->hasTag(Object3D::Tag::Mesh) || object->hasTag(Object3D::Tag::Line) || object->hasTag(Object3D::Tag::Points)) {
+
+                if (object->hasTag(Object3D::Tag::SkinnedMesh)) {
 
-                if (auto skinned = object->as<SkinnedMesh>()) {
+                    auto skinned = dynamic_cast<SkinnedMesh*>(object);
 
                     // update skeleton only once in a frame
 
@@ -519,7 +652,7 @@ struct GLRenderer::Impl {
                     }
                 }
 
-                if (!object->frustumCulled || _frustum.intersectsObject(*object)) {
+                if (!object->frustumCulled || inFrustum(*object)) {
 
                     if (sortObjects) {
 
@@ -527,56 +660,322 @@ struct GLRenderer::Impl {
                                 .applyMatrix4(_projScreenMatrix);
                     }
 
-                    const auto geometry = objects.update(object);
-                    const auto& materials = object->as<ObjectWithMaterials>()->materials();
+                    pushObject(object, groupOrder, _vector3.z);
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] bool inFrustum(Object3D& object) const {
+
+        if (spatialIndex) return spatialIndex->intersectsFrustum(_frustum, object);
+
+        if (object.hasTag(Object3D::Tag::Sprite)) return _frustum.intersectsSprite(static_cast<const Sprite&>(object));
+
+        return _frustum.intersectsObject(object);
+    }
+
+    void pushLight(Light* light) {
+
+        currentRenderState->pushLight(light);
+
+        if (light->castShadow) {
+
+            currentRenderState->pushShadow(light);
+        }
+    }
+
+    void pushSprite(Sprite* sprite, unsigned int groupOrder, float z) {
+
+        const auto geometry = objects.update(sprite);
+        const auto material = sprite->material().get();
+
+        if (material->visible) {
+
+            currentRenderList->push(sprite, geometry, material, groupOrder, z, std::nullopt);
+        }
+    }
 
-                    if (materials.size() > 1) {
+    void pushObject(Object3D* object, unsigned int groupOrder, float z) {
 
-                        const auto& groups = geometry->groups;
+        const auto geometry = objects.update(object);
+        const auto& materials = object->as<ObjectWithMaterials>()->materials();
 
-                        for (const auto& group : groups) {
+        if (materials.size() > 1) {
 
-                            const auto groupMaterial = materials.at(group.materialIndex).get();
+            const auto& groups = geometry->groups;
 
-                            if (groupMaterial && groupMaterial->visible) {
+            for (const auto& group : groups) {
 
-                                currentRenderList->push(object, geometry, groupMaterial, groupOrder, _vector3.z, group);
-                            }
-                        }
+                const auto groupMaterial = materials.at(group.materialIndex).get();
 
-                    } else if (materials.front()->visible) {
+                if (groupMaterial && groupMaterial->visible) {
+
+                    currentRenderList->push(object, geometry, groupMaterial, groupOrder, z, group);
+                }
+            }
+
+        } else if (materials.front()->visible) {
+
+            currentRenderList->push(object, geometry, materials.front().get(), groupOrder, z, std::nullopt);
+        }
+    }
 
-                        currentRenderList->push(object, geometry, materials.front().get(), groupOrder, _vector3.z, std::nullopt);
+    // parallel projection
+    //
+    // Worker threads only read the scene graph: they cull subtrees into per-task buffers.
+    // Anything that mutates shared state (LOD switching, skeleton updates, lazy bounding volumes)
+    // or touches GL (GLObjects::update) is replayed on the render thread while merging the buffers.
+    // Tasks are created in traversal order and merged in that order, so the resulting render list
+    // is identical to the one produced by projectObject.
+
+    struct ProjectionItem {
+
+        enum class Kind {
+            Light,
+            Sprite,
+            Object,
+            Node,   // node must be projected on the render thread
+            Subtree // subtree must be projected on the render thread
+        };
+
+        Kind kind;
+        Object3D* object;
+        unsigned int groupOrder;
+        float z;
+    };
+
+    struct ProjectionTask {
+
+        Object3D* parent = nullptr;
+        size_t childBegin = 0;
+        size_t childEnd = 0;
+        unsigned int groupOrder = 0;
+
+        std::vector<ProjectionItem> items;
+    };
+
+    std::unique_ptr<utils::ThreadPool> projectionPool;
+    std::vector<ProjectionTask> projectionTasks;
+    size_t projectionTaskCount = 0;
+
+    void projectObjectParallel(Object3D* scene, Camera* camera, bool sortObjects) {
+
+        const auto numThreads = scope.projectionThreads == 0 ? utils::ThreadPool::defaultNumThreads() : scope.projectionThreads;
+
+        if (!projectionPool || projectionPool->size() != numThreads) {
+
+            projectionPool = std::make_unique<utils::ThreadPool>(numThreads);
+        }
+
+        projectionTaskCount = 0;
+        splitProjection(scene, camera, 0, sortObjects, numThreads * 4, 0);
+
+        projectionPool->parallelFor(projectionTaskCount, [&](size_t i) {
+            auto& task = projectionTasks[i];
+
+            if (!task.parent) return;// node task, already culled while splitting
+
+            for (auto j = task.childBegin; j < task.childEnd; ++j) {
+
+                cullSubtree(task.parent->children[j], camera, task.groupOrder, sortObjects, task.items);
+            }
+        });
+
+        for (size_t i = 0; i < projectionTaskCount; ++i) {
+
+            for (const auto& item : projectionTasks[i].items) {
+
+                switch (item.kind) {
+
+                    case ProjectionItem::Kind::Light:
+                        pushLight(static_cast<Light*>(item.object));
+                        break;
+                    case ProjectionItem::Kind::Sprite:
+                        pushSprite(static_cast<Sprite*>(item.object), item.groupOrder, item.z);
+                        break;
+                    case ProjectionItem::Kind::Object:
+                        pushObject(item.object, item.groupOrder, item.z);
+                        break;
+                    case ProjectionItem::Kind::Node: {
+                        auto groupOrder = item.groupOrder;
+                        projectNode(item.object, camera, groupOrder, sortObjects);
+                        break;
                     }
+                    case ProjectionItem::Kind::Subtree:
+                        projectObject(item.object, camera, item.groupOrder, sortObjects);
+                        break;
                 }
             }
         }
+    }
+
+    ProjectionTask& nextProjectionTask() {
+
+        if (projectionTaskCount == projectionTasks.size()) {
+
+            projectionTasks.emplace_back();
+        }
+
+        auto& task = projectionTasks[projectionTaskCount++];
+        task.parent = nullptr;
+        task.items.clear();
+
+        return task;
+    }
+
+    // expands the top of the hierarchy on the render thread until there are enough sibling ranges to distribute
+    void splitProjection(Object3D* object, Camera* camera, unsigned int groupOrder, bool sortObjects, size_t minTasks, size_t depth) {
+
+        if (!cullNode(object, camera, groupOrder, sortObjects, nextProjectionTask().items)) return;
+
+        const auto& children = object->children;
+
+        if (children.empty()) return;
+
+        if (children.size() >= minTasks || depth >= maxSplitDepth) {
+
+            const auto chunkSize = (children.size() + minTasks - 1) / minTasks;
+
+            for (size_t begin = 0; begin < children.size(); begin += chunkSize) {
+
+                auto& task = nextProjectionTask();
+                task.parent = object;
+                task.childBegin = begin;
+                task.childEnd = std::min(begin + chunkSize, children.size());
+                task.groupOrder = groupOrder;
+            }
+
+        } else {
+
+            for (const auto& child : children) {
+
+                splitProjection(child, camera, groupOrder, sortObjects, minTasks, depth + 1);
+            }
+        }
+    }
+
+    void cullSubtree(Object3D* object, Camera* camera, unsigned int groupOrder, bool sortObjects, std::vector<ProjectionItem>& items) const {
+
+        if (!cullNode(object, camera, groupOrder, sortObjects, items)) return;
 
         for (const auto& child : object->children) {
 
-            projectObject(child, camera, groupOrder, sortObjects);
+            cullSubtree(child, camera, groupOrder, sortObjects, items);
+        }
+    }
+
+    // thread-safe counterpart of projectNode. Returns false if the children should not be visited.
+    bool cullNode(Object3D* object, Camera* camera, unsigned int& groupOrder, bool sortObjects, std::vector<ProjectionItem>& items) const {
+
+        if (!object->visible) return false;
+
+        if (!object->layers.test(camera->layers)) return true;
+
+        if (object->hasTag(Object3D::Tag::Group)) {
+
+            groupOrder = object->renderOrder;
+
+        } else if (object->hasTag(Object3D::Tag::LOD)) {
+
+            items.push_back({ProjectionItem::Kind::Subtree, object, groupOrder, 0});
+            return false;
+
+        } else if (object->hasTag(Object3D::Tag::Light)) {
+
+            items.push_back({ProjectionItem::Kind::Light, object, groupOrder, 0});
+
+        } else if (object->hasTag(Object3D::Tag::Sprite)) {
+
+            if (!object->frustumCulled || inFrustum(*object)) {
+
+                items.push_back({ProjectionItem::Kind::Sprite, object, groupOrder, projectedDepth(*object, sortObjects)});
+            }
+
+        } else if (object->hasTag(Object3D::Tag::Mesh) || object->hasTag(Object3D::Tag::Line) || object->hasTag(Object3D::Tag::Points)) {
+
+            if (object->hasTag(Object3D::Tag::SkinnedMesh) || !hasBoundingSphere(*object)) {
+
+                items.push_back({ProjectionItem::Kind::Node, object, groupOrder, 0});
+
+            } else if (!object->frustumCulled || inFrustum(*object)) {
+
+                items.push_back({ProjectionItem::Kind::Object, object, groupOrder, projectedDepth(*object, sortObjects)});
+            }
+        }
+
+        return true;
+    }
+
+    [[nodiscard]] float projectedDepth(const Object3D& object, bool sortObjects) const {
+
+        if (!sortObjects) return 0;
+
+        Vector3 v;
+        v.setFromMatrixPosition(*object.matrixWorld).applyMatrix4(_projScreenMatrix);
+
+        return v.z;
+    }
+
+    static bool hasBoundingSphere(Object3D& object) {
+
+        if (object.hasTag(Object3D::Tag::InstancedMesh)) {
+
+            return dynamic_cast<InstancedMesh&>(object).boundingSphere.has_value();
         }
+
+        return object.geometry()->boundingSphere.has_value();
     }
 
-    void renderObjects(const std::vector<gl::RenderItem*>& renderList, Object3D* scene, Camera* camera) {
+    static constexpr size_t maxSplitDepth = 4;
+
+    void renderObjects(const std::vector<gl::RenderItem*>& renderList, Object3D* scene, Camera* camera, const Frustum& frustum) {
 
         Material* overrideMaterial = nullptr;
-        if (auto _scene = scene->as<Scene>()) {
+        if (scene->hasTag(Object3D::Tag::Scene)) {
+            auto _scene = static_cast<Scene*>(scene);
             if (_scene->overrideMaterial) overrideMaterial = _scene->overrideMaterial.get();
         }
 
-        for (const auto& renderItem : renderList) {
+        for (size_t i = 0; i < renderList.size();) {
 
-            auto object = renderItem->object;
+            const auto renderItem = renderList[i];
+
+            Object3D* object = renderItem->object;
             auto geometry = renderItem->geometry;
             auto material = overrideMaterial == nullptr ? renderItem->material : overrideMaterial;
             auto group = renderItem->group;
 
-            renderObject(object, scene, camera, geometry, material, group);
+            size_t count = 1;
+
+            if (scope.autoInstancing) {
+
+                count = gl::GLAutoInstancing::runLength(renderList, i);
+                if (count > 1) {
+
+                    object = autoInstancing.acquire(renderList, i, count);
+                    objects.update(object);
+                }
+            }
+
+            renderObject(object, scene, camera, frustum, geometry, material, group);
+
+            i += count;
         }
     }
 
-    void renderObject(Object3D* object, Object3D* scene, Camera* camera, BufferGeometry* geometry, Material* material, std::optional<GeometryGroup> group) {
+    void renderObject(Object3D* object, Object3D* scene, Camera* camera, const Frustum& frustum, BufferGeometry* geometry, Material* material, std::optional<GeometryGroup> group) {
+
+        if (object->hasTag(Object3D::Tag::InstancedMesh)) {
+
+            // culled here rather than while projecting, as the shadow maps cull the same instances in between
+            auto instancedMesh = dynamic_cast<InstancedMesh*>(object);
+            if (instancedMesh->perInstanceCulling) {
+
+                if (instancedMesh->cullInstances(frustum, *camera) == 0) return;
+                objects.update(object);
+            }
+        }
 
         if (object->onBeforeRender) {
 
@@ -596,8 +995,7 @@ struct GLRenderer::Impl {
 
     gl::GLProgram* getProgram(Material* material, Object3D* _scene, Object3D* object) {
 
-        auto* scene = _scene->as<Scene>();
-        if (!scene) scene = _emptyScene.get();// scene could be a Mesh, Line, Points, ...
+        auto* scene = _scene->hasTag(Object3D::Tag::Scene) ? static_cast<Scene*>(_scene) : _emptyScene.get();// scene could be a Mesh, Line, Points, ...
 
         auto materialProperties = properties.materialProperties.get(material);
 
@@ -613,7 +1011,7 @@ struct GLRenderer::Impl {
 
         // always update environment and fog - changing these trigger an getProgram call, but it's possible that the program doesn't change
 
-        materialProperties->environment = material->is<MeshStandardMaterial>() ? scene->environment.get() : nullptr;
+        materialProperties->environment = material->hasTag(Material::Tag::MeshStandard) ? scene->environment.get() : nullptr;
         materialProperties->fog = scene->fog;
         auto materialWithEnvMap = material->as<MaterialWithEnvMap>();
         if (materialWithEnvMap && materialWithEnvMap->envMap) {
@@ -660,7 +1058,7 @@ struct GLRenderer::Impl {
 
         auto& uniforms = *materialProperties->uniforms;
 
-        if (!material->is<ShaderMaterial>() && !material->is<RawShaderMaterial>() || material->clipping) {
+        if (!material->hasTag(Material::Tag::Shader) || material->clipping) {
 
             uniforms["clippingPlanes"] = clipping.uniform;
         }
@@ -688,6 +1086,8 @@ struct GLRenderer::Impl {
 
             uniforms.at("directionalShadowMap").setValue(lights.state.directionalShadowMap);
             uniforms.at("directionalShadowMatrix").setValue(lights.state.directionalShadowMatrix);
+            uniforms.at("directionalShadowCascadeMatrix").setValue(lights.state.directionalShadowCascadeMatrix);
+            uniforms.at("shadowAtlas").setValue(lights.state.shadowAtlas);
             uniforms.at("spotShadowMap").setValue(lights.state.spotShadowMap);
             uniforms.at("spotShadowMatrix").setValue(lights.state.spotShadowMatrix);
             uniforms.at("pointShadowMap").setValue(lights.state.pointShadowMap);
@@ -709,24 +1109,25 @@ struct GLRenderer::Impl {
 
         materialProperties->outputEncoding = parameters.outputEncoding;
         materialProperties->instancing = parameters.instancing;
+        materialProperties->batching = parameters.batching;
         materialProperties->skinning = parameters.skinning;
         materialProperties->numClippingPlanes = parameters.numClippingPlanes;
         materialProperties->numIntersection = parameters.numClipIntersection;
         materialProperties->vertexAlphas = parameters.vertexAlphas;
+        materialProperties->octahedralNormals = parameters.octahedralNormals;
     }
 
     gl::GLProgram* setProgram(Camera* camera, Object3D* _scene, Material* material, Object3D* object) {
 
-        auto* scene = _scene->as<Scene>();
-        if (!scene) scene = _emptyScene.get();// scene could be a Mesh, Line, Points, ...
+        auto* scene = _scene->hasTag(Object3D::Tag::Scene) ? static_cast<Scene*>(_scene) : _emptyScene.get();// scene could be a Mesh, Line, Points, ...
 
-        bool isMeshBasicMaterial = material->type() == "MeshBasicMaterial";
-        bool isMeshLambertMaterial = material->type() == "MeshLambertMaterial";
-        bool isMeshToonMaterial = material->type() == "MeshToonMaterial";
-        bool isMeshPhongMaterial = material->type() == "MeshPhongMaterial";
-        bool isMeshStandardMaterial = material->type() == "MeshStandardMaterial";
-        bool isShadowMaterial = material->type() == "ShadowMaterial";
-        bool isShaderMaterial = material->is<ShaderMaterial>();
+        bool isMeshBasicMaterial = material->hasTag(Material::Tag::MeshBasic);
+        bool isMeshLambertMaterial = material->hasTag(Material::Tag::MeshLambert);
+        bool isMeshToonMaterial = material->hasTag(Material::Tag::MeshToon);
+        bool isMeshPhongMaterial = material->hasTag(Material::Tag::MeshPhong);
+        bool isMeshStandardMaterial = material->hasTag(Material::Tag::MeshStandard);
+        bool isShadowMaterial = material->hasTag(Material::Tag::Shadow);
+        bool isShaderMaterial = material->hasTag(Material::Tag::Shader);
         bool isEnvMap = material->is<MaterialWithEnvMap>() && material->as<MaterialWithEnvMap>()->envMap;
 
         textures.resetTextureUnits();
@@ -747,7 +1148,10 @@ struct GLRenderer::Impl {
         bool vertexAlphas = material->vertexColors &&
                             object->geometry() &&
                             object->geometry()->hasAttribute("color") &&
-                            object->geometry()->getAttribute<float>("color")->itemSize() == 4;
+                            object->geometry()->getAttribute("color")->itemSize() == 4;
+        bool octahedralNormals = object->geometry() &&
+                                 object->geometry()->hasAttribute("normal") &&
+                                 object->geometry()->getAttribute("normal")->itemSize() == 2;
 
         auto materialProperties = properties.materialProperties.get(material);
         auto& lights = currentRenderState->getLights();
@@ -768,8 +1172,9 @@ struct GLRenderer::Impl {
         //
 
         bool needsProgramChange = false;
-        bool isInstancedMesh = object->type() == "InstancedMesh";
-        bool isSkinnedMesh = object->type() == "SkinnedMesh";
+        bool isInstancedMesh = object->hasTag(Object3D::Tag::InstancedMesh);
+        bool isSkinnedMesh = object->hasTag(Object3D::Tag::SkinnedMesh);
+        bool isBatchedMesh = object->hasTag(Object3D::Tag::BatchedMesh);
 
         if (material->version() == materialProperties->version) {
 
@@ -781,11 +1186,7 @@ struct GLRenderer::Impl {
 
                 needsProgramChange = true;
 
-            } else if (isInstancedMesh && !materialProperties->instancing) {
-
-                needsProgramChange = true;
-
-            } else if (!isInstancedMesh && materialProperties->instancing) {
+            } else if (isBatchedMesh != materialProperties->batching) {
 
                 needsProgramChange = true;
 
@@ -814,6 +1215,10 @@ struct GLRenderer::Impl {
             } else if (materialProperties->vertexAlphas != vertexAlphas) {
 
                 needsProgramChange = true;
+
+            } else if (materialProperties->octahedralNormals != octahedralNormals) {
+
+                needsProgramChange = true;
             }
 
         } else {
@@ -825,10 +1230,31 @@ struct GLRenderer::Impl {
         //
 
         gl::GLProgram* program = materialProperties->currentProgram;
+        auto& otherInstancing = materialProperties->otherInstancing;
 
         if (needsProgramChange) {
 
+            otherInstancing.program = nullptr;
             program = getProgram(material, scene, object);
+
+        } else if (isInstancedMesh != materialProperties->instancing) {
+
+            if (otherInstancing.program) {
+
+                // everything else matches, so the program of the other instancing state still applies
+                std::swap(materialProperties->currentProgram, otherInstancing.program);
+                std::swap(materialProperties->uniformsList, otherInstancing.uniformsList);
+                materialProperties->instancing = isInstancedMesh;
+
+                program = materialProperties->currentProgram;
+
+            } else {
+
+                otherInstancing.program = materialProperties->currentProgram;
+                otherInstancing.uniformsList = materialProperties->uniformsList;
+
+                program = getProgram(material, scene, object);
+            }
         }
 
         bool refreshProgram = false;
@@ -836,6 +1262,7 @@ struct GLRenderer::Impl {
         bool refreshLights = false;
 
         auto p_uniforms = program->getUniforms();
+        const auto& builtins = program->getBuiltinUniforms();
         auto& m_uniforms = *materialProperties->uniforms;
 
         if (state.useProgram(program->program)) {
@@ -854,17 +1281,19 @@ struct GLRenderer::Impl {
 
         if (refreshProgram || _currentCamera != camera) {
 
-            p_uniforms->setValue("projectionMatrix", camera->projectionMatrix);
+            builtins.projectionMatrix.setValue(camera->projectionMatrix);
 
             if (gl::GLCapabilities::instance().logarithmicDepthBuffer) {
 
-                p_uniforms->setValue("logDepthBufFC", 2.f / (std::log(camera->far + 1.f) / math::LN2));
+                builtins.logDepthBufFC.setValue(2.f / (std::log(camera->far + 1.f) / math::LN2));
             }
 
             if (_currentCamera != camera) {
 
                 _currentCamera = camera;
 
+                if (scope.uniformBuffers) uniformBuffers.updateCamera(*camera);
+
                 // lighting uniforms depend on the camera so enforce an update
                 // now, in case this material supports lights - or later, when
                 // the next material that does gets activated:
@@ -882,11 +1311,10 @@ struct GLRenderer::Impl {
                 isMeshStandardMaterial ||
                 isEnvMap) {
 
-                if (p_uniforms->map.count("cameraPosition")) {
+                if (builtins.cameraPosition.valid()) {
 
-                    auto& uCamPos = p_uniforms->map["cameraPosition"];
                     _vector3.setFromMatrixPosition(*camera->matrixWorld);
-                    uCamPos->setValue(_vector3);
+                    builtins.cameraPosition.setValue(_vector3);
                 }
             }
 
@@ -897,7 +1325,7 @@ struct GLRenderer::Impl {
                 isMeshStandardMaterial ||
                 isShaderMaterial) {
 
-                p_uniforms->setValue("isOrthographic", camera->is<OrthographicCamera>());
+                builtins.isOrthographic.setValue(camera->is<OrthographicCamera>());
             }
 
             if (isMeshPhongMaterial ||
@@ -907,9 +1335,9 @@ struct GLRenderer::Impl {
                 isMeshStandardMaterial ||
                 isShaderMaterial ||
                 isShadowMaterial ||
-                object->is<SkinnedMesh>()) {
+                isSkinnedMesh) {
 
-                p_uniforms->setValue("viewMatrix", camera->matrixWorldInverse);
+                builtins.viewMatrix.setValue(camera->matrixWorldInverse);
             }
         }
 
@@ -917,13 +1345,15 @@ struct GLRenderer::Impl {
         // auto-setting of texture unit for bone texture must go before other textures
         // otherwise textures used for skinning can take over texture units reserved for other material textures
 
-        if (auto skinned = object->as<SkinnedMesh>()) {
+        if (isSkinnedMesh) {
+
+            auto skinned = dynamic_cast<SkinnedMesh*>(object);
 
             const auto& bindMatrix = skinned->bindMatrix;
             const auto& bindMatrixInverse = skinned->bindMatrixInverse;
 
-            p_uniforms->setValue("bindMatrix", bindMatrix);
-            p_uniforms->setValue("bindMatrixInverse", bindMatrixInverse);
+            builtins.bindMatrix.setValue(bindMatrix);
+            builtins.bindMatrixInverse.setValue(bindMatrixInverse);
 
             auto& skeleton = skinned->skeleton;
 
@@ -934,7 +1364,7 @@ struct GLRenderer::Impl {
                     if (!skeleton->boneTexture) skeleton->computeBoneTexture();
 
                     p_uniforms->setValue("boneTexture", skeleton->boneTexture.get(), &textures);
-                    p_uniforms->setValue("boneTextureSize", skeleton->boneTextureSize);
+                    builtins.boneTextureSize.setValue(skeleton->boneTextureSize);
 
                 } else {
 
@@ -946,15 +1376,20 @@ struct GLRenderer::Impl {
             }
         }
 
+        if (isBatchedMesh) {
+
+            p_uniforms->setValue("batchingTexture", dynamic_cast<BatchedMesh*>(object)->matricesTexture(), &textures);
+        }
+
         if (refreshMaterial || materialProperties->receiveShadow != object->receiveShadow) {
 
             materialProperties->receiveShadow = object->receiveShadow;
-            p_uniforms->setValue("receiveShadow", object->receiveShadow);
+            builtins.receiveShadow.setValue(object->receiveShadow);
         }
 
         if (refreshMaterial) {
 
-            p_uniforms->setValue("toneMappingExposure", scope.toneMappingExposure);
+            builtins.toneMappingExposure.setValue(scope.toneMappingExposure);
 
             // [threepp] hack to solve #162
             if (_clippingEnabled) {
@@ -989,7 +1424,7 @@ struct GLRenderer::Impl {
 
         if (isShaderMaterial) {
 
-            auto m = dynamic_cast<ShaderMaterial*>(material);
+            auto m = material->as<ShaderMaterial>();
             if (m->uniformsNeedUpdate) {
 
                 gl::GLUniforms::upload(materialProperties->uniformsList, m_uniforms, &textures);
@@ -997,16 +1432,16 @@ struct GLRenderer::Impl {
             }
         }
 
-        if (material->is<SpriteMaterial>() && object->is<Sprite>()) {
+        if (material->hasTag(Material::Tag::Sprite) && object->hasTag(Object3D::Tag::Sprite)) {
 
-            p_uniforms->setValue("center", object->as<Sprite>()->center);
+            builtins.center.setValue(static_cast<Sprite*>(object)->center);
         }
 
         // common matrices
 
-        p_uniforms->setValue("modelViewMatrix", object->modelViewMatrix);
-        p_uniforms->setValue("normalMatrix", object->normalMatrix);
-        p_uniforms->setValue("modelMatrix", *object->matrixWorld);
+        builtins.modelViewMatrix.setValue(object->modelViewMatrix);
+        builtins.normalMatrix.setValue(object->normalMatrix);
+        builtins.modelMatrix.setValue(*object->matrixWorld);
 
         return program;
     }
@@ -1025,12 +1460,12 @@ struct GLRenderer::Impl {
     }
 
     bool materialNeedsLights(Material* material) {
-        bool isMeshLambertMaterial = material->type() == "MeshLambertMaterial";
-        bool isMeshToonMaterial = material->type() == "MeshToonMaterial";
-        bool isMeshPhongMaterial = material->type() == "MeshPhongMaterial";
-        bool isMeshStandardMaterial = material->type() == "MeshStandardMaterial";
-        bool isShadowMaterial = material->type() == "ShadowMaterial";
-        bool isShaderMaterial = material->is<ShaderMaterial>();
+        bool isMeshLambertMaterial = material->hasTag(Material::Tag::MeshLambert);
+        bool isMeshToonMaterial = material->hasTag(Material::Tag::MeshToon);
+        bool isMeshPhongMaterial = material->hasTag(Material::Tag::MeshPhong);
+        bool isMeshStandardMaterial = material->hasTag(Material::Tag::MeshStandard);
+        bool isShadowMaterial = material->hasTag(Material::Tag::Shadow);
+        bool isShaderMaterial = material->hasTag(Material::Tag::Shader);
         bool lights = false;
 
         if (auto materialWithLights = material->as<MaterialWithLights>()) {
@@ -1150,6 +1585,10 @@ struct GLRenderer::Impl {
         renderStates.dispose();
         properties.dispose();
         cubemaps.dispose();
+        uniformBuffers.dispose();
+        autoInstancing.dispose();
+        timerQueries.dispose();
+        occlusionCulling.dispose();
         objects.dispose();
         bindingStates.dispose();
     }
@@ -2,6 +2,8 @@
 #ifndef THREEPP_BUFFER_HPP
 #define THREEPP_BUFFER_HPP
 
+#include <cstddef>
+
 namespace threepp::gl {
 
     struct Buffer {
@@ -9,6 +11,10 @@ namespace threepp::gl {
         int type{};
         int bytesPerElement{};
         unsigned int version{};
+        // byte offset of the current data, non-zero for streamed attributes
+        size_t offset{};
+        // bytes allocated for the data, for streamed attributes the size of one copy
+        size_t size{};
     };
 
 }// namespace threepp::gl
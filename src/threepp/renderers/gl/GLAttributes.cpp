@@ -2,6 +2,10 @@
 #include "threepp/renderers/gl/GLAttributes.hpp"
 #include "threepp/core/InterleavedBufferAttribute.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+
 #ifndef EMSCRIPTEN
 #include <glad/glad.h>
 #else
@@ -11,6 +15,258 @@
 using namespace threepp;
 using namespace threepp::gl;
 
+namespace {
+
+    static_assert(sizeof(Half) == 2);
+
+    // the attribute storage as seen by GL
+    struct AttributeData {
+
+        const void* data{};
+        size_t count{};
+        GLenum type{};
+        int bytesPerElement{};
+
+        [[nodiscard]] size_t bytes() const {
+
+            return count * bytesPerElement;
+        }
+    };
+
+    template<class T>
+    bool describe(BufferAttribute* attribute, GLenum type, AttributeData& target) {
+
+        if (auto attr = attribute->typed<T>()) {
+
+            const auto& array = attr->array();
+            target = {array.data(), array.size(), type, sizeof(T)};
+            return true;
+        }
+
+        return false;
+    }
+
+    AttributeData attributeData(BufferAttribute* attribute) {
+
+        AttributeData data;
+
+        if (describe<float>(attribute, GL_FLOAT, data) ||
+            describe<unsigned int>(attribute, GL_UNSIGNED_INT, data) ||
+            describe<Half>(attribute, GL_HALF_FLOAT, data) ||
+            describe<uint16_t>(attribute, GL_UNSIGNED_SHORT, data) ||
+            describe<int16_t>(attribute, GL_SHORT, data) ||
+            describe<uint8_t>(attribute, GL_UNSIGNED_BYTE, data) ||
+            describe<int8_t>(attribute, GL_BYTE, data)) {
+
+            return data;
+        }
+
+        throw std::runtime_error("THREE.GLAttributes: Unsupported buffer attribute type.");
+    }
+
+    size_t uploadRanges(GLenum bufferType, const AttributeData& data, const std::vector<UpdateRange>& ranges) {
+
+        const auto bytes = static_cast<const char*>(data.data);
+        const auto bytesPerElement = static_cast<size_t>(data.bytesPerElement);
+
+        size_t uploaded = 0;
+
+        // straight from the attribute storage, no staging copy
+        for (const auto& range : ranges) {
+
+            const auto offset = range.offset * bytesPerElement;
+            const auto rangeBytes = range.count * bytesPerElement;
+            glBufferSubData(bufferType, (GLintptr) offset, (GLsizeiptr) rangeBytes, bytes + offset);
+            uploaded += rangeBytes;
+        }
+
+        return uploaded;
+    }
+
+    size_t uploadNarrowedRanges(GLenum bufferType, const unsigned int* indices, const std::vector<UpdateRange>& ranges, std::vector<uint16_t>& scratch) {
+
+        size_t uploaded = 0;
+
+        for (const auto& range : ranges) {
+
+            scratch.assign(indices + range.offset, indices + range.offset + range.count);
+
+            const auto rangeBytes = range.count * sizeof(uint16_t);
+            glBufferSubData(bufferType, (GLintptr) (range.offset * sizeof(uint16_t)), (GLsizeiptr) rangeBytes, scratch.data());
+            uploaded += rangeBytes;
+        }
+
+        return uploaded;
+    }
+
+#ifndef EMSCRIPTEN
+    // one copy being written by the CPU, up to two in flight on the GPU
+    constexpr size_t numRegions = 3;
+#else
+    // WebGL can not map buffers, streamed buffers are orphaned on update instead
+    constexpr size_t numRegions = 1;
+#endif
+
+    // how long to wait for the GPU to release a copy, in nanoseconds
+    constexpr GLuint64 fenceTimeout = 1000000000;
+
+    void prepareRanges(std::vector<UpdateRange>& ranges, int size) {
+
+        if (ranges.empty()) {
+
+            ranges.push_back({0, size});
+
+        } else {
+
+            GLAttributes::coalesce(ranges, size);
+        }
+    }
+
+}// namespace
+
+StreamRing::StreamRing(size_t numRegions)
+    : regions_(std::max<size_t>(1, numRegions)) {}
+
+void StreamRing::reset(size_t regionSize) {
+
+    regionSize_ = regionSize;
+    region_ = 0;
+
+    for (auto& region : regions_) {
+
+        region.lacksAll = true;
+        region.lacks.clear();
+    }
+    regions_.front().lacksAll = false;
+}
+
+const std::vector<UpdateRange>& StreamRing::advance(const std::vector<UpdateRange>& updated, int size) {
+
+    region_ = (region_ + 1) % regions_.size();
+
+    // every copy lacks the update, the one moved to gets it now along with what it missed before
+    for (auto& region : regions_) {
+
+        if (updated.empty()) {
+
+            region.lacksAll = true;
+            region.lacks.clear();
+
+        } else if (!region.lacksAll) {
+
+            region.lacks.insert(region.lacks.end(), updated.begin(), updated.end());
+        }
+    }
+
+    auto& current = regions_[region_];
+
+    if (current.lacksAll) {
+
+        ranges_.assign(1, {0, size});
+
+    } else {
+
+        ranges_.swap(current.lacks);
+    }
+
+    GLAttributes::coalesce(ranges_, size);
+
+    current.lacksAll = false;
+    current.lacks.clear();
+
+    return ranges_;
+}
+
+size_t StreamRing::numRegions() const {
+
+    return regions_.size();
+}
+
+size_t StreamRing::region() const {
+
+    return region_;
+}
+
+size_t StreamRing::regionSize() const {
+
+    return regionSize_;
+}
+
+size_t StreamRing::offset() const {
+
+    return region_ * regionSize_;
+}
+
+struct GLAttributes::Stream {
+
+    StreamRing ring{numRegions};
+    std::array<GLsync, numRegions> fences{};
+
+    void deleteFences() {
+
+        for (auto& fence : fences) {
+
+            if (fence) glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+};
+
+GLAttributes::GLAttributes(GLInfo& info): info_(info) {}
+
+bool GLAttributes::streams(const BufferAttribute& attribute, unsigned int bufferType) {
+
+    return bufferType == GL_ARRAY_BUFFER && attribute.streamed() && attribute.getUsage() != DrawUsage::Static;
+}
+
+bool GLAttributes::fitsUint16(const unsigned int* indices, const std::vector<UpdateRange>& ranges) {
+
+    for (const auto& range : ranges) {
+
+        const auto begin = indices + range.offset;
+        if (std::any_of(begin, begin + range.count, [](unsigned int i) { return i >= 0xffff; })) return false;
+    }
+
+    return true;
+}
+
+void GLAttributes::coalesce(std::vector<UpdateRange>& ranges, int size) {
+
+    for (auto& range : ranges) {
+
+        const auto end = std::min(size, range.offset + range.count);
+        range.offset = std::max(0, range.offset);
+        range.count = std::max(0, end - range.offset);
+    }
+
+    ranges.erase(std::remove_if(ranges.begin(), ranges.end(), [](const UpdateRange& range) {
+                     return range.count == 0;
+                 }),
+                 ranges.end());
+
+    std::sort(ranges.begin(), ranges.end(), [](const UpdateRange& a, const UpdateRange& b) {
+        return a.offset < b.offset;
+    });
+
+    size_t merged = 0;
+    for (size_t i = 1; i < ranges.size(); i++) {
+
+        auto& last = ranges[merged];
+        const auto& range = ranges[i];
+
+        if (range.offset <= last.offset + last.count) {
+
+            last.count = std::max(last.offset + last.count, range.offset + range.count) - last.offset;
+
+        } else {
+
+            ranges[++merged] = range;
+        }
+    }
+
+    if (!ranges.empty()) ranges.resize(merged + 1);
+}
+
 Buffer GLAttributes::createBuffer(BufferAttribute* attribute, GLenum bufferType) {
 
     const auto usage = attribute->getUsage();
@@ -19,75 +275,210 @@ Buffer GLAttributes::createBuffer(BufferAttribute* attribute, GLenum bufferType)
     glGenBuffers(1, &buffer);
     glBindBuffer(bufferType, buffer);
 
-    GLint type;
-    GLsizei bytesPerElement;
-    if (attribute->typed<unsigned int>()) {
-        type = GL_UNSIGNED_INT;
-        bytesPerElement = sizeof(unsigned int);
-        auto attr = attribute->typed<unsigned int>();
-        const auto& array = attr->array();
-        glBufferData(bufferType, (GLsizei) (array.size() * bytesPerElement), array.data(), as_integer(usage));
-
-    } else if (attribute->typed<float>()) {
-        type = GL_FLOAT;
-        bytesPerElement = sizeof(float);
-        auto attr = attribute->typed<float>();
-        const auto& array = attr->array();
-        glBufferData(bufferType, (GLsizei) (array.size() * bytesPerElement), array.data(), as_integer(usage));
+    auto data = attributeData(attribute);
+
+    if (bufferType == GL_ELEMENT_ARRAY_BUFFER && data.type == GL_UNSIGNED_INT) {
+
+        const auto indices = static_cast<const unsigned int*>(data.data);
+        if (fitsUint16(indices, {{0, static_cast<int>(data.count)}})) {
+
+            scratch_.assign(indices, indices + data.count);
+            data = {scratch_.data(), data.count, GL_UNSIGNED_SHORT, sizeof(uint16_t)};
+        }
+    }
+
+    const auto bytes = data.bytes();
+
+    if (streams(*attribute, bufferType)) {
+
+        // room for every copy, the first one holds the initial data
+        glBufferData(bufferType, (GLsizeiptr) (bytes * numRegions), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(bufferType, 0, (GLsizeiptr) bytes, data.data);
+
+        auto stream = std::make_unique<Stream>();
+        stream->ring.reset(bytes);
+        streams_[attribute] = std::move(stream);
+
     } else {
 
-        throw std::runtime_error("TODO");
+        glBufferData(bufferType, (GLsizeiptr) bytes, data.data, as_integer(usage));
     }
 
-    return {buffer, type, bytesPerElement, attribute->version};// attribute->version + 1 (?)
+    info_.updateUpload(bytes);
+
+    // pending ranges are covered by the full upload
+    attribute->updateRange.count = -1;
+    attribute->clearUpdateRanges();
+
+    // the data as of the current version is uploaded, so update has nothing to do until the next needsUpdate
+    return {buffer, static_cast<int>(data.type), data.bytesPerElement, attribute->version, 0, bytes};
 }
 
-void GLAttributes::updateBuffer(GLuint buffer, BufferAttribute* attribute, GLenum bufferType, int bytesPerElement) {
+void GLAttributes::writeStream(Buffer& buffer, BufferAttribute* attribute, Stream& stream, GLenum bufferType) {
+
+    const auto data = attributeData(attribute);
+    const auto bytes = data.bytes();
+    const auto source = static_cast<const char*>(data.data);
 
     auto& updateRange = attribute->updateRange;
 
-    glBindBuffer(bufferType, buffer);
+    ranges_.assign(attribute->updateRanges.begin(), attribute->updateRanges.end());
+    if (updateRange.count != -1) ranges_.emplace_back(updateRange);
 
-    if (updateRange.count == -1) {
+    updateRange.count = -1;
+    attribute->clearUpdateRanges();
 
-        if (attribute->typed<unsigned int>()) {
+    glBindBuffer(bufferType, buffer.buffer);
 
-            auto attr = attribute->typed<unsigned int>();
-            const auto& array = attr->array();
-            glBufferSubData(bufferType, 0, (GLsizei) (array.size() * bytesPerElement), array.data());
+    auto& ring = stream.ring;
 
-        } else if (attribute->typed<float>()) {
+    // replaces the storage, so no copy is in use any longer, and writes all of the data to the first one
+    const auto orphan = [&](size_t regionSize) {
+        stream.deleteFences();
+        ring.reset(regionSize);
+
+        glBufferData(bufferType, (GLsizeiptr) (regionSize * ring.numRegions()), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(bufferType, 0, (GLsizeiptr) bytes, source);
+        buffer.offset = 0;
+        buffer.size = regionSize;
+
+        info_.updateUpload(bytes);
+    };
+
+    if (bytes > ring.regionSize() || ring.numRegions() == 1) {
+
+        // the attribute grew, or there is a single copy (WebGL can not map buffers)
+        orphan(std::max(bytes, ring.regionSize()));
+        return;
+    }
+
+#ifndef EMSCRIPTEN
+    // every draw reading the current copy has been issued by now
+    auto& fence = stream.fences[ring.region()];
+    if (fence) glDeleteSync(fence);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    const auto& ranges = ring.advance(ranges_, static_cast<int>(data.count));
+
+    auto& next = stream.fences[ring.region()];
+    if (next) {
+
+        const auto result = glClientWaitSync(next, GL_SYNC_FLUSH_COMMANDS_BIT, fenceTimeout);
+        glDeleteSync(next);
+        next = nullptr;
+
+        if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+
+            // the GPU may still read the copy, let the driver provide fresh storage instead
+            orphan(ring.regionSize());
+            return;
+        }
+    }
+
+    const auto offset = ring.offset();
+    const auto bytesPerElement = static_cast<size_t>(data.bytesPerElement);
+
+    // unsynchronized, the fence above already guarantees the copy is free
+    auto dst = static_cast<char*>(glMapBufferRange(bufferType, (GLintptr) offset, (GLsizeiptr) bytes,
+                                                   GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT));
+
+    size_t uploaded = 0;
+    for (const auto& range : ranges) {
+
+        const auto rangeOffset = range.offset * bytesPerElement;
+        const auto rangeBytes = range.count * bytesPerElement;
+
+        if (dst) {
+
+            std::memcpy(dst + rangeOffset, source + rangeOffset, rangeBytes);
+            glFlushMappedBufferRange(bufferType, (GLintptr) rangeOffset, (GLsizeiptr) rangeBytes);
 
-            auto attr = attribute->typed<float>();
-            const auto& array = attr->array();
-            glBufferSubData(bufferType, 0, (GLsizei) (array.size() * bytesPerElement), array.data());
         } else {
 
-            throw std::runtime_error("TODO");
+            glBufferSubData(bufferType, (GLintptr) (offset + rangeOffset), (GLsizeiptr) rangeBytes, source + rangeOffset);
         }
 
-    } else {
+        uploaded += rangeBytes;
+    }
 
-        if (attribute->typed<unsigned int>()) {
+    if (dst) glUnmapBuffer(bufferType);
 
-            auto attr = attribute->typed<unsigned int>();
-            const auto& array = attr->array();
-            std::vector<unsigned int> sub(array.begin() + updateRange.offset, array.begin() + updateRange.offset + updateRange.count);
-            glBufferSubData(bufferType, updateRange.offset * bytesPerElement, (GLsizei) (sub.size() * bytesPerElement), sub.data());
+    buffer.offset = offset;
+
+    if (uploaded > 0) info_.updateUpload(uploaded);
+#endif
+}
 
-        } else if (attribute->typed<float>()) {
+void GLAttributes::updateBuffer(Buffer& buffer, BufferAttribute* attribute, GLenum bufferType) {
+
+    auto& updateRange = attribute->updateRange;
+
+    ranges_.assign(attribute->updateRanges.begin(), attribute->updateRanges.end());
+    if (updateRange.count != -1) ranges_.emplace_back(updateRange);
+
+    glBindBuffer(bufferType, buffer.buffer);
+
+    const auto data = attributeData(attribute);
+    prepareRanges(ranges_, static_cast<int>(data.count));
+
+    size_t bytes;
+    if (data.count * buffer.bytesPerElement > buffer.size) {
+
+        // the attribute grew past the storage, ranges can only be written within it
+        if (buffer.type == GL_UNSIGNED_SHORT && data.type == GL_UNSIGNED_INT) {
+
+            const auto indices = static_cast<const unsigned int*>(data.data);
+            if (fitsUint16(indices, {{0, static_cast<int>(data.count)}})) {
+
+                scratch_.assign(indices, indices + data.count);
+                bytes = data.count * sizeof(uint16_t);
+                glBufferData(bufferType, (GLsizeiptr) bytes, scratch_.data(), as_integer(attribute->getUsage()));
+
+            } else {
+
+                bytes = data.bytes();
+                glBufferData(bufferType, (GLsizeiptr) bytes, data.data, as_integer(attribute->getUsage()));
+
+                buffer.type = GL_UNSIGNED_INT;
+                buffer.bytesPerElement = data.bytesPerElement;
+            }
 
-            auto attr = attribute->typed<float>();
-            const auto& array = attr->array();
-            std::vector<float> sub(array.begin() + updateRange.offset, array.begin() + updateRange.offset + updateRange.count);
-            glBufferSubData(bufferType, updateRange.offset * bytesPerElement, (GLsizei) (sub.size() * bytesPerElement), sub.data());
         } else {
 
-            throw std::runtime_error("TODO");
+            bytes = data.bytes();
+            glBufferData(bufferType, (GLsizeiptr) bytes, data.data, as_integer(attribute->getUsage()));
         }
 
-        updateRange.count = -1;
+        buffer.size = bytes;
+
+    } else if (buffer.type == GL_UNSIGNED_SHORT && data.type == GL_UNSIGNED_INT) {
+
+        const auto indices = static_cast<const unsigned int*>(data.data);
+
+        if (fitsUint16(indices, ranges_)) {
+
+            bytes = uploadNarrowedRanges(bufferType, indices, ranges_, scratch_);
+
+        } else {
+
+            // an index outgrew 16 bits, switch the buffer to 32-bit indices
+            bytes = data.bytes();
+            glBufferData(bufferType, (GLsizeiptr) bytes, data.data, as_integer(attribute->getUsage()));
+
+            buffer.type = GL_UNSIGNED_INT;
+            buffer.bytesPerElement = data.bytesPerElement;
+            buffer.size = bytes;
+        }
+
+    } else {
+
+        bytes = uploadRanges(bufferType, data, ranges_);
     }
+
+    if (bytes > 0) info_.updateUpload(bytes);
+
+    updateRange.count = -1;
+    attribute->clearUpdateRanges();
 }
 
 Buffer GLAttributes::get(BufferAttribute* attribute) {
@@ -113,9 +504,27 @@ void GLAttributes::remove(BufferAttribute* attribute) {
 
         buffers_.erase(attribute);
     }
+
+    if (auto it = streams_.find(attribute); it != streams_.end()) {
+
+        it->second->deleteFences();
+        streams_.erase(it);
+    }
+}
+
+bool GLAttributes::isStreamed(BufferAttribute* attribute) const {
+
+    if (auto attr = dynamic_cast<InterleavedBufferAttribute*>(attribute)) {
+        attribute = attr->data.get();
+    }
+
+    return streams_.count(attribute);
 }
 
-#include <iostream>
+bool GLAttributes::hasStreams() const {
+
+    return !streams_.empty();
+}
 
 void GLAttributes::update(BufferAttribute* attribute, GLenum bufferType) {
 
@@ -132,8 +541,19 @@ void GLAttributes::update(BufferAttribute* attribute, GLenum bufferType) {
         auto& data = buffers_.at(attribute);
 
         if (data.version < attribute->version) {
-            updateBuffer(data.buffer, attribute, bufferType, data.bytesPerElement);
-            ++data.version;
+
+            if (auto it = streams_.find(attribute); it != streams_.end()) {
+
+                writeStream(data, attribute, *it->second, bufferType);
+
+            } else {
+
+                updateBuffer(data, attribute, bufferType);
+            }
+
+            data.version = attribute->version;
         }
     }
 }
+
+GLAttributes::~GLAttributes() = default;
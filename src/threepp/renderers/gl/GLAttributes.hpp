@@ -6,16 +6,76 @@
 #include "threepp/core/BufferAttribute.hpp"
 
 #include "threepp/renderers/gl/Buffer.hpp"
+#include "threepp/renderers/gl/GLInfo.hpp"
 
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace threepp::gl {
 
+    // The copies a streamed attribute is written through, used in turn.
+    // Tracks which copy is current and which ranges each copy lacks, so that an update writes only what
+    // changed since the copy it moves to was last current.
+    class StreamRing {
+
+    public:
+        explicit StreamRing(size_t numRegions);
+
+        // Starts over with copies of regionSize bytes. The first copy is current and complete, the others lack everything.
+        void reset(size_t regionSize);
+
+        // Moves to the next copy, for an update of the ranges (in elements, none for all of them) of an attribute
+        // of size elements. Returns the coalesced ranges to write to the copy.
+        const std::vector<UpdateRange>& advance(const std::vector<UpdateRange>& updated, int size);
+
+        [[nodiscard]] size_t numRegions() const;
+
+        [[nodiscard]] size_t region() const;
+
+        [[nodiscard]] size_t regionSize() const;
+
+        // Byte offset of the current copy.
+        [[nodiscard]] size_t offset() const;
+
+    private:
+        struct Region {
+
+            bool lacksAll = true;
+            std::vector<UpdateRange> lacks;
+        };
+
+        std::vector<Region> regions_;
+        size_t region_ = 0;
+        size_t regionSize_ = 0;
+
+        std::vector<UpdateRange> ranges_;
+    };
+
+    // 32-bit index buffers are stored as 16-bit indices on the GPU when every index fits.
+    //
+    // Dynamic and stream usage vertex attributes with BufferAttribute::setStreamed are streamed: their buffer
+    // holds several copies of the data, and each update writes the next copy while the GPU may still read the
+    // previous ones. Fences make sure a copy is no longer in use before it is overwritten; if the GPU does not release
+    // it in time, the buffer is orphaned instead. Update ranges are honoured: a copy gets what changed since it
+    // was last current. Under Emscripten there is a single copy, orphaned and written whole on each update.
     struct GLAttributes {
 
+        explicit GLAttributes(GLInfo& info);
+
+        // Whether updates of the attribute go through the streaming path.
+        [[nodiscard]] static bool streams(const BufferAttribute& attribute, unsigned int bufferType);
+
+        // Whether the indices in the ranges can be stored as 16-bit indices.
+        // 0xffff is left out, it is the primitive restart index of GLES3 and WebGL2.
+        [[nodiscard]] static bool fitsUint16(const unsigned int* indices, const std::vector<UpdateRange>& ranges);
+
+        // Sorts the ranges, clamps them to [0, size) and merges the ones that overlap or touch.
+        static void coalesce(std::vector<UpdateRange>& ranges, int size);
+
         Buffer createBuffer(BufferAttribute* attribute, unsigned int bufferType);
 
-        void updateBuffer(unsigned int buffer, BufferAttribute* attribute, unsigned int bufferType, int bytesPerElement);
+        void updateBuffer(Buffer& buffer, BufferAttribute* attribute, unsigned int bufferType);
 
         Buffer get(BufferAttribute* attribute);
 
@@ -23,8 +83,24 @@ namespace threepp::gl {
 
         void update(BufferAttribute* attribute, unsigned int bufferType);
 
+        // Whether the attribute is streamed, in which case its buffer offset changes between updates.
+        [[nodiscard]] bool isStreamed(BufferAttribute* attribute) const;
+
+        [[nodiscard]] bool hasStreams() const;
+
+        ~GLAttributes();
+
     private:
+        struct Stream;
+
+        GLInfo& info_;
         std::unordered_map<BufferAttribute*, Buffer> buffers_;
+        std::unordered_map<BufferAttribute*, std::unique_ptr<Stream>> streams_;
+
+        void writeStream(Buffer& buffer, BufferAttribute* attribute, Stream& stream, unsigned int bufferType);
+
+        std::vector<UpdateRange> ranges_;
+        std::vector<uint16_t> scratch_;
     };
 
 }// namespace threepp::gl
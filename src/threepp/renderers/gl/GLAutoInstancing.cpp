@@ -0,0 +1,159 @@
+
+#include "threepp/renderers/gl/GLAutoInstancing.hpp"
+
+#include "threepp/materials/interfaces.hpp"
+
+#include <algorithm>
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace {
+
+    bool canBatch(const RenderItem& item) {
+
+        const auto object = item.object;
+
+        if (!object->hasTag(Object3D::Tag::Mesh) ||
+            object->hasTag(Object3D::Tag::InstancedMesh) ||
+            object->hasTag(Object3D::Tag::BatchedMesh) ||
+            object->hasTag(Object3D::Tag::SkinnedMesh)) {
+            return false;
+        }
+
+        if (object->onBeforeRender || object->onAfterRender) return false;
+
+        if (!item.geometry->getMorphAttributes().empty()) return false;
+
+        if (auto m = item.material->as<MaterialWithMorphTargets>()) {
+            if (m->morphTargets || m->morphNormals) return false;
+        }
+
+        // mirrored meshes need a different front face, which is set per draw
+        return object->matrixWorld->determinant() >= 0;
+    }
+
+    bool sameGroup(const std::optional<GeometryGroup>& a, const std::optional<GeometryGroup>& b) {
+
+        if (a.has_value() != b.has_value()) return false;
+        if (!a) return true;
+
+        return a->start == b->start && a->count == b->count && a->materialIndex == b->materialIndex;
+    }
+
+    bool compatible(const RenderItem& a, const RenderItem& b) {
+
+        return a.geometry == b.geometry &&
+               a.material == b.material &&
+               a.program == b.program &&
+               a.object->receiveShadow == b.object->receiveShadow &&
+               sameGroup(a.group, b.group);
+    }
+
+    // the item material is one of the object materials when the geometry has groups
+    std::shared_ptr<Material> findMaterial(const RenderItem& item) {
+
+        const auto mesh = dynamic_cast<const Mesh*>(item.object);
+        for (const auto& material : mesh->materials()) {
+
+            if (material.get() == item.material) return material;
+        }
+
+        return mesh->material();
+    }
+
+    size_t nextCapacity(size_t count) {
+
+        size_t capacity = 16;
+        while (capacity < count) capacity *= 2;
+        return capacity;
+    }
+
+}// namespace
+
+size_t GLAutoInstancing::runLength(const std::vector<RenderItem*>& list, size_t begin) {
+
+    const auto& first = *list[begin];
+    if (!canBatch(first)) return 1;
+
+    auto end = begin + 1;
+    while (end < list.size() && compatible(first, *list[end]) && canBatch(*list[end])) ++end;
+
+    return end - begin;
+}
+
+InstancedMesh* GLAutoInstancing::acquire(const std::vector<RenderItem*>& list, size_t begin, size_t count) {
+
+    const auto& first = *list[begin];
+
+    auto& proxies = proxies_[{first.geometry, first.material}];
+
+    if (proxies.used == proxies.meshes.size()) {
+        proxies.meshes.emplace_back();
+    }
+
+    auto& mesh = proxies.meshes[proxies.used++];
+
+    if (!mesh || mesh->instanceMatrix()->count() < static_cast<int>(count)) {
+
+        if (mesh) mesh->dispose();
+
+        mesh = InstancedMesh::create(first.object->geometry(), findMaterial(first), nextCapacity(count));
+        mesh->instanceMatrix()->setUsage(DrawUsage::Dynamic);
+    }
+
+    mesh->setCount(count);
+    mesh->receiveShadow = first.object->receiveShadow;
+
+    auto& array = mesh->instanceMatrix()->array();
+    for (size_t i = 0; i < count; ++i) {
+
+        const auto& elements = list[begin + i]->object->matrixWorld->elements;
+        std::copy(elements.begin(), elements.end(), array.begin() + static_cast<std::ptrdiff_t>(i * 16));
+    }
+    mesh->instanceMatrix()->needsUpdate();
+
+    return mesh.get();
+}
+
+void GLAutoInstancing::endFrame() {
+
+    for (auto it = proxies_.begin(); it != proxies_.end();) {
+
+        auto& proxies = it->second;
+
+        for (auto i = proxies.used; i < proxies.meshes.size(); ++i) {
+
+            proxies.meshes[i]->dispose();
+        }
+        proxies.meshes.resize(proxies.used);
+        proxies.used = 0;
+
+        if (proxies.meshes.empty()) {
+
+            it = proxies_.erase(it);
+
+        } else {
+
+            ++it;
+        }
+    }
+}
+
+void GLAutoInstancing::dispose() {
+
+    for (auto& [key, proxies] : proxies_) {
+
+        for (auto& mesh : proxies.meshes) {
+
+            mesh->dispose();
+        }
+    }
+
+    proxies_.clear();
+}
+
+GLAutoInstancing::~GLAutoInstancing() {
+
+    dispose();
+}
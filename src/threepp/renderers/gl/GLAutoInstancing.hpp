@@ -0,0 +1,48 @@
+
+#ifndef THREEPP_GLAUTOINSTANCING_HPP
+#define THREEPP_GLAUTOINSTANCING_HPP
+
+#include "threepp/renderers/gl/GLRenderLists.hpp"
+
+#include "threepp/objects/InstancedMesh.hpp"
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace threepp::gl {
+
+    // Draws runs of plain meshes sharing geometry, material and program as one instanced draw.
+    // Each run is represented by a proxy InstancedMesh whose instance matrices are the world matrices
+    // of the meshes in the run, so the regular USE_INSTANCING shader path is used.
+    class GLAutoInstancing {
+
+    public:
+        // Number of consecutive items, starting at begin, that can be drawn together. Always at least 1.
+        [[nodiscard]] static size_t runLength(const std::vector<RenderItem*>& list, size_t begin);
+
+        // Returns a proxy holding the world matrices of list[begin, begin + count).
+        // Proxies are reused across frames, and are valid until the next call to endFrame.
+        InstancedMesh* acquire(const std::vector<RenderItem*>& list, size_t begin, size_t count);
+
+        // Releases the proxies that were not used since the previous call.
+        void endFrame();
+
+        void dispose();
+
+        ~GLAutoInstancing();
+
+    private:
+        struct Proxies {
+
+            std::vector<std::shared_ptr<InstancedMesh>> meshes;
+            size_t used = 0;
+        };
+
+        std::map<std::pair<const BufferGeometry*, const Material*>, Proxies> proxies_;
+    };
+
+}// namespace threepp::gl
+
+#endif//THREEPP_GLAUTOINSTANCING_HPP
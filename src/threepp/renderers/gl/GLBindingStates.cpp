@@ -50,11 +50,24 @@ struct GLBindingStates::Impl {
             saveCache(geometry, index);
         }
 
-        if (object->is<InstancedMesh>()) {
+        if (object->hasTag(Object3D::Tag::InstancedMesh)) {
 
             updateBuffers = true;
         }
 
+        if (!updateBuffers && attributes_.hasStreams()) {
+
+            // streamed attributes move within their buffer on every update
+            for (const auto& [name, attribute] : geometry->getAttributes()) {
+
+                if (attributes_.isStreamed(attribute.get())) {
+
+                    updateBuffers = true;
+                    break;
+                }
+            }
+        }
+
         if (index) {
 
             attributes_.update(index, GL_ELEMENT_ARRAY_BUFFER);
@@ -118,6 +131,13 @@ struct GLBindingStates::Impl {
                 vao);
     }
 
+    static BufferAttribute* interleavedData(BufferAttribute* attribute) {
+
+        auto interleaved = dynamic_cast<InterleavedBufferAttribute*>(attribute);
+
+        return interleaved ? interleaved->data.get() : nullptr;
+    }
+
     bool needsUpdate(BufferGeometry* geometry, BufferAttribute* index) const {
 
         const auto& cachedAttributes = currentState_->attributes;
@@ -138,7 +158,7 @@ struct GLBindingStates::Impl {
 
             if (cachedAttribute != geometryAttribute.get()) return true;
 
-            //          if (cachedAttribute.data != geometryAttribute.data) return true;
+            if (currentState_->attributesData.count(key) && currentState_->attributesData.at(key) != interleavedData(geometryAttribute.get())) return true;
 
             ++attributesNum;
         }
@@ -153,6 +173,7 @@ struct GLBindingStates::Impl {
     void saveCache(BufferGeometry* geometry, BufferAttribute* index) const {
 
         std::unordered_map<std::string, BufferAttribute*> cache;
+        std::unordered_map<std::string, BufferAttribute*> dataCache;
         const auto& attributes = geometry->getAttributes();
         int attributesNum = 0;
 
@@ -160,10 +181,15 @@ struct GLBindingStates::Impl {
 
             cache[key] = attribute.get();
 
+            if (auto data = interleavedData(attribute.get())) {
+                dataCache[key] = data;
+            }
+
             ++attributesNum;
         }
 
         currentState_->attributes = cache;
+        currentState_->attributesData = dataCache;
         currentState_->attributesNum = attributesNum;
 
         currentState_->index = index;
@@ -282,7 +308,7 @@ struct GLBindingStates::Impl {
                         }
 
                         glBindBuffer(GL_ARRAY_BUFFER, buffer);
-                        vertexAttribPointer(programAttribute, size, type, normalized, stride * bytesPerElement, offset * bytesPerElement);
+                        vertexAttribPointer(programAttribute, size, type, normalized, stride * bytesPerElement, attribute.offset + offset * bytesPerElement);
 
                     } else {
 
@@ -296,15 +322,17 @@ struct GLBindingStates::Impl {
                         }
 
                         glBindBuffer(GL_ARRAY_BUFFER, buffer);
-                        vertexAttribPointer(programAttribute, size, type, normalized, 0, 0);
+                        vertexAttribPointer(programAttribute, size, type, normalized, 0, attribute.offset);
                     }
 
                 } else if (name == "instanceMatrix") {
 
-                    auto attribute = attributes_.get(object->as<InstancedMesh>()->instanceMatrix());
+                    const auto instancedMesh = object->as<InstancedMesh>();
+                    auto attribute = attributes_.get(instancedMesh->perInstanceCulling ? instancedMesh->visibleInstanceMatrix() : instancedMesh->instanceMatrix());
 
                     auto buffer = attribute.buffer;
                     auto type = attribute.type;
+                    auto offset = attribute.offset;
 
                     enableAttributeAndDivisor(programAttribute + 0, 1);
                     enableAttributeAndDivisor(programAttribute + 1, 1);
@@ -313,14 +341,15 @@ struct GLBindingStates::Impl {
 
                     glBindBuffer(GL_ARRAY_BUFFER, buffer);
 
-                    glVertexAttribPointer(programAttribute + 0, 4, type, false, 64, (void*) 0);
-                    glVertexAttribPointer(programAttribute + 1, 4, type, false, 64, (void*) 16);
-                    glVertexAttribPointer(programAttribute + 2, 4, type, false, 64, (void*) 32);
-                    glVertexAttribPointer(programAttribute + 3, 4, type, false, 64, (void*) 48);
+                    glVertexAttribPointer(programAttribute + 0, 4, type, false, 64, (void*) (offset + 0));
+                    glVertexAttribPointer(programAttribute + 1, 4, type, false, 64, (void*) (offset + 16));
+                    glVertexAttribPointer(programAttribute + 2, 4, type, false, 64, (void*) (offset + 32));
+                    glVertexAttribPointer(programAttribute + 3, 4, type, false, 64, (void*) (offset + 48));
 
                 } else if (name == "instanceColor") {
 
-                    auto attribute = attributes_.get(object->as<InstancedMesh>()->instanceColor());
+                    const auto instancedMesh = object->as<InstancedMesh>();
+                    auto attribute = attributes_.get(instancedMesh->perInstanceCulling ? instancedMesh->visibleInstanceColor() : instancedMesh->instanceColor());
 
                     auto buffer = attribute.buffer;
                     auto type = attribute.type;
@@ -329,7 +358,7 @@ struct GLBindingStates::Impl {
 
                     glBindBuffer(GL_ARRAY_BUFFER, buffer);
 
-                    glVertexAttribPointer(programAttribute, 3, type, false, 12, 0);
+                    glVertexAttribPointer(programAttribute, 3, type, false, 12, (void*) attribute.offset);
 
                 } else if (!materialDefaultAttributeValues.empty()) {
 
@@ -23,6 +23,8 @@ namespace threepp::gl {
         std::vector<int> attributeDivisors;
         std::optional<unsigned int> object;
         std::unordered_map<std::string, BufferAttribute*> attributes;
+        // buffer of each interleaved attribute, which can be replaced without replacing the attribute
+        std::unordered_map<std::string, BufferAttribute*> attributesData;
         BufferAttribute* index = nullptr;
 
         int attributesNum = 0;
@@ -120,7 +120,7 @@ struct GLGeometries::Impl {
         std::vector<unsigned int> indices;
 
         const auto geometryIndex = geometry->getIndex();
-        const auto geometryPosition = geometry->getAttribute<float>("position");
+        const auto geometryPosition = geometry->getAttribute("position");
         unsigned int version = 0;
 
         if (geometryIndex != nullptr) {
@@ -139,10 +139,9 @@ struct GLGeometries::Impl {
 
         } else {
 
-            const auto& array = geometryPosition->array();
             version = geometryPosition->version;
 
-            for (unsigned i = 0, l = array.size() / 3 - 1; i < l; i += 3) {
+            for (unsigned i = 0, l = geometryPosition->count() - 1; i < l; i += 3) {
 
                 const auto a = i + 0;
                 const auto b = i + 1;
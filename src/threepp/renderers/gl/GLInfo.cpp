@@ -14,6 +14,12 @@ using namespace threepp;
 
 void gl::GLInfo::update(int count, unsigned int mode, size_t instanceCount) {
 
+    if (shadows_) {
+
+        ++render.shadowCalls;
+        return;
+    }
+
     ++render.calls;
 
     switch (mode) {
@@ -43,6 +49,38 @@ void gl::GLInfo::update(int count, unsigned int mode, size_t instanceCount) {
             break;
     }
 }
+
+void gl::GLInfo::beginShadows() {
+
+    shadows_ = true;
+}
+
+void gl::GLInfo::endShadows() {
+
+    shadows_ = false;
+}
+
+void gl::GLInfo::updateUpload(size_t bytes) {
+
+    ++render.uploads;
+    render.uploadedBytes += bytes;
+}
+
+void gl::GLInfo::updateProgramSwitch() {
+
+    ++render.programSwitches;
+}
+
+void gl::GLInfo::updateTextureBind() {
+
+    ++render.textureBinds;
+}
+
+void gl::GLInfo::updateStateChangeAvoided() {
+
+    ++render.stateChangesAvoided;
+}
+
 void gl::GLInfo::reset() {
 
     ++render.frame;
@@ -50,4 +88,12 @@ void gl::GLInfo::reset() {
     render.triangles = 0;
     render.points = 0;
     render.lines = 0;
+    render.shadowCalls = 0;
+    render.uploads = 0;
+    render.uploadedBytes = 0;
+    render.programSwitches = 0;
+    render.textureBinds = 0;
+    render.stateChangesAvoided = 0;
+    render.occlusionQueries = 0;
+    render.occlusionCulled = 0;
 }
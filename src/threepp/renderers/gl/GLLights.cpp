@@ -3,6 +3,7 @@
 
 #include "threepp/renderers/GLRenderTarget.hpp"
 
+#include "threepp/lights/DirectionalLightShadow.hpp"
 #include "threepp/lights/LightProbe.hpp"
 #include "threepp/lights/LightShadow.hpp"
 
@@ -20,6 +21,9 @@ namespace {
         return (lightB->castShadow ? 1 : 0) < (lightA->castShadow ? 1 : 0);
     }
 
+    // fills the cascade matrices of lights with fewer cascades than the others
+    Matrix4 identityCascade;
+
     template<class T>
     void ensureCapacity(T& container, size_t capacity) {
 
@@ -31,7 +35,7 @@ namespace {
 }// namespace
 
 
-void GLLights::setup(std::vector<Light*>& lights) {
+void GLLights::setup(std::vector<Light*>& lights, Texture* shadowAtlas) {
 
     float r = 0, g = 0, b = 0;
 
@@ -46,6 +50,9 @@ void GLLights::setup(std::vector<Light*>& lights) {
     int numPointShadows = 0;
     int numSpotShadows = 0;
 
+    int numDirectionalShadowCascades = 1;
+    std::vector<const DirectionalLightShadow*> cascadedShadows;
+
     std::sort(lights.begin(), lights.end(), shadowCastingLightsFirst);
 
     for (auto light : lights) {
@@ -83,7 +90,15 @@ void GLLights::setup(std::vector<Light*>& lights) {
                 shadowUniforms->at("shadowBias") = shadow->bias;
                 shadowUniforms->at("shadowNormalBias") = shadow->normalBias;
                 shadowUniforms->at("shadowRadius") = shadow->radius;
-                std::get<Vector2>(shadowUniforms->at("shadowMapSize")).copy(shadow->mapSize);
+                std::get<Vector2>(shadowUniforms->at("shadowMapSize")).copy(shadow->getRenderedMapSize());
+                std::get<Vector4>(shadowUniforms->at("shadowMapRect")).copy(shadow->atlasRect);
+
+                const auto directionalShadow = dynamic_cast<const DirectionalLightShadow*>(shadow.get());
+                const auto cascades = directionalShadow ? static_cast<int>(directionalShadow->cascades()) : 1;
+                shadowUniforms->at("shadowCascades") = static_cast<float>(cascades);
+
+                numDirectionalShadowCascades = std::max(numDirectionalShadowCascades, cascades);
+                cascadedShadows.emplace_back(directionalShadow);
 
                 ensureCapacity(state.directionalShadow, directionalLength + 1);
                 ensureCapacity(state.directionalShadowMap, directionalLength + 1);
@@ -121,7 +136,8 @@ void GLLights::setup(std::vector<Light*>& lights) {
                 shadowUniforms->at("shadowBias") = shadow->bias;
                 shadowUniforms->at("shadowNormalBias") = shadow->normalBias;
                 shadowUniforms->at("shadowRadius") = shadow->radius;
-                std::get<Vector2>(shadowUniforms->at("shadowMapSize")).copy(shadow->mapSize);
+                std::get<Vector2>(shadowUniforms->at("shadowMapSize")).copy(shadow->getRenderedMapSize());
+                std::get<Vector4>(shadowUniforms->at("shadowMapRect")).copy(shadow->atlasRect);
 
                 ensureCapacity(state.spotShadow, spotLength + 1);
                 ensureCapacity(state.spotShadowMap, spotLength + 1);
@@ -154,7 +170,8 @@ void GLLights::setup(std::vector<Light*>& lights) {
                 shadowUniforms->at("shadowBias") = shadow->bias;
                 shadowUniforms->at("shadowNormalBias") = shadow->normalBias;
                 shadowUniforms->at("shadowRadius") = shadow->radius;
-                std::get<Vector2>(shadowUniforms->at("shadowMapSize")).copy(shadow->mapSize);
+                std::get<Vector2>(shadowUniforms->at("shadowMapSize")).copy(shadow->getRenderedMapSize());
+                std::get<Vector4>(shadowUniforms->at("shadowMapRect")).copy(shadow->atlasRect);
                 shadowUniforms->at("shadowCameraNear") = shadow->camera->near;
                 shadowUniforms->at("shadowCameraFar") = shadow->camera->far;
 
@@ -189,6 +206,21 @@ void GLLights::setup(std::vector<Light*>& lights) {
 
     state.ambient.setRGB(r, g, b);
 
+    // numDirectionalShadowCascades matrices per shadow, the matrices of light i start at i * numDirectionalShadowCascades
+    std::vector<Matrix4*> directionalShadowCascadeMatrix;
+    if (numDirectionalShadowCascades > 1) {
+
+        for (const auto shadow : cascadedShadows) {
+
+            for (int c = 0; c < numDirectionalShadowCascades; c++) {
+
+                // only read when uploading the uniforms
+                const auto matrix = shadow && c < static_cast<int>(shadow->cascades()) ? &shadow->cascadeMatrices()[c] : &identityCascade;
+                directionalShadowCascadeMatrix.emplace_back(const_cast<Matrix4*>(matrix));
+            }
+        }
+    }
+
     auto& hash = state.hash;
 
     if (hash.directionalLength != directionalLength ||
@@ -197,7 +229,11 @@ void GLLights::setup(std::vector<Light*>& lights) {
         hash.hemiLength != hemiLength ||
         hash.numDirectionalShadows != numDirectionalShadows ||
         hash.numPointShadows != numPointShadows ||
-        hash.numSpotShadows != numSpotShadows) {
+        hash.numSpotShadows != numSpotShadows ||
+        hash.numDirectionalShadowCascades != numDirectionalShadowCascades ||
+        // the matrices are wired to the materials by address
+        state.directionalShadowCascadeMatrix != directionalShadowCascadeMatrix ||
+        hash.shadowAtlas != shadowAtlas) {
 
         state.directional.resize(directionalLength);
         state.spot.resize(spotLength);
@@ -213,6 +249,9 @@ void GLLights::setup(std::vector<Light*>& lights) {
         state.directionalShadowMatrix.resize(numDirectionalShadows);
         state.pointShadowMatrix.resize(numPointShadows);
         state.spotShadowMatrix.resize(numSpotShadows);
+        state.directionalShadowCascades = numDirectionalShadowCascades;
+        state.directionalShadowCascadeMatrix = std::move(directionalShadowCascadeMatrix);
+        state.shadowAtlas = shadowAtlas;
 
         hash.directionalLength = directionalLength;
         hash.pointLength = pointLength;
@@ -222,6 +261,8 @@ void GLLights::setup(std::vector<Light*>& lights) {
         hash.numDirectionalShadows = numDirectionalShadows;
         hash.numPointShadows = numPointShadows;
         hash.numSpotShadows = numSpotShadows;
+        hash.numDirectionalShadowCascades = numDirectionalShadowCascades;
+        hash.shadowAtlas = shadowAtlas;
 
         state.version = nextVersion++;
     }
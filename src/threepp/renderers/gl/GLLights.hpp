@@ -8,6 +8,7 @@
 #include "threepp/core/Uniform.hpp"
 #include "threepp/math/Vector2.hpp"
 #include "threepp/math/Vector3.hpp"
+#include "threepp/math/Vector4.hpp"
 
 #include <unordered_map>
 #include <vector>
@@ -86,7 +87,9 @@ namespace threepp::gl {
                         {"shadowBias", 0.f},
                         {"shadowNormalBias", 0.f},
                         {"shadowRadius", 1.f},
-                        {"shadowMapSize", Vector2()}};
+                        {"shadowMapSize", Vector2()},
+                        {"shadowCascades", 1.f},
+                        {"shadowMapRect", Vector4()}};
 
             } else if (type == "SpotLight") {
 
@@ -94,7 +97,8 @@ namespace threepp::gl {
                         {"shadowBias", 0.f},
                         {"shadowNormalBias", 0.f},
                         {"shadowRadius", 1.f},
-                        {"shadowMapSize", Vector2()}};
+                        {"shadowMapSize", Vector2()},
+                        {"shadowMapRect", Vector4()}};
 
             } else if (type == "PointLight") {
 
@@ -104,7 +108,8 @@ namespace threepp::gl {
                         {"shadowRadius", 1.f},
                         {"shadowMapSize", Vector2()},
                         {"shadowCameraNear", 1.f},
-                        {"shadowCameraFar", 1000.f}};
+                        {"shadowCameraFar", 1000.f},
+                        {"shadowMapRect", Vector4()}};
             }
 
             lights[light.id] = LightUniforms(uniforms);
@@ -131,6 +136,10 @@ namespace threepp::gl {
                 int numDirectionalShadows = -1;
                 int numPointShadows = -1;
                 int numSpotShadows = -1;
+
+                int numDirectionalShadowCascades = -1;
+
+                Texture* shadowAtlas = nullptr;
             };
 
             unsigned int version = 0;
@@ -143,6 +152,9 @@ namespace threepp::gl {
             std::vector<LightUniforms*> directionalShadow;
             std::vector<Texture*> directionalShadowMap;
             std::vector<Matrix4*> directionalShadowMatrix;
+            // the most cascades of any directional light, and their matrices (see DirectionalLightShadow::cascadeMatrices)
+            int directionalShadowCascades = 1;
+            std::vector<Matrix4*> directionalShadowCascadeMatrix;
             std::vector<LightUniforms*> spot;
             std::vector<LightUniforms*> spotShadow;
             std::vector<Texture*> spotShadowMap;
@@ -152,11 +164,13 @@ namespace threepp::gl {
             std::vector<Texture*> pointShadowMap;
             std::vector<Matrix4*> pointShadowMatrix;
             std::vector<LightUniforms*> hemi;
+            // holds every map when the shadow map packs them into an atlas
+            Texture* shadowAtlas = nullptr;
         };
 
         LightState state{};
 
-        void setup(std::vector<Light*>& lights);
+        void setup(std::vector<Light*>& lights, Texture* shadowAtlas = nullptr);
 
         void setupView(std::vector<Light*>& lights, Camera* camera);
 
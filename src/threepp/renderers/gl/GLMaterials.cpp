@@ -476,77 +476,75 @@ struct GLMaterials::Impl {
 
     void refreshMaterialUniforms(UniformMap& uniforms, Material* material, int pixelRatio, int height) {
 
-        const auto type = material->type();
-
-        if (type == "MeshBasicMaterial") {
+        if (material->hasTag(Material::Tag::MeshBasic)) {
 
             refreshUniformsCommon(uniforms, material);
 
-        } else if (type == "MeshLambertMaterial") {
+        } else if (material->hasTag(Material::Tag::MeshLambert)) {
 
             auto m = material->as<MeshLambertMaterial>();
             refreshUniformsCommon(uniforms, m);
             refreshUniformsLambert(uniforms, m);
 
-        } else if (type == "MeshToonMaterial") {
+        } else if (material->hasTag(Material::Tag::MeshToon)) {
 
             auto m = material->as<MeshToonMaterial>();
             refreshUniformsCommon(uniforms, m);
             refreshUniformsToon(uniforms, m);
 
-        } else if (type == "MeshPhongMaterial") {
+        } else if (material->hasTag(Material::Tag::MeshPhong)) {
 
             auto m = material->as<MeshPhongMaterial>();
             refreshUniformsCommon(uniforms, m);
             refreshUniformsPhong(uniforms, m);
 
-        } else if (type == "MeshStandardMaterial") {
+        } else if (material->hasTag(Material::Tag::MeshStandard)) {
 
             auto m = material->as<MeshStandardMaterial>();
             refreshUniformsCommon(uniforms, material);
             refreshUniformsStandard(uniforms, m);
 
-        } else if (type == "MeshMatcapMaterial") {
+        } else if (material->hasTag(Material::Tag::MeshMatcap)) {
 
             auto m = material->as<MeshMatcapMaterial>();
             refreshUniformsCommon(uniforms, m);
             refreshUniformsMatcap(uniforms, m);
 
-        } else if (type == "MeshDepthMaterial") {
+        } else if (material->hasTag(Material::Tag::MeshDepth)) {
 
             auto m = material->as<MeshDepthMaterial>();
             refreshUniformsCommon(uniforms, m);
             refreshUniformsDepth(uniforms, m);
 
-        } else if (type == "MeshDistanceMaterial") {
+        } else if (material->hasTag(Material::Tag::MeshDistance)) {
 
             auto m = material->as<MeshDistanceMaterial>();
             refreshUniformsCommon(uniforms, m);
             refreshUniformsDistance(uniforms, m);
 
-        } else if (type == "LineBasicMaterial") {
+        } else if (material->hasTag(Material::Tag::LineBasic)) {
 
             auto m = material->as<LineBasicMaterial>();
             refreshUniformsLine(uniforms, m);
 
-        } else if (type == "PointsMaterial") {
+        } else if (material->hasTag(Material::Tag::Points)) {
 
             auto m = material->as<PointsMaterial>();
             refreshUniformsPoints(uniforms, m, pixelRatio, static_cast<float>(height));
 
-        } else if (type == "ShadowMaterial") {
+        } else if (material->hasTag(Material::Tag::Shadow)) {
 
             auto m = material->as<ShadowMaterial>();
             uniforms.at("color").value<Color>().copy(m->color);
             uniforms.at("opacity").value<float>() = material->opacity;
 
-        } else if (type == "SpriteMaterial") {
+        } else if (material->hasTag(Material::Tag::Sprite)) {
 
             auto m = material->as<SpriteMaterial>();
             refreshUniformsSprites(uniforms, m);
 
 
-        } else if (type == "ShaderMaterial") {
+        } else if (material->hasTag(Material::Tag::Shader)) {
 
             auto m = material->as<ShaderMaterial>();
             m->uniformsNeedUpdate = false;
@@ -30,6 +30,8 @@ struct GLObjects::Impl {
             scope->attributes_.remove(instancedMesh->instanceMatrix());
 
             if (instancedMesh->instanceColor()) scope->attributes_.remove(instancedMesh->instanceColor());
+
+            for (auto attribute : instancedMesh->visibleInstanceAttributes()) scope->attributes_.remove(attribute);
         }
 
     private:
@@ -65,18 +67,36 @@ struct GLObjects::Impl {
             updateMap_[geometry] = frame;
         }
 
-        if (auto instancedMesh = object->as<InstancedMesh>()) {
+        if (object->hasTag(Object3D::Tag::InstancedMesh)) {
+
+            auto instancedMesh = dynamic_cast<InstancedMesh*>(object);
 
             if (!object->hasEventListener("dispose", &onInstancedMeshDispose)) {
 
                 object->addEventListener("dispose", &onInstancedMeshDispose);
             }
 
-            attributes_.update(instancedMesh->instanceMatrix(), GL_ARRAY_BUFFER);
+            if (instancedMesh->perInstanceCulling) {
+
+                // only the instances found visible are drawn, nothing to upload before the first cull
+                if (instancedMesh->visibleCount() > 0) {
+
+                    attributes_.update(instancedMesh->visibleInstanceMatrix(), GL_ARRAY_BUFFER);
+
+                    if (instancedMesh->visibleInstanceColor() != nullptr) {
+
+                        attributes_.update(instancedMesh->visibleInstanceColor(), GL_ARRAY_BUFFER);
+                    }
+                }
+
+            } else {
+
+                attributes_.update(instancedMesh->instanceMatrix(), GL_ARRAY_BUFFER);
 
-            if (instancedMesh->instanceColor() != nullptr) {
+                if (instancedMesh->instanceColor() != nullptr) {
 
-                attributes_.update(instancedMesh->instanceColor(), GL_ARRAY_BUFFER);
+                    attributes_.update(instancedMesh->instanceColor(), GL_ARRAY_BUFFER);
+                }
             }
         }
 
@@ -0,0 +1,332 @@
+
+#include "threepp/renderers/gl/GLOcclusionCulling.hpp"
+
+#include "threepp/renderers/gl/GLBindingStates.hpp"
+
+#include "threepp/core/BufferGeometry.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+
+#ifndef EMSCRIPTEN
+#include <glad/glad.h>
+#else
+#include <GLES3/gl3.h>
+#endif
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace {
+
+#ifndef EMSCRIPTEN
+    const std::string glslVersion = "#version 330 core\n";
+#else
+    const std::string glslVersion = "#version 300 es\n";
+#endif
+
+    const std::string vertexSource = glslVersion + R"(
+uniform mat4 boxMatrix;
+layout(location = 0) in vec3 position;
+void main() {
+    gl_Position = boxMatrix * vec4(position, 1.0);
+}
+)";
+
+    const std::string fragmentSource = glslVersion + R"(
+precision mediump float;
+out vec4 color;
+void main() {
+    color = vec4(1.0);
+}
+)";
+
+    // unit cube
+    const std::array<float, 24> boxVertices{
+            0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0,
+            0, 0, 1, 1, 0, 1, 1, 1, 1, 0, 1, 1};
+
+    const std::array<uint8_t, 36> boxIndices{
+            0, 2, 1, 0, 3, 2,
+            4, 5, 6, 4, 6, 7,
+            0, 1, 5, 0, 5, 4,
+            3, 6, 2, 3, 7, 6,
+            0, 4, 7, 0, 7, 3,
+            1, 2, 6, 1, 6, 5};
+
+    // objects not rendered for this many frames are forgotten
+    constexpr size_t maxIdleFrames = 60;
+
+    GLuint compileShader(GLenum type, const std::string& source) {
+
+        const auto shader = glCreateShader(type);
+        const auto str = source.c_str();
+        glShaderSource(shader, 1, &str, nullptr);
+        glCompileShader(shader);
+
+        return shader;
+    }
+
+}// namespace
+
+GLOcclusionCulling::GLOcclusionCulling(GLState& state, GLBindingStates& bindingStates, GLInfo& info)
+    : state_(state), bindingStates_(bindingStates), info_(info) {}
+
+bool GLOcclusionCulling::canCull(const RenderItem& item) {
+
+    const auto object = item.object;
+
+    if (!object->occlusionCulled || !object->hasTag(Object3D::Tag::Mesh)) return false;
+
+    // their bounding box does not cover what is drawn
+    if (object->hasTag(Object3D::Tag::InstancedMesh) ||
+        object->hasTag(Object3D::Tag::BatchedMesh) ||
+        object->hasTag(Object3D::Tag::SkinnedMesh)) {
+        return false;
+    }
+
+    return item.geometry->getMorphAttributes().empty();
+}
+
+void GLOcclusionCulling::cull(const std::vector<RenderItem*>& list, const Camera& camera, std::vector<RenderItem*>& result) {
+
+    result.clear();
+    result.reserve(list.size());
+
+    for (const auto item : list) {
+
+        if (!canCull(*item)) {
+
+            result.emplace_back(item);
+            continue;
+        }
+
+        auto [it, inserted] = entries_.try_emplace({camera.id, item->object->id});
+        auto& entry = it->second;
+
+        if (inserted) entry.phase = entries_.size();
+
+        if (entry.lastSeen != frame_) {
+
+            entry.lastSeen = frame_;
+            readResult(entry);
+        }
+
+        if (entry.occluded) {
+
+            ++info_.render.occlusionCulled;
+            continue;
+        }
+
+        result.emplace_back(item);
+    }
+}
+
+void GLOcclusionCulling::test(const std::vector<RenderItem*>& list, const Camera& camera, const Matrix4& projScreenMatrix, unsigned int interval) {
+
+    if (!initialized_) init();
+    if (!program_) return;
+
+    interval = std::max(interval, 1u);
+
+    Vector3 cameraPosition;
+    cameraPosition.setFromMatrixPosition(*camera.matrixWorld);
+
+    // boxes cut by the near plane would be partially clipped away
+    const auto margin = std::max(camera.near, 0.f) * 2;
+
+    Box3 box;
+    Vector3 size;
+    Matrix4 boxMatrix;
+
+    bool drawing = false;
+
+    for (const auto item : list) {
+
+        if (!canCull(*item)) continue;
+
+        auto it = entries_.find({camera.id, item->object->id});
+        if (it == entries_.end()) continue;
+
+        auto& entry = it->second;
+
+        if (entry.pending || entry.lastTested == frame_) continue;
+        if (!entry.occluded && (frame_ + entry.phase) % interval != 0) continue;
+
+        entry.lastTested = frame_;
+
+        auto geometry = item->geometry;
+        if (!geometry->boundingBox) geometry->computeBoundingBox();
+        if (geometry->boundingBox->isEmpty()) continue;
+
+        box.copy(*geometry->boundingBox).applyMatrix4(*item->object->matrixWorld).expandByScalar(margin);
+        if (box.containsPoint(cameraPosition)) {
+
+            entry.occluded = false;
+            continue;
+        }
+
+        if (!drawing) {
+
+            beginBoxes();
+            drawing = true;
+        }
+
+        const auto& localBox = *geometry->boundingBox;
+        localBox.getSize(size);
+
+        // zero sized axes would make the box invisible
+        size.max({1e-6f, 1e-6f, 1e-6f});
+
+        boxMatrix.makeScale(size.x, size.y, size.z).setPosition(localBox.min());
+        boxMatrix.premultiply(*item->object->matrixWorld).premultiply(projScreenMatrix);
+
+        glUniformMatrix4fv(boxMatrixLocation_, 1, GL_FALSE, boxMatrix.elements.data());
+
+        if (!entry.query) glGenQueries(1, &entry.query);
+
+        glBeginQuery(GL_ANY_SAMPLES_PASSED, entry.query);
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(boxIndices.size()), GL_UNSIGNED_BYTE, nullptr);
+        glEndQuery(GL_ANY_SAMPLES_PASSED);
+
+        entry.pending = true;
+        ++info_.render.occlusionQueries;
+    }
+
+    if (drawing) endBoxes();
+}
+
+void GLOcclusionCulling::endFrame() {
+
+    for (auto it = entries_.begin(); it != entries_.end();) {
+
+        if (frame_ - it->second.lastSeen > maxIdleFrames) {
+
+            if (it->second.query) glDeleteQueries(1, &it->second.query);
+            it = entries_.erase(it);
+
+        } else {
+
+            ++it;
+        }
+    }
+
+    ++frame_;
+}
+
+void GLOcclusionCulling::readResult(Entry& entry) const {
+
+    if (!entry.pending) return;
+
+    GLuint available = 0;
+    glGetQueryObjectuiv(entry.query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return;
+
+    GLuint anySamplesPassed = 0;
+    glGetQueryObjectuiv(entry.query, GL_QUERY_RESULT, &anySamplesPassed);
+
+    entry.occluded = anySamplesPassed == 0;
+    entry.pending = false;
+}
+
+void GLOcclusionCulling::init() {
+
+    initialized_ = true;
+
+    const auto vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource);
+    const auto fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+
+    program_ = glCreateProgram();
+    glAttachShader(program_, vertexShader);
+    glAttachShader(program_, fragmentShader);
+    glLinkProgram(program_);
+
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint linked = 0;
+    glGetProgramiv(program_, GL_LINK_STATUS, &linked);
+
+    if (!linked) {
+
+        std::cerr << "THREE.GLOcclusionCulling: Unable to create the box program, occlusion culling is disabled." << std::endl;
+
+        glDeleteProgram(program_);
+        program_ = 0;
+        return;
+    }
+
+    boxMatrixLocation_ = glGetUniformLocation(program_, "boxMatrix");
+
+    glGenVertexArrays(1, &vao_);
+    glBindVertexArray(vao_);
+
+    glGenBuffers(1, &vertexBuffer_);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(boxVertices), boxVertices.data(), GL_STATIC_DRAW);
+
+    glGenBuffers(1, &indexBuffer_);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(boxIndices), boxIndices.data(), GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    glBindVertexArray(0);
+    bindingStates_.reset();
+}
+
+void GLOcclusionCulling::beginBoxes() {
+
+    // depth tested, but leaves no trace
+    state_.colorBuffer.setMask(false);
+    state_.depthBuffer.setMask(false);
+    state_.depthBuffer.setTest(true);
+    state_.depthBuffer.setFunc(DepthFunc::LessEqual);
+    state_.stencilBuffer.setTest(false);
+    state_.setCullFace(CullFace::None);
+    state_.setPolygonOffset(false);
+
+    state_.useProgram(program_);
+
+    glBindVertexArray(vao_);
+}
+
+void GLOcclusionCulling::endBoxes() {
+
+    // the binding states track the bound vertex array
+    glBindVertexArray(0);
+    bindingStates_.reset();
+
+    state_.colorBuffer.setMask(true);
+    state_.depthBuffer.setMask(true);
+}
+
+void GLOcclusionCulling::dispose() {
+
+    for (auto& [key, entry] : entries_) {
+
+        if (entry.query) glDeleteQueries(1, &entry.query);
+    }
+    entries_.clear();
+
+    if (initialized_) {
+
+        if (program_) {
+
+            glDeleteProgram(program_);
+            glDeleteVertexArrays(1, &vao_);
+            glDeleteBuffers(1, &vertexBuffer_);
+            glDeleteBuffers(1, &indexBuffer_);
+        }
+
+        program_ = 0;
+        initialized_ = false;
+    }
+}
+
+GLOcclusionCulling::~GLOcclusionCulling() {
+
+    dispose();
+}
@@ -0,0 +1,85 @@
+
+#ifndef THREEPP_GLOCCLUSIONCULLING_HPP
+#define THREEPP_GLOCCLUSIONCULLING_HPP
+
+#include "threepp/renderers/gl/GLInfo.hpp"
+#include "threepp/renderers/gl/GLRenderLists.hpp"
+#include "threepp/renderers/gl/GLState.hpp"
+
+#include "threepp/cameras/Camera.hpp"
+#include "threepp/math/Matrix4.hpp"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace threepp::gl {
+
+    struct GLBindingStates;
+
+    // Skips objects whose bounding box was hidden when it was last tested.
+    // Boxes are drawn after the opaque pass inside GL_ANY_SAMPLES_PASSED queries, and the results are read in
+    // later frames once GL reports them as available. The CPU never waits for the GPU, at the cost of an object
+    // that comes into view appearing a frame or two late.
+    class GLOcclusionCulling {
+
+    public:
+        GLOcclusionCulling(GLState& state, GLBindingStates& bindingStates, GLInfo& info);
+
+        // Whether the item is subject to occlusion culling: plain meshes with a static bounding box.
+        [[nodiscard]] static bool canCull(const RenderItem& item);
+
+        // Copies the items of list that are not known to be occluded from the camera to result.
+        void cull(const std::vector<RenderItem*>& list, const Camera& camera, std::vector<RenderItem*>& result);
+
+        // Tests the bounding boxes of the items against the current depth buffer. Hidden objects are tested
+        // every frame, visible ones every interval frames. Call after the opaque objects are drawn.
+        void test(const std::vector<RenderItem*>& list, const Camera& camera, const Matrix4& projScreenMatrix, unsigned int interval);
+
+        // Forgets objects that have not been rendered for a while.
+        void endFrame();
+
+        void dispose();
+
+        ~GLOcclusionCulling();
+
+    private:
+        struct Entry {
+
+            unsigned int query = 0;
+            bool pending = false;
+            bool occluded = false;
+
+            // spreads the tests of visible objects over frames
+            size_t phase = 0;
+            size_t lastSeen = 0;
+            size_t lastTested = 0;
+        };
+
+        GLState& state_;
+        GLBindingStates& bindingStates_;
+        GLInfo& info_;
+
+        size_t frame_ = 1;
+        // by camera and object id, which unlike addresses are never reused by later objects
+        std::map<std::pair<unsigned int, unsigned int>, Entry> entries_;
+
+        bool initialized_ = false;
+        unsigned int program_ = 0;
+        int boxMatrixLocation_ = -1;
+        unsigned int vao_ = 0;
+        unsigned int vertexBuffer_ = 0;
+        unsigned int indexBuffer_ = 0;
+
+        void init();
+
+        void readResult(Entry& entry) const;
+
+        void beginBoxes();
+
+        void endBoxes();
+    };
+
+}// namespace threepp::gl
+
+#endif//THREEPP_GLOCCLUSIONCULLING_HPP
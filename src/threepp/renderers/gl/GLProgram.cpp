@@ -2,17 +2,21 @@
 #include "threepp/renderers/gl/GLProgram.hpp"
 
 #include "threepp/renderers/gl/GLBindingStates.hpp"
+#include "threepp/renderers/gl/GLProgramBinaryCache.hpp"
 #include "threepp/renderers/gl/GLPrograms.hpp"
+#include "threepp/renderers/gl/GLShaderPreprocessor.hpp"
+#include "threepp/renderers/gl/GLUniformBuffers.hpp"
 #include "threepp/renderers/gl/GLUniforms.hpp"
 
 #include "threepp/renderers/GLRenderer.hpp"
 #include "threepp/renderers/shaders/ShaderChunk.hpp"
-#include "threepp/utils/RegexUtil.hpp"
 #include "threepp/utils/StringUtils.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <list>
+#include <sstream>
 #include <vector>
 
 #ifndef EMSCRIPTEN
@@ -62,25 +66,6 @@ namespace {
         }
     }
 
-    std::string loopReplacer(const std::smatch& match) {
-
-        static std::regex reg1(R"(\[\s*i\s*\])");
-        static std::regex reg2("UNROLLED_LOOP_INDEX");
-
-        auto start = utils::parseInt(match[1].str());
-        auto end = utils::parseInt(match[2].str());
-
-        std::stringstream ss;
-        for (int i = start; i < end; ++i) {
-
-            auto str = std::regex_replace(match[3].str(), reg1, "[ " + std::to_string(i) + " ]");
-            utils::replaceAll(str, "UNROLLED_LOOP_INDEX", std::to_string(i));
-            ss << str;
-        }
-
-        return ss.str();
-    }
-
     std::string getTexelDecodingFunction(const std::string& functionName, Encoding encoding) {
 
         const auto components = getEncodingComponents(encoding);
@@ -170,72 +155,45 @@ namespace {
         return str.empty();
     }
 
-    void replaceLightNums(std::string& str, const ProgramParameters* parameters) {
-
-        std::string& result = str;
-        utils::replaceAll(result, "NUM_DIR_LIGHTS", std::to_string(parameters->numDirLights));
-        utils::replaceAll(result, "NUM_SPOT_LIGHTS", std::to_string(parameters->numSpotLights));
-        utils::replaceAll(result, "NUM_RECT_AREA_LIGHTS", std::to_string(parameters->numRectAreaLights));
-        utils::replaceAll(result, "NUM_POINT_LIGHTS", std::to_string(parameters->numPointLights));
-        utils::replaceAll(result, "NUM_HEMI_LIGHTS", std::to_string(parameters->numHemiLights));
-        utils::replaceAll(result, "NUM_DIR_LIGHT_SHADOWS", std::to_string(parameters->numDirLightShadows));
-        utils::replaceAll(result, "NUM_SPOT_LIGHT_SHADOWS", std::to_string(parameters->numSpotLightShadows));
-        utils::replaceAll(result, "NUM_POINT_LIGHT_SHADOWS", std::to_string(parameters->numPointLightShadows));
+    GLShaderPreprocessor::Replacements generateReplacements(const ProgramParameters* parameters) {
+
+        return {
+                {"NUM_DIR_LIGHTS", std::to_string(parameters->numDirLights)},
+                {"NUM_SPOT_LIGHTS", std::to_string(parameters->numSpotLights)},
+                {"NUM_RECT_AREA_LIGHTS", std::to_string(parameters->numRectAreaLights)},
+                {"NUM_POINT_LIGHTS", std::to_string(parameters->numPointLights)},
+                {"NUM_HEMI_LIGHTS", std::to_string(parameters->numHemiLights)},
+                {"NUM_DIR_LIGHT_SHADOWS", std::to_string(parameters->numDirLightShadows)},
+                {"NUM_SPOT_LIGHT_SHADOWS", std::to_string(parameters->numSpotLightShadows)},
+                {"NUM_POINT_LIGHT_SHADOWS", std::to_string(parameters->numPointLightShadows)},
+                {"NUM_DIR_LIGHT_SHADOW_CASCADES", std::to_string(parameters->numDirLightShadowCascades)},
+                {"NUM_CLIPPING_PLANES", std::to_string(parameters->numClippingPlanes)},
+                {"UNION_CLIPPING_PLANES", std::to_string(parameters->numClippingPlanes - parameters->numClipIntersection)}};
     }
 
-    void replaceClippingPlaneNums(std::string& str, const ProgramParameters* parameters) {
+    inline std::string generatePrecision() {
 
-        utils::replaceAll(str, "NUM_CLIPPING_PLANES", std::to_string(parameters->numClippingPlanes));
-        utils::replaceAll(str, "UNION_CLIPPING_PLANES", std::to_string(parameters->numClippingPlanes - parameters->numClipIntersection));
+        return "precision highp float;\nprecision highp int;\n#define HIGH_PRECISION";
     }
 
-    // Resolve Includes
+    // with uniform buffers, the camera uniforms live in a block shared by both stages (see GLUniformBuffers)
+    std::string generateCameraUniforms(const ProgramParameters* parameters, bool vertex) {
 
-    std::string resolveIncludes(const std::string& str) {
+        if (parameters->uniformBuffers) {
 
-        static const std::regex rex("#include +<([\\w\\d.]+)>");
-
-        std::string result;
-
-        std::sregex_iterator rex_it(str.begin(), str.end(), rex);
-        std::sregex_iterator rex_end;
-        size_t pos = 0;
-
-        while (rex_it != rex_end) {
-            std::smatch match = *rex_it;
-            result.append(str, pos, match.position(0) - pos);
-            pos = match.position(0) + match.length(0);
-
-            const std::ssub_match& sub = match[1];
-            const std::string& r = shaders::ShaderChunk::instance().get(sub.str());
-            if (r.empty()) {
-                std::stringstream ss;
-                ss << "unable to resolve #include <" << sub.str() << ">";
-                throw std::logic_error(ss.str());
-            }
-            result.append(r);
-            ++rex_it;
+            return "#define USE_UNIFORM_BUFFERS\n"
+                   "layout(std140) uniform CameraBlock {\n"
+                   "\tmat4 projectionMatrix;\n"
+                   "\tmat4 viewMatrix;\n"
+                   "\tvec3 cameraPosition;\n"
+                   "\tbool isOrthographic;\n"
+                   "};";
         }
 
-        if (pos == 0) return str;
-        else {
-            result.append(str, pos, str.length());
-            return result;
-        }
-    }
-
-    // Unroll loops
-
-    std::string unrollLoops(const std::string& glsl) {
-
-        static const std::regex rex(R"(#pragma unroll_loop_start\s+for\s*\(\s*int\s+i\s*=\s*(\d+)\s*;\s*i\s*<\s*(\d+)\s*;\s*i\s*\+\+\s*\)\s*\{([\s\S]+?)\}\s+#pragma unroll_loop_end)");
-
-        return regex_replace(glsl, rex, loopReplacer);
-    }
-
-    inline std::string generatePrecision() {
-
-        return "precision highp float;\nprecision highp int;\n#define HIGH_PRECISION";
+        return std::string(vertex ? "uniform mat4 projectionMatrix;\n" : "") +
+               "uniform mat4 viewMatrix;\n"
+               "uniform vec3 cameraPosition;\n"
+               "uniform bool isOrthographic;";
     }
 
     std::string generateShadowMapTypeDefine(const ProgramParameters* parameters) {
@@ -329,9 +287,22 @@ namespace {
 }// namespace
 
 
-GLProgram::GLProgram(const GLRenderer* renderer, std::string cacheKey, const ProgramParameters* parameters, GLBindingStates* bindingStates)
+GLProgram::GLProgram(const GLRenderer* renderer, std::string cacheKey, const ProgramParameters* parameters, GLBindingStates* bindingStates, const GLProgramBinaryCache* binaryCache)
     : cacheKey(std::move(cacheKey)), bindingStates(bindingStates) {
 
+    this->program = glCreateProgram();
+
+    if (binaryCache && binaryCache->load(program, this->cacheKey)) {
+
+        // block bindings are not part of the program binary
+        if (parameters->uniformBuffers) {
+
+            GLUniformBuffers::bindBlocks(program);
+        }
+
+        return;
+    }
+
     auto& defines = parameters->defines;
 
     auto vertexShader = parameters->vertexShader;
@@ -346,8 +317,6 @@ GLProgram::GLProgram(const GLRenderer* renderer, std::string cacheKey, const Pro
 
     auto customDefines = generateDefines(defines);
 
-    this->program = glCreateProgram();
-
     std::string prefixVertex, prefixFragment;
 
     if (parameters->isRawShaderMaterial) {
@@ -400,6 +369,7 @@ GLProgram::GLProgram(const GLRenderer* renderer, std::string cacheKey, const Pro
 
                     parameters->instancing ? "#define USE_INSTANCING" : "",
                     parameters->instancingColor ? "#define USE_INSTANCING_COLOR" : "",
+                    parameters->batching ? "#define USE_BATCHING" : "",
 
                     parameters->supportsVertexTextures ? "#define VERTEX_TEXTURES" : "",
 
@@ -435,6 +405,7 @@ GLProgram::GLProgram(const GLRenderer* renderer, std::string cacheKey, const Pro
                     parameters->vertexTangents ? "#define USE_TANGENT" : "",
                     parameters->vertexColors ? "#define USE_COLOR" : "",
                     parameters->vertexAlphas ? "#define USE_COLOR_ALPHA" : "",
+                    parameters->octahedralNormals ? "#define USE_OCTAHEDRAL_NORMALS" : "",
                     parameters->vertexUvs ? "#define USE_UV" : "",
                     parameters->uvsVertexOnly ? "#define UVS_VERTEX_ONLY" : "",
 
@@ -457,11 +428,8 @@ GLProgram::GLProgram(const GLRenderer* renderer, std::string cacheKey, const Pro
 
                     "uniform mat4 modelMatrix;",
                     "uniform mat4 modelViewMatrix;",
-                    "uniform mat4 projectionMatrix;",
-                    "uniform mat4 viewMatrix;",
                     "uniform mat3 normalMatrix;",
-                    "uniform vec3 cameraPosition;",
-                    "uniform bool isOrthographic;",
+                    generateCameraUniforms(parameters, true),
 
                     "#ifdef USE_INSTANCING",
 
@@ -475,10 +443,52 @@ GLProgram::GLProgram(const GLRenderer* renderer, std::string cacheKey, const Pro
 
                     "#endif",
 
+                    "#ifdef USE_BATCHING",
+
+                    "	attribute float batchId;",
+                    "	uniform highp sampler2D batchingTexture;",
+
+                    "	mat4 getBatchingMatrix( const in float i ) {",
+
+                    "		int size = textureSize( batchingTexture, 0 ).x;",
+                    "		int j = int( i ) * 4;",
+                    "		int x = j % size;",
+                    "		int y = j / size;",
+
+                    "		vec4 v1 = texelFetch( batchingTexture, ivec2( x, y ), 0 );",
+                    "		vec4 v2 = texelFetch( batchingTexture, ivec2( x + 1, y ), 0 );",
+                    "		vec4 v3 = texelFetch( batchingTexture, ivec2( x + 2, y ), 0 );",
+                    "		vec4 v4 = texelFetch( batchingTexture, ivec2( x + 3, y ), 0 );",
+
+                    "		return mat4( v1, v2, v3, v4 );",
+
+                    "	}",
+
+                    "#endif",
+
                     "attribute vec3 position;",
-                    "attribute vec3 normal;",
                     "attribute vec2 uv;",
 
+                    "#ifdef USE_OCTAHEDRAL_NORMALS",
+
+                    "	attribute vec2 normal;",
+
+                    // the two components are stored as unsigned normalized values
+                    "	vec3 octahedralDecode( const in vec2 encoded ) {",
+
+                    "		vec2 e = encoded * 2.0 - 1.0;",
+                    "		vec3 v = vec3( e, 1.0 - abs( e.x ) - abs( e.y ) );",
+                    "		if ( v.z < 0.0 ) v.xy = ( 1.0 - abs( v.yx ) ) * vec2( v.x >= 0.0 ? 1.0 : - 1.0, v.y >= 0.0 ? 1.0 : - 1.0 );",
+                    "		return normalize( v );",
+
+                    "	}",
+
+                    "#else",
+
+                    "	attribute vec3 normal;",
+
+                    "#endif",
+
                     "#ifdef USE_TANGENT",
 
                     "	attribute vec4 tangent;",
@@ -596,6 +606,7 @@ GLProgram::GLProgram(const GLRenderer* renderer, std::string cacheKey, const Pro
 
                     parameters->shadowMapEnabled ? "#define USE_SHADOWMAP" : "",
                     parameters->shadowMapEnabled ? "#define " + shadowMapTypeDefine : "",
+                    parameters->shadowAtlas ? "#define USE_SHADOW_ATLAS" : "",
 
                     parameters->premultipliedAlpha ? "#define PREMULTIPLIED_ALPHA" : "",
 
@@ -603,9 +614,7 @@ GLProgram::GLProgram(const GLRenderer* renderer, std::string cacheKey, const Pro
 
                     parameters->logarithmicDepthBuffer ? "#define USE_LOGDEPTHBUF" : "",
 
-                    "uniform mat4 viewMatrix;",
-                    "uniform vec3 cameraPosition;",
-                    "uniform bool isOrthographic;",
+                    generateCameraUniforms(parameters, false),
 
                     (parameters->toneMapping != ToneMapping::None) ? "#define TONE_MAPPING" : "",
                     (parameters->toneMapping != ToneMapping::None) ? shaders::ShaderChunk::instance().tonemapping_pars_fragment() : "",// this code is required here because it is used by the toneMapping() function defined below
@@ -638,16 +647,9 @@ GLProgram::GLProgram(const GLRenderer* renderer, std::string cacheKey, const Pro
         }
     }
 
-    vertexShader = resolveIncludes(vertexShader);
-    replaceLightNums(vertexShader, parameters);
-    replaceClippingPlaneNums(vertexShader, parameters);
-
-    fragmentShader = resolveIncludes(fragmentShader);
-    replaceLightNums(fragmentShader, parameters);
-    replaceClippingPlaneNums(fragmentShader, parameters);
-
-    vertexShader = unrollLoops(vertexShader);
-    fragmentShader = unrollLoops(fragmentShader);
+    const auto replacements = generateReplacements(parameters);
+    vertexShader = GLShaderPreprocessor::instance().get(vertexShader, replacements);
+    fragmentShader = GLShaderPreprocessor::instance().get(fragmentShader, replacements);
 
     std::string glslVersion{"330 core"};
 #if EMSCRIPTEN
@@ -713,8 +715,23 @@ GLProgram::GLProgram(const GLRenderer* renderer, std::string cacheKey, const Pro
         glBindAttribLocation(program, 0, "position");
     }
 
+    if (binaryCache) {
+
+        binaryCache->prepare(program);
+    }
+
     glLinkProgram(program);
 
+    if (binaryCache) {
+
+        binaryCache->save(program, this->cacheKey);
+    }
+
+    if (parameters->uniformBuffers) {
+
+        GLUniformBuffers::bindBlocks(program);
+    }
+
     if (renderer->checkShaderErrors) {
 
         int length;
@@ -743,6 +760,37 @@ GLUniforms* GLProgram::getUniforms() {
     return cachedUniforms.get();
 }
 
+const BuiltinUniforms& GLProgram::getBuiltinUniforms() {
+
+    if (!cachedBuiltinUniforms) {
+
+        const auto uniforms = getUniforms();
+
+        cachedBuiltinUniforms = std::make_unique<BuiltinUniforms>();
+        auto& b = *cachedBuiltinUniforms;
+
+        b.modelViewMatrix = uniforms->getHandle("modelViewMatrix");
+        b.normalMatrix = uniforms->getHandle("normalMatrix");
+        b.modelMatrix = uniforms->getHandle("modelMatrix");
+
+        b.projectionMatrix = uniforms->getHandle("projectionMatrix");
+        b.viewMatrix = uniforms->getHandle("viewMatrix");
+        b.cameraPosition = uniforms->getHandle("cameraPosition");
+        b.isOrthographic = uniforms->getHandle("isOrthographic");
+        b.logDepthBufFC = uniforms->getHandle("logDepthBufFC");
+
+        b.bindMatrix = uniforms->getHandle("bindMatrix");
+        b.bindMatrixInverse = uniforms->getHandle("bindMatrixInverse");
+        b.boneTextureSize = uniforms->getHandle("boneTextureSize");
+
+        b.receiveShadow = uniforms->getHandle("receiveShadow");
+        b.toneMappingExposure = uniforms->getHandle("toneMappingExposure");
+        b.center = uniforms->getHandle("center");
+    }
+
+    return *cachedBuiltinUniforms;
+}
+
 std::unordered_map<std::string, int> GLProgram::getAttributes() {
 
     if (cachedAttributes.empty()) {
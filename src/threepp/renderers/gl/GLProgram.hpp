@@ -16,6 +16,29 @@ namespace threepp {
     namespace gl {
 
         struct GLBindingStates;
+        class GLProgramBinaryCache;
+
+        // Handles to the uniforms the renderer writes for every object or camera, resolved once per program.
+        struct BuiltinUniforms {
+
+            UniformHandle modelViewMatrix;
+            UniformHandle normalMatrix;
+            UniformHandle modelMatrix;
+
+            UniformHandle projectionMatrix;
+            UniformHandle viewMatrix;
+            UniformHandle cameraPosition;
+            UniformHandle isOrthographic;
+            UniformHandle logDepthBufFC;
+
+            UniformHandle bindMatrix;
+            UniformHandle bindMatrixInverse;
+            UniformHandle boneTextureSize;
+
+            UniformHandle receiveShadow;
+            UniformHandle toneMappingExposure;
+            UniformHandle center;
+        };
 
         struct GLProgram {
 
@@ -25,7 +48,8 @@ namespace threepp {
             int usedTimes = 1;
             int program = -1;
 
-            GLProgram(const GLRenderer* renderer, std::string cacheKey, const ProgramParameters* parameters, GLBindingStates* bindingStates);
+            // If a binary cache is given, the program is restored from it when possible and stored in it otherwise.
+            GLProgram(const GLRenderer* renderer, std::string cacheKey, const ProgramParameters* parameters, GLBindingStates* bindingStates, const GLProgramBinaryCache* binaryCache = nullptr);
 
             GLProgram(const GLProgram&) = delete;
             GLProgram(GLProgram&&) = delete;
@@ -34,6 +58,8 @@ namespace threepp {
 
             GLUniforms* getUniforms();
 
+            const BuiltinUniforms& getBuiltinUniforms();
+
             std::unordered_map<std::string, int> getAttributes();
 
             void destroy();
@@ -41,6 +67,7 @@ namespace threepp {
         protected:
             GLBindingStates* bindingStates = nullptr;
             std::unique_ptr<GLUniforms> cachedUniforms;
+            std::unique_ptr<BuiltinUniforms> cachedBuiltinUniforms;
             std::unordered_map<std::string, int> cachedAttributes;
 
             GLProgram() = default;
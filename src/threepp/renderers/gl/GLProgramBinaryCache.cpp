@@ -0,0 +1,212 @@
+
+#include "threepp/renderers/gl/GLProgramBinaryCache.hpp"
+
+#include "threepp/renderers/shaders/ShaderChunk.hpp"
+#include "threepp/utils/StringUtils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#ifndef EMSCRIPTEN
+#include <glad/glad.h>
+#else
+#include <GLES3/gl3.h>
+#endif
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace {
+
+    constexpr uint32_t magic = 0x42505054;// "TPPB"
+    // bumped whenever the entry layout or the way keys are built changes
+    constexpr uint32_t formatVersion = 2;
+    // far above any driver's program binaries, a larger size means the file is corrupt
+    constexpr uint64_t maxBinarySize = 256 * 1024 * 1024;
+
+    template<class T>
+    void write(std::ostream& out, T value) {
+
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<class T>
+    bool read(std::istream& in, T& value) {
+
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    // bytes left in the stream, or the largest value when it can not tell
+    uint64_t remaining(std::istream& in) {
+
+        const auto pos = in.tellg();
+        if (pos < 0) return std::numeric_limits<uint64_t>::max();
+
+        in.seekg(0, std::ios::end);
+        const auto end = in.tellg();
+        in.seekg(pos);
+
+        return end > pos ? static_cast<uint64_t>(end - pos) : 0;
+    }
+
+    std::string glString(GLenum name) {
+
+        const auto str = glGetString(name);
+        return str ? reinterpret_cast<const char*>(str) : "";
+    }
+
+}// namespace
+
+GLProgramBinaryCache::GLProgramBinaryCache(std::filesystem::path directory)
+    : directory_(std::move(directory)) {
+
+#ifndef EMSCRIPTEN
+    if (glProgramBinary && glGetProgramBinary) {
+
+        GLint numFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+        supported_ = numFormats > 0;
+    }
+#endif
+
+    if (supported_) {
+
+        std::error_code ec;
+        std::filesystem::create_directories(directory_, ec);
+        supported_ = !ec;
+    }
+
+    identity_ = "threepp program binary cache " + std::to_string(formatVersion) + "\n" +
+                "threepp " THREEPP_VERSION "\n" +
+                glString(GL_VENDOR) + "\n" +
+                glString(GL_RENDERER) + "\n" +
+                glString(GL_VERSION) + "\n" +
+                std::to_string(shaders::ShaderChunk::instance().hash()) + "\n";
+}
+
+const std::filesystem::path& GLProgramBinaryCache::directory() const {
+
+    return directory_;
+}
+
+bool GLProgramBinaryCache::supported() const {
+
+    return supported_;
+}
+
+void GLProgramBinaryCache::prepare(unsigned int program) const {
+
+    if (!supported_) return;
+
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+bool GLProgramBinaryCache::load(unsigned int program, const std::string& cacheKey) const {
+
+    if (!supported_) return false;
+
+    const auto key = fullKey(cacheKey);
+
+    std::ifstream in(directory_ / fileName(key), std::ios::binary);
+    if (!in) return false;
+
+    const auto entry = readEntry(in, key);
+    if (!entry) return false;
+
+    glProgramBinary(program, entry->format, entry->binary.data(), static_cast<GLsizei>(entry->binary.size()));
+
+    // the driver may reject binaries produced by another driver build
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+
+    return linked == GL_TRUE;
+}
+
+void GLProgramBinaryCache::save(unsigned int program, const std::string& cacheKey) const {
+
+    if (!supported_) return;
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE) return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    Entry entry;
+    entry.binary.resize(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, nullptr, &format, entry.binary.data());
+    entry.format = format;
+
+    const auto key = fullKey(cacheKey);
+    const auto path = directory_ / fileName(key);
+
+    // write to a temporary file first, so that a concurrent reader never sees a partial entry
+    auto tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) return;
+        writeEntry(out, key, entry);
+        if (!out) return;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) std::filesystem::remove(tmp, ec);
+}
+
+std::string GLProgramBinaryCache::fileName(const std::string& key) {
+
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << utils::fnv1a(key) << ".bin";
+    return ss.str();
+}
+
+void GLProgramBinaryCache::writeEntry(std::ostream& out, const std::string& key, const Entry& entry) {
+
+    write(out, magic);
+    write(out, formatVersion);
+    write(out, static_cast<uint32_t>(entry.format));
+    write(out, static_cast<uint64_t>(key.size()));
+    out.write(key.data(), static_cast<std::streamsize>(key.size()));
+    write(out, static_cast<uint64_t>(entry.binary.size()));
+    out.write(entry.binary.data(), static_cast<std::streamsize>(entry.binary.size()));
+}
+
+std::optional<GLProgramBinaryCache::Entry> GLProgramBinaryCache::readEntry(std::istream& in, const std::string& key) {
+
+    uint32_t fileMagic, fileVersion, format;
+    if (!read(in, fileMagic) || fileMagic != magic) return std::nullopt;
+    if (!read(in, fileVersion) || fileVersion != formatVersion) return std::nullopt;
+    if (!read(in, format)) return std::nullopt;
+
+    // the full key is stored to guard against file name collisions
+    uint64_t keySize;
+    if (!read(in, keySize) || keySize != key.size()) return std::nullopt;
+    std::string fileKey(keySize, '\0');
+    if (!in.read(fileKey.data(), static_cast<std::streamsize>(keySize)) || fileKey != key) return std::nullopt;
+
+    uint64_t binarySize;
+    if (!read(in, binarySize) || binarySize == 0) return std::nullopt;
+    // checked before allocating, as the size comes from the file
+    if (binarySize > std::min(maxBinarySize, remaining(in))) return std::nullopt;
+
+    Entry entry;
+    entry.format = format;
+    entry.binary.resize(binarySize);
+    if (!in.read(entry.binary.data(), static_cast<std::streamsize>(binarySize))) return std::nullopt;
+
+    return entry;
+}
+
+std::string GLProgramBinaryCache::fullKey(const std::string& cacheKey) const {
+
+    return identity_ + cacheKey;
+}
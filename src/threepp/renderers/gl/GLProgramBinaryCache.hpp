@@ -0,0 +1,60 @@
+
+#ifndef THREEPP_GLPROGRAMBINARYCACHE_HPP
+#define THREEPP_GLPROGRAMBINARYCACHE_HPP
+
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace threepp::gl {
+
+    // Persists linked program binaries (glGetProgramBinary) in a directory, so that later runs can skip
+    // shader preprocessing, compilation and linking. Entries are keyed by the program cache key together
+    // with the cache format version, the library version, the driver identity and the shader chunk sources,
+    // so a driver or library update invalidates them.
+    class GLProgramBinaryCache {
+
+    public:
+        struct Entry {
+
+            unsigned int format{};
+            std::vector<char> binary;
+        };
+
+        // Requires a current GL context.
+        explicit GLProgramBinaryCache(std::filesystem::path directory);
+
+        [[nodiscard]] const std::filesystem::path& directory() const;
+
+        [[nodiscard]] bool supported() const;
+
+        // Must be called before linking a program that is going to be saved.
+        void prepare(unsigned int program) const;
+
+        // Returns true if the program was restored from the cache and linked successfully.
+        // Returns false when there is no entry, or when the driver rejects the stored binary.
+        bool load(unsigned int program, const std::string& cacheKey) const;
+
+        // Stores the binary of a successfully linked program.
+        void save(unsigned int program, const std::string& cacheKey) const;
+
+        static std::string fileName(const std::string& key);
+
+        static void writeEntry(std::ostream& out, const std::string& key, const Entry& entry);
+
+        // Returns an empty optional if the stream is not a valid entry for the given key.
+        static std::optional<Entry> readEntry(std::istream& in, const std::string& key);
+
+    private:
+        std::filesystem::path directory_;
+        std::string identity_;
+        bool supported_ = false;
+
+        [[nodiscard]] std::string fullKey(const std::string& cacheKey) const;
+    };
+
+}// namespace threepp::gl
+
+#endif//THREEPP_GLPROGRAMBINARYCACHE_HPP
@@ -3,6 +3,7 @@
 
 #include "threepp/materials/RawShaderMaterial.hpp"
 #include "threepp/renderers/GLRenderer.hpp"
+#include "threepp/renderers/gl/GLShaderPreprocessor.hpp"
 #include "threepp/utils/StringUtils.hpp"
 
 #include "threepp/renderers/shaders/ShaderLib.hpp"
@@ -128,13 +129,28 @@ GLProgram* GLPrograms::acquireProgram(const GLRenderer& renderer, const ProgramP
 
     if (!program) {
 
-        programs.emplace_back(std::make_unique<GLProgram>(&renderer, cacheKey, &parameters, &bindingStates));
+        programs.emplace_back(std::make_unique<GLProgram>(&renderer, cacheKey, &parameters, &bindingStates, getBinaryCache(renderer)));
         program = programs.back().get();
     }
 
     return program;
 }
 
+const GLProgramBinaryCache* GLPrograms::getBinaryCache(const GLRenderer& renderer) {
+
+    if (renderer.programCacheDirectory.empty()) {
+
+        return nullptr;
+    }
+
+    if (!binaryCache || binaryCache->directory() != renderer.programCacheDirectory) {
+
+        binaryCache = std::make_unique<GLProgramBinaryCache>(renderer.programCacheDirectory);
+    }
+
+    return binaryCache.get();
+}
+
 void GLPrograms::releaseProgram(GLProgram* program) {
 
     if (--(program->usedTimes) == 0) {
@@ -147,5 +163,8 @@ void GLPrograms::releaseProgram(GLProgram* program) {
             program->destroy();
             programs.erase(it);// Remove the element from the vector
         }
+
+        // the expanded sources are only needed while programs are being compiled
+        if (programs.empty()) GLShaderPreprocessor::instance().clear();
     }
 }
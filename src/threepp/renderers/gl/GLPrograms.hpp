@@ -7,6 +7,7 @@
 #include "GLClipping.hpp"
 #include "GLLights.hpp"
 #include "GLProgram.hpp"
+#include "GLProgramBinaryCache.hpp"
 #include "ProgramParameters.hpp"
 
 #include "threepp/core/Object3D.hpp"
@@ -40,6 +41,9 @@ namespace threepp {
         private:
             GLClipping& clipping;
             GLBindingStates& bindingStates;
+            std::unique_ptr<GLProgramBinaryCache> binaryCache;
+
+            const GLProgramBinaryCache* getBinaryCache(const GLRenderer& renderer);
 
         public:
             GLPrograms(GLBindingStates& bindingStates, GLClipping& clipping);
@@ -49,8 +49,10 @@ namespace threepp::gl {
 
         std::optional<Encoding> outputEncoding;
         bool instancing{};
+        bool batching{};
         bool skinning{};
         bool vertexAlphas{};
+        bool octahedralNormals{};
 
         bool needsLights{};
         bool receiveShadow{};
@@ -61,6 +63,14 @@ namespace threepp::gl {
         UniformMap* uniforms;
 
         unsigned int version{};
+
+        // the program last used with the other instancing state, for materials drawn both instanced and not,
+        // e.g. when only some of their meshes are instanced automatically. Cleared when any other state changes.
+        struct {
+
+            GLProgram* program = nullptr;
+            std::vector<UniformObject*> uniformsList;
+        } otherInstancing;
     };
 
     template<class E, class T>
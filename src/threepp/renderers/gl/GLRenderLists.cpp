@@ -2,7 +2,11 @@
 #include "threepp/renderers/gl/GLRenderLists.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
 #include <memory>
+#include <numeric>
 
 using namespace threepp;
 using namespace threepp::gl;
@@ -43,6 +47,168 @@ namespace {
         }
     } reversePainterSortStable;
 
+    // depth bits below this are considered too coarse, and the comparison sort is used instead
+    constexpr unsigned int minDepthBits = 16;
+
+    // Maps a float to an unsigned integer with the same ordering.
+    uint32_t sortableDepth(float z) {
+
+        uint32_t u;
+        std::memcpy(&u, &z, sizeof(uint32_t));
+        return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+    }
+
+    unsigned int bitWidth(uint64_t value) {
+
+        unsigned int n = 0;
+        while (value) {
+            ++n;
+            value >>= 1;
+        }
+        return n;
+    }
+
+    // Value range of one key field over a list, stored relative to its minimum so that it occupies as few bits as possible.
+    struct KeyField {
+
+        uint64_t min = std::numeric_limits<uint64_t>::max();
+        uint64_t max = 0;
+
+        void include(uint64_t value) {
+
+            min = std::min(min, value);
+            max = std::max(max, value);
+        }
+
+        [[nodiscard]] unsigned int bits() const {
+
+            return min > max ? 0 : bitWidth(max - min);
+        }
+
+        [[nodiscard]] uint64_t get(uint64_t value) const {
+
+            return value - min;
+        }
+    };
+
+    uint64_t programKey(const RenderItem* item) {
+
+        return item->program ? static_cast<uint64_t>(item->program->id) + 1 : 0;
+    }
+
+    uint32_t depthKey(const RenderItem* item, bool transparent) {
+
+        // transparent objects are drawn back to front
+        return transparent ? ~sortableDepth(item->z) : sortableDepth(item->z);
+    }
+
+    // Packs (group order, render order[, program id, material id], quantized depth) into one key per item.
+    // Returns false if the fields do not leave enough room for the depth.
+    bool makeKeys(const std::vector<RenderItem*>& list, bool transparent, std::vector<uint64_t>& keys) {
+
+        KeyField groupOrder, renderOrder, program, material, depth;
+        for (const auto item : list) {
+
+            groupOrder.include(item->groupOrder);
+            renderOrder.include(item->renderOrder);
+            if (!transparent) {
+                program.include(programKey(item));
+                material.include(item->material->id);
+            }
+            depth.include(depthKey(item, transparent));
+        }
+
+        const auto fixedBits = groupOrder.bits() + renderOrder.bits() + program.bits() + material.bits();
+        if (fixedBits + minDepthBits > 64) return false;
+
+        const auto depthBits = std::min(32u, 64 - fixedBits);
+        const auto depthShift = depth.bits() > depthBits ? depth.bits() - depthBits : 0;
+
+        keys.resize(list.size());
+        for (size_t i = 0; i < list.size(); ++i) {
+
+            const auto item = list[i];
+
+            uint64_t key = groupOrder.get(item->groupOrder);
+            key = (key << renderOrder.bits()) | renderOrder.get(item->renderOrder);
+            if (!transparent) {
+                key = (key << program.bits()) | program.get(programKey(item));
+                key = (key << material.bits()) | material.get(item->material->id);
+            }
+            key = (key << depthBits) | (depth.get(depthKey(item, transparent)) >> depthShift);
+
+            keys[i] = key;
+        }
+
+        return true;
+    }
+
+    // Stable LSD radix sort on 8 bit digits. Passes over digits that are equal for all keys are skipped.
+    void radixSort(std::vector<RenderSortCache::Entry>& entries, std::vector<RenderSortCache::Entry>& buffer) {
+
+        uint64_t allBits = 0;
+        for (const auto& e : entries) allBits |= e.key;
+
+        buffer.resize(entries.size());
+
+        for (unsigned int shift = 0; shift < 64 && (allBits >> shift) != 0; shift += 8) {
+
+            std::array<size_t, 256> counts{};
+            for (const auto& e : entries) ++counts[(e.key >> shift) & 0xFF];
+
+            if (counts[(entries.front().key >> shift) & 0xFF] == entries.size()) continue;
+
+            size_t offset = 0;
+            for (auto& count : counts) {
+                const auto c = count;
+                count = offset;
+                offset += c;
+            }
+
+            for (const auto& e : entries) buffer[counts[(e.key >> shift) & 0xFF]++] = e;
+
+            entries.swap(buffer);
+        }
+    }
+
+    template<class Compare>
+    void sortList(std::vector<RenderItem*>& list, bool transparent, RenderSortCache& cache, Compare fallback) {
+
+        if (list.size() < 2) return;
+
+        if (!makeKeys(list, transparent, cache.nextKeys)) {
+
+            cache.keys.clear();
+            std::stable_sort(list.begin(), list.end(), fallback);
+            return;
+        }
+
+        const auto n = list.size();
+
+        if (cache.nextKeys != cache.keys) {
+
+            cache.keys.swap(cache.nextKeys);
+            cache.order.resize(n);
+
+            if (std::is_sorted(cache.keys.begin(), cache.keys.end())) {
+
+                std::iota(cache.order.begin(), cache.order.end(), 0);
+
+            } else {
+
+                cache.entries.resize(n);
+                for (uint32_t i = 0; i < n; ++i) cache.entries[i] = {cache.keys[i], i};
+
+                radixSort(cache.entries, cache.buffer);
+
+                for (size_t i = 0; i < n; ++i) cache.order[i] = cache.entries[i].index;
+            }
+        }
+
+        cache.items.assign(list.begin(), list.end());
+        for (size_t i = 0; i < n; ++i) list[i] = cache.items[cache.order[i]];
+    }
+
 }// namespace
 
 gl::GLRenderList::GLRenderList(gl::GLProperties& properties): properties(properties) {}
@@ -65,21 +231,34 @@ gl::RenderItem* gl::GLRenderList::getNextRenderItem(
     auto materialProperties = properties.materialProperties.get(material);
 
     if (renderItemsIndex >= renderItems.size()) {
-        auto r = std::make_unique<RenderItem>(RenderItem{object->id,
-                                                         object,
-                                                         geometry,
-                                                         material,
-                                                         materialProperties->program,
-                                                         groupOrder,
-                                                         object->renderOrder,
-                                                         z,
-                                                         group});
-        renderItems.emplace_back(std::move(r));
-        renderItem = renderItems.back().get();
+
+        if (renderItems.size() == renderItems.capacity()) {
+
+            // growing the pool moves the items, so re-point the lists at the new storage
+            std::vector<size_t> opaqueIndices, transparentIndices;
+            for (auto item : opaque) opaqueIndices.emplace_back(item - renderItems.data());
+            for (auto item : transparent) transparentIndices.emplace_back(item - renderItems.data());
+
+            renderItems.reserve(std::max<size_t>(16, renderItems.size() * 2));
+
+            for (size_t i = 0; i < opaque.size(); ++i) opaque[i] = renderItems.data() + opaqueIndices[i];
+            for (size_t i = 0; i < transparent.size(); ++i) transparent[i] = renderItems.data() + transparentIndices[i];
+        }
+
+        renderItems.emplace_back(RenderItem{object->id,
+                                            object,
+                                            geometry,
+                                            material,
+                                            materialProperties->program,
+                                            groupOrder,
+                                            object->renderOrder,
+                                            z,
+                                            group});
+        renderItem = &renderItems.back();
 
     } else {
 
-        renderItem = renderItems.at(renderItemsIndex).get();
+        renderItem = &renderItems.at(renderItemsIndex);
 
         renderItem->id = object->id;
         renderItem->object = object;
@@ -137,8 +316,8 @@ void GLRenderList::unshift(
 
 void GLRenderList::sort() {
 
-    if (opaque.size() > 1) std::stable_sort(opaque.begin(), opaque.end(), painterSortStable);
-    if (transparent.size() > 1) std::stable_sort(transparent.begin(), transparent.end(), reversePainterSortStable);
+    sortList(opaque, false, opaqueCache_, painterSortStable);
+    sortList(transparent, true, transparentCache_, reversePainterSortStable);
 }
 
 void GLRenderList::finish() {
@@ -149,14 +328,14 @@ void GLRenderList::finish() {
 
         auto& renderItem = renderItems.at(i);
 
-        if (!renderItem->id) break;
+        if (!renderItem.id) break;
 
-        renderItem->id = std::nullopt;
-        renderItem->object = nullptr;
-        renderItem->geometry = nullptr;
-        renderItem->material = nullptr;
-        renderItem->program = nullptr;
-        renderItem->group = std::nullopt;
+        renderItem.id = std::nullopt;
+        renderItem.object = nullptr;
+        renderItem.geometry = nullptr;
+        renderItem.material = nullptr;
+        renderItem.program = nullptr;
+        renderItem.group = std::nullopt;
     }
 }
 
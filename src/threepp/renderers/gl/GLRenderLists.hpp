@@ -10,6 +10,9 @@
 #include "GLProgram.hpp"
 #include "GLProperties.hpp"
 
+#include <cstdint>
+#include <vector>
+
 namespace threepp::gl {
 
     struct RenderItem {
@@ -25,12 +28,33 @@ namespace threepp::gl {
         std::optional<GeometryGroup> group;
     };
 
+    // Packed 64 bit sort keys of the previous sort, in push order, and the resulting permutation.
+    // When a frame produces the same key sequence, the permutation is reused instead of sorting again.
+    struct RenderSortCache {
+
+        struct Entry {
+
+            uint64_t key;
+            uint32_t index;
+        };
+
+        std::vector<uint64_t> keys;
+        std::vector<uint32_t> order;
+
+        // scratch buffers, kept to avoid reallocating every frame
+        std::vector<uint64_t> nextKeys;
+        std::vector<Entry> entries;
+        std::vector<Entry> buffer;
+        std::vector<RenderItem*> items;
+    };
+
     struct GLRenderList {
 
         std::vector<RenderItem*> opaque;
         std::vector<RenderItem*> transparent;
 
-        std::vector<std::unique_ptr<RenderItem>> renderItems;
+        // contiguous pool, reused between frames. opaque and transparent point into it.
+        std::vector<RenderItem> renderItems;
         size_t renderItemsIndex = 0;
 
         explicit GLRenderList(GLProperties& properties);
@@ -61,6 +85,9 @@ namespace threepp::gl {
 
     private:
         GLProperties& properties;
+
+        RenderSortCache opaqueCache_;
+        RenderSortCache transparentCache_;
     };
 
     struct GLRenderLists {
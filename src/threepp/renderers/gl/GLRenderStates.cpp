@@ -38,9 +38,9 @@ void GLRenderState::pushShadow(Light* shadowLight) {
     shadowsArray_.emplace_back(shadowLight);
 }
 
-void GLRenderState::setupLights() {
+void GLRenderState::setupLights(Texture* shadowAtlas) {
 
-    lights_.setup(lightsArray_);
+    lights_.setup(lightsArray_, shadowAtlas);
 }
 
 void GLRenderState::setupLightsView(Camera* camera) {
@@ -51,12 +51,15 @@ void GLRenderState::setupLightsView(Camera* camera) {
 
 GLRenderState* GLRenderStates::get(Object3D* scene, size_t renderCallDepth) {
 
-    if (renderCallDepth >= renderStates_[scene->uuid].size()) {
+    auto& states = renderStates_[scene->uuid];
 
-        renderStates_[scene->uuid].emplace_back(std::make_unique<GLRenderState>());
+    // a scene first rendered by a nested call has fewer states than the call depth, as in GLRenderLists
+    if (renderCallDepth >= states.size()) {
+
+        return states.emplace_back(std::make_unique<GLRenderState>()).get();
     }
 
-    return renderStates_[scene->uuid].at(renderCallDepth).get();
+    return states.at(renderCallDepth).get();
 }
 
 void GLRenderStates::dispose() {
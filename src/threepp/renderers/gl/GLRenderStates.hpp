@@ -21,7 +21,7 @@ namespace threepp::gl {
 
         void pushShadow(Light* shadowLight);
 
-        void setupLights();
+        void setupLights(Texture* shadowAtlas = nullptr);
 
         void setupLightsView(Camera* camera);
 
@@ -0,0 +1,344 @@
+
+#include "threepp/renderers/gl/GLShaderPreprocessor.hpp"
+
+#include "threepp/renderers/shaders/ShaderChunk.hpp"
+#include "threepp/utils/StringUtils.hpp"
+
+#include <cctype>
+#include <stdexcept>
+#include <string_view>
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace {
+
+    bool isIdentifierStart(char c) {
+
+        return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    bool isIdentifierChar(char c) {
+
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    bool isSpace(char c) {
+
+        return std::isspace(static_cast<unsigned char>(c));
+    }
+
+    // Minimal cursor used to match the fixed shape of an unrolled loop header.
+    struct Cursor {
+
+        std::string_view str;
+        size_t pos = 0;
+
+        bool spaces(bool required = false) {
+
+            const auto start = pos;
+            while (pos < str.size() && isSpace(str[pos])) ++pos;
+            return !required || pos > start;
+        }
+
+        bool literal(std::string_view s) {
+
+            if (str.substr(pos, s.size()) != s) return false;
+            pos += s.size();
+            return true;
+        }
+
+        bool number(int& value) {
+
+            const auto start = pos;
+            value = 0;
+            while (pos < str.size() && std::isdigit(static_cast<unsigned char>(str[pos]))) {
+                value = value * 10 + (str[pos++] - '0');
+            }
+            return pos > start;
+        }
+    };
+
+    // Emits one copy of the loop body, replacing "[ i ]" and UNROLLED_LOOP_INDEX with the iteration index.
+    void emitIteration(std::string_view body, int index, std::string& out) {
+
+        const auto indexStr = std::to_string(index);
+
+        size_t i = 0;
+        while (i < body.size()) {
+
+            const char c = body[i];
+
+            if (c == '[') {
+
+                Cursor cursor{body, i + 1};
+                cursor.spaces();
+                if (cursor.literal("i")) {
+                    cursor.spaces();
+                    if (cursor.literal("]")) {
+                        out.append("[ ").append(indexStr).append(" ]");
+                        i = cursor.pos;
+                        continue;
+                    }
+                }
+                out += c;
+                ++i;
+
+            } else if (isIdentifierStart(c)) {
+
+                const auto start = i;
+                while (i < body.size() && isIdentifierChar(body[i])) ++i;
+                const auto identifier = body.substr(start, i - start);
+                if (identifier == "UNROLLED_LOOP_INDEX") {
+                    out += indexStr;
+                } else {
+                    out.append(identifier);
+                }
+
+            } else {
+
+                out += c;
+                ++i;
+            }
+        }
+    }
+
+    class Expander {
+
+    public:
+        explicit Expander(const GLShaderPreprocessor::Replacements& replacements)
+            : replacements_(replacements) {}
+
+        void expand(std::string_view src) {
+
+            size_t i = 0;
+            bool lineStart = true;
+
+            while (i < src.size()) {
+
+                if (lineStart) {
+
+                    lineStart = false;
+
+                    size_t j = i;
+                    while (j < src.size() && (src[j] == ' ' || src[j] == '\t')) ++j;
+                    if (j < src.size() && src[j] == '#') {
+
+                        out_.append(src.substr(i, j - i));
+                        i = directive(src, j);
+                        continue;
+                    }
+                }
+
+                const char c = src[i];
+
+                if (isIdentifierStart(c)) {
+
+                    const auto start = i;
+                    while (i < src.size() && isIdentifierChar(src[i])) ++i;
+                    identifier(src.substr(start, i - start));
+
+                } else if (std::isdigit(static_cast<unsigned char>(c))) {
+
+                    // numeric literals such as 1e5 must not be split into identifiers
+                    const auto start = i;
+                    while (i < src.size() && isIdentifierChar(src[i])) ++i;
+                    out_.append(src.substr(start, i - start));
+
+                } else {
+
+                    out_ += c;
+                    lineStart = c == '\n';
+                    ++i;
+                }
+            }
+        }
+
+        std::string take() {
+
+            return std::move(out_);
+        }
+
+    private:
+        const GLShaderPreprocessor::Replacements& replacements_;
+        std::string out_;
+        size_t loopStart_ = std::string::npos;
+
+        void identifier(std::string_view id) {
+
+            for (const auto& [name, value] : replacements_) {
+
+                if (id == name) {
+                    out_.append(value);
+                    return;
+                }
+            }
+
+            out_.append(id);
+        }
+
+        // Handles a line starting with '#' at position pos and returns the position to continue from.
+        size_t directive(std::string_view src, size_t pos) {
+
+            Cursor cursor{src, pos + 1};
+            cursor.spaces();
+
+            if (cursor.literal("include")) {
+
+                cursor.spaces();
+                if (cursor.literal("<")) {
+
+                    const auto nameStart = cursor.pos;
+                    const auto nameEnd = src.find('>', nameStart);
+                    if (nameEnd != std::string_view::npos) {
+
+                        const std::string name(src.substr(nameStart, nameEnd - nameStart));
+
+                        const std::string* chunk;
+                        try {
+                            chunk = &shaders::ShaderChunk::instance().get(name);
+                        } catch (const std::out_of_range&) {
+                            throw std::logic_error("unable to resolve #include <" + name + ">");
+                        }
+
+                        expand(*chunk);
+                        return nameEnd + 1;
+                    }
+                }
+
+            } else if (cursor.literal("pragma")) {
+
+                cursor.spaces();
+
+                if (cursor.literal("unroll_loop_start")) {
+
+                    if (loopStart_ == std::string::npos) loopStart_ = out_.size();
+                    out_.append(src.substr(pos, cursor.pos - pos));
+                    return cursor.pos;
+                }
+
+                if (cursor.literal("unroll_loop_end")) {
+
+                    out_.append(src.substr(pos, cursor.pos - pos));
+                    if (loopStart_ != std::string::npos) {
+                        unroll(loopStart_);
+                        loopStart_ = std::string::npos;
+                    }
+                    return cursor.pos;
+                }
+            }
+
+            // any other directive is regular text, identifiers included ("#if NUM_DIR_LIGHTS > 0")
+            out_ += '#';
+            return pos + 1;
+        }
+
+        // Replaces out_[start, end) by the unrolled loop, if it has the expected form:
+        // #pragma unroll_loop_start for ( int i = a; i < b; i ++ ) { body } #pragma unroll_loop_end
+        void unroll(size_t start) {
+
+            const std::string_view text(out_.data() + start, out_.size() - start);
+
+            Cursor cursor{text};
+            cursor.literal("#");
+            cursor.spaces();
+            cursor.literal("pragma");
+            cursor.spaces();
+            cursor.literal("unroll_loop_start");
+
+            int from, to;
+            // clang-format off
+            const bool match =
+                    cursor.spaces(true) && cursor.literal("for") && cursor.spaces() && cursor.literal("(") && cursor.spaces() &&
+                    cursor.literal("int") && cursor.spaces(true) && cursor.literal("i") && cursor.spaces() && cursor.literal("=") && cursor.spaces() &&
+                    cursor.number(from) && cursor.spaces() && cursor.literal(";") && cursor.spaces() &&
+                    cursor.literal("i") && cursor.spaces() && cursor.literal("<") && cursor.spaces() &&
+                    cursor.number(to) && cursor.spaces() && cursor.literal(";") && cursor.spaces() &&
+                    cursor.literal("i") && cursor.spaces() && cursor.literal("++") && cursor.spaces() && cursor.literal(")") && cursor.spaces() &&
+                    cursor.literal("{");
+            // clang-format on
+            if (!match) return;
+
+            const auto bodyStart = cursor.pos;
+
+            // the body ends at the closing brace followed by whitespace and the end pragma
+            auto bodyEnd = text.rfind('#');
+            const auto pragmaStart = bodyEnd;
+            while (bodyEnd > bodyStart && isSpace(text[bodyEnd - 1])) --bodyEnd;
+            if (bodyEnd == pragmaStart || bodyEnd <= bodyStart || text[bodyEnd - 1] != '}') return;
+            --bodyEnd;
+
+            if (bodyEnd <= bodyStart) return;// the regex it replaces required a non-empty body
+
+            const std::string body(text.substr(bodyStart, bodyEnd - bodyStart));
+
+            out_.resize(start);
+            for (int i = from; i < to; ++i) {
+
+                emitIteration(body, i, out_);
+            }
+        }
+    };
+
+    std::string makeKey(const std::string& source, const GLShaderPreprocessor::Replacements& replacements) {
+
+        std::string key;
+        for (const auto& [name, value] : replacements) {
+
+            key.append(name).append("=").append(value).append(";");
+        }
+        // the length guards against hash collisions between sources of different size
+        key.append(std::to_string(source.size())).append(":").append(std::to_string(utils::fnv1a(source)));
+
+        return key;
+    }
+
+}// namespace
+
+GLShaderPreprocessor::GLShaderPreprocessor(size_t maxSize)
+    : maxSize_(maxSize) {}
+
+std::string GLShaderPreprocessor::process(const std::string& source, const Replacements& replacements) {
+
+    Expander expander(replacements);
+    expander.expand(source);
+
+    return expander.take();
+}
+
+std::string GLShaderPreprocessor::get(const std::string& source, const Replacements& replacements) {
+
+    auto key = makeKey(source, replacements);
+
+    {
+        std::lock_guard lock(mutex_);
+        auto it = cache_.find(key);
+        if (it != cache_.end()) return it->second;
+    }
+
+    auto result = process(source, replacements);
+
+    std::lock_guard lock(mutex_);
+    if (cache_.size() >= maxSize_) cache_.clear();
+    cache_.emplace(std::move(key), result);
+
+    return result;
+}
+
+size_t GLShaderPreprocessor::size() const {
+
+    std::lock_guard lock(mutex_);
+    return cache_.size();
+}
+
+void GLShaderPreprocessor::clear() {
+
+    std::lock_guard lock(mutex_);
+    cache_.clear();
+}
+
+GLShaderPreprocessor& GLShaderPreprocessor::instance() {
+
+    static GLShaderPreprocessor instance;
+    return instance;
+}
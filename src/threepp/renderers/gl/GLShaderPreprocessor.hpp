@@ -0,0 +1,45 @@
+
+#ifndef THREEPP_GLSHADERPREPROCESSOR_HPP
+#define THREEPP_GLSHADERPREPROCESSOR_HPP
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace threepp::gl {
+
+    // Expands shader templates in a single linear pass: resolves ShaderChunk includes,
+    // substitutes identifiers such as NUM_DIR_LIGHTS and unrolls "#pragma unroll_loop_start" blocks.
+    class GLShaderPreprocessor {
+
+    public:
+        // Identifier to value substitutions. Only whole identifiers are replaced.
+        using Replacements = std::vector<std::pair<std::string, std::string>>;
+
+        explicit GLShaderPreprocessor(size_t maxSize = 512);
+
+        static std::string process(const std::string& source, const Replacements& replacements);
+
+        // Same as process, but memoized per (source, replacements) pair, keyed by a hash of the source.
+        // Starts over once maxSize results are kept.
+        std::string get(const std::string& source, const Replacements& replacements);
+
+        [[nodiscard]] size_t size() const;
+
+        void clear();
+
+        // Shared by all renderers, templates expand to the same source regardless of the context.
+        static GLShaderPreprocessor& instance();
+
+    private:
+        size_t maxSize_;
+
+        mutable std::mutex mutex_;
+        std::unordered_map<std::string, std::string> cache_;
+    };
+
+}// namespace threepp::gl
+
+#endif//THREEPP_GLSHADERPREPROCESSOR_HPP
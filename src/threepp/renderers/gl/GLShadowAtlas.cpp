@@ -0,0 +1,269 @@
+
+#include "threepp/renderers/gl/GLShadowAtlas.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace {
+
+    constexpr unsigned int maxLevel = 4;
+
+    // how far past the next fraction, in octaves of importance, a packed map has to be before it changes size
+    constexpr float hysteresis = 0.25f;
+
+    struct Placement {
+
+        unsigned int level = 0;
+        bool dropped = false;
+
+        // the size taken up in the atlas, padding included
+        unsigned int width = 0;
+        unsigned int height = 0;
+
+        // where the map was before, if it was packed
+        bool packed = false;
+        unsigned int previousLevel = 0;
+        unsigned int previousX = 0;
+        unsigned int previousY = 0;
+    };
+
+    // a map in the atlas, padding included
+    struct Rect {
+
+        unsigned int x = 0;
+        unsigned int y = 0;
+        unsigned int width = 0;
+        unsigned int height = 0;
+    };
+
+    bool overlaps(const Rect& a, const Rect& b) {
+
+        return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+    }
+
+    bool isFree(const Rect& rect, unsigned int size, const std::vector<Rect>& placed) {
+
+        if (rect.x + rect.width > size || rect.y + rect.height > size) return false;
+
+        return std::none_of(placed.begin(), placed.end(), [&](const Rect& other) { return overlaps(rect, other); });
+    }
+
+    void measure(const ShadowAtlasRegion& region, unsigned int padding, Placement& placement) {
+
+        const auto cellWidth = std::max(1u, region.cellWidth >> placement.level);
+        const auto cellHeight = std::max(1u, region.cellHeight >> placement.level);
+
+        placement.width = cellWidth * region.columns + 2 * padding;
+        placement.height = cellHeight * region.rows + 2 * padding;
+    }
+
+    // the level the map was packed at the last time, if it still has the same size
+    void remember(const ShadowAtlasRegion& region, unsigned int padding, Placement& placement) {
+
+        if (region.packedCellWidth == 0 || region.x < padding || region.y < padding) return;
+
+        for (unsigned int level = 0; level <= maxLevel; level++) {
+
+            if (std::max(1u, region.cellWidth >> level) == region.packedCellWidth &&
+                std::max(1u, region.cellHeight >> level) == region.packedCellHeight) {
+
+                placement.packed = true;
+                placement.previousLevel = level;
+                placement.previousX = region.x - padding;
+                placement.previousY = region.y - padding;
+                return;
+            }
+        }
+    }
+
+    unsigned int importanceLevel(const ShadowAtlasRegion& region, const Placement& placement) {
+
+        const auto importance = std::clamp(region.importance, 1e-6f, 1.f);
+        const auto octaves = -std::log2(importance);
+
+        if (placement.packed) {
+
+            const auto previous = static_cast<float>(placement.previousLevel);
+            if (octaves > previous - hysteresis && octaves < previous + 1 + hysteresis) return placement.previousLevel;
+        }
+
+        return std::min(maxLevel, static_cast<unsigned int>(std::floor(octaves)));
+    }
+
+    // fills rows of maps, tallest first
+    bool pack(unsigned int size, unsigned int padding, std::vector<ShadowAtlasRegion>& regions, const std::vector<Placement>& placements) {
+
+        std::vector<size_t> order(regions.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return placements[a].height > placements[b].height;
+        });
+
+        unsigned int x = 0, y = 0, rowHeight = 0;
+        for (const auto i : order) {
+
+            const auto& placement = placements[i];
+            if (placement.dropped) continue;
+
+            if (placement.width > size) return false;
+
+            if (x + placement.width > size) {
+
+                y += rowHeight;
+                x = 0;
+                rowHeight = 0;
+            }
+
+            if (y + placement.height > size) return false;
+
+            regions[i].x = x + padding;
+            regions[i].y = y + padding;
+
+            x += placement.width;
+            rowHeight = std::max(rowHeight, placement.height);
+        }
+
+        return true;
+    }
+
+    bool kept(const Placement& placement) {
+
+        return !placement.dropped && placement.packed && placement.level == placement.previousLevel;
+    }
+
+    // leaves the maps still at their previous size where they were, and places the others around them, tallest first,
+    // each as high up and then as far left as it fits
+    bool packAround(unsigned int size, unsigned int padding, std::vector<ShadowAtlasRegion>& regions, const std::vector<Placement>& placements) {
+
+        if (std::none_of(placements.begin(), placements.end(), kept)) return false;
+
+        std::vector<Rect> placed;
+        std::vector<size_t> order;
+
+        for (size_t i = 0; i < regions.size(); i++) {
+
+            const auto& placement = placements[i];
+            if (placement.dropped) continue;
+
+            if (kept(placement)) {
+
+                const Rect rect{placement.previousX, placement.previousY, placement.width, placement.height};
+                if (!isFree(rect, size, placed)) return false;
+
+                regions[i].x = rect.x + padding;
+                regions[i].y = rect.y + padding;
+                placed.emplace_back(rect);
+
+            } else {
+
+                order.emplace_back(i);
+            }
+        }
+
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return placements[a].height > placements[b].height;
+        });
+
+        std::vector<unsigned int> xs, ys;
+        for (const auto i : order) {
+
+            const auto& placement = placements[i];
+
+            // a map as far up and left as it goes touches the atlas edge or another map on either side
+            xs.assign(1, 0);
+            ys.assign(1, 0);
+            for (const auto& rect : placed) {
+
+                xs.emplace_back(rect.x + rect.width);
+                ys.emplace_back(rect.y + rect.height);
+            }
+            std::sort(xs.begin(), xs.end());
+            std::sort(ys.begin(), ys.end());
+
+            bool found = false;
+            Rect rect{0, 0, placement.width, placement.height};
+            for (auto y = ys.begin(); y != ys.end() && !found; ++y) {
+
+                for (auto x = xs.begin(); x != xs.end() && !found; ++x) {
+
+                    rect.x = *x;
+                    rect.y = *y;
+                    found = isFree(rect, size, placed);
+                }
+            }
+
+            if (!found) return false;
+
+            regions[i].x = rect.x + padding;
+            regions[i].y = rect.y + padding;
+            placed.emplace_back(rect);
+        }
+
+        return true;
+    }
+
+}// namespace
+
+
+void gl::packShadowAtlas(unsigned int size, unsigned int padding, std::vector<ShadowAtlasRegion>& regions) {
+
+    std::vector<Placement> placements(regions.size());
+    for (size_t i = 0; i < regions.size(); i++) {
+
+        remember(regions[i], padding, placements[i]);
+        placements[i].level = importanceLevel(regions[i], placements[i]);
+        measure(regions[i], padding, placements[i]);
+    }
+
+    // when the maps staying in place leave no room for the others, every map is placed anew
+    while (!packAround(size, padding, regions, placements) && !pack(size, padding, regions, placements)) {
+
+        // halve the map taking the most room
+        Placement* largest = nullptr;
+        for (auto& placement : placements) {
+
+            if (placement.dropped || placement.level == maxLevel) continue;
+
+            if (!largest || placement.width * placement.height > largest->width * largest->height) {
+
+                largest = &placement;
+            }
+        }
+
+        if (largest) {
+
+            largest->level++;
+            measure(regions[largest - placements.data()], padding, *largest);
+            continue;
+        }
+
+        // every map is as small as it gets, leave out the least important one
+        size_t leastImportant = regions.size();
+        for (size_t i = 0; i < regions.size(); i++) {
+
+            if (placements[i].dropped) continue;
+
+            if (leastImportant == regions.size() || regions[i].importance < regions[leastImportant].importance) {
+
+                leastImportant = i;
+            }
+        }
+
+        if (leastImportant == regions.size()) break;
+
+        placements[leastImportant].dropped = true;
+    }
+
+    for (size_t i = 0; i < regions.size(); i++) {
+
+        auto& region = regions[i];
+        const auto& placement = placements[i];
+
+        region.packedCellWidth = placement.dropped ? 0 : std::max(1u, region.cellWidth >> placement.level);
+        region.packedCellHeight = placement.dropped ? 0 : std::max(1u, region.cellHeight >> placement.level);
+    }
+}
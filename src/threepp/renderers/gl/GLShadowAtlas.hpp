@@ -0,0 +1,39 @@
+#ifndef THREEPP_GLSHADOWATLAS_HPP
+#define THREEPP_GLSHADOWATLAS_HPP
+
+#include <vector>
+
+namespace threepp::gl {
+
+    // The map of one light in the shadow atlas.
+    struct ShadowAtlasRegion {
+
+        // size of a viewport of the map at full resolution, and the viewports across and down
+        unsigned int cellWidth = 0;
+        unsigned int cellHeight = 0;
+        unsigned int columns = 1;
+        unsigned int rows = 1;
+
+        // share of the view the light affects, in [0, 1]
+        float importance = 1;
+
+        // set by packShadowAtlas: the size of a viewport as packed (0 when the map did not fit), and where the map
+        // starts in the atlas, in texels. Read back on the next call as where the map was before.
+        unsigned int packedCellWidth = 0;
+        unsigned int packedCellHeight = 0;
+        unsigned int x = 0;
+        unsigned int y = 0;
+    };
+
+    // Places the maps in a square atlas of size texels, with padding texels around each of them.
+    // A map starts at the largest power of two fraction of its size that is not below its importance.
+    // While they do not fit, the map taking the most room is halved, down to 1/16 of its size, after which
+    // the least important maps are left out.
+    //
+    // Moving or resizing a map means rendering it again, so a packed map keeps its size until its importance
+    // is well past the next fraction, and keeps its place as long as it still has that size.
+    void packShadowAtlas(unsigned int size, unsigned int padding, std::vector<ShadowAtlasRegion>& regions);
+
+}// namespace threepp::gl
+
+#endif//THREEPP_GLSHADOWATLAS_HPP
@@ -0,0 +1,183 @@
+
+#include "threepp/renderers/gl/GLShadowCache.hpp"
+
+#include "threepp/cameras/Camera.hpp"
+#include "threepp/lights/Light.hpp"
+#include "threepp/lights/LightShadow.hpp"
+#include "threepp/lights/light_interfaces.hpp"
+#include "threepp/objects/InstancedMesh.hpp"
+#include "threepp/objects/ObjectWithMorphTargetInfluences.hpp"
+#include "threepp/objects/SkinnedMesh.hpp"
+#include "threepp/renderers/GLRenderTarget.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace threepp;
+using namespace threepp::gl;
+
+
+void GLShadowCache::begin(const LightShadow& shadow, ShadowMap type) {
+
+    shadow_ = &shadow;
+    changed_ = false;
+    record_.clear();
+
+    push(shadow.map.get());
+    push(shadow.mapSize.x);
+    push(shadow.mapSize.y);
+    push(shadow.radius);
+    push(static_cast<uint64_t>(type));
+
+    push(shadow.atlasRect.x);
+    push(shadow.atlasRect.y);
+    push(shadow.atlasMapSize.x);
+    push(shadow.atlasMapSize.y);
+}
+
+void GLShadowCache::addCamera(const Camera& camera) {
+
+    push(camera.projectionMatrix);
+    push(camera.matrixWorldInverse);
+}
+
+void GLShadowCache::addCaster(Object3D& object) {
+
+    if (object.hasTag(Object3D::Tag::BatchedMesh)) changed_ = true;
+
+    push(&object);
+    push(static_cast<uint64_t>(object.id));
+    push(*object.matrixWorld);
+
+    if (const auto geometry = object.geometry()) {
+
+        push(geometry.get());
+        push(static_cast<uint64_t>(geometry->drawRange.start));
+        push(static_cast<uint64_t>(geometry->drawRange.count));
+        push(static_cast<uint64_t>(geometry->groups.size()));
+
+        if (const auto index = geometry->getIndex()) {
+
+            push(index);
+            push(static_cast<uint64_t>(index->version));
+        }
+
+        // unordered, but iterated in the same order as long as the geometry is unchanged
+        for (const auto& [name, attribute] : geometry->getAttributes()) {
+
+            push(attribute.get());
+            push(static_cast<uint64_t>(attribute->version));
+        }
+
+        for (const auto& [name, attributes] : geometry->getMorphAttributes()) {
+
+            for (const auto& attribute : attributes) {
+
+                push(attribute.get());
+                push(static_cast<uint64_t>(attribute->version));
+            }
+        }
+    }
+
+    if (const auto withMaterials = object.as<ObjectWithMaterials>()) {
+
+        for (const auto& material : withMaterials->materials()) {
+
+            push(material.get());
+            if (!material) continue;
+
+            push(static_cast<uint64_t>(material->version()));
+            push(static_cast<uint64_t>(material->visible));
+            push(static_cast<uint64_t>(material->side));
+            push(static_cast<uint64_t>(material->shadowSide ? static_cast<int>(*material->shadowSide) : -1));
+        }
+    }
+
+    if (const auto morphed = object.as<ObjectWithMorphTargetInfluences>()) {
+
+        for (const auto influence : morphed->morphTargetInfluences()) {
+
+            push(influence);
+        }
+    }
+
+    if (const auto skinned = object.as<SkinnedMesh>()) {
+
+        push(skinned->bindMatrix);
+
+        if (skinned->skeleton) {
+
+            for (const auto& bone : skinned->skeleton->bones) push(*bone->matrixWorld);
+        }
+    }
+
+    if (const auto instanced = object.as<InstancedMesh>()) {
+
+        push(static_cast<uint64_t>(instanced->count()));
+        push(static_cast<uint64_t>(instanced->instanceMatrix()->version));
+    }
+}
+
+bool GLShadowCache::end() {
+
+    auto& last = records_[shadow_];
+    const bool changed = changed_ || last != record_;
+
+    last.swap(record_);
+    shadow_ = nullptr;
+
+    return changed;
+}
+
+void GLShadowCache::retain(const std::vector<Light*>& lights) {
+
+    for (auto it = records_.begin(); it != records_.end();) {
+
+        const bool found = std::any_of(lights.begin(), lights.end(), [&](Light* light) {
+            auto lightWithShadow = dynamic_cast<LightWithShadow*>(light);
+            return lightWithShadow && lightWithShadow->shadow.get() == it->first;
+        });
+
+        if (found) {
+
+            ++it;
+
+        } else {
+
+            it = records_.erase(it);
+        }
+    }
+}
+
+void GLShadowCache::clear() {
+
+    records_.clear();
+}
+
+size_t GLShadowCache::size() const {
+
+    return records_.size();
+}
+
+void GLShadowCache::push(uint64_t value) {
+
+    record_.emplace_back(value);
+}
+
+void GLShadowCache::push(float value) {
+
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(float));
+
+    record_.emplace_back(bits);
+}
+
+void GLShadowCache::push(const void* pointer) {
+
+    record_.emplace_back(reinterpret_cast<uintptr_t>(pointer));
+}
+
+void GLShadowCache::push(const Matrix4& matrix) {
+
+    for (const auto e : matrix.elements) push(e);
+}
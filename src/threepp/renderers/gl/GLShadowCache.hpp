@@ -0,0 +1,72 @@
+
+#ifndef THREEPP_GLSHADOWCACHE_HPP
+#define THREEPP_GLSHADOWCACHE_HPP
+
+#include "threepp/constants.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace threepp {
+
+    class Camera;
+    class Light;
+    class LightShadow;
+    class Matrix4;
+    class Object3D;
+
+}// namespace threepp
+
+namespace threepp::gl {
+
+    // Tells whether the shadow map of a light has to be rendered again.
+    // While collecting the casters of a light, everything its map depends on is recorded: the map, the shadow
+    // camera of every viewport, and per caster the world matrix, geometry (attribute versions and draw range),
+    // materials, morph influences, bone matrices and instance matrices. The map is up to date when the record
+    // equals the one of the last render. Batched meshes can not be described, and always count as changed.
+    //
+    // Changes made behind the renderer's back, like editing an attribute without needsUpdate(), are not seen.
+    class GLShadowCache {
+
+    public:
+        // Starts the record of a light.
+        void begin(const LightShadow& shadow, ShadowMap type);
+
+        // Adds the shadow camera of a viewport.
+        void addCamera(const Camera& camera);
+
+        // Adds an object drawn into the map.
+        void addCaster(Object3D& object);
+
+        // Ends the record. Returns true if it differs from the last one of the light, which it replaces.
+        bool end();
+
+        // Forgets the lights that are not in the list.
+        void retain(const std::vector<Light*>& lights);
+
+        void clear();
+
+        // Number of lights with a record.
+        [[nodiscard]] size_t size() const;
+
+    private:
+        const LightShadow* shadow_ = nullptr;
+        bool changed_ = false;
+
+        std::vector<uint64_t> record_;
+        std::unordered_map<const LightShadow*, std::vector<uint64_t>> records_;
+
+        void push(uint64_t value);
+
+        void push(float value);
+
+        void push(const void* pointer);
+
+        void push(const Matrix4& matrix);
+    };
+
+}// namespace threepp::gl
+
+#endif//THREEPP_GLSHADOWCACHE_HPP
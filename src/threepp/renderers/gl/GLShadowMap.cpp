@@ -3,6 +3,7 @@
 
 #include "threepp/math/Frustum.hpp"
 
+#include "threepp/objects/InstancedMesh.hpp"
 #include "threepp/objects/Line.hpp"
 #include "threepp/objects/Mesh.hpp"
 #include "threepp/objects/Points.hpp"
@@ -11,8 +12,14 @@
 #include "threepp/materials/MeshDistanceMaterial.hpp"
 #include "threepp/materials/ShaderMaterial.hpp"
 
+#include "threepp/lights/DirectionalLightShadow.hpp"
 #include "threepp/lights/PointLight.hpp"
 #include "threepp/lights/PointLightShadow.hpp"
+#include "threepp/lights/SpotLight.hpp"
+
+#include "threepp/cameras/OrthographicCamera.hpp"
+#include "threepp/cameras/PerspectiveCamera.hpp"
+#include "threepp/math/MathUtils.hpp"
 
 #include "threepp/renderers/GLRenderTarget.hpp"
 #include "threepp/renderers/GLRenderer.hpp"
@@ -21,6 +28,10 @@
 
 #include "threepp/renderers/gl/GLCapabilities.hpp"
 #include "threepp/renderers/gl/GLObjects.hpp"
+#include "threepp/renderers/gl/GLShadowAtlas.hpp"
+#include "threepp/renderers/gl/GLShadowCache.hpp"
+
+#include "threepp/scenes/Scene.hpp"
 
 
 #include <cmath>
@@ -36,6 +47,46 @@ namespace {
             {Side::Back, Side::Front},
             {Side::Double, Side::Double}};
 
+    // texels cleared around each map in the atlas, so filters reaching past the edge of a map read no other map
+    constexpr unsigned int atlasPadding = 4;
+
+    // share of the view a light can affect, from the size of its range on screen
+    float screenImportance(Light& light, const LightShadow& shadow, const Camera& camera, const Frustum& viewFrustum) {
+
+        float range;
+        if (auto pointLight = light.as<PointLight>()) {
+            range = pointLight->distance;
+        } else if (auto spotLight = light.as<SpotLight>()) {
+            range = spotLight->distance;
+        } else {
+            // directional lights reach the whole view
+            return 1;
+        }
+
+        if (range <= 0) range = shadow.camera->far;
+
+        Vector3 position;
+        position.setFromMatrixPosition(*light.matrixWorld);
+
+        if (!viewFrustum.intersectsSphere(Sphere(position, range))) return 0;
+
+        Vector3 cameraPosition;
+        cameraPosition.setFromMatrixPosition(*camera.matrixWorld);
+
+        const auto distance = cameraPosition.distanceTo(position);
+        if (distance <= range) return 1;
+
+        // half the height of the view at the distance of the light
+        float halfHeight = distance;
+        if (auto perspective = camera.as<PerspectiveCamera>()) {
+            halfHeight = distance * std::tan(math::DEG2RAD * perspective->fov / 2) / perspective->zoom;
+        } else if (auto orthographic = camera.as<OrthographicCamera>()) {
+            halfHeight = (orthographic->top - orthographic->bottom) / (2 * orthographic->zoom);
+        }
+
+        return std::min(1.f, range / halfHeight);
+    }
+
 
 }// namespace
 
@@ -46,6 +97,9 @@ struct GLShadowMap::Impl {
 
     const Frustum* _frustum;
 
+    // spatial index of the scene, already synchronized by the renderer for this frame
+    SpatialIndex* spatialIndex = nullptr;
+
     Vector2 _shadowMapSize;
     Vector2 _viewportSize;
 
@@ -60,6 +114,15 @@ struct GLShadowMap::Impl {
 
     std::shared_ptr<Mesh> fullScreenMesh;
 
+    // casters per viewport of the current light
+    std::vector<std::vector<Object3D*>> _casters;
+    GLShadowCache _cache;
+
+    std::unique_ptr<GLRenderTarget> _atlas;
+    std::vector<ShadowAtlasRegion> _atlasRegions;
+    Vector2 _viewportOffset;
+    Vector4 _scissor;
+
     Impl(GLShadowMap* scope, GLObjects& objects)
         : scope(scope),
           _objects(objects),
@@ -200,61 +263,199 @@ struct GLShadowMap::Impl {
         return result;
     }
 
-    void renderObject(GLRenderer& _renderer, Object3D* object, Camera* camera, Camera* shadowCamera, Light* light) {
+    [[nodiscard]] bool inFrustum(Object3D& object) const {
+
+        return spatialIndex ? spatialIndex->intersectsFrustum(*_frustum, object) : _frustum->intersectsObject(object);
+    }
+
+    // culls the instances of an InstancedMesh with perInstanceCulling against a viewport of the shadow camera
+    static bool hasVisibleInstances(Object3D& object, const LightShadow& shadow, unsigned int viewport) {
+
+        if (!object.hasTag(Object3D::Tag::InstancedMesh)) return true;
+
+        auto& instancedMesh = dynamic_cast<InstancedMesh&>(object);
+
+        return !instancedMesh.perInstanceCulling || instancedMesh.cullInstances(shadow.getFrustum(), *shadow.camera, viewport) > 0;
+    }
+
+    // appends the objects below object that are drawn into the shadow map of the current viewport
+    void collectCasters(Object3D* object, Camera* camera, std::vector<Object3D*>& casters) const {
 
         if (!object->visible) return;
 
         bool visible = object->layers.test(camera->layers);
 
-        if (visible && (object->is<Mesh>() || object->is<Line>() || object->is<Points>())) {
+        if (visible && (object->hasTag(Object3D::Tag::Mesh) || object->hasTag(Object3D::Tag::Line) || object->hasTag(Object3D::Tag::Points))) {
+
+            if ((object->castShadow || (object->receiveShadow && scope->type == ShadowMap::VSM)) && (!object->frustumCulled || inFrustum(*object))) {
+
+                casters.emplace_back(object);
+            }
+        }
+
+        for (auto& child : object->children) {
 
-            if ((object->castShadow || (object->receiveShadow && scope->type == ShadowMap::VSM)) && (!object->frustumCulled || _frustum->intersectsObject(*object))) {
+            collectCasters(child, camera, casters);
+        }
+    }
 
-                object->modelViewMatrix.multiplyMatrices(shadowCamera->matrixWorldInverse, *object->matrixWorld);
+    void renderObject(GLRenderer& _renderer, Object3D* object, const LightShadow& shadow, unsigned int viewport, Light* light) {
 
-                const auto geometry = _objects.update(object);
-                const auto material = object->as<ObjectWithMaterials>()->materials();
+        if (!hasVisibleInstances(*object, shadow, viewport)) return;
 
-                if (material.size() > 1) {
+        const auto shadowCamera = shadow.camera.get();
 
-                    const auto& groups = geometry->groups;
+        object->modelViewMatrix.multiplyMatrices(shadowCamera->matrixWorldInverse, *object->matrixWorld);
 
-                    for (const auto& group : groups) {
+        const auto geometry = _objects.update(object);
+        const auto material = object->as<ObjectWithMaterials>()->materials();
 
-                        if (material.size() > group.materialIndex) {
-                            const auto groupMaterial = material[group.materialIndex].get();
+        if (material.size() > 1) {
 
-                            if (groupMaterial && groupMaterial->visible) {
+            const auto& groups = geometry->groups;
 
-                                const auto depthMaterial = getDepthMaterial(_renderer, object, geometry, groupMaterial, light, shadowCamera->near, shadowCamera->far);
+            for (const auto& group : groups) {
 
-                                _renderer.renderBufferDirect(shadowCamera, nullptr, geometry, depthMaterial, object, group);
-                            }
-                        }
-                    }
+                if (material.size() > group.materialIndex) {
+                    const auto groupMaterial = material[group.materialIndex].get();
 
-                } else if (material.front()->visible) {
+                    if (groupMaterial && groupMaterial->visible) {
 
-                    const auto depthMaterial = getDepthMaterial(_renderer, object, geometry, material.front().get(), light, shadowCamera->near, shadowCamera->far);
+                        const auto depthMaterial = getDepthMaterial(_renderer, object, geometry, groupMaterial, light, shadowCamera->near, shadowCamera->far);
 
-                    _renderer.renderBufferDirect(shadowCamera, nullptr, geometry, depthMaterial, object, std::nullopt);
+                        _renderer.renderBufferDirect(shadowCamera, nullptr, geometry, depthMaterial, object, group);
+                    }
                 }
             }
+
+        } else if (material.front()->visible) {
+
+            const auto depthMaterial = getDepthMaterial(_renderer, object, geometry, material.front().get(), light, shadowCamera->near, shadowCamera->far);
+
+            _renderer.renderBufferDirect(shadowCamera, nullptr, geometry, depthMaterial, object, std::nullopt);
         }
+    }
 
-        for (auto& child : object->children) {
+    static DirectionalLightShadow* cascadedShadow(LightShadow& shadow) {
+
+        auto directionalShadow = dynamic_cast<DirectionalLightShadow*>(&shadow);
+        return directionalShadow && directionalShadow->cascades() > 1 ? directionalShadow : nullptr;
+    }
+
+    void updateMatrices(LightShadow& shadow, Light* light, unsigned int viewport) {
+
+        if (auto pointLightShadow = dynamic_cast<PointLightShadow*>(&shadow)) {
+            pointLightShadow->updateMatrices(light->as<PointLight>(), viewport);
+        } else if (auto cascaded = cascadedShadow(shadow)) {
+            cascaded->updateCascade(viewport);
+        } else {
+            shadow.updateMatrices(*light);
+        }
+    }
+
+    // creates the atlas at the requested size, or releases it when not used
+    void updateAtlas() {
+
+        if (!scope->usesAtlas()) {
+
+            _atlas = nullptr;
+            return;
+        }
+
+        const auto size = std::min(scope->atlasSize, static_cast<unsigned int>(_maxTextureSize));
+
+        if (!_atlas || _atlas->width != size) {
+
+            GLRenderTarget::Options pars{};
+            pars.minFilter = Filter::Nearest;
+            pars.magFilter = Filter::Nearest;
+            pars.format = Format::RGBA;
+
+            _atlas = GLRenderTarget::create(size, size, pars);
+            _atlas->texture->name = "shadowAtlas";
+
+            // the maps were in the old atlas
+            _cache.clear();
+            scope->needsUpdate = true;
+        }
+    }
+
+    // gives every shadow a region of the atlas, sized by how much of the view its light affects
+    void packAtlas(const std::vector<Light*>& lights, const Camera& camera) {
+
+        Matrix4 projScreenMatrix;
+        projScreenMatrix.multiplyMatrices(camera.projectionMatrix, camera.matrixWorldInverse);
+
+        Frustum viewFrustum;
+        viewFrustum.setFromProjectionMatrix(projScreenMatrix);
+
+        const auto size = _atlas->width;
+        const auto atlasSize = static_cast<float>(size);
 
-            renderObject(_renderer, child, camera, shadowCamera, light);
+        _atlasRegions.resize(lights.size());
+        for (size_t i = 0; i < lights.size(); i++) {
+
+            auto& region = _atlasRegions[i];
+            region = ShadowAtlasRegion();
+
+            auto lightWithShadow = dynamic_cast<LightWithShadow*>(lights[i]);
+            if (!lightWithShadow) continue;
+
+            auto& shadow = *lightWithShadow->shadow;
+
+            region.cellWidth = static_cast<unsigned int>(shadow.mapSize.x);
+            region.cellHeight = static_cast<unsigned int>(shadow.mapSize.y);
+            region.columns = static_cast<unsigned int>(shadow.getFrameExtents().x);
+            region.rows = static_cast<unsigned int>(shadow.getFrameExtents().y);
+            region.importance = screenImportance(*lights[i], shadow, camera, viewFrustum);
+
+            // where the map is now, so the packing can leave it there
+            region.packedCellWidth = static_cast<unsigned int>(shadow.atlasMapSize.x);
+            region.packedCellHeight = static_cast<unsigned int>(shadow.atlasMapSize.y);
+            region.x = static_cast<unsigned int>(std::lround(shadow.atlasRect.x * atlasSize));
+            region.y = static_cast<unsigned int>(std::lround(shadow.atlasRect.y * atlasSize));
+        }
+
+        packShadowAtlas(size, atlasPadding, _atlasRegions);
+
+        for (size_t i = 0; i < lights.size(); i++) {
+
+            auto lightWithShadow = dynamic_cast<LightWithShadow*>(lights[i]);
+            if (!lightWithShadow) continue;
+
+            auto& shadow = *lightWithShadow->shadow;
+            const auto& region = _atlasRegions[i];
+
+            const Vector2 mapSize(static_cast<float>(region.packedCellWidth), static_cast<float>(region.packedCellHeight));
+            Vector4 rect;
+            if (region.packedCellWidth > 0) {
+
+                rect.set(static_cast<float>(region.x) / atlasSize,
+                         static_cast<float>(region.y) / atlasSize,
+                         mapSize.x * static_cast<float>(region.columns) / atlasSize,
+                         mapSize.y * static_cast<float>(region.rows) / atlasSize);
+            }
+
+            // a map that moved has to be rendered again, even for lights that are not updated automatically
+            if (!(rect == shadow.atlasRect) || !(mapSize == shadow.atlasMapSize)) shadow.needsUpdate = true;
+
+            shadow.atlasRect.copy(rect);
+            shadow.atlasMapSize.copy(mapSize);
         }
     }
 
     void render(GLRenderer& _renderer, const std::vector<Light*>& lights, Object3D* scene, Camera* camera) {
 
         if (!scope->enabled) return;
+
+        updateAtlas();
+
         if (!scope->autoUpdate && !scope->needsUpdate) return;
 
         if (lights.empty()) return;
 
+        spatialIndex = scene->hasTag(Object3D::Tag::Scene) ? static_cast<Scene*>(scene)->spatialIndex.get() : nullptr;
+
         auto currentRenderTarget = _renderer.getRenderTarget();
         auto activeCubeFace = _renderer.getActiveCubeFace();
         auto activeMipmapLevel = _renderer.getActiveMipmapLevel();
@@ -267,6 +468,9 @@ struct GLShadowMap::Impl {
         _state.depthBuffer.setTest(true);
         _state.setScissorTest(false);
 
+        if (_atlas) packAtlas(lights, *camera);
+        bool atlasBound = false;
+
         // render depth map
 
         for (auto light : lights) {
@@ -283,85 +487,147 @@ struct GLShadowMap::Impl {
 
             if (!shadow->autoUpdate && !shadow->needsUpdate) continue;
 
-            _shadowMapSize.copy(shadow->mapSize);
+            if (_atlas) {
+
+                // the map is a region of the atlas
+                shadow->map = nullptr;
+                shadow->mapPass = nullptr;
+
+                // no room left for this light
+                if (shadow->atlasMapSize.x == 0) continue;
+
+                _viewportSize.copy(shadow->atlasMapSize);
+                _viewportOffset.set(shadow->atlasRect.x, shadow->atlasRect.y).multiplyScalar(static_cast<float>(_atlas->width));
+
+            } else {
+
+                shadow->atlasRect.set(0, 0, 0, 0);
+                shadow->atlasMapSize.set(0, 0);
+                _viewportOffset.set(0, 0);
+
+                _shadowMapSize.copy(shadow->mapSize);
+
+                auto shadowFrameExtents = shadow->getFrameExtents();
+
+                _shadowMapSize.multiply(shadowFrameExtents);
+
+                _viewportSize.copy(shadow->mapSize);
+
+                if (_shadowMapSize.x > _maxTextureSize || _shadowMapSize.y > _maxTextureSize) {
+
+                    if (_shadowMapSize.x > _maxTextureSize) {
+
+                        _viewportSize.x = std::floor(static_cast<float>(_maxTextureSize) / shadowFrameExtents.x);
+                        _shadowMapSize.x = _viewportSize.x * shadowFrameExtents.x;
+                        shadow->mapSize.x = _viewportSize.x;
+                    }
+
+                    if (_shadowMapSize.y > _maxTextureSize) {
 
-            auto shadowFrameExtents = shadow->getFrameExtents();
+                        _viewportSize.y = std::floor(static_cast<float>(_maxTextureSize) / shadowFrameExtents.y);
+                        _shadowMapSize.y = _viewportSize.y * shadowFrameExtents.y;
+                        shadow->mapSize.y = _viewportSize.y;
+                    }
+                }
 
-            _shadowMapSize.multiply(shadowFrameExtents);
+                if (!shadow->map && !std::dynamic_pointer_cast<PointLightShadow>(shadow) && scope->type == ShadowMap::VSM) {
 
-            _viewportSize.copy(shadow->mapSize);
+                    GLRenderTarget::Options pars{};
+                    pars.minFilter = Filter::Linear;
+                    pars.magFilter = Filter::Linear;
+                    pars.format = Format::RGBA;
 
-            if (_shadowMapSize.x > _maxTextureSize || _shadowMapSize.y > _maxTextureSize) {
+                    shadow->map = GLRenderTarget::create(static_cast<int>(_shadowMapSize.x), static_cast<int>(_shadowMapSize.y), pars);
+                    shadow->map->texture->name = light->name + ".shadowMap";
 
-                if (_shadowMapSize.x > _maxTextureSize) {
+                    shadow->mapPass = GLRenderTarget::create(static_cast<int>(_shadowMapSize.x), static_cast<int>(_shadowMapSize.y), pars);
 
-                    _viewportSize.x = std::floor(static_cast<float>(_maxTextureSize) / shadowFrameExtents.x);
-                    _shadowMapSize.x = _viewportSize.x * shadowFrameExtents.x;
-                    shadow->mapSize.x = _viewportSize.x;
+                    shadow->camera->updateProjectionMatrix();
                 }
 
-                if (_shadowMapSize.y > _maxTextureSize) {
+                if (!shadow->map) {
+
+                    GLRenderTarget::Options pars{};
+                    pars.minFilter = Filter::Nearest;
+                    pars.magFilter = Filter::Nearest;
+                    pars.format = Format::RGBA;
 
-                    _viewportSize.y = std::floor(static_cast<float>(_maxTextureSize) / shadowFrameExtents.y);
-                    _shadowMapSize.y = _viewportSize.y * shadowFrameExtents.y;
-                    shadow->mapSize.y = _viewportSize.y;
+                    shadow->map = GLRenderTarget::create(static_cast<int>(_shadowMapSize.x), static_cast<int>(_shadowMapSize.y), pars);
+                    shadow->map->texture->name = light->name + ".shadowMap";
+
+                    shadow->camera->updateProjectionMatrix();
                 }
             }
 
-            if (!shadow->map && !std::dynamic_pointer_cast<PointLightShadow>(shadow) && scope->type == ShadowMap::VSM) {
+            const auto viewportCount = shadow->getViewportCount();
+            if (_casters.size() < viewportCount) _casters.resize(viewportCount);
 
-                GLRenderTarget::Options pars{};
-                pars.minFilter = Filter::Linear;
-                pars.magFilter = Filter::Linear;
-                pars.format = Format::RGBA;
+            // the cascades follow the view, each viewport then renders one of them
+            if (auto cascaded = cascadedShadow(*shadow)) cascaded->updateCascades(*light, *camera);
 
-                shadow->map = GLRenderTarget::create(static_cast<int>(_shadowMapSize.x), static_cast<int>(_shadowMapSize.y), pars);
-                shadow->map->texture->name = light->name + ".shadowMap";
+            if (scope->skipUnchanged) _cache.begin(*shadow, scope->type);
 
-                shadow->mapPass = GLRenderTarget::create(static_cast<int>(_shadowMapSize.x), static_cast<int>(_shadowMapSize.y), pars);
+            for (unsigned vp = 0; vp < viewportCount; vp++) {
 
-                shadow->camera->updateProjectionMatrix();
-            }
+                updateMatrices(*shadow, light, vp);
 
-            if (!shadow->map) {
+                _frustum = &shadow->getFrustum();
+
+                if (spatialIndex) spatialIndex->query(*_frustum);
 
-                GLRenderTarget::Options pars{};
-                pars.minFilter = Filter::Nearest;
-                pars.magFilter = Filter::Nearest;
-                pars.format = Format::RGBA;
+                _casters[vp].clear();
+                collectCasters(scene, camera, _casters[vp]);
 
-                shadow->map = GLRenderTarget::create(static_cast<int>(_shadowMapSize.x), static_cast<int>(_shadowMapSize.y), pars);
-                shadow->map->texture->name = light->name + ".shadowMap";
+                if (scope->skipUnchanged) {
 
-                shadow->camera->updateProjectionMatrix();
+                    _cache.addCamera(*shadow->camera);
+                    for (auto caster : _casters[vp]) _cache.addCaster(*caster);
+                }
             }
 
-            _renderer.setRenderTarget(shadow->map.get());
-            _renderer.clear();
+            // the map still holds the same casters seen from the same place
+            if (scope->skipUnchanged && !_cache.end() && !shadow->needsUpdate && !scope->needsUpdate) continue;
 
-            const auto viewportCount = shadow->getViewportCount();
+            if (_atlas) {
+
+                if (!atlasBound) {
+
+                    _renderer.setRenderTarget(_atlas.get());
+                    atlasBound = true;
+                }
+
+                // only the region of this light, the others keep their maps
+                _scissor.set(_viewportOffset.x - atlasPadding,
+                             _viewportOffset.y - atlasPadding,
+                             _viewportSize.x * shadow->getFrameExtents().x + 2 * atlasPadding,
+                             _viewportSize.y * shadow->getFrameExtents().y + 2 * atlasPadding);
+
+                _state.scissor(_scissor);
+                _state.setScissorTest(true);
+                _renderer.clear();
+                _state.setScissorTest(false);
+
+            } else {
+
+                _renderer.setRenderTarget(shadow->map.get());
+                _renderer.clear();
+            }
 
             for (unsigned vp = 0; vp < viewportCount; vp++) {
 
                 const auto& viewport = shadow->getViewport(vp);
 
                 _viewport.set(
-                        _viewportSize.x * viewport.x,
-                        _viewportSize.y * viewport.y,
+                        _viewportOffset.x + _viewportSize.x * viewport.x,
+                        _viewportOffset.y + _viewportSize.y * viewport.y,
                         _viewportSize.x * viewport.z,
                         _viewportSize.y * viewport.w);
 
                 _state.viewport(_viewport);
 
-                if (auto pointLightShadow = std::dynamic_pointer_cast<PointLightShadow>(shadow)) {
-                    pointLightShadow->updateMatrices(light->as<PointLight>(), vp);
-                } else {
-                    shadow->updateMatrices(*light);
-                }
-
-                _frustum = &shadow->getFrustum();
+                if (viewportCount > 1) updateMatrices(*shadow, light, vp);
 
-                renderObject(_renderer, scene, camera, shadow->camera.get(), light);
+                for (auto caster : _casters[vp]) renderObject(_renderer, caster, *shadow, vp, light);
             }
 
             // do blur pass for VSM
@@ -374,6 +640,13 @@ struct GLShadowMap::Impl {
             shadow->needsUpdate = false;
         }
 
+        // records are only valid while every render updates them
+        if (scope->skipUnchanged) {
+            _cache.retain(lights);
+        } else {
+            _cache.clear();
+        }
+
         scope->needsUpdate = false;
 
         _renderer.setRenderTarget(currentRenderTarget, activeCubeFace, activeMipmapLevel);
@@ -419,4 +692,14 @@ void GLShadowMap::render(GLRenderer& renderer, const std::vector<Light*>& lights
     pimpl_->render(renderer, lights, scene, camera);
 }
 
+bool GLShadowMap::usesAtlas() const {
+
+    return atlasSize > 0 && type != ShadowMap::VSM;
+}
+
+Texture* GLShadowMap::atlasTexture() const {
+
+    return pimpl_->_atlas ? pimpl_->_atlas->texture.get() : nullptr;
+}
+
 gl::GLShadowMap::~GLShadowMap() = default;
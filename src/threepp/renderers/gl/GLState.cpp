@@ -292,7 +292,7 @@ void gl::StencilBuffer::reset() {
     currentStencilClear = std::nullopt;
 }
 
-gl::GLState::GLState(): maxTextures(glGetParameteri(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS)) {
+gl::GLState::GLState(GLInfo& info): maxTextures(glGetParameteri(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS)), info(info) {
 
     GLint scissorParam[4];
     GLint viewportParam[4];
@@ -351,6 +351,10 @@ void gl::GLState::enable(int id) {
 
         glEnable(id);
         enabledCapabilities[id] = true;
+
+    } else {
+
+        info.updateStateChangeAvoided();
     }
 }
 
@@ -359,6 +363,10 @@ void gl::GLState::disable(int id) {
 
         glDisable(id);
         enabledCapabilities[id] = false;
+
+    } else {
+
+        info.updateStateChangeAvoided();
     }
 }
 
@@ -385,6 +393,8 @@ bool gl::GLState::bindFramebuffer(int target, unsigned int framebuffer) {
         return true;
     }
 
+    info.updateStateChangeAvoided();
+
     return false;
 }
 
@@ -396,9 +406,13 @@ bool gl::GLState::useProgram(unsigned int program) {
 
         currentProgram = program;
 
+        info.updateProgramSwitch();
+
         return true;
     }
 
+    info.updateStateChangeAvoided();
+
     return false;
 }
 
@@ -597,6 +611,10 @@ void gl::GLState::setFlipSided(bool flipSided) {
         }
 
         currentFlipSided = flipSided;
+
+    } else {
+
+        info.updateStateChangeAvoided();
     }
 }
 
@@ -620,6 +638,10 @@ void gl::GLState::setCullFace(CullFace cullFace) {
 
                 glCullFace(GL_FRONT_AND_BACK);
             }
+
+        } else {
+
+            info.updateStateChangeAvoided();
         }
 
     } else {
@@ -637,6 +659,10 @@ void gl::GLState::setLineWidth(float width) {
         if (lineWidthAvailable) glLineWidth(width);
 
         currentLineWidth = width;
+
+    } else {
+
+        info.updateStateChangeAvoided();
     }
 }
 
@@ -680,6 +706,10 @@ void gl::GLState::activeTexture(std::optional<GLenum> glSlot) {
 
         glActiveTexture(*glSlot);
         currentTextureSlot = glSlot;
+
+    } else {
+
+        info.updateStateChangeAvoided();
     }
 }
 
@@ -696,7 +726,7 @@ void gl::GLState::bindTexture(int glType, std::optional<int> glTexture) {
         currentBoundTextures[*currentTextureSlot] = boundTexture;
     }
 
-    auto boundTexture = currentBoundTextures.at(*currentTextureSlot);
+    auto& boundTexture = currentBoundTextures.at(*currentTextureSlot);
 
     if (boundTexture.type != glType || boundTexture.texture != glTexture) {
 
@@ -704,6 +734,24 @@ void gl::GLState::bindTexture(int glType, std::optional<int> glTexture) {
 
         boundTexture.type = glType;
         boundTexture.texture = glTexture;
+
+        info.updateTextureBind();
+
+    } else {
+
+        info.updateStateChangeAvoided();
+    }
+}
+
+void gl::GLState::invalidateTexture(int glTexture) {
+
+    for (auto& [slot, boundTexture] : currentBoundTextures) {
+
+        if (boundTexture.texture == glTexture) {
+
+            boundTexture.type = std::nullopt;
+            boundTexture.texture = std::nullopt;
+        }
     }
 }
 
@@ -739,6 +787,10 @@ void gl::GLState::scissor(const Vector4& scissor) {
 
         glScissor((GLint) scissor.x, (GLint) scissor.y, (GLsizei) scissor.z, (GLsizei) scissor.w);
         currentScissor.copy(scissor);
+
+    } else {
+
+        info.updateStateChangeAvoided();
     }
 }
 
@@ -748,6 +800,10 @@ void gl::GLState::viewport(const Vector4& viewport) {
 
         glViewport((GLint) viewport.x, (GLint) viewport.y, (GLsizei) viewport.z, (GLsizei) viewport.w);
         currentViewport.copy(viewport);
+
+    } else {
+
+        info.updateStateChangeAvoided();
     }
 }
 
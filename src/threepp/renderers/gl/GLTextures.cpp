@@ -224,6 +224,7 @@ void gl::GLTextures::deallocateTexture(Texture* texture) {
 
     if (!textureProperties->glInit) return;
 
+    state->invalidateTexture(static_cast<int>(*textureProperties->glTexture));
     glDeleteTextures(1, &textureProperties->glTexture.value());
 
     properties->textureProperties.remove(texture);
@@ -240,6 +241,7 @@ void gl::GLTextures::deallocateRenderTarget(GLRenderTarget* renderTarget) {
 
     if (textureProperties->glTexture) {
 
+        state->invalidateTexture(static_cast<int>(*textureProperties->glTexture));
         glDeleteTextures(1, &textureProperties->glTexture.value());
 
         info->memory.textures--;
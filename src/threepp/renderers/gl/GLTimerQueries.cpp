@@ -0,0 +1,93 @@
+
+#include "threepp/renderers/gl/GLTimerQueries.hpp"
+
+#ifndef EMSCRIPTEN
+#include <glad/glad.h>
+#endif
+
+using namespace threepp::gl;
+
+// GLES 3.0 has no timer queries, so nothing is measured there
+
+void GLTimerQueries::begin() {
+
+#ifndef EMSCRIPTEN
+    if (active_) return;
+
+    if (!initialized_) {
+
+        glGenQueries(numQueries, queries_.data());
+        free_.assign(queries_.begin(), queries_.end());
+
+        initialized_ = true;
+    }
+
+    if (free_.empty()) return;
+
+    active_ = free_.back();
+    free_.pop_back();
+
+    glBeginQuery(GL_TIME_ELAPSED, *active_);
+#endif
+}
+
+void GLTimerQueries::end() {
+
+#ifndef EMSCRIPTEN
+    if (!active_) return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+
+    pending_.emplace_back(*active_);
+    active_.reset();
+#endif
+}
+
+std::optional<double> GLTimerQueries::poll() {
+
+    std::optional<double> result;
+
+#ifndef EMSCRIPTEN
+    while (!pending_.empty()) {
+
+        const auto query = pending_.front();
+
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+
+        // queries complete in order
+        if (!available) break;
+
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+
+        result = static_cast<double>(nanoseconds) / 1e6;
+
+        pending_.pop_front();
+        free_.emplace_back(query);
+    }
+#endif
+
+    return result;
+}
+
+void GLTimerQueries::dispose() {
+
+#ifndef EMSCRIPTEN
+    if (!initialized_) return;
+
+    if (active_) glEndQuery(GL_TIME_ELAPSED);
+
+    glDeleteQueries(numQueries, queries_.data());
+#endif
+
+    initialized_ = false;
+    active_.reset();
+    free_.clear();
+    pending_.clear();
+}
+
+GLTimerQueries::~GLTimerQueries() {
+
+    dispose();
+}
@@ -0,0 +1,43 @@
+
+#ifndef THREEPP_GLTIMERQUERIES_HPP
+#define THREEPP_GLTIMERQUERIES_HPP
+
+#include <array>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace threepp::gl {
+
+    // Measures GPU time with GL_TIME_ELAPSED queries.
+    // Results are read back frames later, once the GPU reports them as available, so the CPU never waits.
+    class GLTimerQueries {
+
+    public:
+        // Starts a measurement, unless one is active or all queries are still waiting for their results.
+        void begin();
+
+        void end();
+
+        // Latest result that became available since the previous call, in milliseconds.
+        std::optional<double> poll();
+
+        void dispose();
+
+        ~GLTimerQueries();
+
+    private:
+        static constexpr size_t numQueries = 4;
+
+        bool initialized_ = false;
+        std::optional<unsigned int> active_;
+
+        std::array<unsigned int, numQueries> queries_{};
+        std::vector<unsigned int> free_;
+        // ended, oldest first
+        std::deque<unsigned int> pending_;
+    };
+
+}// namespace threepp::gl
+
+#endif//THREEPP_GLTIMERQUERIES_HPP
@@ -0,0 +1,251 @@
+
+#include "threepp/renderers/gl/GLUniformBuffers.hpp"
+
+#include "threepp/cameras/OrthographicCamera.hpp"
+
+#ifndef EMSCRIPTEN
+#include <glad/glad.h>
+#else
+#include <GLES3/gl3.h>
+#endif
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace {
+
+    constexpr size_t numBlocks = static_cast<size_t>(GLUniformBuffers::Block::Count);
+
+    // indexed by GLUniformBuffers::Block
+    const std::array<const char*, numBlocks> blockNames{
+            "CameraBlock",
+            "AmbientLightBlock",
+            "DirectionalLightsBlock",
+            "PointLightsBlock",
+            "SpotLightsBlock",
+            "HemisphereLightsBlock",
+            "DirectionalShadowMatrixBlock",
+            "DirectionalLightShadowsBlock",
+            "SpotShadowMatrixBlock",
+            "SpotLightShadowsBlock",
+            "PointShadowMatrixBlock",
+            "PointLightShadowsBlock",
+            "DirectionalShadowCascadeMatrixBlock"};
+
+    float getFloat(const LightUniforms& uniforms, const std::string& name) {
+
+        const auto& value = uniforms.at(name);
+        if (std::holds_alternative<int>(value)) {
+            return static_cast<float>(std::get<int>(value));
+        }
+        return std::get<float>(value);
+    }
+
+    void putVec3(Std140Buffer& target, const LightUniforms& uniforms, const std::string& name) {
+
+        const auto& value = uniforms.at(name);
+        if (std::holds_alternative<Color>(value)) {
+            target.putVec3(std::get<Color>(value));
+        } else {
+            target.putVec3(std::get<Vector3>(value));
+        }
+    }
+
+    void packShadows(const std::vector<LightUniforms*>& shadows, bool pointShadow, Std140Buffer& target) {
+
+        for (const auto shadow : shadows) {
+
+            if (shadow) {
+
+                target.putFloat(getFloat(*shadow, "shadowBias"));
+                target.putFloat(getFloat(*shadow, "shadowNormalBias"));
+                target.putFloat(getFloat(*shadow, "shadowRadius"));
+                target.putVec2(std::get<Vector2>(shadow->at("shadowMapSize")));
+
+                if (shadow->count("shadowCascades")) {
+
+                    target.putFloat(getFloat(*shadow, "shadowCascades"));
+                }
+
+                if (pointShadow) {
+
+                    target.putFloat(getFloat(*shadow, "shadowCameraNear"));
+                    target.putFloat(getFloat(*shadow, "shadowCameraFar"));
+                }
+
+                if (shadow->count("shadowMapRect")) {
+
+                    target.putVec4(std::get<Vector4>(shadow->at("shadowMapRect")));
+                }
+            }
+
+            target.endElement();
+        }
+    }
+
+    void packMatrices(const std::vector<Matrix4*>& matrices, Std140Buffer& target) {
+
+        static const Matrix4 identity;
+
+        for (const auto m : matrices) {
+
+            target.putMat4(m ? *m : identity);
+        }
+    }
+
+}// namespace
+
+void GLUniformBuffers::bindBlocks(unsigned int program) {
+
+    for (unsigned i = 0; i < numBlocks; ++i) {
+
+        const auto index = glGetUniformBlockIndex(program, blockNames[i]);
+        if (index != GL_INVALID_INDEX) {
+
+            glUniformBlockBinding(program, index, i);
+        }
+    }
+}
+
+void GLUniformBuffers::packCamera(const Camera& camera, Std140Buffer& target) {
+
+    Vector3 cameraPosition;
+    cameraPosition.setFromMatrixPosition(*camera.matrixWorld);
+
+    target.clear();
+    target.putMat4(camera.projectionMatrix);
+    target.putMat4(camera.matrixWorldInverse);
+    target.putVec3(cameraPosition);
+    target.putBool(camera.is<OrthographicCamera>());
+    target.endElement();
+}
+
+void GLUniformBuffers::packLights(const GLLights::LightState& lights, std::array<Std140Buffer, numBlocks>& target) {
+
+    auto& ambient = target[static_cast<size_t>(Block::AmbientLight)];
+    ambient.clear();
+    ambient.putVec3(lights.ambient);
+    for (size_t i = 0; i < 9; ++i) {
+        ambient.putVec3(i < lights.probe.size() ? lights.probe[i] : Vector3());
+        ambient.endElement();
+    }
+
+    auto& directional = target[static_cast<size_t>(Block::DirectionalLights)];
+    directional.clear();
+    for (const auto light : lights.directional) {
+        putVec3(directional, *light, "direction");
+        putVec3(directional, *light, "color");
+        directional.endElement();
+    }
+
+    auto& point = target[static_cast<size_t>(Block::PointLights)];
+    point.clear();
+    for (const auto light : lights.point) {
+        putVec3(point, *light, "position");
+        putVec3(point, *light, "color");
+        point.putFloat(getFloat(*light, "distance"));
+        point.putFloat(getFloat(*light, "decay"));
+        point.endElement();
+    }
+
+    auto& spot = target[static_cast<size_t>(Block::SpotLights)];
+    spot.clear();
+    for (const auto light : lights.spot) {
+        putVec3(spot, *light, "position");
+        putVec3(spot, *light, "direction");
+        putVec3(spot, *light, "color");
+        spot.putFloat(getFloat(*light, "distance"));
+        spot.putFloat(getFloat(*light, "decay"));
+        spot.putFloat(getFloat(*light, "coneCos"));
+        spot.putFloat(getFloat(*light, "penumbraCos"));
+        spot.endElement();
+    }
+
+    auto& hemi = target[static_cast<size_t>(Block::HemisphereLights)];
+    hemi.clear();
+    for (const auto light : lights.hemi) {
+        putVec3(hemi, *light, "direction");
+        putVec3(hemi, *light, "skyColor");
+        putVec3(hemi, *light, "groundColor");
+        hemi.endElement();
+    }
+
+    auto& directionalShadowMatrix = target[static_cast<size_t>(Block::DirectionalShadowMatrix)];
+    directionalShadowMatrix.clear();
+    packMatrices(lights.directionalShadowMatrix, directionalShadowMatrix);
+
+    auto& directionalShadows = target[static_cast<size_t>(Block::DirectionalLightShadows)];
+    directionalShadows.clear();
+    packShadows(lights.directionalShadow, false, directionalShadows);
+
+    auto& spotShadowMatrix = target[static_cast<size_t>(Block::SpotShadowMatrix)];
+    spotShadowMatrix.clear();
+    packMatrices(lights.spotShadowMatrix, spotShadowMatrix);
+
+    auto& spotShadows = target[static_cast<size_t>(Block::SpotLightShadows)];
+    spotShadows.clear();
+    packShadows(lights.spotShadow, false, spotShadows);
+
+    auto& pointShadowMatrix = target[static_cast<size_t>(Block::PointShadowMatrix)];
+    pointShadowMatrix.clear();
+    packMatrices(lights.pointShadowMatrix, pointShadowMatrix);
+
+    auto& pointShadows = target[static_cast<size_t>(Block::PointLightShadows)];
+    pointShadows.clear();
+    packShadows(lights.pointShadow, true, pointShadows);
+
+    auto& directionalShadowCascadeMatrix = target[static_cast<size_t>(Block::DirectionalShadowCascadeMatrix)];
+    directionalShadowCascadeMatrix.clear();
+    packMatrices(lights.directionalShadowCascadeMatrix, directionalShadowCascadeMatrix);
+}
+
+void GLUniformBuffers::updateCamera(const Camera& camera) {
+
+    packCamera(camera, data_[static_cast<size_t>(Block::Camera)]);
+    upload(Block::Camera);
+}
+
+void GLUniformBuffers::updateLights(const GLLights::LightState& lights) {
+
+    // light values rarely change from frame to frame, so only upload blocks that differ
+    packLights(lights, data_);
+
+    for (unsigned i = static_cast<unsigned>(Block::AmbientLight); i < numBlocks; ++i) {
+
+        if (!buffers_[i] || data_[i].changed()) {
+
+            upload(static_cast<Block>(i));
+        }
+    }
+}
+
+void GLUniformBuffers::upload(Block block) {
+
+    const auto index = static_cast<size_t>(block);
+    const auto& data = data_[index];
+
+    auto& buffer = buffers_[index];
+    if (!buffer) glGenBuffers(1, &buffer);
+
+    // blocks for absent lights are never read, but binding an empty buffer is not allowed
+    static const std::array<float, 4> empty{};
+    const auto size = data.data().empty() ? sizeof(empty) : data.byteSize();
+    const auto ptr = data.data().empty() ? empty.data() : data.data().data();
+
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size), ptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, static_cast<GLuint>(index), buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void GLUniformBuffers::dispose() {
+
+    for (auto& buffer : buffers_) {
+
+        if (buffer) {
+
+            glDeleteBuffers(1, &buffer);
+            buffer = 0;
+        }
+    }
+}
@@ -0,0 +1,163 @@
+
+#ifndef THREEPP_GLUNIFORMBUFFERS_HPP
+#define THREEPP_GLUNIFORMBUFFERS_HPP
+
+#include "threepp/renderers/gl/GLLights.hpp"
+
+#include "threepp/math/Color.hpp"
+#include "threepp/math/Matrix4.hpp"
+#include "threepp/math/Vector2.hpp"
+#include "threepp/math/Vector3.hpp"
+#include "threepp/math/Vector4.hpp"
+
+#include <array>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace threepp {
+
+    class Camera;
+
+    namespace gl {
+
+        // CPU side image of a uniform block, packed according to the std140 layout rules.
+        class Std140Buffer {
+
+        public:
+            // Starts over, keeping the previous contents for changed().
+            void clear() {
+
+                std::swap(data_, previous_);
+                data_.clear();
+            }
+
+            // Whether the contents differ from those before the last clear().
+            [[nodiscard]] bool changed() const {
+
+                return data_ != previous_;
+            }
+
+            void putFloat(float value) {
+
+                data_.emplace_back(value);
+            }
+
+            void putBool(bool value) {
+
+                const int i = value ? 1 : 0;
+                float f;
+                std::memcpy(&f, &i, sizeof(float));
+                data_.emplace_back(f);
+            }
+
+            void putVec2(const Vector2& v) {
+
+                align(2);
+                data_.insert(data_.end(), {v.x, v.y});
+            }
+
+            void putVec3(const Vector3& v) {
+
+                align(4);
+                data_.insert(data_.end(), {v.x, v.y, v.z});
+            }
+
+            void putVec3(const Color& c) {
+
+                align(4);
+                data_.insert(data_.end(), {c.r, c.g, c.b});
+            }
+
+            void putVec4(const Vector4& v) {
+
+                align(4);
+                data_.insert(data_.end(), {v.x, v.y, v.z, v.w});
+            }
+
+            void putMat4(const Matrix4& m) {
+
+                align(4);
+                data_.insert(data_.end(), m.elements.begin(), m.elements.end());
+            }
+
+            // Structs and array elements start and end on a vec4 boundary.
+            void endElement() {
+
+                align(4);
+            }
+
+            [[nodiscard]] const std::vector<float>& data() const {
+
+                return data_;
+            }
+
+            [[nodiscard]] size_t byteSize() const {
+
+                return data_.size() * sizeof(float);
+            }
+
+        private:
+            std::vector<float> data_;
+            std::vector<float> previous_;
+
+            void align(size_t n) {
+
+                while (data_.size() % n != 0) data_.emplace_back(0.f);
+            }
+        };
+
+        // Uniform buffer objects holding the camera, light and shadow uniforms shared by all programs
+        // compiled with ProgramParameters::uniformBuffers. They are written once per frame (lights) or
+        // per camera switch (camera), instead of being uploaded to every program that uses them.
+        class GLUniformBuffers {
+
+        public:
+            // Block binding points. Must match the block names used by the shader chunks.
+            enum class Block {
+                Camera,
+                AmbientLight,
+                DirectionalLights,
+                PointLights,
+                SpotLights,
+                HemisphereLights,
+                DirectionalShadowMatrix,
+                DirectionalLightShadows,
+                SpotShadowMatrix,
+                SpotLightShadows,
+                PointShadowMatrix,
+                PointLightShadows,
+                DirectionalShadowCascadeMatrix,
+                Count
+            };
+
+            GLUniformBuffers() = default;
+
+            GLUniformBuffers(const GLUniformBuffers&) = delete;
+            GLUniformBuffers& operator=(const GLUniformBuffers&) = delete;
+
+            // Assigns the binding point of every block the program declares.
+            static void bindBlocks(unsigned int program);
+
+            static void packCamera(const Camera& camera, Std140Buffer& target);
+
+            static void packLights(const GLLights::LightState& lights, std::array<Std140Buffer, static_cast<size_t>(Block::Count)>& target);
+
+            void updateCamera(const Camera& camera);
+
+            void updateLights(const GLLights::LightState& lights);
+
+            void dispose();
+
+        private:
+            std::array<unsigned int, static_cast<size_t>(Block::Count)> buffers_{};
+            std::array<Std140Buffer, static_cast<size_t>(Block::Count)> data_;
+
+            void upload(Block block);
+        };
+
+    }// namespace gl
+
+}// namespace threepp
+
+#endif//THREEPP_GLUNIFORMBUFFERS_HPP
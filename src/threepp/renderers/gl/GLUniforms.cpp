@@ -55,6 +55,11 @@ namespace {
             setValueFun(value, textures);
         }
 
+        UniformHandle handle() {
+
+            return {addr, activeInfo.type, &cache};
+        }
+
     private:
         int addr;
         std::vector<float> cache;
@@ -396,6 +401,7 @@ namespace {
                                                        [&](float arg) { u->setValue(arg, textures); },
                                                        [&](Vector2 arg) { u->setValue(arg, textures); },
                                                        [&](Vector3 arg) { u->setValue(arg, textures); },
+                                                       [&](Vector4 arg) { u->setValue(arg, textures); },
                                                        [&](Color arg) { u->setValue(arg, textures); }},
                                                v);
                                 }
@@ -480,6 +486,9 @@ GLUniforms::GLUniforms(unsigned int program) {
         ActiveUniformInfo info(program, i);
         GLint addr = glGetUniformLocation(program, info.name.c_str());
 
+        // members of uniform blocks have no location and are written through their buffer
+        if (addr == -1) continue;
+
         parseUniform(info, addr, dynamic_cast<Container*>(this));
     }
 }
@@ -492,6 +501,19 @@ void GLUniforms::setValue(const std::string& name, const UniformValue& value, GL
     }
 }
 
+UniformHandle GLUniforms::getHandle(const std::string& name) const {
+
+    auto it = map.find(name);
+    if (it == map.end()) return {};
+
+    if (auto single = dynamic_cast<SingleUniform*>(it->second)) {
+
+        return single->handle();
+    }
+
+    return {};
+}
+
 void GLUniforms::upload(std::vector<UniformObject*>& seq, UniformMap& values, GLTextures* textures) {
 
     for (const auto& u : seq) {
@@ -517,3 +539,76 @@ std::vector<UniformObject*> GLUniforms::seqWithValue(const std::vector<std::uniq
 
     return r;
 }
+
+void UniformHandle::setValue(bool value) const {
+
+    if (!accepts(GL_BOOL) && !accepts(GL_INT)) return;
+
+    glUniform1i(addr_, value);
+}
+
+void UniformHandle::setValue(int value) const {
+
+    if (!accepts(GL_INT) && !accepts(GL_BOOL)) return;
+
+    glUniform1i(addr_, value);
+}
+
+void UniformHandle::setValue(float value) const {
+
+    if (!accepts(GL_FLOAT)) return;
+
+    auto& cache = *cache_;
+    ensureCapacity(cache, 1);
+    if (cache[0] == value) return;
+
+    glUniform1f(addr_, value);
+    cache[0] = value;
+}
+
+void UniformHandle::setValue(const Vector2& value) const {
+
+    if (!accepts(GL_FLOAT_VEC2)) return;
+
+    auto& cache = *cache_;
+    ensureCapacity(cache, 2);
+    if (cache[0] == value.x && cache[1] == value.y) return;
+
+    glUniform2f(addr_, value.x, value.y);
+    cache[0] = value.x;
+    cache[1] = value.y;
+}
+
+void UniformHandle::setValue(const Vector3& value) const {
+
+    if (!accepts(GL_FLOAT_VEC3)) return;
+
+    auto& cache = *cache_;
+    ensureCapacity(cache, 3);
+    if (cache[0] == value.x && cache[1] == value.y && cache[2] == value.z) return;
+
+    glUniform3f(addr_, value.x, value.y, value.z);
+    cache[0] = value.x;
+    cache[1] = value.y;
+    cache[2] = value.z;
+}
+
+void UniformHandle::setValue(const Matrix3& value) const {
+
+    if (!accepts(GL_FLOAT_MAT3) || arraysEqual(*cache_, value.elements)) return;
+
+    glUniformMatrix3fv(addr_, 1, false, value.elements.data());
+
+    ensureCapacity(*cache_, 9);
+    copyArray(*cache_, value.elements);
+}
+
+void UniformHandle::setValue(const Matrix4& value) const {
+
+    if (!accepts(GL_FLOAT_MAT4) || arraysEqual(*cache_, value.elements)) return;
+
+    glUniformMatrix4fv(addr_, 1, false, value.elements.data());
+
+    ensureCapacity(*cache_, 16);
+    copyArray(*cache_, value.elements);
+}
@@ -24,6 +24,48 @@ namespace threepp::gl {
         virtual ~UniformObject() = default;
     };
 
+    // Pre-resolved location of a plain (non-array, non-struct) uniform.
+    // Writes skip the name lookup and UniformValue boxing of GLUniforms::setValue,
+    // but share the redundant-upload cache of the uniform they were resolved from.
+    // Writing through a handle of an inactive uniform, or a value the GL type of the uniform does not take
+    // (bool and int for BOOL and INT, float, vectors and matrices for their own type only), is a no-op.
+    struct UniformHandle {
+
+        UniformHandle() = default;
+
+        UniformHandle(int addr, unsigned int type, std::vector<float>* cache)
+            : addr_(addr), type_(type), cache_(cache) {}
+
+        [[nodiscard]] bool valid() const {
+
+            return cache_ != nullptr;
+        }
+
+        void setValue(bool value) const;
+        void setValue(int value) const;
+        void setValue(float value) const;
+        void setValue(const Vector2& value) const;
+        void setValue(const Vector3& value) const;
+        void setValue(const Matrix3& value) const;
+        void setValue(const Matrix4& value) const;
+
+        // The GL type of the uniform, 0 for an inactive one.
+        [[nodiscard]] unsigned int type() const {
+
+            return type_;
+        }
+
+    private:
+        int addr_ = -1;
+        unsigned int type_ = 0;
+        std::vector<float>* cache_ = nullptr;
+
+        [[nodiscard]] bool accepts(unsigned int type) const {
+
+            return cache_ && type_ == type;
+        }
+    };
+
     struct Container {
 
         std::vector<std::unique_ptr<UniformObject>> seq;
@@ -38,6 +80,9 @@ namespace threepp::gl {
 
         void setValue(const std::string& name, const UniformValue& value, GLTextures* textures = nullptr);
 
+        // Resolves a handle for a plain uniform. The handle stays valid for the lifetime of this object.
+        [[nodiscard]] UniformHandle getHandle(const std::string& name) const;
+
         static void upload(std::vector<UniformObject*>& seq, UniformMap& values, GLTextures* textures);
 
         static std::vector<UniformObject*> seqWithValue(const std::vector<std::unique_ptr<UniformObject>>& seq, UniformMap& values);
@@ -81,13 +81,14 @@ ProgramParameters::ProgramParameters(
         defines = definesMaterial->defines;
     }
 
-    isRawShaderMaterial = material->is<RawShaderMaterial>();
+    isRawShaderMaterial = material->hasTag(Material::Tag::RawShader);
 
     precision = "highp";
 
-    auto instancedMesh = dynamic_cast<InstancedMesh*>(object);
+    auto instancedMesh = object->hasTag(Object3D::Tag::InstancedMesh) ? dynamic_cast<InstancedMesh*>(object) : nullptr;
     instancing = instancedMesh != nullptr;
     instancingColor = instancedMesh != nullptr && instancedMesh->instanceColor() != nullptr;
+    batching = object->hasTag(Object3D::Tag::BatchedMesh);
 
     supportsVertexTextures = GLCapabilities::instance().vertexTextures;
     outputEncoding = renderer.outputEncoding;
@@ -141,7 +142,10 @@ ProgramParameters::ProgramParameters(
     vertexAlphas = material->vertexColors &&
                    object->geometry() &&
                    object->geometry()->hasAttribute("color") &&
-                   object->geometry()->getAttribute<float>("color")->itemSize() == 4;
+                   object->geometry()->getAttribute("color")->itemSize() == 4;
+    octahedralNormals = object->geometry() &&
+                        object->geometry()->hasAttribute("normal") &&
+                        object->geometry()->getAttribute("normal")->itemSize() == 2;
     vertexUvs = true;     // TODO
     uvsVertexOnly = false;// TODO;
 
@@ -156,7 +160,7 @@ ProgramParameters::ProgramParameters(
     auto sizeMaterial = material->as<MaterialWithSize>();
     sizeAttenuation = sizeMaterial ? sizeMaterial->sizeAttenuation : false;
 
-    skinning = object->is<SkinnedMesh>();
+    skinning = object->hasTag(Object3D::Tag::SkinnedMesh);
     maxBones = 64;// TODO
     useVertexTexture = GLCapabilities::instance().floatVertexTextures;
 
@@ -174,6 +178,7 @@ ProgramParameters::ProgramParameters(
     numDirLightShadows = lights.directionalShadowMap.size();
     numPointLightShadows = lights.pointShadowMap.size();
     numSpotLightShadows = lights.spotShadowMap.size();
+    numDirLightShadowCascades = numDirLightShadows > 0 ? lights.directionalShadowCascades : 1;
 
     numClippingPlanes = clipping.numPlanes;
     numClipIntersection = clipping.numIntersection;
@@ -182,9 +187,11 @@ ProgramParameters::ProgramParameters(
 
     shadowMapEnabled = renderer.shadowMap().enabled && numShadows > 0;
     shadowMapType = renderer.shadowMap().type;
+    shadowAtlas = shadowMapEnabled && renderer.shadowMap().usesAtlas();
 
     toneMapping = material->toneMapped ? renderer.toneMapping : ToneMapping::None;
     physicallyCorrectLights = renderer.physicallyCorrectLights;
+    uniformBuffers = renderer.uniformBuffers && !isRawShaderMaterial;
 
     premultipliedAlpha = material->premultipliedAlpha;
 
@@ -205,6 +212,7 @@ std::string ProgramParameters::hash() const {
 
     s << std::to_string(instancing) << '\n';
     s << std::to_string(instancingColor) << '\n';
+    s << std::to_string(batching) << '\n';
 
     s << std::to_string(supportsVertexTextures) << '\n';
     s << std::to_string(as_integer(outputEncoding)) << '\n';
@@ -252,6 +260,7 @@ std::string ProgramParameters::hash() const {
     s << std::to_string(vertexTangents) << '\n';
     s << std::to_string(vertexColors) << '\n';
     s << std::to_string(vertexAlphas) << '\n';
+    s << std::to_string(octahedralNormals) << '\n';
     s << std::to_string(vertexUvs) << '\n';
     s << std::to_string(uvsVertexOnly) << '\n';
 
@@ -279,6 +288,7 @@ std::string ProgramParameters::hash() const {
     s << std::to_string(numDirLightShadows) << '\n';
     s << std::to_string(numPointLightShadows) << '\n';
     s << std::to_string(numSpotLightShadows) << '\n';
+    s << std::to_string(numDirLightShadowCascades) << '\n';
 
     s << std::to_string(numClippingPlanes) << '\n';
     s << std::to_string(numClipIntersection) << '\n';
@@ -287,9 +297,11 @@ std::string ProgramParameters::hash() const {
 
     s << std::to_string(shadowMapEnabled) << '\n';
     s << std::to_string(as_integer(shadowMapType)) << '\n';
+    s << std::to_string(shadowAtlas) << '\n';
 
     s << std::to_string(as_integer(toneMapping)) << '\n';
     s << std::to_string(physicallyCorrectLights) << '\n';
+    s << std::to_string(uniformBuffers) << '\n';
 
     s << std::to_string(premultipliedAlpha) << '\n';
 
@@ -33,6 +33,7 @@ namespace threepp {
 
             bool instancing{};
             bool instancingColor{};
+            bool batching{};
 
             bool supportsVertexTextures;
             Encoding outputEncoding{};
@@ -75,6 +76,7 @@ namespace threepp {
             bool vertexTangents{};
             bool vertexColors{};
             bool vertexAlphas{};
+            bool octahedralNormals{};
             bool vertexUvs{};
             bool uvsVertexOnly{};
 
@@ -103,6 +105,7 @@ namespace threepp {
             size_t numDirLightShadows{};
             size_t numPointLightShadows{};
             size_t numSpotLightShadows{};
+            int numDirLightShadowCascades{};
 
             int numClippingPlanes{};
             int numClipIntersection{};
@@ -111,9 +114,11 @@ namespace threepp {
 
             bool shadowMapEnabled{};
             ShadowMap shadowMapType{};
+            bool shadowAtlas{};
 
             ToneMapping toneMapping{};
             bool physicallyCorrectLights{};
+            bool uniformBuffers{};
 
             bool premultipliedAlpha{};
 
@@ -7,6 +7,11 @@
 using namespace threepp;
 
 
+Scene::Scene() {
+
+    addTag(Tag::Scene);
+}
+
 std::shared_ptr<Scene> Scene::create() {
 
     return std::make_shared<Scene>();
@@ -0,0 +1,233 @@
+
+#include "threepp/scenes/SpatialIndex.hpp"
+
+#include "threepp/core/BufferGeometry.hpp"
+#include "threepp/core/Object3D.hpp"
+#include "threepp/objects/Sprite.hpp"
+
+#include <mutex>
+
+using namespace threepp;
+
+namespace {
+
+    // same bounds as Frustum::intersectsSprite
+    const Sphere spriteSphere{Vector3(), 0.7071067811865476f};
+
+    bool indexable(const Object3D& object) {
+
+        if (object.hasTag(Object3D::Tag::Sprite)) return true;
+
+        if (!object.hasTag(Object3D::Tag::Mesh) && !object.hasTag(Object3D::Tag::Line) && !object.hasTag(Object3D::Tag::Points)) return false;
+
+        return !object.hasTag(Object3D::Tag::InstancedMesh) && !object.hasTag(Object3D::Tag::BatchedMesh);
+    }
+
+    Box3 worldBox(const Sphere& sphere, const Matrix4& matrixWorld) {
+
+        Sphere s(sphere);
+        s.applyMatrix4(matrixWorld);
+
+        const Vector3 extent{s.radius, s.radius, s.radius};
+
+        return {Vector3(s.center).sub(extent), Vector3(s.center).add(extent)};
+    }
+
+}// namespace
+
+SpatialIndex::SpatialIndex(float margin)
+    : tree_(margin) {}
+
+void SpatialIndex::update(Object3D& root) {
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    ++updateStamp_;
+    uncovered_.clear();
+
+    root.traverse([this](Object3D& object) {
+        updateObject(object);
+    });
+
+    // entries that were not visited belong to objects that left the scene, or no longer exist, so they are not dereferenced
+    for (size_t proxy = 0; proxy < entries_.size(); ++proxy) {
+
+        auto& entry = entries_[proxy];
+
+        if (entry.object && entry.updateStamp != updateStamp_) {
+
+            tree_.remove(static_cast<int>(proxy));
+            entry = Entry{};
+        }
+    }
+}
+
+void SpatialIndex::updateObject(Object3D& object) {
+
+    Sphere sphere;
+    BufferGeometry* geometry = nullptr;
+
+    const bool sprite = object.hasTag(Object3D::Tag::Sprite);
+
+    if (sprite) {
+
+        sphere = spriteSphere;
+
+    } else if (indexable(object)) {
+
+        geometry = object.geometry().get();
+
+        if (geometry) {
+
+            if (!geometry->boundingSphere) geometry->computeBoundingSphere();
+            sphere = *geometry->boundingSphere;
+        }
+    }
+
+    auto proxy = proxyOf(object);
+
+    if (sphere.isEmpty()) {
+
+        if (proxy != DynamicAABBTree::nullNode) {
+
+            tree_.remove(proxy);
+            entries_[proxy] = Entry{};
+        }
+
+        uncovered_.emplace_back(&object);
+        return;
+    }
+
+    if (sprite) uncovered_.emplace_back(&object);
+
+    if (proxy == DynamicAABBTree::nullNode) {
+
+        proxy = tree_.insert(worldBox(sphere, *object.matrixWorld), &object);
+
+        if (proxy >= static_cast<int>(entries_.size())) entries_.resize(proxy + 1);
+
+        object.spatialIndex_ = this;
+        object.spatialProxy_ = proxy;
+
+        auto& entry = entries_[proxy];
+        entry.object = &object;
+        entry.sprite = sprite;
+
+    } else {
+
+        const auto& entry = entries_[proxy];
+
+        if (entry.geometry == geometry && entry.sphere.equals(sphere) && entry.matrixWorld.equals(*object.matrixWorld)) {
+
+            entries_[proxy].updateStamp = updateStamp_;
+            return;
+        }
+
+        tree_.move(proxy, worldBox(sphere, *object.matrixWorld));
+    }
+
+    auto& entry = entries_[proxy];
+    entry.geometry = geometry;
+    entry.sphere = sphere;
+    entry.matrixWorld.copy(*object.matrixWorld);
+    entry.updateStamp = updateStamp_;
+
+    // the result of the last query no longer applies
+    entry.queryStamp = queryStamp_;
+    entry.inside = false;
+}
+
+void SpatialIndex::query(const Frustum& frustum) {
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    ++queryStamp_;
+
+    tree_.query(frustum, [this](int proxy, bool inside) {
+        auto& entry = entries_[proxy];
+        entry.queryStamp = queryStamp_;
+        entry.inside = inside;
+    });
+}
+
+SpatialIndex::FrustumResult SpatialIndex::frustumResult(const Object3D& object) const {
+
+    const auto proxy = proxyOf(object);
+
+    if (proxy == DynamicAABBTree::nullNode) return FrustumResult::NotIndexed;
+
+    const auto& entry = entries_[proxy];
+
+    if (entry.queryStamp != queryStamp_) return FrustumResult::Outside;
+
+    return entry.inside ? FrustumResult::Inside : FrustumResult::Intersecting;
+}
+
+bool SpatialIndex::intersectsFrustum(const Frustum& frustum, Object3D& object) const {
+
+    switch (frustumResult(object)) {
+
+        case FrustumResult::Outside:
+            return false;
+        case FrustumResult::Inside:
+            return true;
+        default:
+            break;
+    }
+
+    if (object.hasTag(Object3D::Tag::Sprite)) {
+
+        return frustum.intersectsSprite(static_cast<const Sprite&>(object));
+    }
+
+    return frustum.intersectsObject(object);
+}
+
+void SpatialIndex::raycast(const Ray& ray, float near, float far, float threshold, std::vector<Object3D*>& result) const {
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    tree_.raycast(ray, near, far, threshold, [&](int proxy) {
+        const auto& entry = entries_[proxy];
+        if (!entry.sprite) result.emplace_back(entry.object);
+    });
+
+    result.insert(result.end(), uncovered_.begin(), uncovered_.end());
+}
+
+const std::vector<Object3D*>& SpatialIndex::uncovered() const {
+
+    return uncovered_;
+}
+
+bool SpatialIndex::contains(const Object3D& object) const {
+
+    return proxyOf(object) != DynamicAABBTree::nullNode;
+}
+
+size_t SpatialIndex::size() const {
+
+    return tree_.size();
+}
+
+const DynamicAABBTree& SpatialIndex::tree() const {
+
+    return tree_;
+}
+
+int SpatialIndex::proxyOf(const Object3D& object) const {
+
+    if (object.spatialIndex_ != this) return DynamicAABBTree::nullNode;
+
+    const auto proxy = object.spatialProxy_;
+    if (proxy < 0 || proxy >= static_cast<int>(entries_.size()) || entries_[proxy].object != &object) {
+        return DynamicAABBTree::nullNode;
+    }
+
+    return proxy;
+}
+
+std::shared_ptr<SpatialIndex> SpatialIndex::create(float margin) {
+
+    return std::make_shared<SpatialIndex>(margin);
+}
@@ -1,7 +1,13 @@
 
 #include "threepp/utils/BufferGeometryUtils.hpp"
 
+#include "threepp/core/InterleavedBufferAttribute.hpp"
+#include "threepp/objects/Mesh.hpp"
+
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 
 using namespace threepp;
 
@@ -194,3 +200,365 @@ std::shared_ptr<BufferGeometry> threepp::mergeBufferGeometries(const std::vector
 
     return mergeBufferGeometries(arr, useGroups);
 }
+
+std::vector<std::unique_ptr<InterleavedBufferAttribute>> threepp::interleaveAttributes(const std::vector<const FloatBufferAttribute*>& attributes) {
+
+    int stride = 0;
+    int count = -1;
+
+    for (const auto attribute : attributes) {
+
+        if (count != -1 && attribute->count() != count) {
+
+            throw std::runtime_error("THREE.BufferGeometryUtils: .interleaveAttributes() failed. All attributes must have the same count.");
+        }
+
+        count = attribute->count();
+        stride += attribute->itemSize();
+    }
+
+    std::vector<float> array(std::max(count, 0) * stride);
+
+    std::vector<std::unique_ptr<InterleavedBufferAttribute>> result;
+    result.reserve(attributes.size());
+
+    int offset = 0;
+    for (const auto attribute : attributes) {
+
+        const auto itemSize = attribute->itemSize();
+
+        // getX() and friends, so that interleaved sources work too
+        for (int i = 0; i < count; i++) {
+
+            const auto index = i * stride + offset;
+
+            array[index] = attribute->getX(i);
+            if (itemSize >= 2) array[index + 1] = attribute->getY(i);
+            if (itemSize >= 3) array[index + 2] = attribute->getZ(i);
+            if (itemSize >= 4) array[index + 3] = attribute->getW(i);
+        }
+
+        offset += itemSize;
+    }
+
+    auto buffer = InterleavedBuffer::create(array, stride);
+
+    // the buffer is uploaded as a whole, so it is as dynamic as its most dynamic attribute
+    for (const auto attribute : attributes) {
+
+        if (attribute->getUsage() != DrawUsage::Static) buffer->setUsage(attribute->getUsage());
+    }
+
+    offset = 0;
+    for (const auto attribute : attributes) {
+
+        result.emplace_back(InterleavedBufferAttribute::create(buffer, attribute->itemSize(), offset, attribute->normalized()));
+        offset += attribute->itemSize();
+    }
+
+    return result;
+}
+
+std::shared_ptr<InterleavedBuffer> threepp::interleave(BufferGeometry& geometry) {
+
+    std::vector<std::string> names;
+    std::vector<const FloatBufferAttribute*> attributes;
+
+    for (const auto& [name, attribute] : geometry.getAttributes()) {
+
+        if (!attribute->typed<float>() || attribute->itemSize() > 4) continue;
+
+        names.emplace_back(name);
+    }
+
+    if (names.size() < 2) return nullptr;
+
+    // position first, the rest by name, so that the layout does not depend on the map order
+    std::sort(names.begin(), names.end(), [](const std::string& a, const std::string& b) {
+        if (a == "position" || b == "position") return a == "position" && b != "position";
+        return a < b;
+    });
+
+    for (const auto& name : names) {
+
+        attributes.emplace_back(geometry.getAttribute<float>(name));
+    }
+
+    auto interleaved = interleaveAttributes(attributes);
+    auto buffer = interleaved.front()->data;
+
+    for (size_t i = 0; i < names.size(); i++) {
+
+        geometry.setAttribute(names[i], std::move(interleaved[i]));
+    }
+
+    return buffer;
+}
+
+namespace {
+
+    template<class T>
+    T toUnorm(float value) {
+
+        return static_cast<T>(std::lround(std::clamp(value, 0.f, 1.f) * std::numeric_limits<T>::max()));
+    }
+
+    template<class T>
+    float fromUnorm(T value) {
+
+        return static_cast<float>(value) / std::numeric_limits<T>::max();
+    }
+
+    // Encodes values in [0, 1] as unsigned normalized integers.
+    // The error of each component is scaled by errorScale[component] before being compared to maxError.
+    template<class T>
+    std::shared_ptr<BufferAttribute> encodeUnorm(const std::vector<float>& values, int itemSize, bool normalize, const std::vector<float>& errorScale, float& maxError) {
+
+        std::vector<T> array(values.size());
+        for (size_t i = 0; i < values.size(); i++) {
+
+            array[i] = toUnorm<T>(values[i]);
+            maxError = std::max(maxError, std::abs(fromUnorm(array[i]) - values[i]) * errorScale[i % itemSize]);
+        }
+
+        return TypedBufferAttribute<T>::create(array, itemSize, normalize);
+    }
+
+    std::shared_ptr<BufferAttribute> encodeUnorm(int bits, const std::vector<float>& values, int itemSize, const std::vector<float>& errorScale, float& maxError) {
+
+        if (bits == 8) return encodeUnorm<uint8_t>(values, itemSize, true, errorScale, maxError);
+        if (bits == 16) return encodeUnorm<uint16_t>(values, itemSize, true, errorScale, maxError);
+
+        throw std::runtime_error("THREE.BufferGeometryUtils: quantizeGeometry() supports 8 and 16 bits only.");
+    }
+
+    // unit vector to octahedral coordinates in [-1, 1]
+    Vector2 octahedralEncode(const Vector3& n) {
+
+        const auto l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+        Vector2 e{n.x / l1, n.y / l1};
+
+        if (n.z < 0) {
+
+            e.set((1 - std::abs(e.y)) * (e.x >= 0 ? 1.f : -1.f),
+                  (1 - std::abs(e.x)) * (e.y >= 0 ? 1.f : -1.f));
+        }
+
+        return e;
+    }
+
+    // same as octahedralDecode in the vertex shader
+    Vector3 octahedralDecode(const Vector2& e) {
+
+        Vector3 v{e.x, e.y, 1 - std::abs(e.x) - std::abs(e.y)};
+
+        if (v.z < 0) {
+
+            const auto x = v.x;
+            v.x = (1 - std::abs(v.y)) * (x >= 0 ? 1.f : -1.f);
+            v.y = (1 - std::abs(x)) * (v.y >= 0 ? 1.f : -1.f);
+        }
+
+        return v.normalize();
+    }
+
+    template<class T>
+    std::shared_ptr<BufferAttribute> encodeNormals(const FloatBufferAttribute& normals, const Vector3& decodeScale, float& maxError) {
+
+        const auto count = normals.count();
+
+        std::vector<T> array(count * 2);
+        Vector3 n, original, decoded;
+
+        for (int i = 0; i < count; i++) {
+
+            normals.setFromBufferAttribute(original, i);
+            if (original.lengthSq() == 0) original.set(0, 0, 1);
+            original.normalize();
+
+            // the normal matrix divides by the decode scale, compensate for it
+            n.copy(original).multiply(decodeScale).normalize();
+
+            const auto e = octahedralEncode(n);
+            array[i * 2 + 0] = toUnorm<T>(e.x * 0.5f + 0.5f);
+            array[i * 2 + 1] = toUnorm<T>(e.y * 0.5f + 0.5f);
+
+            decoded = octahedralDecode({fromUnorm(array[i * 2 + 0]) * 2 - 1, fromUnorm(array[i * 2 + 1]) * 2 - 1});
+            decoded.divide(decodeScale).normalize();
+
+            maxError = std::max(maxError, decoded.angleTo(original));
+        }
+
+        return TypedBufferAttribute<T>::create(array, 2, true);
+    }
+
+    // float attribute that is not interleaved
+    FloatBufferAttribute* floatAttribute(BufferGeometry& geometry, const std::string& name) {
+
+        auto attribute = geometry.getAttribute<float>(name);
+        if (!attribute || dynamic_cast<InterleavedBufferAttribute*>(attribute)) return nullptr;
+
+        return attribute;
+    }
+
+    bool inUnitRange(const std::vector<float>& values) {
+
+        return std::all_of(values.begin(), values.end(), [](float v) { return v >= 0 && v <= 1; });
+    }
+
+    size_t floatBytes(const BufferAttribute& attribute) {
+
+        return attribute.count() * attribute.itemSize() * sizeof(float);
+    }
+
+    size_t quantizedBytes(const BufferAttribute& attribute, int bits) {
+
+        return attribute.count() * attribute.itemSize() * bits / 8;
+    }
+
+}// namespace
+
+QuantizeResult threepp::quantizeGeometry(BufferGeometry& geometry, const QuantizeOptions& options) {
+
+    if (!geometry.getMorphAttributes().empty() || geometry.hasAttribute("skinIndex")) {
+
+        throw std::runtime_error("THREE.BufferGeometryUtils: quantizeGeometry() does not support morph targets or skinning.");
+    }
+
+    QuantizeResult result;
+
+    // positions, relative to the bounding box
+
+    Vector3 decodeScale{1, 1, 1};
+
+    if (auto position = floatAttribute(geometry, "position")) {
+
+        Box3 box;
+        position->setFromBufferAttribute(box);
+
+        Vector3 size;
+        box.getSize(size);
+
+        // flat axes keep a unit scale, so that the object transform stays invertible
+        decodeScale.set(size.x > 0 ? size.x : 1, size.y > 0 ? size.y : 1, size.z > 0 ? size.z : 1);
+
+        const auto& min = box.min();
+        const std::vector<float> minimum{min.x, min.y, min.z};
+        const std::vector<float> scale{decodeScale.x, decodeScale.y, decodeScale.z};
+
+        std::vector<float> values(position->array());
+        for (size_t i = 0; i < values.size(); i++) {
+
+            values[i] = (values[i] - minimum[i % 3]) / scale[i % 3];
+        }
+
+        result.bytesBefore += floatBytes(*position);
+        result.bytesAfter += quantizedBytes(*position, options.positionBits);
+
+        geometry.setAttribute("position", encodeUnorm(options.positionBits, values, 3, scale, result.positionError));
+
+        result.decodeMatrix.makeScale(decodeScale.x, decodeScale.y, decodeScale.z).setPosition(min);
+
+        // bounds in the quantized space
+        geometry.boundingBox = Box3({0, 0, 0}, {size.x / decodeScale.x, size.y / decodeScale.y, size.z / decodeScale.z});
+        geometry.boundingSphere = Sphere();
+        geometry.boundingBox->getBoundingSphere(*geometry.boundingSphere);
+    }
+
+    // normals, octahedral
+
+    if (auto normal = floatAttribute(geometry, "normal"); normal && normal->itemSize() == 3 && options.normalBits != 0) {
+
+        result.bytesBefore += floatBytes(*normal);
+
+        std::shared_ptr<BufferAttribute> encoded;
+        if (options.normalBits == 8) {
+            encoded = encodeNormals<uint8_t>(*normal, decodeScale, result.normalError);
+        } else if (options.normalBits == 16) {
+            encoded = encodeNormals<uint16_t>(*normal, decodeScale, result.normalError);
+        } else {
+            throw std::runtime_error("THREE.BufferGeometryUtils: quantizeGeometry() supports 8 and 16 bits only.");
+        }
+
+        result.bytesAfter += normal->count() * 2 * options.normalBits / 8;
+
+        geometry.setAttribute("normal", encoded);
+
+    } else if (auto floatNormal = geometry.getAttribute<float>("normal"); floatNormal && floatNormal->itemSize() >= 3) {
+
+        // normals that stay float get the same compensation for the normal matrix
+        Vector3 n;
+        for (int i = 0; i < floatNormal->count(); i++) {
+
+            n.set(floatNormal->getX(i), floatNormal->getY(i), floatNormal->getZ(i)).multiply(decodeScale).normalize();
+            floatNormal->setXYZ(i, n.x, n.y, n.z);
+        }
+        floatNormal->needsUpdate();
+    }
+
+    // tangents stay float, but live in the quantized space too
+
+    if (auto tangent = floatAttribute(geometry, "tangent")) {
+
+        Vector3 t;
+        for (int i = 0; i < tangent->count(); i++) {
+
+            t.set(tangent->getX(i), tangent->getY(i), tangent->getZ(i)).divide(decodeScale).normalize();
+            tangent->setXYZ(i, t.x, t.y, t.z);
+        }
+        tangent->needsUpdate();
+    }
+
+    // uvs and colors, when they fit the unit range
+
+    const std::vector<float> unitScale(4, 1.f);
+
+    if (options.uvs) {
+
+        for (const auto name : {"uv", "uv2"}) {
+
+            auto uv = floatAttribute(geometry, name);
+            if (!uv || !inUnitRange(uv->array())) continue;
+
+            result.bytesBefore += floatBytes(*uv);
+            result.bytesAfter += quantizedBytes(*uv, 16);
+
+            geometry.setAttribute(name, encodeUnorm(16, uv->array(), uv->itemSize(), unitScale, result.uvError));
+        }
+    }
+
+    if (options.colors) {
+
+        auto color = floatAttribute(geometry, "color");
+        if (color && inUnitRange(color->array())) {
+
+            result.bytesBefore += floatBytes(*color);
+            result.bytesAfter += quantizedBytes(*color, 8);
+
+            geometry.setAttribute("color", encodeUnorm(8, color->array(), color->itemSize(), unitScale, result.colorError));
+        }
+    }
+
+    return result;
+}
+
+QuantizeResult threepp::quantizeMesh(Mesh& mesh, const QuantizeOptions& options) {
+
+    if (!mesh.children.empty()) {
+
+        throw std::runtime_error("THREE.BufferGeometryUtils: quantizeMesh() requires a mesh without children.");
+    }
+
+    const auto result = quantizeGeometry(*mesh.geometry(), options);
+
+    // position * quaternion * scale * decode, where decode is a translation and a scale
+    Vector3 offset, decodeScale;
+    Quaternion q;
+    result.decodeMatrix.decompose(offset, q, decodeScale);
+
+    offset.multiply(mesh.scale).applyQuaternion(mesh.quaternion);
+    mesh.position.add(offset);
+    mesh.scale.multiply(decodeScale);
+
+    return result;
+}
@@ -0,0 +1,146 @@
+
+#ifndef THREEPP_THREADPOOL_HPP
+#define THREEPP_THREADPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace threepp::utils {
+
+    // Fixed size pool used to fan out data-parallel work (culling, matrix updates, raycasting).
+    // The calling thread always participates in parallelFor, so a pool of N threads uses N - 1 workers.
+    class ThreadPool {
+
+    public:
+        explicit ThreadPool(size_t numThreads = defaultNumThreads())
+            : numThreads_(std::max<size_t>(1, numThreads)) {
+
+            for (size_t i = 1; i < numThreads_; i++) {
+                workers_.emplace_back([this] { workerLoop(); });
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        [[nodiscard]] size_t size() const {
+
+            return numThreads_;
+        }
+
+        // Invokes fn(i) for every i in [0, count) and blocks until all invocations have returned.
+        // Not re-entrant: fn must not call parallelFor on the same pool.
+        void parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+
+            if (count == 0) return;
+
+            if (workers_.empty() || count == 1) {
+                for (size_t i = 0; i < count; i++) fn(i);
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lck(m_);
+                job_ = &fn;
+                jobSize_ = count;
+                next_ = 0;
+                pending_ = count;
+                ++generation_;
+            }
+            cv_.notify_all();
+
+            const auto completed = runJob(fn, count);
+
+            std::unique_lock<std::mutex> lck(m_);
+            pending_ -= completed;
+            // wait for stragglers too, so that none of them can claim indices of the next job
+            done_.wait(lck, [this] { return pending_ == 0 && active_ == 0; });
+            job_ = nullptr;
+        }
+
+        ~ThreadPool() {
+
+            {
+                std::lock_guard<std::mutex> lck(m_);
+                stop_ = true;
+            }
+            cv_.notify_all();
+
+            for (auto& worker : workers_) {
+                worker.join();
+            }
+        }
+
+        static size_t defaultNumThreads() {
+
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+
+    private:
+        size_t numThreads_;
+        std::vector<std::thread> workers_;
+
+        std::mutex m_;
+        std::condition_variable cv_;
+        std::condition_variable done_;
+
+        const std::function<void(size_t)>* job_{nullptr};
+        size_t jobSize_{0};
+        size_t generation_{0};
+        std::atomic<size_t> next_{0};
+        size_t pending_{0};
+        size_t active_{0};
+        bool stop_{false};
+
+        size_t runJob(const std::function<void(size_t)>& fn, size_t count) {
+
+            size_t completed = 0;
+            for (size_t i = next_++; i < count; i = next_++) {
+                fn(i);
+                ++completed;
+            }
+
+            return completed;
+        }
+
+        void workerLoop() {
+
+            size_t seenGeneration = 0;
+
+            while (true) {
+
+                const std::function<void(size_t)>* job;
+                size_t count;
+
+                {
+                    std::unique_lock<std::mutex> lck(m_);
+                    cv_.wait(lck, [&] { return stop_ || (job_ && generation_ != seenGeneration); });
+
+                    if (stop_) return;
+
+                    seenGeneration = generation_;
+                    job = job_;
+                    count = jobSize_;
+                    ++active_;
+                }
+
+                const auto completed = runJob(*job, count);
+
+                {
+                    std::lock_guard<std::mutex> lck(m_);
+                    pending_ -= completed;
+                    --active_;
+                    if (pending_ == 0 && active_ == 0) done_.notify_one();
+                }
+            }
+        }
+    };
+
+}// namespace threepp::utils
+
+#endif//THREEPP_THREADPOOL_HPP
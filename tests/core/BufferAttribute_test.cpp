@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/core/BufferGeometry.hpp"
+
+using namespace threepp;
+
+TEST_CASE("small typed attributes") {
+
+    auto colors = Uint8BufferAttribute::create({255, 0, 128, 0, 255, 64}, 3, true);
+    CHECK(colors->count() == 2);
+    CHECK(colors->normalized());
+    CHECK(colors->getZ(0) == 128);
+    CHECK(colors->typed<uint8_t>() != nullptr);
+    CHECK(colors->typed<float>() == nullptr);
+
+    auto normals = Int16BufferAttribute::create({-32767, 0, 32767}, 3, true);
+    CHECK(normals->getX(0) == -32767);
+
+    auto uvs = Float16BufferAttribute::create(std::vector<float>{0.5f, 0.25f, 1.f, 2.f}, 2);
+    CHECK(uvs->count() == 2);
+    CHECK(uvs->getX(0) == 0.5f);
+    CHECK(uvs->getY(1) == 2.f);
+
+    uvs->setXY(0, 4.f, 8.f);
+    CHECK(uvs->array()[0].bits == 0x4400);
+    CHECK(uvs->getY(0) == 8.f);
+}
+
+TEST_CASE("geometry with typed attributes") {
+
+    BufferGeometry geometry;
+    geometry.setAttribute("position", FloatBufferAttribute::create(std::vector<float>{0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0}, 3));
+    geometry.setAttribute("color", Uint8BufferAttribute::create({255, 0, 0, 0, 255, 0, 0, 0, 255, 255, 255, 255}, 3, true));
+    geometry.setAttribute("uv", Float16BufferAttribute::create(std::vector<float>{0, 0, 1, 0, 0, 1, 1, 1}, 2));
+    geometry.setIndex(std::vector<unsigned int>{0, 1, 2, 2, 1, 3});
+
+    SECTION("clone") {
+
+        auto clone = geometry.clone();
+        auto color = dynamic_cast<Uint8BufferAttribute*>(clone->getAttribute("color"));
+        REQUIRE(color);
+        CHECK(color->normalized());
+        CHECK(color->array() == std::vector<uint8_t>{255, 0, 0, 0, 255, 0, 0, 0, 255, 255, 255, 255});
+        CHECK(dynamic_cast<Float16BufferAttribute*>(clone->getAttribute("uv")));
+    }
+
+    SECTION("toNonIndexed") {
+
+        auto nonIndexed = geometry.toNonIndexed();
+        auto color = dynamic_cast<Uint8BufferAttribute*>(nonIndexed->getAttribute("color"));
+        REQUIRE(color);
+        CHECK(color->count() == 6);
+        CHECK(color->getX(5) == 255);
+        CHECK(dynamic_cast<Float16BufferAttribute*>(nonIndexed->getAttribute("uv"))->getY(5) == 1.f);
+    }
+}
+
+TEST_CASE("geometry with an unsupported attribute type") {
+
+    BufferGeometry geometry;
+    geometry.setAttribute("position", FloatBufferAttribute::create(std::vector<float>{0, 0, 0, 1, 0, 0, 0, 1, 0}, 3));
+    geometry.setAttribute("weight", TypedBufferAttribute<double>::create(std::vector<double>{1, 2, 3}, 1));
+    geometry.setIndex(std::vector<unsigned int>{0, 1, 2});
+
+    const std::string message = "THREE.BufferGeometry: Unsupported buffer attribute type, "
+                                "expected float, unsigned int, Half, uint16_t, int16_t, uint8_t or int8_t.";
+
+    CHECK_THROWS_WITH(geometry.clone(), message);
+    CHECK_THROWS_WITH(geometry.toNonIndexed(), message);
+}
@@ -3,6 +3,19 @@
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 
 #include "threepp/core/Object3D.hpp"
+#include "threepp/lights/PointLight.hpp"
+#include "threepp/materials/LineBasicMaterial.hpp"
+#include "threepp/materials/MeshDepthMaterial.hpp"
+#include "threepp/materials/MeshPhongMaterial.hpp"
+#include "threepp/materials/MeshStandardMaterial.hpp"
+#include "threepp/materials/PointsMaterial.hpp"
+#include "threepp/materials/RawShaderMaterial.hpp"
+#include "threepp/materials/SpriteMaterial.hpp"
+#include "threepp/objects/Group.hpp"
+#include "threepp/objects/InstancedMesh.hpp"
+#include "threepp/objects/LineSegments.hpp"
+#include "threepp/objects/Sprite.hpp"
+#include "threepp/scenes/Scene.hpp"
 #include "threepp/math/Euler.hpp"
 #include "threepp/math/MathUtils.hpp"
 #include "threepp/math/Matrix3.hpp"
@@ -12,6 +25,7 @@
 #include "../equals_util.hpp"
 
 #include <cmath>
+#include <thread>
 
 using namespace threepp;
 
@@ -320,6 +334,143 @@ TEST_CASE("updateMatrixWorld") {
                                                                   4, 5, 6, 1});
 }
 
+TEST_CASE("updateMatrixWorld skips unchanged transforms") {
+
+    auto parent = Object3D::create();
+    auto child = Object3D::create();
+    parent->add(child);
+
+    parent->position.set(1, 2, 3);
+    child->position.set(4, 5, 6);
+    parent->updateMatrixWorld();
+
+    // a static hierarchy leaves its world matrices untouched
+    child->matrixWorld->identity();
+    parent->updateMatrixWorld();
+    REQUIRE(child->matrixWorld->elements == std::array<float, 16>{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1});
+
+    // moving the parent recomputes the subtree
+    parent->position.x = 2;
+    parent->updateMatrixWorld();
+    REQUIRE(child->matrixWorld->elements == std::array<float, 16>{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 6, 7, 9, 1});
+
+    // rotation and scale are tracked as well
+    child->rotation.y = math::PI;
+    child->scale.z = 2;
+    parent->updateMatrixWorld();
+
+    Matrix4 expected;
+    expected.compose(child->position, child->quaternion, child->scale).premultiply(*parent->matrix);
+    REQUIRE(child->matrixWorld->equals(expected));
+}
+
+TEST_CASE("updateMatrixWorld keeps an edited matrix") {
+
+    auto object = Object3D::create();
+    object->position.set(1, 2, 3);
+    object->updateMatrixWorld();
+
+    // position, quaternion and scale did not change, so the edit is not overwritten
+    object->matrix->makeTranslation(4, 5, 6);
+    object->matrixWorldNeedsUpdate = true;
+    object->updateMatrixWorld();
+    REQUIRE(object->matrixWorld->elements == std::array<float, 16>{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 4, 5, 6, 1});
+
+    // until they do
+    object->position.x = 0;
+    object->updateMatrixWorld();
+    REQUIRE(object->matrixWorld->elements == std::array<float, 16>{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 2, 3, 1});
+}
+
+TEST_CASE("updateMatrixWorldParallel") {
+
+    const auto build = [](Object3D& root) {
+        // wide enough levels to be distributed over the threads
+        for (int i = 0; i < 20; i++) {
+            auto group = Object3D::create();
+            group->position.set(static_cast<float>(i), 1, 0);
+            group->rotation.z = static_cast<float>(i) * 0.1f;
+            for (int j = 0; j < 50; j++) {
+                auto node = Object3D::create();
+                node->position.set(0, static_cast<float>(j), 1);
+                node->scale.set(1, 2, 0.5f * static_cast<float>(j + 1));
+                for (int k = 0; k < 3; k++) {
+                    auto leaf = Object3D::create();
+                    leaf->position.set(static_cast<float>(k), 0, 0);
+                    leaf->rotation.x = static_cast<float>(k) * 0.3f;
+                    node->add(leaf);
+                }
+                group->add(node);
+            }
+            root.add(group);
+        }
+        root.position.set(5, 5, 5);
+    };
+
+    Object3D sequential;
+    build(sequential);
+    Object3D parallel;
+    build(parallel);
+
+    for (int frame = 0; frame < 2; frame++) {
+
+        sequential.updateMatrixWorld();
+        parallel.updateMatrixWorldParallel(false, 4);
+
+        std::vector<Matrix4> expected;
+        sequential.traverse([&](Object3D& o) { expected.emplace_back(*o.matrixWorld); });
+
+        size_t index = 0;
+        bool equal = true;
+        parallel.traverse([&](Object3D& o) { equal = equal && o.matrixWorld->elements == expected[index++].elements; });
+        REQUIRE(index == expected.size());
+        REQUIRE(equal);
+
+        // move something in the middle of the hierarchy for the next frame
+        sequential.children[7]->position.y = 10;
+        parallel.children[7]->position.y = 10;
+    }
+}
+
+TEST_CASE("updateMatrixWorldParallel from several threads") {
+
+    std::vector<std::shared_ptr<Object3D>> roots;
+    for (int i = 0; i < 4; i++) {
+
+        auto root = Object3D::create();
+        for (int j = 0; j < 1000; j++) {
+
+            auto node = Object3D::create();
+            node->position.x = static_cast<float>(j);
+            root->add(node);
+        }
+        roots.emplace_back(root);
+    }
+
+    // each asks for another number of threads, which replaces the shared pool
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < roots.size(); i++) {
+
+        threads.emplace_back([&, i] {
+            for (int pass = 0; pass < 20; pass++) {
+
+                roots[i]->position.y = static_cast<float>(pass);
+                roots[i]->updateMatrixWorldParallel(false, i + 1);
+            }
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+    for (const auto& root : roots) {
+
+        for (const auto& child : root->children) {
+
+            REQUIRE(child->matrixWorld->elements[13] == 19);
+        }
+    }
+}
+
 TEST_CASE("updateWorldMatrix") {
 
     auto object = Object3D::create();
@@ -425,3 +576,102 @@ TEST_CASE("updateWorldMatrix") {
 
     REQUIRE(object->matrixWorld->elements == m.setPosition(parent->position).elements);
 }
+
+TEST_CASE("tags") {
+
+    using Tag = Object3D::Tag;
+
+    Object3D object;
+    REQUIRE(!object.hasTag(Tag::Mesh));
+    REQUIRE(!object.hasTag(Tag::Group));
+
+    auto mesh = InstancedMesh::create(nullptr, nullptr, 1);
+    REQUIRE(mesh->hasTag(Tag::Mesh));
+    REQUIRE(mesh->hasTag(Tag::InstancedMesh));
+    REQUIRE(!mesh->hasTag(Tag::SkinnedMesh));
+    REQUIRE(mesh->material()->hasTag(Material::Tag::MeshBasic));
+
+    auto line = LineSegments::create();
+    REQUIRE(line->hasTag(Tag::Line));
+    REQUIRE(line->hasTag(Tag::LineSegments));
+    REQUIRE(!line->hasTag(Tag::LineLoop));
+    REQUIRE(line->material()->hasTag(Material::Tag::LineBasic));
+
+    REQUIRE(Sprite::create()->hasTag(Tag::Sprite));
+    REQUIRE(PointLight::create()->hasTag(Tag::Light));
+    REQUIRE(Group::create()->hasTag(Tag::Group));
+    REQUIRE(Scene::create()->hasTag(Tag::Scene));
+
+    auto clone = Group::create()->clone<Group>();
+    REQUIRE(clone->hasTag(Tag::Group));
+
+    auto material = RawShaderMaterial::create();
+    REQUIRE(material->hasTag(Material::Tag::Shader));
+    REQUIRE(material->hasTag(Material::Tag::RawShader));
+    REQUIRE(!material->hasTag(Material::Tag::MeshBasic));
+}
+
+namespace {
+
+    // as<T>() answers some types from registered pointers, which must agree with a dynamic_cast
+    template<class T>
+    void checkAs(Material& material) {
+
+        CHECK(material.as<T>() == dynamic_cast<T*>(&material));
+        CHECK(material.is<T>() == (dynamic_cast<T*>(&material) != nullptr));
+    }
+
+    void checkRegisteredTypes(Material& material) {
+
+        checkAs<MaterialWithEnvMap>(material);
+        checkAs<MaterialWithLights>(material);
+        checkAs<MaterialWithLineWidth>(material);
+        checkAs<MaterialWithMorphTargets>(material);
+        checkAs<MaterialWithWireframe>(material);
+        checkAs<ShaderMaterial>(material);
+    }
+
+}// namespace
+
+TEST_CASE("registered types") {
+
+    std::vector<std::shared_ptr<Material>> materials{
+            MeshBasicMaterial::create(),
+            MeshPhongMaterial::create(),
+            MeshStandardMaterial::create(),
+            MeshDepthMaterial::create(),
+            LineBasicMaterial::create(),
+            PointsMaterial::create(),
+            SpriteMaterial::create(),
+            ShaderMaterial::create(),
+            RawShaderMaterial::create()};
+
+    for (const auto& material : materials) {
+
+        checkRegisteredTypes(*material);
+        checkRegisteredTypes(*material->clone());
+    }
+
+    REQUIRE(materials[2]->as<MaterialWithEnvMap>());
+    REQUIRE(materials[7]->as<ShaderMaterial>());
+    REQUIRE_FALSE(materials[4]->as<MaterialWithWireframe>());
+
+    std::vector<std::shared_ptr<Object3D>> objects{
+            Object3D::create(),
+            Mesh::create(),
+            InstancedMesh::create(nullptr, nullptr, 1),
+            LineSegments::create(),
+            Sprite::create(),
+            Group::create()};
+
+    for (const auto& object : objects) {
+
+        CHECK(object->as<ObjectWithMaterials>() == dynamic_cast<ObjectWithMaterials*>(object.get()));
+
+        const auto clone = object->clone();
+        CHECK(clone->as<ObjectWithMaterials>() == dynamic_cast<ObjectWithMaterials*>(clone.get()));
+    }
+
+    REQUIRE(objects[1]->as<ObjectWithMaterials>());
+    REQUIRE_FALSE(objects[4]->is<ObjectWithMaterials>());
+}
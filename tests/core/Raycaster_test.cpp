@@ -0,0 +1,203 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/core/Raycaster.hpp"
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/geometries/SphereGeometry.hpp"
+#include "threepp/geometries/TorusKnotGeometry.hpp"
+#include "threepp/materials/LineBasicMaterial.hpp"
+#include "threepp/materials/MeshBasicMaterial.hpp"
+#include "threepp/materials/PointsMaterial.hpp"
+#include "threepp/math/MathUtils.hpp"
+#include "threepp/objects/InstancedMesh.hpp"
+#include "threepp/objects/Line.hpp"
+#include "threepp/objects/Points.hpp"
+#include "threepp/scenes/Scene.hpp"
+#include "threepp/scenes/SpatialIndex.hpp"
+
+#include <thread>
+
+using namespace threepp;
+
+namespace {
+
+    // emptyObjects are added before the instanced mesh
+    std::shared_ptr<Scene> createScene(size_t emptyObjects = 0) {
+
+        auto scene = Scene::create();
+
+        for (int i = 0; i < 20; i++) {
+
+            std::shared_ptr<BufferGeometry> geometry;
+            if (i % 2 == 0) {
+                geometry = TorusKnotGeometry::create(1, 0.3f, 64, 8);
+            } else {
+                geometry = SphereGeometry::create(1);
+            }
+            geometry->useBoundsTree = i % 4 == 0;
+
+            auto mesh = Mesh::create(geometry, MeshBasicMaterial::create());
+            mesh->position.set(math::randFloatSpread(20), math::randFloatSpread(20), math::randFloatSpread(10));
+            scene->add(mesh);
+        }
+
+        for (size_t i = 0; i < emptyObjects; i++) scene->add(Object3D::create());
+
+        auto instanced = InstancedMesh::create(BoxGeometry::create(), MeshBasicMaterial::create(), 10);
+        for (int i = 0; i < 10; i++) {
+
+            Matrix4 matrix;
+            matrix.makeTranslation(math::randFloatSpread(20), math::randFloatSpread(20), 0);
+            instanced->setMatrixAt(i, matrix);
+        }
+        scene->add(instanced);
+
+        const auto sphere = SphereGeometry::create(3);
+        const auto& positions = *sphere->getAttribute<float>("position");
+        auto lineGeometry = BufferGeometry::create();
+        lineGeometry->setAttribute("position", positions.clone());
+        scene->add(Line::create(lineGeometry, LineBasicMaterial::create()));
+
+        auto pointsGeometry = BufferGeometry::create();
+        pointsGeometry->setAttribute("position", positions.clone());
+        scene->add(Points::create(pointsGeometry, PointsMaterial::create()));
+
+        scene->updateMatrixWorld();
+
+        return scene;
+    }
+
+    std::vector<Ray> createRays(size_t count) {
+
+        std::vector<Ray> rays(count);
+        for (auto& ray : rays) {
+
+            const Vector3 target{math::randFloatSpread(20), math::randFloatSpread(20), 0};
+            ray.origin.set(math::randFloatSpread(4), math::randFloatSpread(4), 30);
+            ray.direction.copy(target).sub(ray.origin).normalize();
+        }
+
+        return rays;
+    }
+
+    void checkSameIntersections(const std::vector<Intersection>& actual, const std::vector<Intersection>& expected) {
+
+        REQUIRE(actual.size() == expected.size());
+        for (size_t i = 0; i < actual.size(); i++) {
+
+            CHECK(actual[i].distance == expected[i].distance);
+            CHECK(actual[i].object == expected[i].object);
+            CHECK(actual[i].faceIndex == expected[i].faceIndex);
+            CHECK(actual[i].index == expected[i].index);
+            CHECK(actual[i].instanceId == expected[i].instanceId);
+        }
+    }
+
+}// namespace
+
+TEST_CASE("batched intersectObjects") {
+
+    auto scene = createScene();
+    const auto rays = createRays(500);
+
+    Raycaster raycaster;
+    raycaster.params.lineThreshold = 0.1f;
+    raycaster.params.pointsThreshold = 0.1f;
+
+    SECTION("without spatial index") {}
+
+    SECTION("with spatial index") {
+
+        scene->spatialIndex = SpatialIndex::create();
+        scene->spatialIndex->update(*scene);
+    }
+
+    for (const auto firstHitOnly : {false, true}) {
+
+        raycaster.firstHitOnly = firstHitOnly;
+
+        const auto batched = raycaster.intersectObjects(rays, {scene.get()}, true, 4);
+        REQUIRE(batched.size() == rays.size());
+
+        size_t hits = 0;
+        for (size_t i = 0; i < rays.size(); i++) {
+
+            raycaster.ray.copy(rays[i]);
+            checkSameIntersections(batched[i], raycaster.intersectObject(*scene, true));
+            hits += batched[i].size();
+        }
+
+        CHECK(hits > 0);
+    }
+}
+
+TEST_CASE("batched intersectObjects on a single thread") {
+
+    auto scene = createScene();
+    const auto rays = createRays(50);
+
+    Raycaster raycaster;
+
+    const auto batched = raycaster.intersectObjects(rays, {scene.get()}, true, 1);
+
+    for (size_t i = 0; i < rays.size(); i++) {
+
+        raycaster.ray.copy(rays[i]);
+        checkSameIntersections(batched[i], raycaster.intersectObject(*scene, true));
+    }
+
+    CHECK(raycaster.intersectObjects(std::vector<Ray>{}, {scene.get()}, true).empty());
+}
+
+TEST_CASE("separate raycasters on several threads") {
+
+    // the spatial index lists them as uncovered, in a list rebuilt by every update
+    auto scene = createScene(1000);
+    const auto rays = createRays(200);
+
+    SECTION("without spatial index") {}
+
+    SECTION("with spatial index") {
+
+        // updated once, raycasts only read it
+        scene->spatialIndex = SpatialIndex::create();
+        scene->spatialIndex->update(*scene);
+    }
+
+    Raycaster raycaster;
+
+    std::vector<std::vector<Intersection>> expected;
+    for (const auto& ray : rays) {
+
+        raycaster.ray.copy(ray);
+        expected.emplace_back(raycaster.intersectObject(*scene, true));
+    }
+
+    std::vector<std::vector<std::vector<Intersection>>> results(4);
+    std::vector<std::thread> threads;
+    for (auto& result : results) {
+
+        threads.emplace_back([&] {
+            Raycaster raycaster;
+            for (int pass = 0; pass < 5; pass++) {
+
+                for (const auto& ray : rays) {
+
+                    raycaster.ray.copy(ray);
+                    result.emplace_back(raycaster.intersectObject(*scene, true));
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+    for (const auto& result : results) {
+
+        REQUIRE(result.size() == 5 * rays.size());
+        for (size_t i = 0; i < result.size(); i++) {
+
+            checkSameIntersections(result[i], expected[i % rays.size()]);
+        }
+    }
+}
@@ -0,0 +1,195 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/core/Raycaster.hpp"
+#include "threepp/core/TriangleBVH.hpp"
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/geometries/TorusKnotGeometry.hpp"
+#include "threepp/materials/MeshBasicMaterial.hpp"
+#include "threepp/math/MathUtils.hpp"
+#include "threepp/objects/Mesh.hpp"
+#include "threepp/utils/BufferGeometryUtils.hpp"
+
+#include <algorithm>
+
+using namespace threepp;
+
+namespace {
+
+    std::vector<Intersection> raycast(Mesh& mesh, Raycaster& raycaster, bool useBoundsTree) {
+
+        mesh.geometry()->useBoundsTree = useBoundsTree;
+
+        auto intersects = raycaster.intersectObject(mesh);
+
+        // hits on shared edges have equal distances, but are found in a different order
+        std::stable_sort(intersects.begin(), intersects.end(), [](const auto& a, const auto& b) {
+            return a.distance < b.distance || (a.distance == b.distance && a.faceIndex < b.faceIndex);
+        });
+
+        return intersects;
+    }
+
+    void checkSameIntersections(Mesh& mesh, Raycaster& raycaster) {
+
+        const auto expected = raycast(mesh, raycaster, false);
+        const auto actual = raycast(mesh, raycaster, true);
+
+        REQUIRE(actual.size() == expected.size());
+        for (size_t i = 0; i < actual.size(); i++) {
+
+            CHECK(actual[i].distance == expected[i].distance);
+            CHECK(actual[i].faceIndex == expected[i].faceIndex);
+            CHECK(actual[i].face->materialIndex == expected[i].face->materialIndex);
+        }
+    }
+
+    void randomRay(Raycaster& raycaster) {
+
+        const Vector3 origin{math::randFloatSpread(20), math::randFloatSpread(20), 30};
+        const Vector3 target{math::randFloatSpread(4), math::randFloatSpread(4), 0};
+
+        raycaster.set(origin, Vector3(target).sub(origin).normalize());
+    }
+
+}// namespace
+
+TEST_CASE("build") {
+
+    auto geometry = TorusKnotGeometry::create(10, 3, 200, 16);
+    const auto& position = *geometry->getAttribute<float>("position");
+
+    TriangleBVH bvh(position, geometry->getIndex());
+
+    CHECK(bvh.triangleCount() == geometry->getIndex()->count() / 3);
+    CHECK(bvh.nodeCount() > 1);
+    CHECK(bvh.upToDate(position, geometry->getIndex()));
+
+    geometry->computeBoundingBox();
+    CHECK(bvh.boundingBox().min().equals(geometry->boundingBox->min()));
+    CHECK(bvh.boundingBox().max().equals(geometry->boundingBox->max()));
+
+    // every triangle is reachable exactly once
+    const Ray ray({0, 0, 100}, {0, 0, -1});
+    std::vector<int> visited(bvh.triangleCount());
+    bvh.raycast(ray, std::numeric_limits<float>::infinity(), [&](int triangle) {
+        visited[triangle]++;
+        return std::numeric_limits<float>::infinity();
+    });
+    CHECK(std::all_of(visited.begin(), visited.end(), [](int count) { return count <= 1; }));
+
+    geometry->getAttribute("position")->needsUpdate();
+    CHECK_FALSE(bvh.upToDate(position, geometry->getIndex()));
+
+    // lazily rebuilt by the geometry
+    const auto tree = geometry->boundsTree();
+    REQUIRE(tree);
+    CHECK(tree->upToDate(position, geometry->getIndex()));
+    CHECK(geometry->boundsTree() == tree);
+}
+
+TEST_CASE("interleaved position") {
+
+    auto geometry = BoxGeometry::create();
+    const auto buffer = interleave(*geometry);
+    REQUIRE(buffer);
+
+    const auto tree = geometry->boundsTree();
+    REQUIRE(tree);
+    const auto& position = *geometry->getAttribute<float>("position");
+    CHECK(tree->upToDate(position, geometry->getIndex()));
+
+    // the flag goes to the buffer shared by the attributes, not the position
+    const auto version = position.version;
+    geometry->getAttribute("position")->needsUpdate();
+    CHECK(position.version == version);
+    CHECK_FALSE(tree->upToDate(position, geometry->getIndex()));
+
+    // a change to another attribute of the buffer rebuilds it too, as nothing tells them apart
+    const auto rebuilt = geometry->boundsTree();
+    CHECK(rebuilt->upToDate(position, geometry->getIndex()));
+    geometry->getAttribute("normal")->needsUpdate();
+    CHECK_FALSE(rebuilt->upToDate(position, geometry->getIndex()));
+}
+
+TEST_CASE("raycast matches brute force") {
+
+    auto mesh = Mesh::create(TorusKnotGeometry::create(10, 3, 200, 16), MeshBasicMaterial::create());
+    mesh->position.set(1, -2, 3);
+    mesh->rotation.set(0.4f, 1.1f, -0.3f);
+    mesh->scale.set(1.5f, 0.8f, 1.2f);
+    mesh->updateMatrixWorld();
+
+    Raycaster raycaster;
+
+    SECTION("indexed") {
+
+        for (int i = 0; i < 50; i++) {
+
+            randomRay(raycaster);
+            checkSameIntersections(*mesh, raycaster);
+        }
+    }
+
+    SECTION("non-indexed") {
+
+        mesh->setGeometry(mesh->geometry()->toNonIndexed());
+
+        for (int i = 0; i < 50; i++) {
+
+            randomRay(raycaster);
+            checkSameIntersections(*mesh, raycaster);
+        }
+    }
+
+    SECTION("far") {
+
+        raycaster.far = 28;
+
+        for (int i = 0; i < 50; i++) {
+
+            randomRay(raycaster);
+            checkSameIntersections(*mesh, raycaster);
+        }
+    }
+
+    SECTION("groups") {
+
+        auto box = Mesh::create(BoxGeometry::create(4, 4, 4, 8, 8, 8), std::vector<std::shared_ptr<Material>>{
+                MeshBasicMaterial::create(), MeshBasicMaterial::create(), MeshBasicMaterial::create(),
+                MeshBasicMaterial::create(), MeshBasicMaterial::create(), MeshBasicMaterial::create()});
+        box->geometry()->setDrawRange(0, 1000);
+        box->updateMatrixWorld();
+
+        for (int i = 0; i < 50; i++) {
+
+            randomRay(raycaster);
+            checkSameIntersections(*box, raycaster);
+        }
+    }
+}
+
+TEST_CASE("firstHitOnly") {
+
+    auto material = MeshBasicMaterial::create();
+    material->side = Side::Double;
+
+    auto mesh = Mesh::create(TorusKnotGeometry::create(10, 3, 200, 16), material);
+    mesh->updateMatrixWorld();
+
+    Raycaster raycaster({0, 10, 30}, {0, 0, -1});
+
+    const auto all = raycast(*mesh, raycaster, false);
+    REQUIRE(all.size() > 1);
+
+    raycaster.firstHitOnly = true;
+
+    for (const auto useBoundsTree : {false, true}) {
+
+        const auto first = raycast(*mesh, raycaster, useBoundsTree);
+
+        REQUIRE(first.size() == 1);
+        CHECK(first.front().distance == all.front().distance);
+        CHECK(first.front().faceIndex == all.front().faceIndex);
+    }
+}
@@ -0,0 +1,57 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/extras/DataUtils.hpp"
+
+#include <cmath>
+#include <limits>
+
+using namespace threepp;
+
+TEST_CASE("toHalfFloat") {
+
+    CHECK(datautils::toHalfFloat(0.f) == 0x0000);
+    CHECK(datautils::toHalfFloat(-0.f) == 0x8000);
+    CHECK(datautils::toHalfFloat(1.f) == 0x3c00);
+    CHECK(datautils::toHalfFloat(-2.f) == 0xc000);
+    CHECK(datautils::toHalfFloat(0.5f) == 0x3800);
+    CHECK(datautils::toHalfFloat(65504.f) == 0x7bff);
+    CHECK(datautils::toHalfFloat(100000.f) == 0x7c00);
+    CHECK(datautils::toHalfFloat(std::numeric_limits<float>::infinity()) == 0x7c00);
+    CHECK((datautils::toHalfFloat(std::numeric_limits<float>::quiet_NaN()) & 0x7c00) == 0x7c00);
+
+    // smallest subnormal, and a value that underflows to zero
+    CHECK(datautils::toHalfFloat(std::ldexp(1.f, -24)) == 0x0001);
+    CHECK(datautils::toHalfFloat(std::ldexp(1.f, -26)) == 0x0000);
+
+    // round to nearest even
+    CHECK(datautils::toHalfFloat(1.f + std::ldexp(1.f, -11)) == 0x3c00);
+    CHECK(datautils::toHalfFloat(1.f + 3 * std::ldexp(1.f, -11)) == 0x3c02);
+}
+
+TEST_CASE("fromHalfFloat") {
+
+    CHECK(datautils::fromHalfFloat(0x3c00) == 1.f);
+    CHECK(datautils::fromHalfFloat(0xc000) == -2.f);
+    CHECK(datautils::fromHalfFloat(0x7bff) == 65504.f);
+    CHECK(datautils::fromHalfFloat(0x0001) == std::ldexp(1.f, -24));
+    CHECK(std::isinf(datautils::fromHalfFloat(0x7c00)));
+    CHECK(std::isnan(datautils::fromHalfFloat(0x7e00)));
+
+    // every finite half survives a round trip
+    int mismatches = 0;
+    for (unsigned i = 0; i < 0x10000; i++) {
+
+        const auto bits = static_cast<uint16_t>(i);
+        if ((bits & 0x7c00) == 0x7c00) continue;
+
+        if (datautils::toHalfFloat(datautils::fromHalfFloat(bits)) != bits) ++mismatches;
+    }
+    CHECK(mismatches == 0);
+}
+
+TEST_CASE("Half") {
+
+    Half h = 0.25f;
+    CHECK(h.bits == 0x3400);
+    CHECK(static_cast<float>(h) == 0.25f);
+}
@@ -0,0 +1,165 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/cameras/PerspectiveCamera.hpp"
+#include "threepp/lights/DirectionalLight.hpp"
+#include "threepp/lights/DirectionalLightShadow.hpp"
+
+#include "../equals_util.hpp"
+
+#include <array>
+#include <cmath>
+
+using namespace threepp;
+
+namespace {
+
+    struct Fixture {
+
+        std::shared_ptr<DirectionalLight> light = DirectionalLight::create();
+        std::shared_ptr<DirectionalLightShadow> shadow = std::dynamic_pointer_cast<DirectionalLightShadow>(light->shadow);
+        PerspectiveCamera camera{60, 1.5f, 0.5f, 200};
+
+        Fixture() {
+
+            light->position.set(30, 50, 20);
+            light->updateMatrixWorld();
+
+            camera.position.set(5, 3, 10);
+            camera.lookAt(0, 0, -40);
+            camera.updateMatrixWorld();
+        }
+    };
+
+    // corners of the view frustum between the view distances start and end
+    std::array<Vector3, 8> sliceCorners(const PerspectiveCamera& camera, float start, float end) {
+
+        std::array<Vector3, 8> corners;
+        for (size_t i = 0; i < 4; i++) {
+
+            const auto x = (i & 1) ? 1.f : -1.f;
+            const auto y = (i & 2) ? 1.f : -1.f;
+
+            const auto nearCorner = Vector3(x, y, -1).unproject(camera);
+            const auto farCorner = Vector3(x, y, 1).unproject(camera);
+
+            corners[i].lerpVectors(nearCorner, farCorner, (start - camera.near) / (camera.far - camera.near));
+            corners[i + 4].lerpVectors(nearCorner, farCorner, (end - camera.near) / (camera.far - camera.near));
+        }
+
+        return corners;
+    }
+
+    // shadow coordinates of point in cascade index
+    Vector3 cascadeCoord(const DirectionalLightShadow& shadow, size_t index, const Vector3& point) {
+
+        Matrix4 matrix;
+        matrix.multiplyMatrices(shadow.cascadeMatrices()[index], shadow.matrix);
+
+        return Vector3(point).applyMatrix4(matrix);
+    }
+
+}// namespace
+
+TEST_CASE("setCascades") {
+
+    Fixture f;
+
+    CHECK(f.shadow->cascades() == 1);
+    CHECK(f.shadow->getViewportCount() == 1);
+
+    f.shadow->setCascades(4);
+    CHECK(f.shadow->cascades() == 4);
+    CHECK(f.shadow->getFrameExtents() == Vector2(2, 2));
+    REQUIRE(f.shadow->getViewportCount() == 4);
+    CHECK(f.shadow->getViewport(3) == Vector4(1.f, 1.f, 1.f, 1.f));
+
+    f.shadow->setCascades(3);
+    CHECK(f.shadow->getFrameExtents() == Vector2(2, 2));
+    REQUIRE(f.shadow->getViewportCount() == 3);
+    CHECK(f.shadow->getViewport(2) == Vector4(0.f, 1.f, 1.f, 1.f));
+
+    f.shadow->setCascades(0);
+    CHECK(f.shadow->cascades() == 1);
+    CHECK(f.shadow->getFrameExtents() == Vector2(1, 1));
+}
+
+TEST_CASE("cascade splits") {
+
+    Fixture f;
+    f.shadow->setCascades(4);
+
+    f.shadow->cascadeSplitLambda = 0;
+    f.shadow->updateCascades(*f.light, f.camera);
+
+    const auto& ends = f.shadow->cascadeEnds();
+    REQUIRE(ends.size() == 4);
+    CHECK(std::abs(ends[0] - (0.5f + 199.5f / 4)) < 1e-3f);
+    CHECK(ends[3] == 200);
+
+    f.shadow->cascadeSplitLambda = 1;
+    f.shadow->updateCascades(*f.light, f.camera);
+
+    // logarithmic, every cascade covers the same ratio of distances
+    CHECK(std::abs(ends[1] / ends[0] - ends[0] / 0.5f) < 1e-2f);
+    CHECK(std::abs(ends[2] / ends[1] - ends[0] / 0.5f) < 1e-2f);
+
+    f.shadow->cascadeSplits = {5, 20, 60};
+    f.shadow->cascadeFar = 100;
+    f.shadow->updateCascades(*f.light, f.camera);
+
+    CHECK(ends == std::vector<float>{5, 20, 60, 100});
+}
+
+TEST_CASE("cascades cover their slice of the view") {
+
+    Fixture f;
+    f.shadow->setCascades(4);
+    f.shadow->updateCascades(*f.light, f.camera);
+
+    CHECK(matrixEquals4(f.shadow->cascadeMatrices()[0], Matrix4(), 1e-4f));
+
+    const auto& ends = f.shadow->cascadeEnds();
+    for (size_t i = 0; i < 4; i++) {
+
+        f.shadow->updateCascade(i);
+
+        const auto start = i == 0 ? f.camera.near : ends[i - 1];
+        for (const auto& corner : sliceCorners(f.camera, start, ends[i])) {
+
+            CHECK(f.shadow->getFrustum().containsPoint(corner));
+
+            const auto coord = cascadeCoord(*f.shadow, i, corner);
+            CHECK(coord.x >= 0);
+            CHECK(coord.x <= 1);
+            CHECK(coord.y >= 0);
+            CHECK(coord.y <= 1);
+            CHECK(coord.z >= 0);
+            CHECK(coord.z <= 1);
+        }
+    }
+}
+
+TEST_CASE("cascades move by whole texels") {
+
+    Fixture f;
+    f.shadow->setCascades(2);
+    f.shadow->updateCascades(*f.light, f.camera);
+
+    const Vector3 point(1, 2, -15);
+    const auto before = cascadeCoord(*f.shadow, 1, point);
+
+    f.camera.position.add(Vector3(2.123f, 0.456f, -1.2f));
+    f.camera.updateMatrixWorld();
+    f.shadow->updateCascades(*f.light, f.camera);
+
+    const auto after = cascadeCoord(*f.shadow, 1, point);
+
+    // the point moves over the map, but stays at the same place within its texel
+    const auto dx = (after.x - before.x) * f.shadow->mapSize.x;
+    const auto dy = (after.y - before.y) * f.shadow->mapSize.y;
+
+    CHECK(std::abs(dx - std::round(dx)) < 1e-2f);
+    CHECK(std::abs(dy - std::round(dy)) < 1e-2f);
+    CHECK(std::abs(dx) + std::abs(dy) > 0.5f);
+}
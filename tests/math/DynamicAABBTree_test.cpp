@@ -0,0 +1,200 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/cameras/PerspectiveCamera.hpp"
+#include "threepp/math/DynamicAABBTree.hpp"
+#include "threepp/math/MathUtils.hpp"
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+using namespace threepp;
+
+namespace {
+
+    Box3 randomBox(float extent) {
+
+        const Vector3 center{math::randFloat(-extent, extent), math::randFloat(-extent, extent), math::randFloat(-extent, extent)};
+        const Vector3 size{math::randFloat(0.1f, 2), math::randFloat(0.1f, 2), math::randFloat(0.1f, 2)};
+
+        Box3 box;
+        box.setFromCenterAndSize(center, size);
+
+        return box;
+    }
+
+    template<class Query>
+    std::set<int> collect(const Query& query) {
+
+        std::set<int> result;
+        query([&](int proxy, auto...) { result.insert(proxy); });
+
+        return result;
+    }
+
+}// namespace
+
+TEST_CASE("insert, move and remove") {
+
+    DynamicAABBTree tree;
+    std::map<int, Box3> boxes;
+
+    for (int i = 0; i < 500; i++) {
+
+        const auto box = randomBox(50);
+        boxes[tree.insert(box)] = box;
+    }
+
+    tree.validate();
+    CHECK(tree.size() == 500);
+    // a balanced tree of 500 leaves
+    CHECK(tree.height() < 20);
+
+    for (int i = 0; i < 1000; i++) {
+
+        auto it = std::next(boxes.begin(), math::randInt(0, static_cast<int>(boxes.size()) - 1));
+        it->second = randomBox(50);
+        tree.move(it->first, it->second);
+    }
+
+    tree.validate();
+
+    for (const auto& [proxy, box] : boxes) {
+
+        CHECK(tree.fatBox(proxy).containsBox(box));
+    }
+
+    for (int i = 0; i < 250; i++) {
+
+        auto it = std::next(boxes.begin(), math::randInt(0, static_cast<int>(boxes.size()) - 1));
+        tree.remove(it->first);
+        boxes.erase(it);
+    }
+
+    tree.validate();
+    CHECK(tree.size() == 250);
+
+    // freed nodes are reused
+    for (int i = 0; i < 250; i++) {
+
+        const auto box = randomBox(50);
+        boxes[tree.insert(box)] = box;
+    }
+
+    tree.validate();
+    CHECK(tree.size() == 500);
+
+    CHECK_THROWS(tree.remove(-1));
+
+    tree.clear();
+    tree.validate();
+    CHECK(tree.empty());
+}
+
+TEST_CASE("small moves keep the fat box") {
+
+    DynamicAABBTree tree(0.1f);
+
+    Box3 box({0, 0, 0}, {1, 1, 1});
+    const auto proxy = tree.insert(box);
+
+    box.translate({0.05f, 0, 0});
+    CHECK_FALSE(tree.move(proxy, box));
+
+    box.translate({1, 0, 0});
+    CHECK(tree.move(proxy, box));
+    CHECK(tree.fatBox(proxy).containsBox(box));
+}
+
+TEST_CASE("queries match brute force") {
+
+    DynamicAABBTree tree;
+    std::map<int, Box3> boxes;
+
+    for (int i = 0; i < 1000; i++) {
+
+        const auto box = randomBox(100);
+        boxes[tree.insert(box)] = box;
+    }
+
+    SECTION("box") {
+
+        const Box3 query({-20, -10, -30}, {30, 10, 5});
+
+        const auto result = collect([&](auto callback) { tree.query(query, callback); });
+
+        for (const auto& [proxy, box] : boxes) {
+
+            CHECK(result.count(proxy) == (tree.fatBox(proxy).intersectsBox(query) ? 1 : 0));
+        }
+    }
+
+    SECTION("frustum") {
+
+        PerspectiveCamera camera(60, 1, 1, 80);
+        camera.position.set(10, 5, 20);
+        camera.lookAt({0, 0, 0});
+        camera.updateMatrixWorld();
+
+        Matrix4 projScreenMatrix;
+        projScreenMatrix.multiplyMatrices(camera.projectionMatrix, camera.matrixWorldInverse);
+
+        Frustum frustum;
+        frustum.setFromProjectionMatrix(projScreenMatrix);
+
+        std::map<int, bool> result;
+        tree.query(frustum, [&](int proxy, bool inside) { result[proxy] = inside; });
+
+        CHECK(!result.empty());
+        CHECK(result.size() < boxes.size());
+
+        for (const auto& [proxy, box] : boxes) {
+
+            const auto& fatBox = tree.fatBox(proxy);
+            CHECK(result.count(proxy) == (frustum.intersectsBox(fatBox) ? 1 : 0));
+
+            if (result.count(proxy) && result[proxy]) {
+
+                CHECK(frustum.containsPoint(fatBox.min()));
+                CHECK(frustum.containsPoint(fatBox.max()));
+            }
+        }
+    }
+
+    SECTION("ray") {
+
+        // boxes along the ray
+        for (int i = 0; i < 50; i++) {
+
+            Box3 box;
+            box.setFromCenterAndSize({-100.f + static_cast<float>(i) * 4, 3, 2}, {1, 1, 1});
+            boxes[tree.insert(box)] = box;
+        }
+
+        const Ray ray({-150, 3, 2}, Vector3(1, 0, 0));
+
+        const auto result = collect([&](auto callback) { tree.raycast(ray, 0, 1000, 0, callback); });
+
+        for (const auto& [proxy, box] : boxes) {
+
+            CHECK(result.count(proxy) == (ray.intersectsBox(tree.fatBox(proxy)) ? 1 : 0));
+        }
+
+        // near and far limit the hits
+        const auto limited = collect([&](auto callback) { tree.raycast(ray, 100, 200, 0, callback); });
+        CHECK(limited.size() < result.size());
+
+        for (auto proxy : limited) {
+
+            Vector3 point;
+            ray.intersectBox(tree.fatBox(proxy), point);
+            CHECK(result.count(proxy) == 1);
+            CHECK(ray.origin.distanceTo(point) <= 200);
+        }
+
+        // the threshold enlarges every box
+        const auto enlarged = collect([&](auto callback) { tree.raycast(ray, 0, 1000, 5, callback); });
+        CHECK(enlarged.size() > result.size());
+    }
+}
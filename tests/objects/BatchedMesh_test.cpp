@@ -0,0 +1,215 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/core/Raycaster.hpp"
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/geometries/PlaneGeometry.hpp"
+#include "threepp/geometries/SphereGeometry.hpp"
+#include "threepp/materials/MeshBasicMaterial.hpp"
+#include "threepp/math/Frustum.hpp"
+#include "threepp/objects/BatchedMesh.hpp"
+
+#include <stdexcept>
+
+using namespace threepp;
+
+TEST_CASE("addGeometry") {
+
+    auto box = BoxGeometry::create();
+    auto sphere = SphereGeometry::create();
+
+    const auto boxVertices = box->getAttribute<float>("position")->count();
+    const auto sphereVertices = sphere->getAttribute<float>("position")->count();
+    const auto boxIndices = box->getIndex()->count();
+    const auto sphereIndices = sphere->getIndex()->count();
+
+    BatchedMesh mesh(2, boxVertices + sphereVertices, boxIndices + sphereIndices, MeshBasicMaterial::create());
+
+    REQUIRE(mesh.addGeometry(*box) == 0);
+    REQUIRE(mesh.addGeometry(*sphere) == 1);
+    REQUIRE(mesh.geometryCount() == 2);
+
+    const auto geometry = mesh.geometry();
+    REQUIRE(geometry->hasAttribute("batchId"));
+
+    const auto& batchIds = geometry->getAttribute<float>("batchId")->array();
+    CHECK(batchIds[0] == 0);
+    CHECK(batchIds[boxVertices - 1] == 0);
+    CHECK(batchIds[boxVertices] == 1);
+    CHECK(batchIds[boxVertices + sphereVertices - 1] == 1);
+
+    // indices of the second geometry are offset by the vertices of the first
+    const auto& index = geometry->getIndex()->array();
+    CHECK(index[boxIndices] == sphere->getIndex()->array()[0] + boxVertices);
+
+    CHECK_THROWS_AS(mesh.addGeometry(*box), std::runtime_error);
+}
+
+TEST_CASE("reserved space") {
+
+    auto box = BoxGeometry::create();
+
+    BatchedMesh mesh(4, 10, 10, MeshBasicMaterial::create());
+
+    CHECK_THROWS_AS(mesh.addGeometry(*box), std::runtime_error);
+}
+
+TEST_CASE("mismatching geometry") {
+
+    auto box = BoxGeometry::create();
+    auto plane = PlaneGeometry::create();
+    plane->deleteAttribute("uv");
+
+    BatchedMesh mesh(4, 1000, 1000, MeshBasicMaterial::create());
+    mesh.addGeometry(*box);
+
+    CHECK_THROWS_AS(mesh.addGeometry(*plane), std::runtime_error);
+    CHECK(mesh.geometryCount() == 1);
+}
+
+TEST_CASE("rejected geometry leaves the mesh unchanged") {
+
+    auto box = BoxGeometry::create();
+    const auto boxVertices = box->getAttribute<float>("position")->count();
+    const auto boxIndices = box->getIndex()->count();
+
+    // room for one box only
+    BatchedMesh mesh(4, boxVertices + 1, boxIndices + 1, MeshBasicMaterial::create());
+    mesh.addGeometry(*box);
+
+    const auto positions = mesh.geometry()->getAttribute<float>("position")->array();
+    const auto batchIds = mesh.geometry()->getAttribute<float>("batchId")->array();
+    const auto index = mesh.geometry()->getIndex()->array();
+
+    CHECK_THROWS_AS(mesh.addGeometry(*box), std::runtime_error);
+
+    CHECK(mesh.geometryCount() == 1);
+    CHECK(mesh.geometry()->getAttribute<float>("position")->array() == positions);
+    CHECK(mesh.geometry()->getAttribute<float>("batchId")->array() == batchIds);
+    CHECK(mesh.geometry()->getIndex()->array() == index);
+
+    // a first geometry that does not fit does not set up the shared buffers either
+    BatchedMesh empty(4, 10, 10, MeshBasicMaterial::create());
+    CHECK_THROWS_AS(empty.addGeometry(*box), std::runtime_error);
+    CHECK(empty.geometry()->getAttributes().empty());
+}
+
+TEST_CASE("frustum culling") {
+
+    auto box = BoxGeometry::create();
+
+    BatchedMesh mesh(2, 100, 200, MeshBasicMaterial::create());
+    const auto a = mesh.addGeometry(*box);
+    const auto b = mesh.addGeometry(*box);
+    mesh.setMatrixAt(a, Matrix4().makeTranslation(10, 0, 0));
+    mesh.setMatrixAt(b, Matrix4().makeTranslation(20, 0, 0));
+    mesh.updateMatrixWorld();
+
+    CHECK(mesh.frustumCulled);
+
+    mesh.computeBoundingSphere();
+    CHECK(mesh.boundingSphere->containsPoint({10.5f, 0.5f, 0.5f}));
+    CHECK(mesh.boundingSphere->containsPoint({20.5f, 0.5f, 0.5f}));
+    CHECK_FALSE(mesh.boundingSphere->containsPoint({0, 0, 0}));
+
+    // a box around the origin sees neither geometry
+    Frustum frustum;
+    frustum.setFromProjectionMatrix(Matrix4().makeOrthographic(-2, 2, 2, -2, -2, 2));
+    CHECK_FALSE(frustum.intersectsObject(mesh));
+
+    // moving one in resets the bounds
+    mesh.setMatrixAt(b, Matrix4());
+    CHECK_FALSE(mesh.boundingSphere);
+    CHECK(frustum.intersectsObject(mesh));
+
+    // hidden geometries do not count
+    mesh.setVisibleAt(b, false);
+    CHECK_FALSE(frustum.intersectsObject(mesh));
+}
+
+TEST_CASE("draw ranges") {
+
+    auto box = BoxGeometry::create();
+    const auto indexCount = box->getIndex()->count();
+
+    BatchedMesh mesh(3, 100, 200, MeshBasicMaterial::create());
+    const auto a = mesh.addGeometry(*box);
+    const auto b = mesh.addGeometry(*box);
+    const auto c = mesh.addGeometry(*box);
+
+    std::vector<int> starts, counts;
+    mesh.getDrawRanges(starts, counts);
+    CHECK(starts == std::vector<int>{0, indexCount, 2 * indexCount});
+    CHECK(counts == std::vector<int>{indexCount, indexCount, indexCount});
+
+    mesh.setVisibleAt(b, false);
+    CHECK_FALSE(mesh.getVisibleAt(b));
+    mesh.getDrawRanges(starts, counts);
+    CHECK(starts == std::vector<int>{0, 2 * indexCount});
+
+    mesh.deleteGeometry(a);
+    mesh.getDrawRanges(starts, counts);
+    CHECK(starts == std::vector<int>{2 * indexCount});
+    CHECK(counts == std::vector<int>{indexCount});
+
+    CHECK(mesh.getVisibleAt(c));
+    CHECK_THROWS(mesh.getVisibleAt(3));
+}
+
+TEST_CASE("non-indexed draw ranges") {
+
+    auto box = BoxGeometry::create()->toNonIndexed();
+    const auto vertexCount = box->getAttribute<float>("position")->count();
+
+    BatchedMesh mesh(2, 2 * vertexCount, 0, MeshBasicMaterial::create());
+    mesh.addGeometry(*box);
+    mesh.addGeometry(*box);
+
+    REQUIRE_FALSE(mesh.geometry()->hasIndex());
+
+    std::vector<int> starts, counts;
+    mesh.getDrawRanges(starts, counts);
+    CHECK(starts == std::vector<int>{0, vertexCount});
+    CHECK(counts == std::vector<int>{vertexCount, vertexCount});
+}
+
+TEST_CASE("matrices") {
+
+    BatchedMesh mesh(2, 100, 100, MeshBasicMaterial::create());
+    const auto id = mesh.addGeometry(*BoxGeometry::create());
+
+    Matrix4 m;
+    mesh.getMatrixAt(id, m);
+    CHECK(m.equals(Matrix4()));
+
+    const auto version = mesh.matricesTexture()->version();
+
+    mesh.setMatrixAt(id, Matrix4().makeTranslation(1, 2, 3));
+    mesh.getMatrixAt(id, m);
+    CHECK(m.equals(Matrix4().makeTranslation(1, 2, 3)));
+    CHECK(mesh.matricesTexture()->version() > version);
+
+    CHECK_THROWS(mesh.setMatrixAt(1, m));
+}
+
+TEST_CASE("raycast") {
+
+    auto box = BoxGeometry::create();
+
+    BatchedMesh mesh(2, 100, 100, MeshBasicMaterial::create());
+    mesh.addGeometry(*box);
+    const auto id = mesh.addGeometry(*box);
+    mesh.setMatrixAt(0, Matrix4().makeTranslation(-5, 0, 0));
+    mesh.setMatrixAt(id, Matrix4().makeTranslation(5, 0, 0));
+    mesh.updateMatrixWorld();
+
+    Raycaster raycaster({5, 0, 10}, {0, 0, -1});
+    auto intersects = raycaster.intersectObject(mesh);
+
+    REQUIRE(!intersects.empty());
+    CHECK(intersects.front().instanceId == static_cast<int>(id));
+    CHECK(intersects.front().object == &mesh);
+    CHECK(intersects.front().point.z == 0.5f);
+
+    mesh.setVisibleAt(id, false);
+    CHECK(raycaster.intersectObject(mesh).empty());
+}
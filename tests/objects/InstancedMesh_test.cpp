@@ -0,0 +1,329 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/cameras/PerspectiveCamera.hpp"
+#include "threepp/core/Raycaster.hpp"
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/materials/MeshBasicMaterial.hpp"
+#include "threepp/math/MathUtils.hpp"
+#include "threepp/objects/InstancedMesh.hpp"
+
+#include <algorithm>
+
+using namespace threepp;
+
+namespace {
+
+    std::shared_ptr<InstancedMesh> createGrid(size_t count) {
+
+        auto mesh = InstancedMesh::create(BoxGeometry::create(), MeshBasicMaterial::create(), count);
+
+        Matrix4 matrix;
+        for (size_t i = 0; i < count; i++) {
+
+            matrix.makeTranslation(math::randFloatSpread(200), math::randFloatSpread(200), math::randFloatSpread(200));
+            mesh->setMatrixAt(i, matrix);
+            mesh->setColorAt(i, Color(static_cast<float>(i), 0, 0));
+        }
+
+        return mesh;
+    }
+
+    Frustum cameraFrustum() {
+
+        PerspectiveCamera camera(60, 1, 0.1f, 100);
+        camera.position.set(10, 5, 20);
+        camera.lookAt(0, 0, 0);
+        camera.updateMatrixWorld();
+
+        Matrix4 projScreenMatrix;
+        projScreenMatrix.multiplyMatrices(camera.projectionMatrix, camera.matrixWorldInverse);
+
+        Frustum frustum;
+        frustum.setFromProjectionMatrix(projScreenMatrix);
+
+        return frustum;
+    }
+
+    // indices of the instances whose world bounding sphere intersects the frustum
+    std::vector<size_t> expectedVisible(InstancedMesh& mesh, const Frustum& frustum) {
+
+        const auto& source = *mesh.geometry()->boundingSphere;
+
+        std::vector<size_t> visible;
+        Matrix4 matrix;
+        for (size_t i = 0; i < mesh.count(); i++) {
+
+            mesh.getMatrixAt(i, matrix);
+
+            Sphere sphere(source);
+            sphere.applyMatrix4(matrix).applyMatrix4(*mesh.matrixWorld);
+
+            if (frustum.intersectsSphere(sphere)) visible.emplace_back(i);
+        }
+
+        return visible;
+    }
+
+    void checkCompacted(InstancedMesh& mesh, const std::vector<size_t>& visible) {
+
+        REQUIRE(mesh.visibleCount() == visible.size());
+        REQUIRE(mesh.visibleInstanceMatrix()->array().size() == visible.size() * 16);
+        REQUIRE(mesh.visibleInstanceColor()->array().size() == visible.size() * 3);
+
+        Matrix4 expected, actual;
+        Color expectedColor, actualColor;
+        for (size_t i = 0; i < visible.size(); i++) {
+
+            mesh.getMatrixAt(visible[i], expected);
+            actual.fromArray(mesh.visibleInstanceMatrix()->array(), i * 16);
+            CHECK(actual == expected);
+
+            mesh.getColorAt(visible[i], expectedColor);
+            actualColor.fromArray(mesh.visibleInstanceColor()->array(), i * 3);
+            CHECK(actualColor == expectedColor);
+        }
+    }
+
+}// namespace
+
+TEST_CASE("cullInstances") {
+
+    const auto frustum = cameraFrustum();
+
+    for (const size_t count : {1000, 20000}) {
+
+        auto mesh = createGrid(count);
+        mesh->rotation.y = 0.3f;
+        mesh->position.set(2, 0, -3);
+        mesh->scale.setScalar(1.5f);
+        mesh->updateMatrixWorld();
+
+        const auto numVisible = mesh->cullInstances(frustum, 4);
+        const auto visible = expectedVisible(*mesh, frustum);
+
+        CHECK(numVisible == visible.size());
+        CHECK(numVisible > 0);
+        CHECK(numVisible < count);
+        checkCompacted(*mesh, visible);
+    }
+}
+
+TEST_CASE("cullInstances caches the last result") {
+
+    const auto frustum = cameraFrustum();
+
+    auto mesh = createGrid(1000);
+    mesh->updateMatrixWorld();
+
+    const auto numVisible = mesh->cullInstances(frustum);
+    const auto version = mesh->visibleInstanceMatrix()->version;
+
+    CHECK(mesh->cullInstances(frustum) == numVisible);
+    CHECK(mesh->visibleInstanceMatrix()->version == version);
+
+    // moving an instance into view is picked up once the matrix is flagged for upload
+    const auto visible = expectedVisible(*mesh, frustum);
+    size_t hidden = 0;
+    while (std::find(visible.begin(), visible.end(), hidden) != visible.end()) hidden++;
+
+    Matrix4 matrix;
+    mesh->setMatrixAt(hidden, matrix.makeTranslation(0, 0, 0));
+    mesh->instanceMatrix()->needsUpdate();
+
+    CHECK(mesh->cullInstances(frustum) == numVisible + 1);
+    CHECK(mesh->visibleInstanceMatrix()->version != version);
+    checkCompacted(*mesh, expectedVisible(*mesh, frustum));
+
+    // so is moving the whole mesh
+    mesh->position.set(1000, 0, 0);
+    mesh->updateMatrixWorld();
+
+    CHECK(mesh->cullInstances(frustum) == 0);
+
+    mesh->setCount(0);
+    CHECK(mesh->cullInstances(frustum) == 0);
+}
+
+TEST_CASE("cullInstances keeps a result per view") {
+
+    const auto frustum = cameraFrustum();
+
+    Frustum other(frustum);
+    Matrix4 matrix;
+    other.setFromProjectionMatrix(matrix.makeOrthographic(-50, 50, 50, -50, 0, 100));
+
+    PerspectiveCamera camera;
+    PerspectiveCamera shadowCamera;
+
+    auto mesh = createGrid(1000);
+    mesh->updateMatrixWorld();
+
+    const auto numVisible = mesh->cullInstances(frustum, camera);
+    const auto matrices = mesh->visibleInstanceMatrix();
+    const auto version = matrices->version;
+
+    const auto numVisibleOther = mesh->cullInstances(other, shadowCamera);
+    const auto otherMatrices = mesh->visibleInstanceMatrix();
+    const auto otherVersion = otherMatrices->version;
+    CHECK(otherMatrices != matrices);
+    checkCompacted(*mesh, expectedVisible(*mesh, other));
+
+    // alternating views reuse their own results
+    for (int i = 0; i < 3; i++) {
+
+        CHECK(mesh->cullInstances(frustum, camera) == numVisible);
+        CHECK(mesh->visibleInstanceMatrix() == matrices);
+        CHECK(mesh->cullInstances(other, shadowCamera) == numVisibleOther);
+        CHECK(mesh->visibleInstanceMatrix() == otherMatrices);
+    }
+
+    CHECK(matrices->version == version);
+    CHECK(otherMatrices->version == otherVersion);
+
+    // viewports of the same camera are views of their own
+    mesh->cullInstances(frustum, shadowCamera, 1);
+    CHECK(mesh->visibleInstanceMatrix() != otherMatrices);
+    CHECK(mesh->visibleInstanceAttributes().size() == 6);
+
+    // past the limit, the least recently culled view is reused
+    std::vector<PerspectiveCamera> cameras(InstancedMesh::maxCullViews);
+    for (auto& c : cameras) mesh->cullInstances(frustum, c);
+
+    CHECK(mesh->visibleInstanceAttributes().size() == 2 * InstancedMesh::maxCullViews);
+    checkCompacted(*mesh, expectedVisible(*mesh, frustum));
+}
+
+TEST_CASE("cullInstances with a non uniform scale") {
+
+    const auto frustum = cameraFrustum();
+
+    auto mesh = createGrid(2000);
+    mesh->scale.set(1, 3, 0.5f);
+    mesh->rotation.x = 0.7f;
+    mesh->updateMatrixWorld();
+
+    mesh->cullInstances(frustum);
+
+    // the world sphere bounds the scaled instance sphere, so the exact test finds a subset
+    const auto visible = expectedVisible(*mesh, frustum);
+    CHECK(mesh->visibleCount() <= visible.size());
+    CHECK(mesh->visibleCount() > 0);
+
+    Matrix4 actual, expected;
+    for (size_t i = 0, j = 0; i < mesh->visibleCount(); i++) {
+
+        actual.fromArray(mesh->visibleInstanceMatrix()->array(), i * 16);
+        for (; j < visible.size(); j++) {
+
+            mesh->getMatrixAt(visible[j], expected);
+            if (actual == expected) break;
+        }
+        CHECK(j < visible.size());
+    }
+}
+
+namespace {
+
+    // what the loop over every instance reports
+    std::vector<Intersection> raycastEveryInstance(InstancedMesh& mesh, const Raycaster& raycaster) {
+
+        auto single = Mesh::create(mesh.geometry(), mesh.material());
+
+        std::vector<Intersection> intersects;
+        Matrix4 matrix;
+        for (size_t i = 0; i < mesh.count(); i++) {
+
+            mesh.getMatrixAt(i, matrix);
+            single->matrixWorld->multiplyMatrices(*mesh.matrixWorld, matrix);
+
+            const auto first = intersects.size();
+            single->raycast(raycaster, intersects);
+            for (auto j = first; j < intersects.size(); j++) intersects[j].instanceId = static_cast<int>(i);
+        }
+
+        std::stable_sort(intersects.begin(), intersects.end(), [](const auto& a, const auto& b) {
+            return a.distance < b.distance;
+        });
+
+        return intersects;
+    }
+
+    void checkRaycast(InstancedMesh& mesh, Raycaster& raycaster, size_t numRays) {
+
+        size_t hits = 0;
+        Matrix4 matrix;
+        for (size_t i = 0; i < numRays; i++) {
+
+            // aimed at an instance, the grid is too sparse for random rays
+            mesh.getMatrixAt(math::randInt(0, static_cast<int>(mesh.count()) - 1), matrix);
+            matrix.premultiply(*mesh.matrixWorld);
+
+            const Vector3 origin{math::randFloatSpread(20), math::randFloatSpread(20), 150};
+            Vector3 target;
+            target.setFromMatrixPosition(matrix);
+            raycaster.set(origin, Vector3(target).sub(origin).normalize());
+
+            const auto expected = raycastEveryInstance(mesh, raycaster);
+            const auto actual = raycaster.intersectObject(mesh);
+
+            REQUIRE(actual.size() == expected.size());
+            for (size_t j = 0; j < actual.size(); j++) {
+
+                CHECK(actual[j].distance == expected[j].distance);
+                CHECK(actual[j].instanceId == expected[j].instanceId);
+                CHECK(actual[j].faceIndex == expected[j].faceIndex);
+            }
+            hits += actual.size();
+        }
+
+        CHECK(hits > 0);
+    }
+
+}// namespace
+
+TEST_CASE("raycast matches testing every instance") {
+
+    auto mesh = createGrid(2000);
+    mesh->rotation.set(0.2f, 0.5f, 0);
+    mesh->scale.set(1, 2, 1.5f);
+    mesh->updateMatrixWorld();
+
+    Raycaster raycaster;
+    checkRaycast(*mesh, raycaster, 50);
+
+    raycaster.far = 120;
+    checkRaycast(*mesh, raycaster, 50);
+}
+
+TEST_CASE("instanceBoundsTree follows the instances") {
+
+    auto mesh = createGrid(500);
+    mesh->updateMatrixWorld();
+
+    const auto& tree = mesh->instanceBoundsTree();
+    CHECK(tree.size() == 500);
+    CHECK_NOTHROW(tree.validate());
+
+    // refit when the matrices are flagged for upload
+    Matrix4 matrix;
+    for (size_t i = 0; i < 100; i++) {
+
+        mesh->setMatrixAt(i, matrix.makeTranslation(math::randFloatSpread(200), 0, 0));
+    }
+    mesh->instanceMatrix()->needsUpdate();
+
+    CHECK(&mesh->instanceBoundsTree() == &tree);
+    CHECK_NOTHROW(tree.validate());
+
+    Raycaster raycaster;
+    checkRaycast(*mesh, raycaster, 20);
+
+    // rebuilt for a new count
+    mesh->setCount(200);
+    CHECK(mesh->instanceBoundsTree().size() == 200);
+    checkRaycast(*mesh, raycaster, 20);
+
+    mesh->setCount(0);
+    raycaster.set({0, 0, 150}, {0, 0, -1});
+    CHECK(raycaster.intersectObject(*mesh).empty());
+}
@@ -0,0 +1,418 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/threepp.hpp"
+#include "threepp/renderers/GLRenderTarget.hpp"
+
+#include "HeadlessContext.hpp"
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace threepp;
+
+namespace {
+
+    struct ShadowScene {
+
+        std::shared_ptr<Scene> scene = Scene::create();
+        std::shared_ptr<PerspectiveCamera> camera = PerspectiveCamera::create(60, 1, 0.1f, 100);
+        std::shared_ptr<DirectionalLight> light = DirectionalLight::create();
+        std::shared_ptr<Mesh> mesh = Mesh::create(BoxGeometry::create(), MeshPhongMaterial::create());
+
+        ShadowScene() {
+
+            camera->position.z = 5;
+
+            light->position.set(2, 5, 3);
+            light->castShadow = true;
+            scene->add(light);
+
+            mesh->castShadow = true;
+            mesh->receiveShadow = true;
+            scene->add(mesh);
+        }
+    };
+
+}// namespace
+
+TEST_CASE("frame counters keep the shadow pass apart") {
+
+    HeadlessContext context;
+    if (!context.valid()) SKIP("no OpenGL context available");
+
+    GLRenderer renderer({64, 64});
+    renderer.shadowMap().enabled = true;
+
+    auto target = GLRenderTarget::create(64, 64, {});
+    renderer.setRenderTarget(target.get());
+
+    ShadowScene s;
+    renderer.render(*s.scene, *s.camera);
+
+    const auto& info = renderer.info().render;
+
+    // the mesh is drawn into the shadow map and into the target, the shadow draw is counted apart
+    CHECK(info.calls == 1);
+    CHECK(info.shadowCalls == 1);
+    CHECK(info.triangles == 12);
+    // geometry is uploaded during projection, before any draw
+    CHECK(info.uploads > 0);
+    // the depth program of the shadow pass, then the phong program
+    CHECK(info.programSwitches == 2);
+
+    renderer.render(*s.scene, *s.camera);
+
+    // nothing left to upload, and the counters start over
+    CHECK(info.frame == 2);
+    CHECK(info.calls == 1);
+    CHECK(info.shadowCalls == 1);
+    CHECK(info.uploads == 0);
+}
+
+TEST_CASE("a new buffer is up to date with its attribute") {
+
+    HeadlessContext context;
+    if (!context.valid()) SKIP("no OpenGL context available");
+
+    GLRenderer renderer({64, 64});
+
+    auto target = GLRenderTarget::create(64, 64, {});
+    renderer.setRenderTarget(target.get());
+
+    ShadowScene s;
+    auto position = s.mesh->geometry()->getAttribute<float>("position");
+    position->needsUpdate();
+    renderer.render(*s.scene, *s.camera);
+
+    const auto& info = renderer.info().render;
+
+    // the upload on creation covers the edit made before it
+    renderer.render(*s.scene, *s.camera);
+    CHECK(info.uploads == 0);
+
+    // an edit after it is uploaded on the next frame, once
+    position->needsUpdate();
+    renderer.render(*s.scene, *s.camera);
+    CHECK(info.uploads == 1);
+
+    renderer.render(*s.scene, *s.camera);
+    CHECK(info.uploads == 0);
+}
+
+TEST_CASE("streamed attributes upload what each copy missed") {
+
+    HeadlessContext context;
+    if (!context.valid()) SKIP("no OpenGL context available");
+
+    GLRenderer renderer({64, 64});
+
+    auto target = GLRenderTarget::create(64, 64, {});
+    renderer.setRenderTarget(target.get());
+
+    auto scene = Scene::create();
+    auto camera = PerspectiveCamera::create(60, 1, 0.1f, 100);
+    camera->position.z = 5;
+
+    auto geometry = PlaneGeometry::create(1, 1, 10, 10);
+    auto position = geometry->getAttribute<float>("position");
+    position->setUsage(DrawUsage::Dynamic);
+    position->setStreamed(true);
+    scene->add(Mesh::create(geometry, MeshBasicMaterial::create()));
+
+    renderer.render(*scene, *camera);
+
+    const auto& info = renderer.info().render;
+    const auto vertexBytes = 3 * sizeof(float);
+    const auto allBytes = position->count() * vertexBytes;
+
+    const auto update = [&](int vertex) {
+        position->setZ(vertex, 0.1f);
+        position->addUpdateRange(vertex * 3, 3);
+        position->needsUpdate();
+        renderer.render(*scene, *camera);
+    };
+
+    // the other two copies are written whole the first time they are used
+    update(0);
+    CHECK(info.uploadedBytes == allBytes);
+    update(1);
+    CHECK(info.uploadedBytes == allBytes);
+
+    // back to the first copy, which missed all three updates
+    update(2);
+    CHECK(info.uploadedBytes == 3 * vertexBytes);
+
+    // and from then on each copy gets the update it is current for and the two it missed
+    update(3);
+    CHECK(info.uploadedBytes == 3 * vertexBytes);
+}
+
+TEST_CASE("a small camera move keeps cached shadows in the atlas") {
+
+    HeadlessContext context;
+    if (!context.valid()) SKIP("no OpenGL context available");
+
+    GLRenderer renderer({64, 64});
+    renderer.shadowMap().enabled = true;
+    renderer.shadowMap().atlasSize = 1024;
+    renderer.shadowMap().skipUnchanged = true;
+
+    auto target = GLRenderTarget::create(64, 64, {});
+    renderer.setRenderTarget(target.get());
+
+    auto scene = Scene::create();
+    auto camera = PerspectiveCamera::create(60, 1, 0.1f, 100);
+
+    auto light = SpotLight::create();
+    light->distance = 1;
+    light->castShadow = true;
+    light->position.set(0, 0.5f, 0);
+    scene->add(light);
+
+    auto mesh = Mesh::create(BoxGeometry::create(0.2f, 0.2f, 0.2f), MeshPhongMaterial::create());
+    mesh->castShadow = true;
+    scene->add(mesh);
+
+    // the light covers about half the view, right where its map would be halved
+    camera->position.set(0, 0, 3.45f);
+    renderer.render(*scene, *camera);
+
+    const auto& info = renderer.info().render;
+    REQUIRE(info.shadowCalls == 1);
+    const auto rect = light->shadow->atlasRect;
+
+    camera->position.z = 3.5f;
+    renderer.render(*scene, *camera);
+
+    // only the view is drawn, the map stays where it was
+    CHECK(info.calls == 1);
+    CHECK(info.shadowCalls == 0);
+    CHECK(light->shadow->atlasRect == rect);
+}
+
+TEST_CASE("culled instances are not uploaded again for the shadow pass") {
+
+    HeadlessContext context;
+    if (!context.valid()) SKIP("no OpenGL context available");
+
+    GLRenderer renderer({64, 64});
+    renderer.shadowMap().enabled = true;
+
+    auto target = GLRenderTarget::create(64, 64, {});
+    renderer.setRenderTarget(target.get());
+
+    ShadowScene s;
+    s.mesh->visible = false;
+
+    auto instances = InstancedMesh::create(BoxGeometry::create(0.1f, 0.1f, 0.1f), MeshPhongMaterial::create(), 100);
+    instances->perInstanceCulling = true;
+    instances->castShadow = true;
+
+    Matrix4 matrix;
+    for (unsigned i = 0; i < 100; i++) {
+
+        instances->setMatrixAt(i, matrix.makeTranslation(static_cast<float>(i % 10) - 5, static_cast<float>(i / 10) - 5, 0));
+    }
+    s.scene->add(instances);
+
+    renderer.render(*s.scene, *s.camera);
+
+    const auto& info = renderer.info().render;
+    CHECK(info.calls == 1);
+    CHECK(info.shadowCalls == 1);
+
+    // the view and the shadow camera see different instances, each keeps its own
+    renderer.render(*s.scene, *s.camera);
+    CHECK(info.calls == 1);
+    CHECK(info.shadowCalls == 1);
+    CHECK(info.uploads == 0);
+}
+
+TEST_CASE("culled instances grow the buffer when more of them come into view") {
+
+    HeadlessContext context;
+    if (!context.valid()) SKIP("no OpenGL context available");
+
+    GLRenderer renderer({64, 64});
+
+    auto target = GLRenderTarget::create(64, 64, {});
+    renderer.setRenderTarget(target.get());
+
+    auto scene = Scene::create();
+    auto camera = PerspectiveCamera::create(60, 1, 0.1f, 1000);
+    camera->position.z = 5;
+
+    auto instances = InstancedMesh::create(BoxGeometry::create(0.1f, 0.1f, 0.1f), MeshBasicMaterial::create(), 10000);
+    instances->perInstanceCulling = true;
+
+    Matrix4 matrix;
+    for (unsigned i = 0; i < 10000; i++) {
+
+        instances->setMatrixAt(i, matrix.makeTranslation(static_cast<float>(i % 100) - 50, static_cast<float>(i / 100) - 50, 0));
+    }
+    scene->add(instances);
+
+    renderer.render(*scene, *camera);
+    const auto before = instances->visibleCount();
+
+    camera->position.z = 200;
+    renderer.render(*scene, *camera);
+
+    CHECK(instances->visibleCount() > before);
+    CHECK(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE("a material drawn instanced and not keeps both programs") {
+
+    HeadlessContext context;
+    if (!context.valid()) SKIP("no OpenGL context available");
+
+    GLRenderer renderer({64, 64});
+
+    auto target = GLRenderTarget::create(64, 64, {});
+    renderer.setRenderTarget(target.get());
+
+    auto scene = Scene::create();
+    auto camera = PerspectiveCamera::create(60, 1, 0.1f, 100);
+    camera->position.z = 5;
+
+    auto material = MeshBasicMaterial::create({{"color", Color::red}});
+    auto geometry = PlaneGeometry::create();
+
+    auto mesh = Mesh::create(geometry, material);
+    mesh->position.x = -1;
+    scene->add(mesh);
+
+    auto instances = InstancedMesh::create(geometry, material, 1);
+    instances->setMatrixAt(0, Matrix4().makeTranslation(1, 0, 0));
+    scene->add(instances);
+
+    // the material alternates between the two programs every frame
+    for (int frame = 0; frame < 3; frame++) {
+
+        renderer.render(*scene, *camera);
+        CHECK(renderer.info().render.calls == 2);
+
+        std::array<unsigned char, 4> left{}, right{};
+        glReadPixels(21, 32, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, left.data());
+        glReadPixels(43, 32, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, right.data());
+
+        CHECK(left[0] == 255);
+        CHECK(right[0] == 255);
+    }
+
+    CHECK(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE("occlusion queries hide an object until it comes into view") {
+
+    HeadlessContext context;
+    if (!context.valid()) SKIP("no OpenGL context available");
+
+    GLRenderer renderer({64, 64});
+    renderer.occlusionCulling = true;
+    // visible objects are tested every frame too
+    renderer.occlusionTestInterval = 1;
+
+    auto target = GLRenderTarget::create(64, 64, {});
+    renderer.setRenderTarget(target.get());
+
+    auto scene = Scene::create();
+    auto camera = PerspectiveCamera::create(60, 1, 0.1f, 100);
+    camera->position.z = 5;
+
+    auto material = MeshBasicMaterial::create();
+
+    auto occluder = Mesh::create(BoxGeometry::create(4, 4, 0.2f), material);
+    occluder->position.z = 1;
+    scene->add(occluder);
+
+    auto hidden = Mesh::create(BoxGeometry::create(0.5f, 0.5f, 0.5f), material);
+    hidden->position.z = -2;
+    scene->add(hidden);
+
+    const auto& info = renderer.info().render;
+
+    // waits for the queries, so their results are available in the next frame
+    const auto renderFrame = [&] {
+        renderer.render(*scene, *camera);
+        glFinish();
+    };
+
+    // unknown objects are drawn, and their boxes tested
+    renderFrame();
+    CHECK(info.calls == 2);
+    CHECK(info.occlusionQueries == 2);
+    CHECK(info.occlusionCulled == 0);
+
+    // the result of the last frame hides the box behind the occluder, which is tested again
+    renderFrame();
+    CHECK(info.calls == 1);
+    CHECK(info.occlusionCulled == 1);
+    CHECK(info.occlusionQueries == 2);
+
+    // still hidden as of the last test, this frame's test finds it in view
+    occluder->visible = false;
+    renderFrame();
+    CHECK(info.calls == 0);
+    CHECK(info.occlusionCulled == 1);
+
+    renderFrame();
+    CHECK(info.calls == 1);
+    CHECK(info.occlusionCulled == 0);
+
+    // hidden again, then replaced by a new object, which does not inherit the result
+    occluder->visible = true;
+    renderFrame();
+    renderFrame();
+    REQUIRE(info.occlusionCulled == 1);
+
+    scene->remove(*hidden);
+    hidden.reset();
+
+    auto replacement = Mesh::create(BoxGeometry::create(0.5f, 0.5f, 0.5f), material);
+    replacement->position.z = -2;
+    scene->add(replacement);
+
+    renderFrame();
+    CHECK(info.calls == 2);
+    CHECK(info.occlusionCulled == 0);
+}
+
+TEST_CASE("timing covers the outermost render call") {
+
+    HeadlessContext context;
+    if (!context.valid()) SKIP("no OpenGL context available");
+
+    GLRenderer renderer({64, 64});
+
+    auto target = GLRenderTarget::create(64, 64, {});
+    renderer.setRenderTarget(target.get());
+
+    auto scene = Scene::create();
+    auto nested = Scene::create();
+    auto camera = PerspectiveCamera::create(60, 1, 0.1f, 100);
+    camera->position.z = 5;
+
+    // the timing seen right after a nested render of an empty scene
+    double seenOpaque = -1;
+
+    auto mesh = Mesh::create(BoxGeometry::create(), MeshBasicMaterial::create());
+    mesh->onBeforeRender = RenderCallback([&](void*, Object3D*, Camera*, BufferGeometry*, Material*, std::optional<GeometryGroup>) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        renderer.render(*nested, *camera);
+        seenOpaque = renderer.info().timing.opaque;
+    });
+    scene->add(mesh);
+
+    renderer.render(*scene, *camera);
+    CHECK(renderer.info().timing.opaque >= 20);
+
+    // the nested render leaves the timing of the last frame in place
+    renderer.render(*scene, *camera);
+    CHECK(seenOpaque >= 20);
+    CHECK(renderer.info().timing.opaque >= 20);
+}
@@ -0,0 +1,70 @@
+
+#ifndef THREEPP_HEADLESSCONTEXT_HPP
+#define THREEPP_HEADLESSCONTEXT_HPP
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+// An OpenGL 3.3 context without a window, for tests that drive the renderer.
+// Made current on construction. Where EGL can not provide one (no driver, or no surfaceless platform),
+// valid() is false and the test should be skipped.
+class HeadlessContext {
+
+public:
+    HeadlessContext() {
+
+        const auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        display_ = getPlatformDisplay
+                           ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+                           : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+        if (display_ == EGL_NO_DISPLAY || !eglInitialize(display_, nullptr, nullptr)) {
+
+            display_ = EGL_NO_DISPLAY;
+            return;
+        }
+
+        if (!eglBindAPI(EGL_OPENGL_API)) return;
+
+        const EGLint configAttributes[]{EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+        EGLConfig config{};
+        EGLint configs = 0;
+        eglChooseConfig(display_, configAttributes, &config, 1, &configs);
+
+        const EGLint contextAttributes[]{
+                EGL_CONTEXT_MAJOR_VERSION, 3,
+                EGL_CONTEXT_MINOR_VERSION, 3,
+                EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                EGL_NONE};
+        context_ = eglCreateContext(display_, configs > 0 ? config : EGLConfig{}, EGL_NO_CONTEXT, contextAttributes);
+
+        if (context_ != EGL_NO_CONTEXT) {
+
+            current_ = eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, context_);
+        }
+    }
+
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    [[nodiscard]] bool valid() const {
+
+        return current_;
+    }
+
+    ~HeadlessContext() {
+
+        if (display_ == EGL_NO_DISPLAY) return;
+
+        eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (context_ != EGL_NO_CONTEXT) eglDestroyContext(display_, context_);
+        eglTerminate(display_);
+    }
+
+private:
+    EGLDisplay display_ = EGL_NO_DISPLAY;
+    EGLContext context_ = EGL_NO_CONTEXT;
+    bool current_ = false;
+};
+
+#endif//THREEPP_HEADLESSCONTEXT_HPP
@@ -0,0 +1,179 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/renderers/gl/GLAttributes.hpp"
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace threepp {
+
+    bool operator==(const UpdateRange& a, const UpdateRange& b) {
+
+        return a.offset == b.offset && a.count == b.count;
+    }
+
+}// namespace threepp
+
+TEST_CASE("coalesce") {
+
+    SECTION("disjoint ranges are sorted") {
+
+        std::vector<UpdateRange> ranges{{50, 10}, {0, 10}, {20, 5}};
+        GLAttributes::coalesce(ranges, 100);
+
+        CHECK(ranges == std::vector<UpdateRange>{{0, 10}, {20, 5}, {50, 10}});
+    }
+
+    SECTION("overlapping and touching ranges are merged") {
+
+        std::vector<UpdateRange> ranges{{10, 10}, {0, 10}, {15, 20}, {40, 5}, {42, 1}};
+        GLAttributes::coalesce(ranges, 100);
+
+        CHECK(ranges == std::vector<UpdateRange>{{0, 35}, {40, 5}});
+    }
+
+    SECTION("ranges are clamped to the attribute") {
+
+        std::vector<UpdateRange> ranges{{-5, 10}, {95, 20}, {200, 10}, {30, 0}};
+        GLAttributes::coalesce(ranges, 100);
+
+        CHECK(ranges == std::vector<UpdateRange>{{0, 5}, {95, 5}});
+    }
+
+    SECTION("empty") {
+
+        std::vector<UpdateRange> ranges{{200, 10}};
+        GLAttributes::coalesce(ranges, 100);
+
+        CHECK(ranges.empty());
+    }
+}
+
+TEST_CASE("updateRanges") {
+
+    auto attribute = FloatBufferAttribute::create(std::vector<float>(100), 1);
+
+    attribute->addUpdateRange(0, 10);
+    attribute->addUpdateRange(50, 10);
+    REQUIRE(attribute->updateRanges.size() == 2);
+    CHECK(attribute->updateRanges[1] == UpdateRange{50, 10});
+
+    attribute->clearUpdateRanges();
+    CHECK(attribute->updateRanges.empty());
+}
+
+TEST_CASE("fitsUint16") {
+
+    std::vector<unsigned int> indices{0, 1, 2, 0xfffe};
+    CHECK(GLAttributes::fitsUint16(indices.data(), {{0, 4}}));
+
+    // 0xffff restarts the primitive in GLES3 and WebGL2
+    indices.back() = 0xffff;
+    CHECK_FALSE(GLAttributes::fitsUint16(indices.data(), {{0, 4}}));
+    CHECK(GLAttributes::fitsUint16(indices.data(), {{0, 3}}));
+
+    indices.back() = 0x10000;
+    CHECK_FALSE(GLAttributes::fitsUint16(indices.data(), {{0, 4}}));
+}
+
+TEST_CASE("streams") {
+
+    constexpr unsigned int arrayBuffer = 0x8892;// GL_ARRAY_BUFFER
+    constexpr unsigned int elementArrayBuffer = 0x8893;// GL_ELEMENT_ARRAY_BUFFER
+
+    auto attribute = FloatBufferAttribute::create(std::vector<float>(12), 3);
+    attribute->setUsage(DrawUsage::Dynamic);
+
+    // opt-in only
+    CHECK_FALSE(GLAttributes::streams(*attribute, arrayBuffer));
+
+    attribute->setStreamed(true);
+    CHECK(GLAttributes::streams(*attribute, arrayBuffer));
+    CHECK_FALSE(GLAttributes::streams(*attribute, elementArrayBuffer));
+    CHECK(attribute->clone()->streamed());
+
+    attribute->setUsage(DrawUsage::Static);
+    CHECK_FALSE(GLAttributes::streams(*attribute, arrayBuffer));
+}
+
+TEST_CASE("StreamRing") {
+
+    StreamRing ring(3);
+    ring.reset(400);
+
+    REQUIRE(ring.numRegions() == 3);
+    CHECK(ring.region() == 0);
+    CHECK(ring.offset() == 0);
+
+    SECTION("copies are used in turn") {
+
+        for (size_t i = 1; i <= 6; i++) {
+
+            ring.advance({}, 100);
+            CHECK(ring.region() == i % 3);
+            CHECK(ring.offset() == (i % 3) * 400);
+        }
+    }
+
+    SECTION("a full update writes everything") {
+
+        CHECK(ring.advance({}, 100) == std::vector<UpdateRange>{{0, 100}});
+        CHECK(ring.advance({}, 100) == std::vector<UpdateRange>{{0, 100}});
+    }
+
+    SECTION("copies that never held the data are written whole") {
+
+        CHECK(ring.advance({{10, 5}}, 100) == std::vector<UpdateRange>{{0, 100}});
+        CHECK(ring.advance({{20, 5}}, 100) == std::vector<UpdateRange>{{0, 100}});
+
+        // back to the first copy, which missed both updates
+        CHECK(ring.advance({{30, 5}}, 100) == std::vector<UpdateRange>{{10, 5}, {20, 5}, {30, 5}});
+        CHECK(ring.region() == 0);
+
+        // the second copy was written whole after the first update
+        CHECK(ring.advance({{40, 5}}, 100) == std::vector<UpdateRange>{{20, 5}, {30, 5}, {40, 5}});
+    }
+
+    SECTION("missed ranges are coalesced and clamped") {
+
+        ring.advance({}, 100);
+        ring.advance({}, 100);
+        ring.advance({{10, 10}}, 100);
+        ring.advance({{15, 10}}, 100);
+
+        CHECK(ring.advance({{95, 10}}, 100) == std::vector<UpdateRange>{{10, 15}, {95, 5}});
+    }
+
+    SECTION("a full update in between is not lost") {
+
+        ring.advance({}, 100);
+        ring.advance({}, 100);
+        ring.advance({{10, 5}}, 100);
+        ring.advance({}, 100);
+
+        CHECK(ring.advance({{50, 5}}, 100) == std::vector<UpdateRange>{{0, 100}});
+    }
+
+    SECTION("reset starts over from the first copy") {
+
+        ring.advance({}, 100);
+        ring.reset(800);
+
+        CHECK(ring.region() == 0);
+        CHECK(ring.regionSize() == 800);
+
+        CHECK(ring.advance({{10, 5}}, 200) == std::vector<UpdateRange>{{0, 200}});
+        CHECK(ring.offset() == 800);
+    }
+
+    SECTION("a single copy") {
+
+        StreamRing single(1);
+        single.reset(400);
+
+        single.advance({{10, 5}}, 100);
+        CHECK(single.region() == 0);
+        CHECK(single.offset() == 0);
+        CHECK(single.advance({{20, 5}}, 100) == std::vector<UpdateRange>{{20, 5}});
+    }
+}
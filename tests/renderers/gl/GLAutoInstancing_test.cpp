@@ -0,0 +1,103 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/materials/MeshBasicMaterial.hpp"
+#include "threepp/renderers/gl/GLAutoInstancing.hpp"
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace {
+
+    struct Fixture {
+
+        std::vector<std::shared_ptr<Mesh>> meshes;
+        std::vector<RenderItem> items;
+
+        void add(const std::shared_ptr<BufferGeometry>& geometry, const std::shared_ptr<Material>& material) {
+
+            auto mesh = Mesh::create(geometry, material);
+            mesh->position.x = static_cast<float>(meshes.size());
+            mesh->updateMatrixWorld();
+            meshes.emplace_back(mesh);
+        }
+
+        std::vector<RenderItem*> list() {
+
+            items.clear();
+            for (auto& mesh : meshes) {
+                items.push_back({mesh->id, mesh.get(), mesh->geometry().get(), mesh->material().get(), nullptr, 0, 0, 0, std::nullopt});
+            }
+
+            std::vector<RenderItem*> result;
+            for (auto& item : items) result.emplace_back(&item);
+            return result;
+        }
+    };
+
+}// namespace
+
+TEST_CASE("run length") {
+
+    auto geometry = BoxGeometry::create();
+    auto material = MeshBasicMaterial::create();
+    auto otherMaterial = MeshBasicMaterial::create();
+
+    Fixture f;
+    f.add(geometry, material);
+    f.add(geometry, material);
+    f.add(geometry, material);
+    f.add(geometry, otherMaterial);
+    f.add(geometry, material);
+
+    auto list = f.list();
+    CHECK(GLAutoInstancing::runLength(list, 0) == 3);
+    CHECK(GLAutoInstancing::runLength(list, 1) == 2);
+    CHECK(GLAutoInstancing::runLength(list, 3) == 1);
+    CHECK(GLAutoInstancing::runLength(list, 4) == 1);
+
+    // objects with render callbacks are drawn on their own
+    f.meshes[1]->onBeforeRender = RenderCallback([](void*, Object3D*, Camera*, BufferGeometry*, Material*, std::optional<GeometryGroup>) {});
+    CHECK(GLAutoInstancing::runLength(list, 0) == 1);
+    f.meshes[1]->onBeforeRender.reset();
+
+    // as are mirrored objects
+    f.meshes[2]->scale.x = -1;
+    f.meshes[2]->updateMatrixWorld();
+    CHECK(GLAutoInstancing::runLength(list, 0) == 2);
+}
+
+TEST_CASE("acquire") {
+
+    auto geometry = BoxGeometry::create();
+    auto material = MeshBasicMaterial::create();
+
+    Fixture f;
+    for (int i = 0; i < 20; i++) f.add(geometry, material);
+    auto list = f.list();
+
+    GLAutoInstancing instancing;
+
+    auto mesh = instancing.acquire(list, 2, 3);
+    REQUIRE(mesh->count() == 3);
+    REQUIRE(mesh->geometry() == geometry);
+    REQUIRE(mesh->material() == material);
+
+    Matrix4 m;
+    mesh->getMatrixAt(1, m);
+    CHECK(m.equals(*f.meshes[3]->matrixWorld));
+
+    // a second run in the same frame gets its own proxy
+    auto other = instancing.acquire(list, 0, 2);
+    CHECK(other != mesh);
+
+    instancing.endFrame();
+
+    // proxies are reused across frames, and grown when needed
+    CHECK(instancing.acquire(list, 0, 3) == mesh);
+    auto grown = instancing.acquire(list, 0, 20);
+    CHECK(grown->count() == 20);
+    grown->getMatrixAt(19, m);
+    CHECK(m.equals(*f.meshes[19]->matrixWorld));
+}
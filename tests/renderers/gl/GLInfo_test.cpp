@@ -0,0 +1,57 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/renderers/gl/GLInfo.hpp"
+
+#include <sstream>
+
+using namespace threepp::gl;
+
+TEST_CASE("reset clears the per frame counters") {
+
+    GLInfo info;
+
+    info.updateUpload(128);
+    info.updateProgramSwitch();
+    info.updateTextureBind();
+    info.updateTextureBind();
+    info.updateStateChangeAvoided();
+
+    CHECK(info.render.uploadedBytes == 128);
+    CHECK(info.render.programSwitches == 1);
+    CHECK(info.render.textureBinds == 2);
+    CHECK(info.render.stateChangesAvoided == 1);
+
+    info.timing.opaque = 2;
+
+    info.reset();
+
+    CHECK(info.render.frame == 1);
+    CHECK(info.render.uploads == 0);
+    CHECK(info.render.programSwitches == 0);
+    CHECK(info.render.textureBinds == 0);
+    CHECK(info.render.stateChangesAvoided == 0);
+
+    // timings are replaced by every render call instead
+    CHECK(info.timing.opaque == 2);
+}
+
+TEST_CASE("timing") {
+
+    TimingInfo timing;
+    CHECK(timing.gpu < 0);
+    CHECK(timing.cpu() == 0);
+
+    timing.update = 1;
+    timing.projection = 2;
+    timing.sort = 0.5;
+    timing.shadows = 3;
+    timing.opaque = 4;
+    timing.transparent = 0.5;
+    CHECK(timing.cpu() == 11);
+
+    std::stringstream ss;
+    ss << GLInfo{};
+    CHECK(ss.str().find("TimingInfo") != std::string::npos);
+    CHECK(ss.str().find("stateChangesAvoided=0") != std::string::npos);
+}
@@ -0,0 +1,51 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/materials/MeshBasicMaterial.hpp"
+#include "threepp/materials/PointsMaterial.hpp"
+#include "threepp/objects/InstancedMesh.hpp"
+#include "threepp/objects/Points.hpp"
+#include "threepp/renderers/gl/GLOcclusionCulling.hpp"
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace {
+
+    RenderItem makeItem(Object3D& object) {
+
+        return {object.id, &object, object.geometry().get(), nullptr, nullptr, 0, 0, 0, std::nullopt};
+    }
+
+}// namespace
+
+TEST_CASE("canCull") {
+
+    auto geometry = BoxGeometry::create();
+    auto material = MeshBasicMaterial::create();
+
+    auto mesh = Mesh::create(geometry, material);
+    CHECK(GLOcclusionCulling::canCull(makeItem(*mesh)));
+
+    mesh->occlusionCulled = false;
+    CHECK_FALSE(GLOcclusionCulling::canCull(makeItem(*mesh)));
+
+    // the geometry bounds do not cover the instances
+    auto instanced = InstancedMesh::create(geometry, material, 10);
+    CHECK_FALSE(GLOcclusionCulling::canCull(makeItem(*instanced)));
+
+    auto points = Points::create(geometry, PointsMaterial::create());
+    CHECK_FALSE(GLOcclusionCulling::canCull(makeItem(*points)));
+
+    auto morphed = BoxGeometry::create();
+    morphed->getOrCreateMorphAttribute("position")->emplace_back(FloatBufferAttribute::create(std::vector<float>(72), 3));
+    CHECK_FALSE(GLOcclusionCulling::canCull(makeItem(*Mesh::create(morphed, material))));
+}
+
+TEST_CASE("occlusionCulled is copied") {
+
+    auto mesh = Mesh::create(BoxGeometry::create(), MeshBasicMaterial::create());
+    mesh->occlusionCulled = false;
+
+    CHECK_FALSE(mesh->clone<Mesh>()->occlusionCulled);
+}
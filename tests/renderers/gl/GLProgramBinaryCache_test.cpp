@@ -0,0 +1,78 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/renderers/gl/GLProgramBinaryCache.hpp"
+
+#include <cstdint>
+#include <sstream>
+
+using namespace threepp::gl;
+
+TEST_CASE("entry roundtrip") {
+
+    GLProgramBinaryCache::Entry entry;
+    entry.format = 0x8E8E;
+    entry.binary = {1, 2, 3, 4, 5};
+
+    std::stringstream ss;
+    GLProgramBinaryCache::writeEntry(ss, "key", entry);
+
+    auto read = GLProgramBinaryCache::readEntry(ss, "key");
+    REQUIRE(read);
+    REQUIRE(read->format == entry.format);
+    REQUIRE(read->binary == entry.binary);
+}
+
+TEST_CASE("entry key mismatch") {
+
+    GLProgramBinaryCache::Entry entry;
+    entry.binary = {1, 2, 3};
+
+    std::stringstream ss;
+    GLProgramBinaryCache::writeEntry(ss, "key", entry);
+
+    REQUIRE_FALSE(GLProgramBinaryCache::readEntry(ss, "other"));
+}
+
+TEST_CASE("truncated entry") {
+
+    GLProgramBinaryCache::Entry entry;
+    entry.binary = {1, 2, 3};
+
+    std::stringstream ss;
+    GLProgramBinaryCache::writeEntry(ss, "key", entry);
+
+    auto data = ss.str();
+    std::stringstream truncated(data.substr(0, data.size() - 1));
+
+    REQUIRE_FALSE(GLProgramBinaryCache::readEntry(truncated, "key"));
+}
+
+TEST_CASE("corrupt binary size") {
+
+    GLProgramBinaryCache::Entry entry;
+    entry.binary = {1, 2, 3};
+
+    std::stringstream ss;
+    GLProgramBinaryCache::writeEntry(ss, "key", entry);
+
+    // magic, version, format and key size, then the key
+    auto data = ss.str();
+    const auto sizeOffset = 3 * sizeof(uint32_t) + sizeof(uint64_t) + 3;
+
+    const uint64_t binarySize = uint64_t{1} << 60;
+    data.replace(sizeOffset, sizeof(binarySize), reinterpret_cast<const char*>(&binarySize), sizeof(binarySize));
+
+    std::stringstream corrupt(data);
+    REQUIRE_FALSE(GLProgramBinaryCache::readEntry(corrupt, "key"));
+}
+
+TEST_CASE("file name") {
+
+    REQUIRE(GLProgramBinaryCache::fileName("key") == GLProgramBinaryCache::fileName("key"));
+    REQUIRE(GLProgramBinaryCache::fileName("key") != GLProgramBinaryCache::fileName("key2"));
+    REQUIRE(GLProgramBinaryCache::fileName("").size() == 20);
+
+    // the same in every build, so entries are found again by later runs
+    REQUIRE(GLProgramBinaryCache::fileName("key") == "3dc94a19365b10ec.bin");
+}
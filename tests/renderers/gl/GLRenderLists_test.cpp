@@ -7,6 +7,10 @@
 #include "threepp/renderers/gl/GLProperties.hpp"
 #include "threepp/renderers/gl/GLRenderLists.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
 using namespace threepp;
 using namespace threepp::gl;
 
@@ -174,3 +178,75 @@ TEST_CASE("push") {
         CHECK(!o->group.has_value());
     }
 }
+
+namespace {
+
+    std::vector<Object3D*> sortedObjects(const std::vector<RenderItem*>& list) {
+
+        std::vector<Object3D*> result;
+        for (auto item : list) result.emplace_back(item->object);
+        return result;
+    }
+
+}// namespace
+
+TEST_CASE("sort") {
+
+    GLProperties properties;
+    GLRenderList list(properties);
+
+    std::vector<std::unique_ptr<DummyMaterial>> materials(4);
+    std::vector<std::unique_ptr<DummyProgram>> programs(3);
+    for (auto& p : programs) p = std::make_unique<DummyProgram>();
+    for (unsigned i = 0; i < materials.size(); i++) {
+        materials[i] = std::make_unique<DummyMaterial>();
+        materials[i]->transparent = i % 2 == 1;
+        properties.materialProperties.get(materials[i].get())->program = programs[i % programs.size()].get();
+    }
+
+    const int numObjects = 200;
+    std::vector<std::unique_ptr<Object3D>> objects(numObjects);
+    std::vector<float> depths(numObjects);
+    for (int i = 0; i < numObjects; i++) {
+        objects[i] = std::make_unique<Object3D>();
+        objects[i]->renderOrder = (i * 7) % 3;
+        depths[i] = static_cast<float>((i * 37) % 101) / 10.f - 5.f;
+    }
+
+    auto fill = [&] {
+        list.init();
+        for (int i = 0; i < numObjects; i++) {
+            list.push(objects[i].get(), nullptr, materials[i % materials.size()].get(), i % 2, depths[i], std::nullopt);
+        }
+        list.finish();
+    };
+
+    fill();
+
+    // object ids increase with push order, so a stable sort with the original comparators gives the expected order
+    auto expectedOpaque = list.opaque;
+    std::stable_sort(expectedOpaque.begin(), expectedOpaque.end(), [](auto a, auto b) {
+        return std::make_tuple(a->groupOrder, a->renderOrder, a->program->id, a->material->id, a->z) <
+               std::make_tuple(b->groupOrder, b->renderOrder, b->program->id, b->material->id, b->z);
+    });
+    auto expectedTransparent = list.transparent;
+    std::stable_sort(expectedTransparent.begin(), expectedTransparent.end(), [](auto a, auto b) {
+        return std::make_tuple(a->groupOrder, a->renderOrder, -a->z) < std::make_tuple(b->groupOrder, b->renderOrder, -b->z);
+    });
+
+    list.sort();
+    CHECK(sortedObjects(list.opaque) == sortedObjects(expectedOpaque));
+    CHECK(sortedObjects(list.transparent) == sortedObjects(expectedTransparent));
+
+    // an unchanged frame reuses the previous order
+    fill();
+    list.sort();
+    CHECK(sortedObjects(list.opaque) == sortedObjects(expectedOpaque));
+    CHECK(sortedObjects(list.transparent) == sortedObjects(expectedTransparent));
+
+    // render orders too wide to pack fall back to the comparison sort
+    objects[0]->renderOrder = std::numeric_limits<unsigned int>::max();
+    fill();
+    list.sort();
+    CHECK(list.opaque.back()->object == objects[0].get());
+}
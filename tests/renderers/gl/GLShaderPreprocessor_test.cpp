@@ -0,0 +1,79 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/renderers/gl/GLShaderPreprocessor.hpp"
+#include "threepp/renderers/shaders/ShaderChunk.hpp"
+
+using namespace threepp;
+using namespace threepp::gl;
+
+TEST_CASE("resolve includes") {
+
+    const auto& chunk = shaders::ShaderChunk::instance().get("alphatest_fragment");
+
+    REQUIRE(GLShaderPreprocessor::process("a\n#include <alphatest_fragment>\nb", {}) == "a\n" + chunk + "\nb");
+    REQUIRE(GLShaderPreprocessor::process("\t#include <alphatest_fragment>", {}) == "\t" + chunk);
+
+    REQUIRE_THROWS(GLShaderPreprocessor::process("#include <missing_chunk>", {}));
+}
+
+TEST_CASE("replace identifiers") {
+
+    const GLShaderPreprocessor::Replacements replacements{{"NUM_DIR_LIGHTS", "2"}};
+
+    REQUIRE(GLShaderPreprocessor::process("#if NUM_DIR_LIGHTS > 0\nfloat x[ NUM_DIR_LIGHTS ];", replacements) == "#if 2 > 0\nfloat x[ 2 ];");
+    // only whole identifiers are replaced
+    REQUIRE(GLShaderPreprocessor::process("NUM_DIR_LIGHTS_X", replacements) == "NUM_DIR_LIGHTS_X");
+}
+
+TEST_CASE("unroll loops") {
+
+    const std::string source =
+            "#pragma unroll_loop_start\n"
+            "for ( int i = 0; i < NUM; i ++ ) {\n"
+            "\tx[ i ] = y[i] + UNROLLED_LOOP_INDEX;\n"
+            "}\n"
+            "#pragma unroll_loop_end\n"
+            "z";
+
+    REQUIRE(GLShaderPreprocessor::process(source, {{"NUM", "2"}}) ==
+            "\n\tx[ 0 ] = y[ 0 ] + 0;\n"
+            "\n\tx[ 1 ] = y[ 1 ] + 1;\n"
+            "\n"
+            "z");
+
+    REQUIRE(GLShaderPreprocessor::process(source, {{"NUM", "0"}}) == "\nz");
+
+    // loops with non constant bounds are left untouched
+    REQUIRE(GLShaderPreprocessor::process(source, {}) == source);
+}
+
+TEST_CASE("memoize") {
+
+    GLShaderPreprocessor preprocessor;
+
+    const auto a = preprocessor.get("x NUM", {{"NUM", "1"}});
+    const auto b = preprocessor.get("x NUM", {{"NUM", "1"}});
+    const auto c = preprocessor.get("x NUM", {{"NUM", "2"}});
+
+    REQUIRE(a == "x 1");
+    REQUIRE(b == a);
+    REQUIRE(c == "x 2");
+    REQUIRE(preprocessor.size() == 2);
+}
+
+TEST_CASE("memoize up to a size") {
+
+    GLShaderPreprocessor preprocessor(2);
+
+    preprocessor.get("x NUM", {{"NUM", "1"}});
+    preprocessor.get("x NUM", {{"NUM", "2"}});
+    REQUIRE(preprocessor.size() == 2);
+
+    // full, starts over
+    REQUIRE(preprocessor.get("y NUM", {{"NUM", "1"}}) == "y 1");
+    REQUIRE(preprocessor.size() == 1);
+
+    preprocessor.clear();
+    REQUIRE(preprocessor.size() == 0);
+}
@@ -0,0 +1,208 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/renderers/gl/GLShadowAtlas.hpp"
+
+using namespace threepp::gl;
+
+namespace {
+
+    ShadowAtlasRegion region(unsigned int cellSize, unsigned int columns, unsigned int rows, float importance) {
+
+        ShadowAtlasRegion region;
+        region.cellWidth = cellSize;
+        region.cellHeight = cellSize;
+        region.columns = columns;
+        region.rows = rows;
+        region.importance = importance;
+
+        return region;
+    }
+
+    unsigned int packedWidth(const ShadowAtlasRegion& region) {
+
+        return region.packedCellWidth * region.columns;
+    }
+
+    unsigned int packedHeight(const ShadowAtlasRegion& region) {
+
+        return region.packedCellHeight * region.rows;
+    }
+
+    // every packed map and its padding lies inside the atlas, and no two overlap
+    void checkLayout(unsigned int size, unsigned int padding, const std::vector<ShadowAtlasRegion>& regions) {
+
+        for (size_t i = 0; i < regions.size(); i++) {
+
+            const auto& a = regions[i];
+            if (a.packedCellWidth == 0) continue;
+
+            CHECK(a.x >= padding);
+            CHECK(a.y >= padding);
+            CHECK(a.x + packedWidth(a) + padding <= size);
+            CHECK(a.y + packedHeight(a) + padding <= size);
+
+            for (size_t j = i + 1; j < regions.size(); j++) {
+
+                const auto& b = regions[j];
+                if (b.packedCellWidth == 0) continue;
+
+                const bool apart = a.x + packedWidth(a) + padding <= b.x - padding ||
+                                   b.x + packedWidth(b) + padding <= a.x - padding ||
+                                   a.y + packedHeight(a) + padding <= b.y - padding ||
+                                   b.y + packedHeight(b) + padding <= a.y - padding;
+                CHECK(apart);
+            }
+        }
+    }
+
+}// namespace
+
+TEST_CASE("maps are sized by importance") {
+
+    std::vector<ShadowAtlasRegion> regions{
+            region(1024, 1, 1, 1),
+            region(1024, 1, 1, 0.6f),
+            region(1024, 1, 1, 0.3f),
+            region(512, 4, 2, 0.1f),
+            region(512, 1, 1, 0)};
+
+    packShadowAtlas(4096, 4, regions);
+
+    CHECK(regions[0].packedCellWidth == 1024);
+    CHECK(regions[1].packedCellWidth == 1024);
+    CHECK(regions[2].packedCellWidth == 512);
+    CHECK(regions[3].packedCellWidth == 64);
+    CHECK(regions[3].packedCellHeight == 64);
+    CHECK(regions[4].packedCellWidth == 32);
+
+    checkLayout(4096, 4, regions);
+}
+
+TEST_CASE("the largest maps shrink when the atlas is full") {
+
+    std::vector<ShadowAtlasRegion> regions;
+    for (int i = 0; i < 6; i++) regions.emplace_back(region(2048, 1, 1, 1));
+    regions.emplace_back(region(256, 1, 1, 1));
+
+    packShadowAtlas(4096, 2, regions);
+
+    for (int i = 0; i < 6; i++) {
+
+        CHECK(regions[i].packedCellWidth > 0);
+        CHECK(regions[i].packedCellWidth < 2048);
+    }
+    CHECK(regions[6].packedCellWidth == 256);
+
+    checkLayout(4096, 2, regions);
+}
+
+TEST_CASE("the least important maps are left out of a full atlas") {
+
+    std::vector<ShadowAtlasRegion> regions;
+    for (int i = 0; i < 40; i++) regions.emplace_back(region(1024, 4, 2, static_cast<float>(i) / 40));
+
+    packShadowAtlas(1024, 4, regions);
+
+    size_t packed = 0;
+    for (const auto& r : regions) {
+
+        if (r.packedCellWidth > 0) packed++;
+    }
+
+    CHECK(packed > 0);
+    CHECK(packed < regions.size());
+    // the ones left out are the least important
+    CHECK(regions.front().packedCellWidth == 0);
+    CHECK(regions.back().packedCellWidth > 0);
+
+    checkLayout(1024, 4, regions);
+}
+
+TEST_CASE("packing is stable") {
+
+    std::vector<ShadowAtlasRegion> regions{
+            region(1024, 1, 1, 1),
+            region(512, 4, 2, 0.5f),
+            region(1024, 2, 2, 0.8f)};
+
+    packShadowAtlas(4096, 4, regions);
+    const auto first = regions;
+
+    packShadowAtlas(4096, 4, regions);
+
+    for (size_t i = 0; i < regions.size(); i++) {
+
+        CHECK(regions[i].x == first[i].x);
+        CHECK(regions[i].y == first[i].y);
+        CHECK(regions[i].packedCellWidth == first[i].packedCellWidth);
+    }
+}
+
+TEST_CASE("maps keep their size close to a fraction") {
+
+    std::vector<ShadowAtlasRegion> regions{region(1024, 1, 1, 0.51f)};
+
+    packShadowAtlas(4096, 4, regions);
+    REQUIRE(regions[0].packedCellWidth == 1024);
+    const auto x = regions[0].x;
+    const auto y = regions[0].y;
+
+    // just below half
+    regions[0].importance = 0.49f;
+    packShadowAtlas(4096, 4, regions);
+    CHECK(regions[0].packedCellWidth == 1024);
+    CHECK(regions[0].x == x);
+    CHECK(regions[0].y == y);
+
+    // well below
+    regions[0].importance = 0.4f;
+    packShadowAtlas(4096, 4, regions);
+    CHECK(regions[0].packedCellWidth == 512);
+
+    // and back up, just above half
+    regions[0].importance = 0.55f;
+    packShadowAtlas(4096, 4, regions);
+    CHECK(regions[0].packedCellWidth == 512);
+
+    regions[0].importance = 0.7f;
+    packShadowAtlas(4096, 4, regions);
+    CHECK(regions[0].packedCellWidth == 1024);
+}
+
+TEST_CASE("maps keep their place when others change") {
+
+    std::vector<ShadowAtlasRegion> regions{
+            region(1024, 1, 1, 1),
+            region(1024, 1, 1, 1),
+            region(512, 4, 2, 1),
+            region(1024, 2, 2, 1)};
+
+    packShadowAtlas(4096, 4, regions);
+    const auto first = regions;
+
+    regions[1].importance = 0.2f;
+    packShadowAtlas(4096, 4, regions);
+
+    CHECK(regions[1].packedCellWidth == 256);
+    for (const auto i : {0, 2, 3}) {
+
+        CHECK(regions[i].x == first[i].x);
+        CHECK(regions[i].y == first[i].y);
+        CHECK(regions[i].packedCellWidth == first[i].packedCellWidth);
+    }
+
+    checkLayout(4096, 4, regions);
+
+    // growing again needs room next to the maps that stayed
+    regions[1].importance = 1;
+    packShadowAtlas(4096, 4, regions);
+
+    CHECK(regions[1].packedCellWidth == 1024);
+    for (const auto i : {0, 2, 3}) {
+
+        CHECK(regions[i].x == first[i].x);
+        CHECK(regions[i].y == first[i].y);
+    }
+
+    checkLayout(4096, 4, regions);
+}
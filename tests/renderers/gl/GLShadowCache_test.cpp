@@ -0,0 +1,100 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/lights/DirectionalLight.hpp"
+#include "threepp/materials/MeshBasicMaterial.hpp"
+#include "threepp/objects/InstancedMesh.hpp"
+#include "threepp/renderers/gl/GLShadowCache.hpp"
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace {
+
+    bool record(GLShadowCache& cache, DirectionalLight& light, const std::vector<Object3D*>& casters) {
+
+        light.updateMatrixWorld();
+        light.shadow->updateMatrices(light);
+
+        cache.begin(*light.shadow, ShadowMap::PFC);
+        cache.addCamera(*light.shadow->camera);
+        for (auto caster : casters) {
+
+            caster->updateMatrixWorld();
+            cache.addCaster(*caster);
+        }
+
+        return cache.end();
+    }
+
+}// namespace
+
+TEST_CASE("changes to casters are detected") {
+
+    auto light = DirectionalLight::create();
+    light->position.set(5, 10, 5);
+
+    auto mesh = Mesh::create(BoxGeometry::create(), MeshBasicMaterial::create());
+    auto instanced = InstancedMesh::create(BoxGeometry::create(), MeshBasicMaterial::create(), 10);
+
+    GLShadowCache cache;
+    const std::vector<Object3D*> casters{mesh.get(), instanced.get()};
+
+    CHECK(record(cache, *light, casters));
+    CHECK_FALSE(record(cache, *light, casters));
+
+    mesh->position.x = 1;
+    CHECK(record(cache, *light, casters));
+    CHECK_FALSE(record(cache, *light, casters));
+
+    mesh->geometry()->getAttribute("position")->needsUpdate();
+    CHECK(record(cache, *light, casters));
+
+    mesh->material()->needsUpdate();
+    CHECK(record(cache, *light, casters));
+
+    mesh->material()->side = Side::Double;
+    CHECK(record(cache, *light, casters));
+
+    instanced->instanceMatrix()->needsUpdate();
+    CHECK(record(cache, *light, casters));
+
+    instanced->setCount(5);
+    CHECK(record(cache, *light, casters));
+    CHECK_FALSE(record(cache, *light, casters));
+
+    // a caster leaving the frustum
+    CHECK(record(cache, *light, {mesh.get()}));
+    CHECK_FALSE(record(cache, *light, {mesh.get()}));
+}
+
+TEST_CASE("changes to the light are detected") {
+
+    auto light = DirectionalLight::create();
+    auto mesh = Mesh::create(BoxGeometry::create(), MeshBasicMaterial::create());
+
+    GLShadowCache cache;
+
+    CHECK(record(cache, *light, {mesh.get()}));
+    CHECK_FALSE(record(cache, *light, {mesh.get()}));
+
+    light->position.set(1, 2, 3);
+    CHECK(record(cache, *light, {mesh.get()}));
+
+    light->shadow->mapSize.set(512, 512);
+    CHECK(record(cache, *light, {mesh.get()}));
+    CHECK_FALSE(record(cache, *light, {mesh.get()}));
+
+    // lights keep separate records
+    auto other = DirectionalLight::create();
+    CHECK(record(cache, *other, {mesh.get()}));
+    CHECK_FALSE(record(cache, *light, {mesh.get()}));
+    CHECK(cache.size() == 2);
+
+    cache.retain({light.get()});
+    CHECK(cache.size() == 1);
+    CHECK(record(cache, *other, {mesh.get()}));
+
+    cache.clear();
+    CHECK(record(cache, *light, {mesh.get()}));
+}
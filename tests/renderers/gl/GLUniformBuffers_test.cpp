@@ -0,0 +1,177 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/cameras/OrthographicCamera.hpp"
+#include "threepp/cameras/PerspectiveCamera.hpp"
+#include "threepp/renderers/gl/GLUniformBuffers.hpp"
+
+#include <cstring>
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace {
+
+    int asInt(float f) {
+
+        int i;
+        std::memcpy(&i, &f, sizeof(int));
+        return i;
+    }
+
+    const Std140Buffer& block(const std::array<Std140Buffer, static_cast<size_t>(GLUniformBuffers::Block::Count)>& blocks, GLUniformBuffers::Block b) {
+
+        return blocks[static_cast<size_t>(b)];
+    }
+
+}// namespace
+
+TEST_CASE("std140 alignment") {
+
+    Std140Buffer buffer;
+    buffer.putFloat(1);
+    buffer.putVec2({2, 3});
+    buffer.putVec3(Vector3{4, 5, 6});
+    buffer.putFloat(7);
+    buffer.endElement();
+
+    // vec2 aligns to 8 bytes, vec3 to 16 bytes and a float may fill the tail of a vec3
+    REQUIRE(buffer.data() == std::vector<float>{1, 0, 2, 3, 4, 5, 6, 7});
+    REQUIRE(buffer.byteSize() == 32);
+}
+
+TEST_CASE("std140 changes") {
+
+    Std140Buffer buffer;
+    buffer.putVec3(Vector3{1, 2, 3});
+    REQUIRE(buffer.changed());
+
+    // the same contents again
+    buffer.clear();
+    buffer.putVec3(Vector3{1, 2, 3});
+    REQUIRE_FALSE(buffer.changed());
+
+    buffer.clear();
+    buffer.putVec3(Vector3{1, 2, 4});
+    REQUIRE(buffer.changed());
+
+    // fewer elements
+    buffer.clear();
+    buffer.putFloat(1);
+    REQUIRE(buffer.changed());
+}
+
+TEST_CASE("pack camera") {
+
+    Std140Buffer buffer;
+
+    PerspectiveCamera perspective;
+    perspective.position.set(1, 2, 3);
+    perspective.updateMatrixWorld();
+
+    GLUniformBuffers::packCamera(perspective, buffer);
+
+    REQUIRE(buffer.byteSize() == 144);
+    REQUIRE(buffer.data()[0] == perspective.projectionMatrix.elements[0]);
+    REQUIRE(buffer.data()[16 + 12] == perspective.matrixWorldInverse.elements[12]);
+    REQUIRE(buffer.data()[32] == 1);
+    REQUIRE(buffer.data()[33] == 2);
+    REQUIRE(buffer.data()[34] == 3);
+    REQUIRE(asInt(buffer.data()[35]) == 0);
+
+    OrthographicCamera ortho;
+    GLUniformBuffers::packCamera(ortho, buffer);
+
+    REQUIRE(buffer.byteSize() == 144);
+    REQUIRE(asInt(buffer.data()[35]) == 1);
+}
+
+TEST_CASE("pack lights") {
+
+    using Block = GLUniformBuffers::Block;
+
+    LightUniforms point{
+            {"position", Vector3(1, 2, 3)},
+            {"color", Color(0.5f, 0.5f, 0.5f)},
+            {"distance", 10.f},
+            {"decay", 2.f}};
+
+    LightUniforms spot{
+            {"position", Vector3(1, 2, 3)},
+            {"direction", Vector3(0, -1, 0)},
+            {"color", Color(1, 1, 1)},
+            {"distance", 5.f},
+            {"decay", 1.f},
+            {"coneCos", 0.5f},
+            {"penumbraCos", 0.25f}};
+
+    LightUniforms pointShadow{
+            {"shadowBias", 0.1f},
+            {"shadowNormalBias", 0.2f},
+            {"shadowRadius", 1.f},
+            {"shadowMapSize", Vector2(512, 512)},
+            {"shadowCameraNear", 1.f},
+            {"shadowCameraFar", 1000.f}};
+
+    LightUniforms directionalShadow{
+            {"shadowBias", 0.1f},
+            {"shadowNormalBias", 0.2f},
+            {"shadowRadius", 1.f},
+            {"shadowMapSize", Vector2(1024, 1024)},
+            {"shadowCascades", 4.f},
+            {"shadowMapRect", Vector4(0.5f, 0.25f, 0.5f, 0.5f)}};
+
+    Matrix4 shadowMatrix;
+    shadowMatrix.makeTranslation(1, 2, 3);
+
+    GLLights::LightState state;
+    state.ambient.setRGB(0.1f, 0.2f, 0.3f);
+    state.point = {&point, &point};
+    state.spot = {&spot};
+    state.pointShadow = {&pointShadow};
+    state.pointShadowMatrix = {&shadowMatrix};
+    state.directionalShadow = {&directionalShadow};
+    state.directionalShadowCascadeMatrix = {nullptr, &shadowMatrix};
+
+    std::array<Std140Buffer, static_cast<size_t>(Block::Count)> blocks;
+    GLUniformBuffers::packLights(state, blocks);
+
+    // vec3 ambientLightColor followed by vec3[9] with a 16 byte stride
+    REQUIRE(block(blocks, Block::AmbientLight).byteSize() == 16 + 9 * 16);
+    REQUIRE(block(blocks, Block::AmbientLight).data()[2] == 0.3f);
+
+    const auto& pointData = block(blocks, Block::PointLights).data();
+    REQUIRE(block(blocks, Block::PointLights).byteSize() == 2 * 48);
+    REQUIRE(pointData[4] == 0.5f); // color
+    REQUIRE(pointData[7] == 10.f); // distance packed into the tail of color
+    REQUIRE(pointData[8] == 2.f);  // decay
+    REQUIRE(pointData[12] == 1.f); // second light
+    REQUIRE(pointData[13] == 2.f);
+
+    const auto& spotData = block(blocks, Block::SpotLights).data();
+    REQUIRE(block(blocks, Block::SpotLights).byteSize() == 64);
+    REQUIRE(spotData[5] == -1.f);    // direction.y
+    REQUIRE(spotData[11] == 5.f);    // distance
+    REQUIRE(spotData[14] == 0.25f);  // penumbraCos
+
+    const auto& shadowData = block(blocks, Block::PointLightShadows).data();
+    REQUIRE(block(blocks, Block::PointLightShadows).byteSize() == 32);
+    REQUIRE(shadowData[4] == 512.f);  // shadowMapSize aligned to 8 bytes
+    REQUIRE(shadowData[7] == 1000.f); // shadowCameraFar
+
+    REQUIRE(block(blocks, Block::PointShadowMatrix).data() == std::vector<float>(shadowMatrix.elements.begin(), shadowMatrix.elements.end()));
+
+    const auto& directionalShadowData = block(blocks, Block::DirectionalLightShadows).data();
+    REQUIRE(block(blocks, Block::DirectionalLightShadows).byteSize() == 48);
+    REQUIRE(directionalShadowData[5] == 1024.f);
+    REQUIRE(directionalShadowData[6] == 4.f);   // shadowCascades
+    REQUIRE(directionalShadowData[9] == 0.25f); // shadowMapRect aligned to 16 bytes
+
+    const auto& cascadeData = block(blocks, Block::DirectionalShadowCascadeMatrix).data();
+    REQUIRE(cascadeData.size() == 32);
+    REQUIRE(cascadeData[0] == 1.f);  // identity for a missing matrix
+    REQUIRE(cascadeData[28] == 1.f); // translation of the second
+
+    REQUIRE(block(blocks, Block::DirectionalLights).data().empty());
+    REQUIRE(block(blocks, Block::HemisphereLights).data().empty());
+}
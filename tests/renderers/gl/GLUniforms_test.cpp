@@ -0,0 +1,143 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/renderers/gl/GLUniforms.hpp"
+#include "threepp/utils/LoadGlad.hpp"
+
+#include "../HeadlessContext.hpp"
+
+#include <glad/glad.h>
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace {
+
+    const char* vertexShader = R"(#version 330 core
+uniform mat4 modelMatrix;
+uniform float opacity;
+uniform int count;
+uniform bool flag;
+uniform float unused;
+void main() {
+    gl_Position = modelMatrix * vec4(opacity, float(count), flag ? 1.0 : 0.0, 1.0);
+})";
+
+    const char* fragmentShader = R"(#version 330 core
+out vec4 color;
+void main() {
+    color = vec4(1.0);
+})";
+
+    GLuint compile(GLenum type, const char* source) {
+
+        const auto shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+
+        return shader;
+    }
+
+    GLuint link() {
+
+        const auto vertex = compile(GL_VERTEX_SHADER, vertexShader);
+        const auto fragment = compile(GL_FRAGMENT_SHADER, fragmentShader);
+
+        const auto program = glCreateProgram();
+        glAttachShader(program, vertex);
+        glAttachShader(program, fragment);
+        glLinkProgram(program);
+
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+
+        return program;
+    }
+
+    int intUniform(GLuint program, const char* name) {
+
+        GLint value = -1;
+        glGetUniformiv(program, glGetUniformLocation(program, name), &value);
+
+        return value;
+    }
+
+    float floatUniform(GLuint program, const char* name) {
+
+        GLfloat value = -1;
+        glGetUniformfv(program, glGetUniformLocation(program, name), &value);
+
+        return value;
+    }
+
+}// namespace
+
+TEST_CASE("uniform handles") {
+
+    HeadlessContext context;
+    if (!context.valid()) SKIP("no OpenGL context available");
+
+    loadGlad();
+
+    const auto program = link();
+    GLint linked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    REQUIRE(linked);
+
+    glUseProgram(program);
+
+    GLUniforms uniforms(program);
+
+    const auto opacity = uniforms.getHandle("opacity");
+    const auto count = uniforms.getHandle("count");
+    const auto flag = uniforms.getHandle("flag");
+    const auto modelMatrix = uniforms.getHandle("modelMatrix");
+
+    SECTION("lookup") {
+
+        CHECK(opacity.valid());
+        CHECK(opacity.type() == GL_FLOAT);
+        CHECK(count.type() == GL_INT);
+        CHECK(flag.type() == GL_BOOL);
+        CHECK(modelMatrix.type() == GL_FLOAT_MAT4);
+
+        // optimized away, or not declared at all
+        CHECK_FALSE(uniforms.getHandle("unused").valid());
+        CHECK_FALSE(uniforms.getHandle("missing").valid());
+        uniforms.getHandle("missing").setValue(1.f);
+    }
+
+    SECTION("matching types are written") {
+
+        opacity.setValue(0.5f);
+        count.setValue(7);
+        flag.setValue(true);
+
+        CHECK(floatUniform(program, "opacity") == 0.5f);
+        CHECK(intUniform(program, "count") == 7);
+        CHECK(intUniform(program, "flag") == 1);
+
+        // bool and int are interchangeable, as for glUniform1i
+        count.setValue(true);
+        flag.setValue(0);
+        CHECK(intUniform(program, "count") == 1);
+        CHECK(intUniform(program, "flag") == 0);
+    }
+
+    SECTION("mismatched types are ignored") {
+
+        count.setValue(3);
+        opacity.setValue(0.25f);
+
+        count.setValue(2.f);
+        opacity.setValue(5);
+        opacity.setValue(true);
+        modelMatrix.setValue(Matrix3());
+
+        CHECK(glGetError() == GL_NO_ERROR);
+        CHECK(intUniform(program, "count") == 3);
+        CHECK(floatUniform(program, "opacity") == 0.25f);
+    }
+
+    glDeleteProgram(program);
+}
@@ -0,0 +1,234 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/cameras/PerspectiveCamera.hpp"
+#include "threepp/core/Raycaster.hpp"
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/geometries/SphereGeometry.hpp"
+#include "threepp/materials/MeshBasicMaterial.hpp"
+#include "threepp/math/MathUtils.hpp"
+#include "threepp/objects/Group.hpp"
+#include "threepp/objects/InstancedMesh.hpp"
+#include "threepp/objects/Line.hpp"
+#include "threepp/objects/Mesh.hpp"
+#include "threepp/objects/Points.hpp"
+#include "threepp/objects/Sprite.hpp"
+#include "threepp/scenes/Scene.hpp"
+
+using namespace threepp;
+
+namespace {
+
+    struct TestScene {
+
+        std::shared_ptr<Scene> scene = Scene::create();
+        std::vector<std::shared_ptr<Object3D>> objects;
+
+        TestScene() {
+
+            const auto geometry = BoxGeometry::create();
+            const auto material = MeshBasicMaterial::create();
+
+            auto group = Group::create();
+            group->position.x = 5;
+            scene->add(group);
+
+            for (int i = 0; i < 200; i++) {
+
+                auto mesh = Mesh::create(geometry, material);
+                mesh->position.set(math::randFloatSpread(100), math::randFloatSpread(100), math::randFloatSpread(100));
+                mesh->scale.setScalar(math::randFloat(0.5f, 3));
+                objects.emplace_back(mesh);
+                if (i % 2) {
+                    scene->add(mesh);
+                } else {
+                    group->add(mesh);
+                }
+            }
+
+            auto line = Line::create(SphereGeometry::create(2));
+            line->position.set(3, -4, 10);
+            objects.emplace_back(line);
+            scene->add(line);
+
+            auto points = Points::create(SphereGeometry::create(3));
+            points->position.set(-3, 4, 12);
+            objects.emplace_back(points);
+            scene->add(points);
+
+            auto sprite = Sprite::create();
+            sprite->position.set(0, 0, 15);
+            objects.emplace_back(sprite);
+            scene->add(sprite);
+
+            auto instanced = InstancedMesh::create(geometry, material, 10);
+            objects.emplace_back(instanced);
+            scene->add(instanced);
+
+            scene->updateMatrixWorld();
+        }
+    };
+
+    Frustum makeFrustum(const Vector3& position) {
+
+        PerspectiveCamera camera(60, 1, 1, 100);
+        camera.position.copy(position);
+        camera.lookAt({0, 0, 0});
+        camera.updateMatrixWorld();
+
+        Matrix4 projScreenMatrix;
+        projScreenMatrix.multiplyMatrices(camera.projectionMatrix, camera.matrixWorldInverse);
+
+        Frustum frustum;
+        frustum.setFromProjectionMatrix(projScreenMatrix);
+
+        return frustum;
+    }
+
+    bool exactTest(const Frustum& frustum, Object3D& object) {
+
+        if (auto sprite = object.as<Sprite>()) return frustum.intersectsSprite(*sprite);
+
+        return frustum.intersectsObject(object);
+    }
+
+    void checkFrustum(SpatialIndex& index, const Frustum& frustum, const std::vector<std::shared_ptr<Object3D>>& objects) {
+
+        index.query(frustum);
+
+        for (const auto& object : objects) {
+
+            CHECK(index.intersectsFrustum(frustum, *object) == exactTest(frustum, *object));
+        }
+    }
+
+}// namespace
+
+TEST_CASE("update") {
+
+    TestScene s;
+    auto index = SpatialIndex::create();
+
+    index->update(*s.scene);
+    index->tree().validate();
+
+    // meshes, line, points and sprite
+    CHECK(index->size() == 203);
+    CHECK_FALSE(index->contains(*s.objects.back()));
+    CHECK_FALSE(index->contains(*s.scene));
+
+    // scene, group, sprite and instanced mesh
+    CHECK(index->uncovered().size() == 4);
+
+    auto removed = s.objects.front();
+    removed->removeFromParent();
+
+    index->update(*s.scene);
+    index->tree().validate();
+
+    CHECK(index->size() == 202);
+    CHECK_FALSE(index->contains(*removed));
+
+    s.scene->add(removed);
+    index->update(*s.scene);
+
+    CHECK(index->size() == 203);
+    CHECK(index->contains(*removed));
+
+    // objects are tracked by the index that updated them last
+    auto other = SpatialIndex::create();
+    other->update(*s.scene);
+    CHECK(other->contains(*removed));
+    CHECK_FALSE(index->contains(*removed));
+
+    index->update(*s.scene);
+    index->tree().validate();
+    CHECK(index->contains(*removed));
+    CHECK(index->size() == 203);
+}
+
+TEST_CASE("frustum results match exact tests") {
+
+    TestScene s;
+    auto index = SpatialIndex::create();
+
+    index->update(*s.scene);
+
+    const auto frustum = makeFrustum({0, 10, 60});
+    checkFrustum(*index, frustum, s.objects);
+
+    // objects moved, resized and with new geometry
+    for (size_t i = 0; i < 100; i++) {
+
+        auto object = s.objects[i];
+        object->position.set(math::randFloatSpread(100), math::randFloatSpread(100), math::randFloatSpread(100));
+
+        if (i % 10 == 0) object->scale.setScalar(20);
+        if (i % 25 == 0) object->as<Mesh>()->setGeometry(SphereGeometry::create(5));
+    }
+    s.scene->updateMatrixWorld();
+
+    index->update(*s.scene);
+    index->tree().validate();
+
+    checkFrustum(*index, frustum, s.objects);
+    checkFrustum(*index, makeFrustum({-40, -20, 30}), s.objects);
+}
+
+TEST_CASE("raycast through the index") {
+
+    TestScene s;
+
+    Raycaster raycaster;
+    raycaster.params.pointsThreshold = 0.5f;
+
+    PerspectiveCamera camera(60, 1, 1, 1000);
+    camera.position.set(0, 0, 80);
+    camera.updateMatrixWorld();
+
+    for (int i = 0; i < 20; i++) {
+
+        raycaster.setFromCamera({math::randFloatSpread(0.5f), math::randFloatSpread(0.5f)}, camera);
+        if (i == 0) raycaster.setFromCamera({0, 0}, camera);
+
+        s.scene->spatialIndex = nullptr;
+        const auto expected = raycaster.intersectObject(*s.scene, true);
+
+        s.scene->spatialIndex = SpatialIndex::create();
+        s.scene->spatialIndex->update(*s.scene);
+        const auto actual = raycaster.intersectObject(*s.scene, true);
+
+        REQUIRE(actual.size() == expected.size());
+        for (size_t j = 0; j < actual.size(); j++) {
+
+            CHECK(actual[j].object == expected[j].object);
+            CHECK(actual[j].distance == expected[j].distance);
+        }
+    }
+}
+
+TEST_CASE("raycasts read the index as of its last update") {
+
+    auto scene = Scene::create();
+    scene->spatialIndex = SpatialIndex::create();
+
+    auto mesh = Mesh::create(BoxGeometry::create(), MeshBasicMaterial::create());
+    scene->add(mesh);
+    scene->updateMatrixWorld();
+    scene->spatialIndex->update(*scene);
+
+    Raycaster raycaster({0, 0, 10}, {0, 0, -1});
+    CHECK(!raycaster.intersectObject(*scene, true).empty());
+
+    // moved out of the ray, the index still has it where it was, so the raycast tests it and misses
+    mesh->position.x = 10;
+    scene->updateMatrixWorld();
+    CHECK(raycaster.intersectObject(*scene, true).empty());
+
+    // moved under the ray, where the index does not look until it is updated
+    raycaster.ray.origin.x = 10;
+    CHECK(raycaster.intersectObject(*scene, true).empty());
+
+    scene->spatialIndex->update(*scene);
+    CHECK(!raycaster.intersectObject(*scene, true).empty());
+}
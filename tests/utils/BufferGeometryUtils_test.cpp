@@ -0,0 +1,265 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/geometries/PlaneGeometry.hpp"
+#include "threepp/geometries/SphereGeometry.hpp"
+#include "threepp/materials/MeshBasicMaterial.hpp"
+#include "threepp/math/MathUtils.hpp"
+#include "threepp/objects/Mesh.hpp"
+#include "threepp/utils/BufferGeometryUtils.hpp"
+
+#include <limits>
+
+using namespace threepp;
+
+namespace {
+
+    std::shared_ptr<BufferGeometry> makeGeometry() {
+
+        auto geometry = SphereGeometry::create(1, 32, 16);
+        geometry->scale(4, 1, 0.5f);
+        geometry->translate(10, -3, 2);
+
+        return geometry;
+    }
+
+    template<class T>
+    Vector3 decodePosition(BufferAttribute& attribute, int index) {
+
+        const auto& quantized = *attribute.typed<T>();
+        const float max = std::numeric_limits<T>::max();
+
+        return {quantized.getX(index) / max, quantized.getY(index) / max, quantized.getZ(index) / max};
+    }
+
+    // same decoding as the vertex shader
+    Vector3 decodeNormal(BufferAttribute& attribute, int index) {
+
+        const auto& quantized = *attribute.typed<uint8_t>();
+
+        const float x = quantized.getX(index) / 255.f * 2 - 1;
+        const float y = quantized.getY(index) / 255.f * 2 - 1;
+
+        Vector3 v{x, y, 1 - std::abs(x) - std::abs(y)};
+        if (v.z < 0) {
+
+            v.x = (1 - std::abs(y)) * (x >= 0 ? 1.f : -1.f);
+            v.y = (1 - std::abs(x)) * (y >= 0 ? 1.f : -1.f);
+        }
+
+        return v.normalize();
+    }
+
+}// namespace
+
+TEST_CASE("quantizeGeometry") {
+
+    auto geometry = makeGeometry();
+    const auto original = makeGeometry();
+
+    const auto count = original->getAttribute<float>("position")->count();
+
+    const auto result = quantizeGeometry(*geometry);
+
+    CHECK(geometry->getAttribute("position")->typed<uint16_t>() != nullptr);
+    CHECK(geometry->getAttribute("position")->normalized());
+    CHECK(geometry->getAttribute("normal")->typed<uint8_t>() != nullptr);
+    CHECK(geometry->getAttribute("normal")->itemSize() == 2);
+    // the pole vertices of a sphere have u > 1
+    CHECK(geometry->getAttribute("uv")->typed<float>() != nullptr);
+
+    // float: 12 + 12 bytes per vertex, quantized: 6 + 2
+    CHECK(result.bytesBefore == count * 24);
+    CHECK(result.bytesAfter == count * 8);
+
+    // half a step of the largest axis
+    CHECK(result.positionError > 0);
+    CHECK(result.positionError <= 8.f / 65535 / 2 * 1.01f);
+    CHECK(result.normalError < 2 * math::DEG2RAD);
+
+    auto& position = *geometry->getAttribute("position");
+    const auto& originalPosition = *original->getAttribute<float>("position");
+
+    float maxError = 0;
+    for (int i = 0; i < count; i++) {
+
+        auto decoded = decodePosition<uint16_t>(position, i).applyMatrix4(result.decodeMatrix);
+
+        Vector3 expected;
+        originalPosition.setFromBufferAttribute(expected, i);
+
+        maxError = std::max(maxError, decoded.distanceTo(expected));
+    }
+    CHECK(maxError <= result.positionError * 2);
+
+    REQUIRE(geometry->boundingBox);
+    CHECK(geometry->boundingBox->min().equals({0, 0, 0}));
+    CHECK(geometry->boundingBox->max().equals({1, 1, 1}));
+}
+
+TEST_CASE("quantizeGeometry uvs") {
+
+    auto geometry = PlaneGeometry::create(2, 2, 3, 3);
+    const auto uv = geometry->getAttribute<float>("uv")->array();
+
+    const auto result = quantizeGeometry(*geometry);
+
+    auto& quantized = *geometry->getAttribute("uv")->typed<uint16_t>();
+    CHECK(quantized.normalized());
+    CHECK(result.uvError <= 0.5f / 65535);
+
+    float maxError = 0;
+    for (size_t i = 0; i < uv.size(); i++) {
+
+        maxError = std::max(maxError, std::abs(quantized.array()[i] / 65535.f - uv[i]));
+    }
+    CHECK(maxError <= result.uvError);
+
+    // the plane is flat along z
+    CHECK(result.decodeMatrix.elements[10] == 1);
+}
+
+TEST_CASE("quantizeGeometry 8 bits") {
+
+    auto geometry = makeGeometry();
+
+    QuantizeOptions options;
+    options.positionBits = 8;
+    options.uvs = false;
+
+    const auto result = quantizeGeometry(*geometry, options);
+
+    CHECK(geometry->getAttribute("position")->typed<uint8_t>() != nullptr);
+    CHECK(geometry->getAttribute("uv")->typed<float>() != nullptr);
+    CHECK(result.positionError <= 8.f / 255 / 2 * 1.01f);
+
+    options.positionBits = 12;
+    CHECK_THROWS(quantizeGeometry(*makeGeometry(), options));
+}
+
+TEST_CASE("quantizeGeometry float normals") {
+
+    auto geometry = BoxGeometry::create(2, 1, 1);
+
+    const Vector3 slanted = Vector3(1, 1, 0).normalize();
+    geometry->getAttribute<float>("normal")->setXYZ(0, slanted.x, slanted.y, slanted.z);
+
+    QuantizeOptions options;
+    options.normalBits = 0;
+
+    const auto result = quantizeGeometry(*geometry, options);
+
+    auto& normal = *geometry->getAttribute<float>("normal");
+    CHECK(normal.itemSize() == 3);
+
+    // the normal matrix of the decode matrix divides by its scale
+    Matrix3 normalMatrix;
+    normalMatrix.getNormalMatrix(result.decodeMatrix);
+
+    Vector3 decoded;
+    normal.setFromBufferAttribute(decoded, 0);
+    decoded.applyNormalMatrix(normalMatrix);
+
+    CHECK(decoded.angleTo(slanted) < 1e-4f);
+}
+
+TEST_CASE("quantizeMesh") {
+
+    auto mesh = Mesh::create(makeGeometry(), MeshBasicMaterial::create());
+    mesh->position.set(1, 2, 3);
+    mesh->rotation.set(0.3f, -1.2f, 0.7f);
+    mesh->scale.set(2, 3, 1);
+    mesh->updateMatrixWorld();
+
+    const auto original = makeGeometry();
+    const auto& originalPosition = *original->getAttribute<float>("position");
+    const auto& originalNormal = *original->getAttribute<float>("normal");
+
+    Matrix3 normalMatrix;
+    normalMatrix.getNormalMatrix(*mesh->matrixWorld);
+
+    std::vector<Vector3> worldPositions, worldNormals;
+    for (int i = 0; i < originalPosition.count(); i++) {
+
+        Vector3 v;
+        originalPosition.setFromBufferAttribute(v, i);
+        worldPositions.emplace_back(v.applyMatrix4(*mesh->matrixWorld));
+
+        originalNormal.setFromBufferAttribute(v, i);
+        worldNormals.emplace_back(v.applyNormalMatrix(normalMatrix));
+    }
+
+    const auto result = quantizeMesh(*mesh);
+    mesh->updateMatrixWorld();
+    normalMatrix.getNormalMatrix(*mesh->matrixWorld);
+
+    auto& position = *mesh->geometry()->getAttribute("position");
+    auto& normal = *mesh->geometry()->getAttribute("normal");
+
+    float positionError = 0;
+    float normalError = 0;
+    for (int i = 0; i < position.count(); i++) {
+
+        const auto p = decodePosition<uint16_t>(position, i).applyMatrix4(*mesh->matrixWorld);
+        positionError = std::max(positionError, p.distanceTo(worldPositions[i]));
+
+        const auto n = decodeNormal(normal, i).applyNormalMatrix(normalMatrix);
+        normalError = std::max(normalError, n.angleTo(worldNormals[i]));
+    }
+
+    // the mesh scales the geometry by up to 3
+    CHECK(positionError <= result.positionError * 3 * 1.01f);
+    CHECK(normalError < 4 * math::DEG2RAD);
+
+    auto parent = Mesh::create(makeGeometry(), MeshBasicMaterial::create());
+    parent->add(Mesh::create());
+    CHECK_THROWS(quantizeMesh(*parent));
+}
+
+TEST_CASE("interleave") {
+
+    auto geometry = SphereGeometry::create(1, 8, 6);
+    const auto original = SphereGeometry::create(1, 8, 6);
+
+    const auto buffer = interleave(*geometry);
+    REQUIRE(buffer);
+
+    // position, normal, uv
+    CHECK(buffer->stride() == 8);
+    CHECK(buffer->count() == original->getAttribute<float>("position")->count());
+
+    for (const auto& name : {"position", "normal", "uv"}) {
+
+        auto attribute = dynamic_cast<InterleavedBufferAttribute*>(geometry->getAttribute(name));
+        REQUIRE(attribute);
+        CHECK(attribute->data == buffer);
+
+        const auto expected = original->getAttribute<float>(name);
+        CHECK(attribute->itemSize() == expected->itemSize());
+
+        for (int i = 0; i < expected->count(); i++) {
+
+            CHECK(attribute->getX(i) == expected->getX(i));
+            CHECK(attribute->getY(i) == expected->getY(i));
+        }
+    }
+
+    CHECK(dynamic_cast<InterleavedBufferAttribute*>(geometry->getAttribute("position"))->offset == 0);
+
+    // updates of any attribute reach the shared buffer
+    const auto version = buffer->version;
+    geometry->getAttribute("uv")->needsUpdate();
+    CHECK(buffer->version == version + 1);
+
+    // non-indexed copies are packed again
+    const auto nonIndexed = geometry->toNonIndexed();
+    const auto position = nonIndexed->getAttribute<float>("position");
+    CHECK(dynamic_cast<InterleavedBufferAttribute*>(position) == nullptr);
+    CHECK(position->count() == geometry->getIndex()->count());
+
+    const auto index = geometry->getIndex()->array()[5];
+    CHECK(position->getZ(5) == original->getAttribute<float>("position")->getZ(index));
+
+    CHECK_THROWS(interleaveAttributes({FloatBufferAttribute::create({0, 0, 0}, 3).get(), FloatBufferAttribute::create({0, 0, 0, 0}, 2).get()}));
+}
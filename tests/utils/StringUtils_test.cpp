@@ -97,3 +97,11 @@ TEST_CASE("parseNumber successfully parses numbers from strings", "[parseNumber]
         REQUIRE_THAT(floatResult, Catch::Matchers::WithinRel(456.789f));
     }
 }
+
+TEST_CASE("fnv1a") {
+
+    // reference values of 64-bit FNV-1a
+    REQUIRE(utils::fnv1a("") == 0xcbf29ce484222325ull);
+    REQUIRE(utils::fnv1a("a") == 0xaf63dc4c8601ec8cull);
+    REQUIRE(utils::fnv1a("foobar") == 0x85944171f73967e8ull);
+}
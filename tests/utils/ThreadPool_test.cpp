@@ -0,0 +1,55 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/utils/ThreadPool.hpp"
+
+#include <atomic>
+#include <vector>
+
+using namespace threepp;
+
+TEST_CASE("parallelFor visits every index once") {
+
+    utils::ThreadPool pool(4);
+    REQUIRE(pool.size() == 4);
+
+    std::vector<int> visits(1000);
+    pool.parallelFor(visits.size(), [&](size_t i) {
+        visits[i]++;
+    });
+
+    for (auto v : visits) {
+        CHECK(v == 1);
+    }
+}
+
+TEST_CASE("parallelFor can be called repeatedly") {
+
+    utils::ThreadPool pool(3);
+
+    std::atomic<size_t> sum{0};
+    for (int run = 0; run < 100; run++) {
+        pool.parallelFor(run, [&](size_t i) {
+            sum += i;
+        });
+    }
+
+    size_t expected = 0;
+    for (size_t run = 1; run < 100; run++) {
+        expected += run * (run - 1) / 2;
+    }
+
+    CHECK(sum == expected);
+}
+
+TEST_CASE("single threaded pool runs inline") {
+
+    utils::ThreadPool pool(1);
+
+    std::vector<size_t> order;
+    pool.parallelFor(5, [&](size_t i) {
+        order.emplace_back(i);
+    });
+
+    CHECK(order == std::vector<size_t>{0, 1, 2, 3, 4});
+}